@@ -42,6 +42,368 @@
 #define CLIENT_QUEUE_SIZE 20
 #endif
 
+/** Default maximum number of sockets a single client may hold open, including accepted TCP connections.
+ * Zero is unlimited, so any client may use every socket. Default is 0.
+ * Can be set per client with xtcp_configure_client_quota(). */
+#ifndef XTCP_CLIENT_MAX_SOCKETS
+#define XTCP_CLIENT_MAX_SOCKETS 0
+#endif
+
+/** Default maximum number of received bytes a single client may hold in pbufs waiting for recv()/recvfrom().
+ * Zero is unlimited, otherwise it must be at least TCP_MSS and XTCP_UDP_MAX_DATAGRAM_SIZE. Default is 0. Can be set
+ * per client with xtcp_configure_client_quota(). */
+#ifndef XTCP_CLIENT_MAX_RX_BYTES
+#define XTCP_CLIENT_MAX_RX_BYTES 0
+#endif
+
+/** Default maximum number of TCP bytes a single client may have sent but not yet acknowledged by the remote host.
+ * Zero is unlimited. Default is 0. Can be set per client with xtcp_configure_client_quota(). */
+#ifndef XTCP_CLIENT_MAX_TX_BYTES
+#define XTCP_CLIENT_MAX_TX_BYTES 0
+#endif
+
+/** Serve the send calls of clients in weighted rounds in the xtcp_lwip() select loop, and hold them for a
+ * high-priority client whose events have waited XTCP_CLIENT_PRIORITY_BOUND iterations. The select then takes ready
+ * cases in a fixed order: the lwIP timers, a stream transfer every other iteration, the network, then the clients.
+ * When 0 the select serves them in whatever order it chooses. Default is 0. */
+#ifndef XTCP_CLIENT_SCHED_ENABLE
+#define XTCP_CLIENT_SCHED_ENABLE 0
+#endif
+
+/** Default weight of a client, the number of send calls it is served in each round of the select loop.
+ * Can be set per client with xtcp_configure_client_sched(). Default is 4. */
+#ifndef XTCP_CLIENT_WEIGHT
+#define XTCP_CLIENT_WEIGHT 4
+#endif
+
+/** Number of iterations of the select loop a high-priority client's queued events may wait before the send calls of
+ * normal-priority clients are held, until it takes an event. Default is 8. */
+#ifndef XTCP_CLIENT_PRIORITY_BOUND
+#define XTCP_CLIENT_PRIORITY_BOUND 8
+#endif
+
+/** Maximum number of iterations of the select loop the send calls of a client are held, either for a high-priority
+ * client that is not taking its events or for a round that has not ended because the loop is never idle. A
+ * high-priority client's wait then starts again, or a new round starts. Default is 64. */
+#ifndef XTCP_CLIENT_HOLD_MAX
+#define XTCP_CLIENT_HOLD_MAX 64
+#endif
+
+/** Enable the fixed size-class pools for transmit buffers. When disabled, or when lwIP is built without custom pbuf
+ * support, every transmit buffer is allocated from the lwIP heap. Default is 1. */
+#ifndef XTCP_TX_POOL_ENABLE
+#define XTCP_TX_POOL_ENABLE 1
+#endif
+
+/** Number of transmit buffer pool size classes. Fixed at 4. */
+#define XTCP_TX_POOL_NUM_CLASSES 4
+
+/** Payload size of the smallest transmit buffer pool class, for small control messages. Default is 64. */
+#ifndef XTCP_TX_POOL_SMALL_SIZE
+#define XTCP_TX_POOL_SMALL_SIZE 64
+#endif
+
+/** Number of buffers in the smallest transmit buffer pool class. Default is 8. */
+#ifndef XTCP_TX_POOL_SMALL_COUNT
+#define XTCP_TX_POOL_SMALL_COUNT 8
+#endif
+
+/** Payload size of the medium transmit buffer pool class. Default is 256. */
+#ifndef XTCP_TX_POOL_MEDIUM_SIZE
+#define XTCP_TX_POOL_MEDIUM_SIZE 256
+#endif
+
+/** Number of buffers in the medium transmit buffer pool class. Default is 4. */
+#ifndef XTCP_TX_POOL_MEDIUM_COUNT
+#define XTCP_TX_POOL_MEDIUM_COUNT 4
+#endif
+
+/** Payload size of the MSS transmit buffer pool class, one full TCP segment. Default is 1460. */
+#ifndef XTCP_TX_POOL_MSS_SIZE
+#define XTCP_TX_POOL_MSS_SIZE 1460
+#endif
+
+/** Number of buffers in the MSS transmit buffer pool class. Default is 2. */
+#ifndef XTCP_TX_POOL_MSS_COUNT
+#define XTCP_TX_POOL_MSS_COUNT 2
+#endif
+
+/** Payload size of the largest transmit buffer pool class, one full unfragmented UDP datagram. Default is 1472. */
+#ifndef XTCP_TX_POOL_FRAME_SIZE
+#define XTCP_TX_POOL_FRAME_SIZE 1472
+#endif
+
+/** Number of buffers in the largest transmit buffer pool class. Default is 2. */
+#ifndef XTCP_TX_POOL_FRAME_COUNT
+#define XTCP_TX_POOL_FRAME_COUNT 2
+#endif
+
+/** Allow a transmit buffer to be allocated from the lwIP heap when every pool class that fits is exhausted, or the
+ * length is larger than the largest class. Set to 0 to never use the heap for transmit buffers. Default is 1. */
+#ifndef XTCP_TX_POOL_FALLBACK_HEAP
+#define XTCP_TX_POOL_FALLBACK_HEAP 1
+#endif
+
+/** Build the queues between xtcp_frontend() and xtcp_lwip_pipelined(), needed to use the pipelined mode. When 0 the
+ * queues take no memory and xtcp_lwip_pipelined() fails when started. Default is 0. */
+#ifndef XTCP_PIPELINE_ENABLE
+#define XTCP_PIPELINE_ENABLE 0
+#endif
+
+/** Number of received frames that can be queued between xtcp_frontend() and xtcp_lwip_pipelined(), when
+ * XTCP_PIPELINE_ENABLE is 1. Each frame uses ETHERNET_MAX_PACKET_SIZE bytes of memory. Default is 4. */
+#ifndef XTCP_PIPELINE_RX_FRAMES
+#define XTCP_PIPELINE_RX_FRAMES 4
+#endif
+
+/** Number of frames to send that can be queued between xtcp_lwip_pipelined() and xtcp_frontend(), when
+ * XTCP_PIPELINE_ENABLE is 1. Each frame uses ETHERNET_MAX_PACKET_SIZE bytes of memory. A frame sent while the queue
+ * is full is dropped and counted in tx_queue_full: a TCP segment then waits in LwIP for its next timer, stalling the
+ * connection, and a UDP datagram is lost. The default holds a full TCP send buffer, TCP_SND_BUF / TCP_MSS segments,
+ * plus two frames for acknowledgements and ARP, so one connection never fills it. A smaller queue saves memory at the
+ * cost of these stalls. Default is TCP_SND_BUF / TCP_MSS + 2. */
+#ifndef XTCP_PIPELINE_TX_FRAMES
+#define XTCP_PIPELINE_TX_FRAMES (TCP_SND_BUF / TCP_MSS + 2)
+#endif
+
+/** Drop received frames before lwIP processing when they are for a UDP port with no socket bound, a TCP connection
+ * request to a port with no listening socket, or a multicast group that has not been joined. No ICMP port
+ * unreachable or TCP reset is sent for the dropped frames, so a peer connecting to a closed port waits for its own
+ * timeout instead of being refused. Default is 0. */
+#ifndef XTCP_RX_FILTER_ENABLE
+#define XTCP_RX_FILTER_ENABLE 0
+#endif
+
+/** Maximum rate of ARP requests for other hosts passed to lwIP, in requests per second. Zero removes the limit.
+ * Default is 0. */
+#ifndef XTCP_RATE_LIMIT_ARP_REQUESTS
+#define XTCP_RATE_LIMIT_ARP_REQUESTS 0
+#endif
+
+/** Number of ARP requests for other hosts passed to lwIP in a burst before XTCP_RATE_LIMIT_ARP_REQUESTS applies.
+ * Default is 10. */
+#ifndef XTCP_RATE_LIMIT_ARP_BURST
+#define XTCP_RATE_LIMIT_ARP_BURST 10
+#endif
+
+/** Maximum rate of ARP requests for the interface's own address passed to lwIP, in requests per second. These are
+ * limited separately so a storm of requests for other hosts does not stop hosts resolving this one. Zero removes the
+ * limit. Default is 0. */
+#ifndef XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS
+#define XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS 0
+#endif
+
+/** Number of ARP requests for the interface's own address passed to lwIP in a burst before
+ * XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS applies. Default is 10. */
+#ifndef XTCP_RATE_LIMIT_ARP_LOCAL_BURST
+#define XTCP_RATE_LIMIT_ARP_LOCAL_BURST 10
+#endif
+
+/** Maximum rate of ICMP echo requests passed to lwIP, and so of echo replies sent, per second. Zero removes the
+ * limit. Default is 0. */
+#ifndef XTCP_RATE_LIMIT_ICMP_ECHO
+#define XTCP_RATE_LIMIT_ICMP_ECHO 0
+#endif
+
+/** Number of ICMP echo requests passed to lwIP in a burst before XTCP_RATE_LIMIT_ICMP_ECHO applies. Default is 10. */
+#ifndef XTCP_RATE_LIMIT_ICMP_ECHO_BURST
+#define XTCP_RATE_LIMIT_ICMP_ECHO_BURST 10
+#endif
+
+/** Maximum rate of received packets passed to lwIP that cause an ICMP destination unreachable reply, per second. These
+ * are UDP datagrams to a port with no socket when XTCP_RX_FILTER_ENABLE is 0, and packets for an unsupported IP
+ * protocol. Zero removes the limit. Default is 0. */
+#ifndef XTCP_RATE_LIMIT_ICMP_UNREACHABLE
+#define XTCP_RATE_LIMIT_ICMP_UNREACHABLE 0
+#endif
+
+/** Number of packets causing an ICMP destination unreachable reply passed to lwIP in a burst before
+ * XTCP_RATE_LIMIT_ICMP_UNREACHABLE applies. Default is 5. */
+#ifndef XTCP_RATE_LIMIT_ICMP_UNREACHABLE_BURST
+#define XTCP_RATE_LIMIT_ICMP_UNREACHABLE_BURST 5
+#endif
+
+/** Maximum rate of broadcast UDP datagrams for bound sockets passed to lwIP, per second. Zero removes the limit.
+ * Default is 0. */
+#ifndef XTCP_RATE_LIMIT_BROADCAST_UDP
+#define XTCP_RATE_LIMIT_BROADCAST_UDP 0
+#endif
+
+/** Number of broadcast UDP datagrams passed to lwIP in a burst before XTCP_RATE_LIMIT_BROADCAST_UDP applies. Default
+ * is 20. */
+#ifndef XTCP_RATE_LIMIT_BROADCAST_UDP_BURST
+#define XTCP_RATE_LIMIT_BROADCAST_UDP_BURST 20
+#endif
+
+/** Number of slots in the hashed table of static ARP entries, a power of two. The table holds up to three quarters
+ * of this number of entries, and IPv4 output to a neighbour or gateway with an entry takes a hash lookup, usually
+ * examining one or two slots. When zero, static entries are held in the lwIP ARP table and count against
+ * ARP_TABLE_SIZE. Default is 0. */
+#ifndef XTCP_ARP_HASH_TABLE_SIZE
+#define XTCP_ARP_HASH_TABLE_SIZE 0
+#endif
+
+/** Send datagrams on a connected UDP socket with a cached route, next-hop MAC address and header template, so each
+ * send only fills in the lengths, IP ID and checksums. Default is 0. */
+#ifndef XTCP_UDP_FAST_PATH
+#define XTCP_UDP_FAST_PATH 0
+#endif
+
+/** Maximum age in milliseconds of a cached UDP route. The next send after this goes through lwIP, which refreshes the
+ * ARP entry for the destination, and the route is rebuilt. A change to the destination's MAC address learnt by lwIP
+ * is only picked up then, so datagrams can go to the old address for up to this long. Default is 1000. */
+#ifndef XTCP_UDP_FAST_PATH_REVALIDATE_MS
+#define XTCP_UDP_FAST_PATH_REVALIDATE_MS 1000
+#endif
+
+/** Build recvfrom_batch() and sendto_batch(). When 0 both calls fail with XTCP_EPROTONOSUPPORT and the batch buffer
+ * is not allocated. Default is 0. */
+#ifndef XTCP_UDP_BATCH_ENABLE
+#define XTCP_UDP_BATCH_ENABLE 0
+#endif
+
+/** Maximum number of datagrams taken or sent by one recvfrom_batch() or sendto_batch() call. Default is 16. */
+#ifndef XTCP_BATCH_MAX_DATAGRAMS
+#define XTCP_BATCH_MAX_DATAGRAMS 16
+#endif
+
+/** Size in bytes of the buffer used to stage the payloads of one recvfrom_batch() or sendto_batch() call, larger
+ * client buffers are only used up to this size. The buffer is a static allocation made only when
+ * XTCP_UDP_BATCH_ENABLE is 1. Default is 4096. */
+#ifndef XTCP_BATCH_MAX_BYTES
+#define XTCP_BATCH_MAX_BYTES 4096
+#endif
+
+/** Build the bulk data streams of xtcp_stream.h. When 0 open_stream() always fails and no stream state is allocated.
+ * Default is 0. */
+#ifndef XTCP_STREAM_ENABLE
+#define XTCP_STREAM_ENABLE 0
+#endif
+
+/** Number of words of a bulk data stream moved per turn of the TCP/IP stack's event loop, and granted to a client
+ * per flow control credit. The words are staged in a static block for each client when XTCP_STREAM_ENABLE is 1.
+ * Default is 128. */
+#ifndef XTCP_STREAM_BLOCK_WORDS
+#define XTCP_STREAM_BLOCK_WORDS 128
+#endif
+
+/** Maximum number of immutable regions that can be registered with xtcp_register_static() for send_static().
+ * Default is 8. */
+#ifndef XTCP_STATIC_REGIONS
+#define XTCP_STATIC_REGIONS 8
+#endif
+
+/** Build the packet capture layer, which keeps received and sent frames in a ring while a client has started a
+ * capture with start_capture(). When 0 the capture hooks are compiled out and start_capture() fails. Default is 0. */
+#ifndef XTCP_CAPTURE_ENABLE
+#define XTCP_CAPTURE_ENABLE 0
+#endif
+
+/** Size in bytes of the packet capture ring, holding each frame as a pcap record. The ring is a static allocation
+ * made only when XTCP_CAPTURE_ENABLE is 1. Default is 16384. */
+#ifndef XTCP_CAPTURE_RING_BYTES
+#define XTCP_CAPTURE_RING_BYTES 16384
+#endif
+
+/** Maximum number of bytes of each frame kept by the packet capture, longer frames are truncated. Default is 128. */
+#ifndef XTCP_CAPTURE_SNAPLEN
+#define XTCP_CAPTURE_SNAPLEN 128
+#endif
+
+/** Length of the pcap file header read_capture() returns first after start_capture(). */
+#define XTCP_CAPTURE_PCAP_HEADER_LENGTH 24
+
+/** Length of the pcap record header in front of each captured frame. */
+#define XTCP_CAPTURE_RECORD_HEADER_LENGTH 16
+
+/** Smallest buffer read_capture() accepts, the pcap file header and one record of XTCP_CAPTURE_SNAPLEN bytes. */
+#define XTCP_CAPTURE_READ_MIN \
+  (XTCP_CAPTURE_PCAP_HEADER_LENGTH + XTCP_CAPTURE_RECORD_HEADER_LENGTH + XTCP_CAPTURE_SNAPLEN)
+
+/** Build the event trace, which records stack activity as compact binary records in a ring read with read_trace().
+ * When 0 the trace points are compiled out and read_trace() fails. Default is 0. */
+#ifndef XTCP_TRACE_ENABLE
+#define XTCP_TRACE_ENABLE 0
+#endif
+
+/** Number of records held by the event trace ring, a power of two. When the ring is full the oldest records are
+ * overwritten. Default is 256. */
+#ifndef XTCP_TRACE_RECORDS
+#define XTCP_TRACE_RECORDS 256
+#endif
+
+/** Trace points of client events being queued for, taken by and dropped for a client, for XTCP_TRACE_CLASSES. */
+#define XTCP_TRACE_EVENTS 0x01
+
+/** Trace points of transmit pbufs being allocated and receive pbufs being freed, for XTCP_TRACE_CLASSES. */
+#define XTCP_TRACE_PBUFS 0x02
+
+/** Trace points of tcp_write() and tcp_output() calls, for XTCP_TRACE_CLASSES. */
+#define XTCP_TRACE_TCP 0x04
+
+/** Trace points of frames received, before the receive filter, for XTCP_TRACE_CLASSES. */
+#define XTCP_TRACE_RX 0x08
+
+/** Trace points of the stack's timers firing, for XTCP_TRACE_CLASSES. */
+#define XTCP_TRACE_TIMERS 0x10
+
+/** Every class of trace point. */
+#define XTCP_TRACE_ALL 0x1F
+
+/** Classes of trace point recorded when XTCP_TRACE_ENABLE is 1, the others are compiled out. Default is
+ * XTCP_TRACE_ALL. */
+#ifndef XTCP_TRACE_CLASSES
+#define XTCP_TRACE_CLASSES XTCP_TRACE_ALL
+#endif
+
+/** Length of the header read_trace() returns first. */
+#define XTCP_TRACE_HEADER_LENGTH 16
+
+/** Length of each event trace record. */
+#define XTCP_TRACE_RECORD_LENGTH 16
+
+/** Smallest buffer read_trace() accepts, the header, a record of records lost and one record. */
+#define XTCP_TRACE_READ_MIN (XTCP_TRACE_HEADER_LENGTH + 2 * XTCP_TRACE_RECORD_LENGTH)
+
+/** Defer the stack's data path error messages, storing each as a message number and its arguments in a ring read
+ * with read_log() and formatted by the reader, rather than printing them with debug_printf() as they happen. When 0
+ * the messages are printed as before. Default is 0. */
+#ifndef XTCP_LOG_DEFERRED
+#define XTCP_LOG_DEFERRED 0
+#endif
+
+/** Number of records held by the deferred log ring. When the ring is full the oldest records are overwritten.
+ * Default is 32. */
+#ifndef XTCP_LOG_RECORDS
+#define XTCP_LOG_RECORDS 32
+#endif
+
+/** Records of each message stored per second, repeats beyond the rate are counted in the next record of the
+ * message. Zero is unlimited. Default is 10. */
+#ifndef XTCP_LOG_RATE
+#define XTCP_LOG_RATE 10
+#endif
+
+/** Records of each message stored at once before XTCP_LOG_RATE applies. Default is 4. */
+#ifndef XTCP_LOG_BURST
+#define XTCP_LOG_BURST 4
+#endif
+
+/** Length of each deferred log record, the smallest buffer read_log() accepts. */
+#define XTCP_LOG_RECORD_LENGTH 16
+
+/** Record the time each client event spends queued, from being raised to the client taking it with get_event(), in
+ * a histogram per client and event type read with get_event_latency(). Default is 0. */
+#ifndef XTCP_EVENT_LATENCY_ENABLE
+#define XTCP_EVENT_LATENCY_ENABLE 0
+#endif
+
+/** Number of buckets in each event latency histogram. Bucket 0 counts latencies under a microsecond, bucket n those
+ * from 2^(n-1) up to 2^n microseconds, and the last bucket every latency above. Default is 16. */
+#ifndef XTCP_EVENT_LATENCY_BUCKETS
+#define XTCP_EVENT_LATENCY_BUCKETS 16
+#endif
+
 /** Minimum number of bytes lib_xtcp can successfully transmit, small packets will be padded to this size */
 #define ETHERNET_MIN_FRAME_SIZE 60
 
@@ -61,6 +423,20 @@ typedef struct xtcp_host_t {
   uint16_t port_number; /**< The port number of the host */
 } xtcp_host_t;
 
+/** XTCP datagram descriptor.
+ *
+ *  This data type describes one datagram of a batch passed to recvfrom_batch() or sendto_batch(), with its place in
+ *  the payload buffer, its remote host and its timestamp.
+ *
+ */
+typedef struct xtcp_datagram_t {
+  uint32_t offset;       /**< Offset of the datagram payload in the buffer */
+  uint32_t length;       /**< Length of the datagram payload */
+  xtcp_ipaddr_t ipaddr;  /**< The IP Address of the remote host */
+  uint16_t port_number;  /**< The port number of the remote host */
+  uint32_t timestamp;    /**< The packet receive or transmit timestamp */
+} xtcp_datagram_t;
+
 /** IP configuration information structure.
  *
  *  This structure describes IP configuration for a network interface. With an IP address, netmask and gateway.
@@ -107,7 +483,7 @@ typedef enum xtcp_event_type_t {
   XTCP_RECV_FROM_DATA,
 
   /** This event occurs when the server has successfully sent the previous piece of TCP data that was given to it via a
-   * call to send(). */
+   * call to send(). get_event_length() gives the number of bytes acknowledged by the remote host. */
   XTCP_SENT_DATA,
 
   /** This event occurs when the local host has failed to send the previous piece of data that was given to it via a call to
@@ -135,9 +511,16 @@ typedef enum xtcp_event_type_t {
   /** This event occurs when the XTCP connection has a DNS result for a request.
    * There is no connection associated with this event, so the "id" returned by get_event() is the DNS return code as a xtcp_error_code_t.
    * XTCP_SUCCESS for successful resolution. XTCP_EINVAL for invalid argument. XTCP_ENOMEM for DNS request failed. */
-  XTCP_DNS_RESULT
+  XTCP_DNS_RESULT,
+
+  /** This event occurs when every byte given to send_static() has been acknowledged by the remote host, TCP only.
+   * get_event_length() gives the length of the static send. */
+  XTCP_SENT_STATIC
 } xtcp_event_type_t;
 
+/** Number of event types, for arrays indexed by xtcp_event_type_t. */
+#define XTCP_EVENT_TYPES (XTCP_SENT_STATIC + 1)
+
 /** XTCP error codes.
  *
  *  This type represents the error codes that can be returned by
@@ -159,7 +542,7 @@ typedef enum xtcp_error_code_t
  *  This type represents the socket levels for getsockopt() and
  *  setsockopt().
  *
- *  Presently only XTCP_SOCKET_LEVEL_IP is supported.
+ *  Presently only XTCP_SOCKET_LEVEL_IP and XTCP_SOCKET_LEVEL_SOCKET are supported.
  */
 typedef enum xtcp_socket_level_t {
   XTCP_SOCKET_LEVEL_IP = 0,     /**< IP */
@@ -181,6 +564,24 @@ typedef enum xtcp_ip_socket_option_t {
   XTCP_IP_SOCKET_OPTION_MULTICAST_LOOP = 7, /**< multicast loopback, value is uint8_t */
 } xtcp_ip_socket_option_t;
 
+/** XTCP socket options for the socket itself.
+ *
+ *  This type represents a socket option when calling getsockopt()
+ *  or setsockopt() with XTCP_SOCKET_LEVEL_SOCKET. TCP only. Options set on a listening socket apply to the
+ *  connections it accepts.
+ */
+typedef enum xtcp_socket_option_t {
+  XTCP_SOCKET_OPTION_SNDLOWAT = 0x1003, /**< Send low watermark, value is uint32_t. When non-zero a single
+                                             XTCP_SENT_DATA event is raised after data is sent, once the free send
+                                             space given by get_send_space() is above the watermark. Zero raises
+                                             one for every acknowledgement, which is the default. */
+  XTCP_SOCKET_OPTION_RCVLOWAT = 0x1004, /**< Receive low watermark, value is uint32_t. XTCP_RECV_DATA events are
+                                             held until at least this many bytes are queued, or the remote host
+                                             closes the connection. At most TCP_WND and the client's max_rx_bytes
+                                             quota, the default of zero raises an event for each piece of data
+                                             received. */
+} xtcp_socket_option_t;
+
 /** This type represents an int32_t with a status value.
  *
  *  This is a type used to return both a status code and an int32_t value.
@@ -191,6 +592,171 @@ typedef struct xtcp_error_int32_t {
   int32_t value;            /**< The int32_t value of the operation */
 } xtcp_error_int32_t;
 
+/** Per-client resource limits.
+ *
+ *  This structure limits the share of the stack's resources a single client can use. A value of zero means unlimited.
+ *  Requests that would exceed a limit fail with XTCP_ENOMEM.
+ *
+ */
+typedef struct xtcp_client_quota_t {
+  uint32_t max_sockets;   /**< Maximum number of open sockets, including accepted TCP connections */
+  uint32_t max_rx_bytes;  /**< Maximum number of received bytes held in pbufs waiting for the client, at least
+                               TCP_MSS and XTCP_UDP_MAX_DATAGRAM_SIZE when non-zero */
+  uint32_t max_tx_bytes;  /**< Maximum number of TCP bytes sent but not yet acknowledged */
+} xtcp_client_quota_t;
+
+/** Per-client resource usage.
+ *
+ *  This structure reports the resources a client is currently using, alongside its configured limits.
+ *
+ */
+typedef struct xtcp_client_usage_t {
+  xtcp_client_quota_t quota; /**< The limits configured for the client */
+  uint32_t sockets;          /**< Number of open sockets */
+  uint32_t rx_bytes;         /**< Number of received bytes held in pbufs waiting for the client */
+  uint32_t tx_bytes;         /**< Number of TCP bytes sent but not yet acknowledged */
+} xtcp_client_usage_t;
+
+/** Normal priority, for the priority of xtcp_client_sched_t. */
+#define XTCP_PRIORITY_NORMAL 0
+
+/** High priority, for the priority of xtcp_client_sched_t. */
+#define XTCP_PRIORITY_HIGH 1
+
+/** Per-client servicing in the stack's select loop.
+ *
+ *  This structure sets the share of the stack's send calls a client is served, and whether its events are served
+ *  ahead of the send calls of other clients. Used when XTCP_CLIENT_SCHED_ENABLE is set.
+ *
+ */
+typedef struct xtcp_client_sched_t {
+  uint32_t weight;    /**< Number of send calls served in each round, at least one */
+  uint32_t priority;  /**< XTCP_PRIORITY_NORMAL or XTCP_PRIORITY_HIGH */
+} xtcp_client_sched_t;
+
+/** Transmit buffer pool size class statistics.
+ *
+ *  This structure reports the state of one size class of the transmit buffer pools.
+ *
+ */
+typedef struct xtcp_tx_pool_class_stats_t {
+  uint16_t block_size; /**< Payload size of each buffer in the class */
+  uint16_t num_blocks; /**< Number of buffers in the class */
+  uint16_t in_use;     /**< Number of buffers currently allocated */
+  uint16_t high_water; /**< Maximum number of buffers allocated at once */
+  uint32_t allocs;     /**< Number of buffers allocated from the class */
+  uint32_t exhausted;  /**< Number of requests that fitted this class but found it empty */
+} xtcp_tx_pool_class_stats_t;
+
+/** Transmit buffer pool statistics.
+ *
+ *  This structure reports the state of all transmit buffer pools, smallest class first.
+ *
+ */
+typedef struct xtcp_tx_pool_stats_t {
+  xtcp_tx_pool_class_stats_t size_class[XTCP_TX_POOL_NUM_CLASSES]; /**< Per size class statistics */
+  uint32_t heap_allocs;  /**< Number of buffers allocated from the lwIP heap instead of a pool */
+  uint32_t failures;     /**< Number of transmit buffer allocations that failed */
+} xtcp_tx_pool_stats_t;
+
+/** Pipelined mode statistics.
+ *
+ *  This structure reports the frames passed between xtcp_frontend() and xtcp_lwip_pipelined(), and the frames
+ *  dropped by the front end before they reach the TCP/IP stack.
+ *
+ */
+typedef struct xtcp_pipeline_stats_t {
+  uint32_t rx_frames;      /**< Number of received frames passed to the TCP/IP stack */
+  uint32_t rx_invalid;     /**< Number of received frames dropped for a malformed Ethernet, ARP or IPv4 header */
+  uint32_t rx_unsupported; /**< Number of received frames dropped for an EtherType other than ARP or IPv4 */
+  uint32_t rx_queue_full;  /**< Number of received frames dropped because the receive queue was full */
+  uint32_t tx_frames;      /**< Number of frames sent by the front end */
+  uint32_t tx_queue_full;  /**< Number of frames to send dropped because the transmit queue was full */
+} xtcp_pipeline_stats_t;
+
+/** Receive filter statistics.
+ *
+ *  This structure reports the received frames dropped by the receive filter and rate limits before lwIP processing,
+ *  by reason.
+ *
+ */
+typedef struct xtcp_rx_filter_stats_t {
+  uint32_t accepted;                      /**< Number of frames passed to lwIP */
+  uint32_t udp_no_socket;                 /**< Number of UDP datagrams dropped for a port with no socket bound */
+  uint32_t tcp_no_listener;               /**< Number of TCP connection requests dropped for a port with no listener */
+  uint32_t multicast_not_joined;          /**< Number of IPv4 multicast packets dropped for a group not joined */
+  uint32_t arp_rate_limited;              /**< Number of ARP requests dropped by XTCP_RATE_LIMIT_ARP_REQUESTS or
+                                               XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS */
+  uint32_t icmp_echo_rate_limited;        /**< Number of ICMP echo requests dropped by XTCP_RATE_LIMIT_ICMP_ECHO */
+  uint32_t icmp_unreachable_rate_limited; /**< Number of packets dropped by XTCP_RATE_LIMIT_ICMP_UNREACHABLE */
+  uint32_t broadcast_udp_rate_limited;    /**< Number of broadcast UDP datagrams dropped by
+                                               XTCP_RATE_LIMIT_BROADCAST_UDP */
+} xtcp_rx_filter_stats_t;
+
+/** Capture received frames, for the directions of xtcp_capture_filter_t. */
+#define XTCP_CAPTURE_RX 0x1
+
+/** Capture sent frames, for the directions of xtcp_capture_filter_t. */
+#define XTCP_CAPTURE_TX 0x2
+
+/** Packet capture filter.
+ *
+ *  This structure selects the frames start_capture() keeps. A frame is kept when it matches every field that is not
+ *  zero, fields for IPv4 only match IPv4 frames.
+ *
+ */
+typedef struct xtcp_capture_filter_t {
+  uint32_t directions;    /**< XTCP_CAPTURE_RX, XTCP_CAPTURE_TX, or both */
+  uint16_t ethertype;     /**< EtherType of the frame, after any VLAN tag, 0 for any */
+  uint8_t ip_protocol;    /**< IPv4 protocol number, such as 6 for TCP or 17 for UDP, 0 for any */
+  uint16_t port;          /**< TCP or UDP source or destination port, 0 for any */
+  xtcp_ipaddr_t ipaddr;   /**< IPv4 source or destination address, 0.0.0.0 for any */
+  uint16_t ignore_port;   /**< TCP or UDP port whose frames are never kept, such as the port the capture is read out
+                               over, 0 for none */
+} xtcp_capture_filter_t;
+
+/** Packet capture statistics.
+ *
+ *  This structure reports the frames seen by the packet capture since the last start_capture().
+ *
+ */
+typedef struct xtcp_capture_stats_t {
+  int running;              /**< Non-zero while the capture is running */
+  uint32_t captured;        /**< Number of frames kept in the ring */
+  uint32_t filtered;        /**< Number of frames not kept because they did not match the filter */
+  uint32_t truncated;       /**< Number of frames kept truncated to XTCP_CAPTURE_SNAPLEN bytes */
+  uint32_t overwritten;     /**< Number of frames overwritten by newer frames before they were read */
+  uint32_t pending_bytes;   /**< Number of bytes of records in the ring waiting to be read */
+} xtcp_capture_stats_t;
+
+/** Client event queue statistics.
+ *
+ *  This structure reports the events raised for a client and how deep its event queue has been, to show whether
+ *  CLIENT_QUEUE_SIZE is large enough.
+ *
+ */
+typedef struct xtcp_client_queue_stats_t {
+  uint32_t queued;      /**< Number of events queued for the client */
+  uint32_t dropped;     /**< Number of events dropped because the client's queue was full */
+  uint32_t depth;       /**< Number of events currently queued */
+  uint32_t high_water;  /**< Maximum number of events queued at once */
+} xtcp_client_queue_stats_t;
+
+/** Client event latency histogram.
+ *
+ *  This structure reports the time events of one type spent in a client's queue, from being raised by the stack to
+ *  the client taking them with get_event(). Events removed from the queue because their connection closed are not
+ *  counted.
+ *
+ */
+typedef struct xtcp_event_latency_t {
+  uint32_t count;                                /**< Number of events taken */
+  uint32_t max_us;                               /**< Longest latency, in microseconds */
+  uint64_t total_us;                             /**< Sum of the latencies, in microseconds, for the mean */
+  uint32_t buckets[XTCP_EVENT_LATENCY_BUCKETS];  /**< Number of events in each latency bucket, see
+                                                      XTCP_EVENT_LATENCY_BUCKETS */
+} xtcp_event_latency_t;
+
 #if defined(__XC__) || defined(__DOXYGEN__)
 #ifndef __DOXYGEN__
 typedef interface xtcp_if {
@@ -221,6 +787,18 @@ typedef interface xtcp_if {
    */
   [[clears_notification]] xtcp_event_type_t get_event(REFERENCE_PARAM(int32_t, id));
 
+  /** \brief Receive information/data from the XTCP server, with the length of data it relates to.
+   *
+   *  As get_event(), for a client that needs to know how much of its TCP data has been acknowledged.
+   *
+   * \param id     Output parameter for the connection descriptor the event occurred on.
+   * \param length Output parameter for the number of bytes acknowledged by the remote host since the last
+   *               XTCP_SENT_DATA event on the connection, when the event is XTCP_SENT_DATA. Otherwise 0.
+   * \returns      The event type produced on the given connection.
+   */
+  [[clears_notification]] xtcp_event_type_t get_event_length(REFERENCE_PARAM(int32_t, id),
+                                                             REFERENCE_PARAM(uint32_t, length));
+
   /** \brief Create an xtcp socket
    *
    *  \param protocol   The protocol for any communication over the returned connection.
@@ -304,9 +882,22 @@ typedef interface xtcp_if {
    * \param length      The length of data to send. If this is 0, no data will
    *                    be sent and a XTCP_SENT_DATA event will not occur.
    * \returns           The number of bytes accepted by xtcp or a negative xtcp_error_code_t.
-   *                    XTCP_EINVAL if invalid parameters are provided.
+   *                    XTCP_EINVAL if invalid parameters are provided. XTCP_EAGAIN if the TCP send buffer
+   *                    cannot take the data, see get_send_space(). XTCP_ENOMEM if a UDP datagram could not
+   *                    be sent for lack of buffer or output queue space.
+   */
+  [[guarded]] int32_t send(int32_t id, const uint8_t buffer[length], uint32_t length);
+
+  /** \brief Get the number of bytes a TCP connection can accept from send().
+   *
+   * The space is limited by the stack's send buffer and queue, and by the client's unacknowledged bytes quota. It
+   * grows as the remote host acknowledges data, which is notified by XTCP_SENT_DATA.
+   *
+   * \param id          The connection descriptor to act on.
+   * \returns           The number of bytes, 0 if the connection cannot send, or an xtcp_error_code_t.
+   *                    XTCP_EPROTONOSUPPORT for a UDP socket.
    */
-  int32_t send(int32_t id, const uint8_t buffer[length], uint32_t length);
+  int32_t get_send_space(int32_t id);
 
   /** \brief Send data to the connection.
    *
@@ -318,7 +909,7 @@ typedef interface xtcp_if {
    * \returns           The number of bytes accepted by xtcp or a negative xtcp_error_code_t.
    *                    XTCP_EINVAL if invalid parameters are provided.
    */
-  int32_t send_timed(int32_t id, const uint8_t buffer[length], uint32_t length, REFERENCE_PARAM(uint32_t, ts));
+  [[guarded]] int32_t send_timed(int32_t id, const uint8_t buffer[length], uint32_t length, REFERENCE_PARAM(uint32_t, ts));
 
   /** \brief Send data to the connection.
    *
@@ -330,8 +921,9 @@ typedef interface xtcp_if {
    * \param remote_port The remote port of the remote host.
    * \returns           The number of bytes accepted by xtcp or an xtcp_error_code_t.
    *                    XTCP_EINVAL if invalid parameters are provided.
+   *                    XTCP_ENOMEM if there is no buffer or output queue space to send it.
    */
-  int32_t sendto(int32_t id, const uint8_t buffer[length], uint32_t length, xtcp_ipaddr_t remote_addr, uint16_t remote_port);
+  [[guarded]] int32_t sendto(int32_t id, const uint8_t buffer[length], uint32_t length, xtcp_ipaddr_t remote_addr, uint16_t remote_port);
 
   /** \brief Send timestamped data to the connection.
    *
@@ -344,8 +936,9 @@ typedef interface xtcp_if {
    * \param ts          The packet transmit timestamp.
    * \returns           The number of bytes accepted by xtcp or an xtcp_error_code_t.
    *                    XTCP_EINVAL if invalid parameters are provided.
+   *                    XTCP_ENOMEM if there is no buffer or output queue space to send it.
    */
-  int32_t sendto_timed(int32_t id, const uint8_t buffer[length], uint32_t length, xtcp_ipaddr_t remote_addr, uint16_t remote_port, REFERENCE_PARAM(uint32_t, ts));
+  [[guarded]] int32_t sendto_timed(int32_t id, const uint8_t buffer[length], uint32_t length, xtcp_ipaddr_t remote_addr, uint16_t remote_port, REFERENCE_PARAM(uint32_t, ts));
 
   /** \brief Receive data on a connection.
    *
@@ -405,6 +998,109 @@ typedef interface xtcp_if {
    */
   int32_t recvfrom_timed(int32_t id, uint8_t buffer[length], uint32_t length, REFERENCE_PARAM(xtcp_ipaddr_t, ipaddr), REFERENCE_PARAM(uint16_t, port_number), REFERENCE_PARAM(uint32_t, ts));
 
+  /** \brief Receive several datagrams on a UDP connection in one call.
+   *
+   * Copies queued datagrams into the given buffer, oldest first, each starting at the next word aligned offset, and
+   * describes each one in datagrams[] with its offset, length, remote host and receive timestamp. Copying stops when the next datagram does not fit, it
+   * stays queued for the next call. The receive events for the datagrams taken are removed from the event queue.
+   *
+   * \param id          The connection descriptor to act on.
+   * \param buffer      The destination buffer where received data will be stored.
+   * \param length      The length of the given buffer, at most XTCP_BATCH_MAX_BYTES of it is used.
+   * \param datagrams   The descriptors of the datagrams received.
+   * \param max         The number of descriptors, at most XTCP_BATCH_MAX_DATAGRAMS datagrams are received.
+   * \returns           Either the number of datagrams received, 0 if none are queued, or an xtcp_error_code_t.
+   *                    XTCP_EINVAL if invalid parameters are provided.
+   *                    XTCP_EPROTONOSUPPORT if the connection is TCP, or the library is built without
+   *                    XTCP_UDP_BATCH_ENABLE.
+   *                    XTCP_EAGAIN if the first datagram is longer than the buffer, it is discarded.
+   */
+  int32_t recvfrom_batch(int32_t id, uint8_t buffer[length], uint32_t length, xtcp_datagram_t datagrams[max], uint32_t max);
+
+  /** \brief Send several datagrams on a UDP connection in one call.
+   *
+   * Each descriptor gives the offset and length of a datagram payload in the buffer and its remote host. A remote
+   * address of 0.0.0.0 sends to the connected remote host. The transmit timestamp of each datagram sent is written to
+   * its descriptor. Sending stops at the first datagram that fails.
+   *
+   * \param id          The connection descriptor to act on.
+   * \param buffer      The payloads of the datagrams to send.
+   * \param length      The length of the given buffer, at most XTCP_BATCH_MAX_BYTES of it is used.
+   * \param datagrams   The descriptors of the datagrams to send.
+   * \param max         The number of descriptors, at most XTCP_BATCH_MAX_DATAGRAMS datagrams are sent.
+   * \returns           Either the number of datagrams sent or, if the first fails, an xtcp_error_code_t.
+   *                    XTCP_EINVAL if invalid parameters are provided.
+   *                    XTCP_EPROTONOSUPPORT if the connection is TCP, or the library is built without
+   *                    XTCP_UDP_BATCH_ENABLE.
+   *                    XTCP_ENOMEM if no transmit buffer is available.
+   */
+  [[guarded]] int32_t sendto_batch(int32_t id, const uint8_t buffer[length], uint32_t length, xtcp_datagram_t datagrams[max], uint32_t max);
+
+  /** \brief Send part of a registered immutable region on a TCP connection, without copying it.
+   *
+   * The region is one registered with xtcp_register_static() on the stack's tile. The stack queues the data to LwIP by
+   * reference, as much as the send buffer allows and the rest as the remote host acknowledges it, and raises
+   * XTCP_SENT_STATIC once all of it has been acknowledged. Until then send(), send_stream() and another
+   * send_static() on the connection fail with XTCP_EAGAIN, and get_send_space() returns 0.
+   *
+   * \param id          The connection descriptor to act on.
+   * \param region      The region identifier returned by xtcp_register_static().
+   * \param offset      The offset of the data in the region.
+   * \param length      The number of bytes to send.
+   * \returns           XTCP_SUCCESS if the send has started.
+   *                    XTCP_EINVAL if invalid parameters are provided, the range is outside the region or the
+   *                    connection cannot send.
+   *                    XTCP_EPROTONOSUPPORT if the connection is UDP.
+   *                    XTCP_EAGAIN if a static send is already in progress on the connection.
+   */
+  xtcp_error_code_t send_static(int32_t id, uint32_t region, uint32_t offset, uint32_t length);
+
+  /** \brief Open the client's bulk data stream, a streaming channel carrying the data of send_stream() and
+   * recv_stream().
+   *
+   * Use xtcp_open_stream() rather than calling this directly.
+   *
+   * \param client_end  The resource identifier of the client's end of the channel.
+   * \returns           The resource identifier of the stack's end of the channel, 0 if the stream is already open,
+   *                    no channel end is available or the library is built without XTCP_STREAM_ENABLE.
+   */
+  unsigned open_stream(unsigned client_end);
+
+  /** \brief Close the client's bulk data stream.
+   *
+   * Use xtcp_close_stream() rather than calling this directly.
+   */
+  void close_stream(void);
+
+  /** \brief Start sending TCP data through the client's bulk data stream.
+   *
+   * Only the control is passed through the interface, the client must then write the number of bytes accepted to
+   * the stream. Use xtcp_send_stream() rather than calling this directly.
+   *
+   * \param id          The connection descriptor to act on.
+   * \param length      The number of bytes the client has to send.
+   * \returns           The number of bytes the stack accepts, limited by get_send_space(), or an xtcp_error_code_t.
+   *                    XTCP_EINVAL if invalid parameters are provided or the stream is not open.
+   *                    XTCP_EPROTONOSUPPORT if the connection is UDP.
+   *                    XTCP_EAGAIN if the TCP send buffer is full.
+   */
+  int32_t send_stream(int32_t id, uint32_t length);
+
+  /** \brief Start receiving TCP data through the client's bulk data stream.
+   *
+   * Takes as much received data as fits in length, in whole received pbufs, and removes their receive events. The
+   * client must then read the data from the stream. Use xtcp_recv_stream() rather than calling this directly.
+   *
+   * \param id          The connection descriptor to act on.
+   * \param length      The length of the client's buffer.
+   * \returns           The number of bytes the stack will write to the stream, 0 if none are queued, or an
+   *                    xtcp_error_code_t.
+   *                    XTCP_EINVAL if invalid parameters are provided or the stream is not open.
+   *                    XTCP_EPROTONOSUPPORT if the connection is UDP.
+   *                    XTCP_EAGAIN if the first queued pbuf is longer than the buffer.
+   */
+  int32_t recv_stream(int32_t id, uint32_t length);
+
   /** \brief Fill the provided ipconfig address with the current state of the interface.
    *
    * \param netif_id    The network interface ID to get the IP config for.
@@ -502,7 +1198,139 @@ typedef interface xtcp_if {
    * \retval           0 if the underlying interface is down.
    */
   int is_ifup(void);
-  
+
+  /** \brief Get the resource limits and current resource usage of this client.
+   *
+   * \returns          The client's configured quota and the sockets, received bytes and unacknowledged sent bytes it
+   *                   currently holds.
+   *
+   * \see xtcp_configure_client_quota()
+   */
+  xtcp_client_usage_t get_client_usage(void);
+
+  /** \brief Get the transmit buffer pool statistics.
+   *
+   * \returns          The usage and high-water mark of each transmit buffer pool size class, and the number of
+   *                   heap allocations and failures.
+   */
+  xtcp_tx_pool_stats_t get_tx_pool_stats(void);
+
+  /** \brief Get the pipelined mode statistics.
+   *
+   * \returns          The frames passed between xtcp_frontend() and xtcp_lwip_pipelined(), and the frames dropped by
+   *                   the front end. All zero when the stack is not running in pipelined mode.
+   */
+  xtcp_pipeline_stats_t get_pipeline_stats(void);
+
+  /** \brief Get the receive filter statistics.
+   *
+   * \returns          The number of received frames passed to lwIP, and the number dropped by the receive filter for
+   *                   each reason.
+   */
+  xtcp_rx_filter_stats_t get_rx_filter_stats(void);
+
+  /** \brief Add a static ARP entry, so IPv4 packets to the neighbour are sent without an ARP request.
+   *
+   * The entry does not expire. An existing entry for the address is replaced.
+   *
+   * \param ipaddr       The IPv4 address of the neighbour, or of the gateway for off-link destinations.
+   * \param mac_address  The MAC address of the neighbour.
+   * \returns            XTCP_SUCCESS if successful, XTCP_EINVAL if the address is not a unicast address, or
+   *                     XTCP_ENOMEM if the table is full.
+   */
+  xtcp_error_code_t add_static_arp_entry(xtcp_ipaddr_t ipaddr, const uint8_t mac_address[MACADDR_NUM_BYTES]);
+
+  /** \brief Remove a static ARP entry added by add_static_arp_entry().
+   *
+   * \param ipaddr       The IPv4 address of the neighbour.
+   * \returns            XTCP_SUCCESS if successful, or XTCP_EINVAL if there is no static entry for the address.
+   */
+  xtcp_error_code_t remove_static_arp_entry(xtcp_ipaddr_t ipaddr);
+
+  /** \brief Start capturing frames into the packet capture ring.
+   *
+   * The ring and the statistics are cleared. Received frames are captured as they arrive, before the receive filter,
+   * and sent frames as they are given to the MAC. When the ring is full the oldest frames are overwritten.
+   *
+   * \param filter       The frames to keep.
+   * \returns            XTCP_SUCCESS if successful, XTCP_EINVAL if the filter selects no direction, or
+   *                     XTCP_EPROTONOSUPPORT if the library is built without XTCP_CAPTURE_ENABLE.
+   */
+  xtcp_error_code_t start_capture(xtcp_capture_filter_t filter);
+
+  /** \brief Stop capturing frames, the frames already captured can still be read.
+   */
+  void stop_capture(void);
+
+  /** \brief Read captured frames from the packet capture ring, in pcap format.
+   *
+   * The first read after start_capture() returns the pcap file header, and every read returns whole pcap records,
+   * oldest first, removing them from the ring. The bytes of successive reads concatenated are a pcap file with
+   * nanosecond timestamps counted from start_capture(), which can be written to a TCP socket or xscope and read by
+   * Wireshark or tcpdump.
+   *
+   * \param buffer       The buffer to read into.
+   * \param length       The length of the buffer, at least XTCP_CAPTURE_READ_MIN.
+   * \returns            The number of bytes read, 0 if there is nothing to read, or XTCP_EINVAL if the buffer is
+   *                     shorter than XTCP_CAPTURE_READ_MIN.
+   */
+  int32_t read_capture(uint8_t buffer[length], uint32_t length);
+
+  /** \brief Get the packet capture statistics.
+   *
+   * \returns          Whether the capture is running, the frames kept, filtered out, truncated and overwritten
+   *                   since the last start_capture(), and the bytes waiting to be read.
+   */
+  xtcp_capture_stats_t get_capture_stats(void);
+
+  /** \brief Read records from the event trace ring.
+   *
+   * The first read returns the trace header, and every read returns whole records, oldest first, removing them from
+   * the ring. Records overwritten since the last read are reported by a record of their number ahead of the rest. The
+   * bytes of successive reads concatenated can be written to xscope or a file and decoded by tests/xtcp_trace.py.
+   *
+   * \param buffer       The buffer to read into.
+   * \param length       The length of the buffer, at least XTCP_TRACE_READ_MIN.
+   * \returns            The number of bytes read, 0 if there is nothing to read, XTCP_EINVAL if the buffer is shorter
+   *                     than XTCP_TRACE_READ_MIN, or XTCP_EPROTONOSUPPORT if the library is built without
+   *                     XTCP_TRACE_ENABLE.
+   */
+  int32_t read_trace(uint8_t buffer[length], uint32_t length);
+
+  /** \brief Read records from the deferred log ring.
+   *
+   * Every read returns whole records, oldest first, removing them from the ring. Records overwritten since the last
+   * read are reported by a record of their number ahead of the rest. Each record is formatted with
+   * xtcp_log_format(), on the reading core rather than the stack's.
+   *
+   * \param buffer       The buffer to read into.
+   * \param length       The length of the buffer, at least XTCP_LOG_RECORD_LENGTH.
+   * \returns            The number of bytes read, 0 if there is nothing to read, XTCP_EINVAL if the buffer is shorter
+   *                     than XTCP_LOG_RECORD_LENGTH, or XTCP_EPROTONOSUPPORT if the library is built without
+   *                     XTCP_LOG_DEFERRED.
+   */
+  int32_t read_log(uint8_t buffer[length], uint32_t length);
+
+  /** \brief Get the event queue statistics of a client.
+   *
+   * Any client may read the statistics of every client, so one task can monitor which client is slow to take its
+   * events.
+   *
+   * \param client_num   The index of the client in the array of interfaces given to the stack.
+   * \returns            The events queued and dropped for the client and the depth and high-water mark of its
+   *                     queue. All zero for an invalid client.
+   */
+  xtcp_client_queue_stats_t get_client_queue_stats(unsigned client_num);
+
+  /** \brief Get the latency histogram of one type of event for a client.
+   *
+   * \param client_num   The index of the client in the array of interfaces given to the stack.
+   * \param event        The type of event.
+   * \returns            The histogram of the time the client's events of the type were queued. All zero for an
+   *                     invalid client or event type, or if the library is built without XTCP_EVENT_LATENCY_ENABLE.
+   */
+  xtcp_event_latency_t get_event_latency(unsigned client_num, xtcp_event_type_t event);
+
   /** \} */
 #ifndef __DOXYGEN__
 } xtcp_if;
@@ -552,6 +1380,40 @@ void xtcp_lwip(SERVER_INTERFACE_ARRAY(xtcp_if, i_xtcp, n_xtcp),
                NULLABLE_CLIENT_INTERFACE(ethernet_rx_if, i_eth_rx),
                NULLABLE_CLIENT_INTERFACE(ethernet_tx_if, i_eth_tx),
                REFERENCE_PARAM(xtcp_ipconfig_t, ipconfig));
+
+/** Function implementing the TCP/IP stack task in pipelined mode.
+ *
+ *  The Ethernet receive and transmit interfaces are handled by xtcp_frontend(), running on another logical core of the
+ *  same tile. The front end validates received frames and drops unwanted traffic before passing them to this task,
+ *  and sends the frames this task outputs, so this task only runs the protocol processing, timers and client calls.
+ *
+ *  \param i_xtcp       The interface array to connect to the clients.
+ *  \param n_xtcp       The number of clients to the task.
+ *  \param i_eth_cfg    The configuration interface of the Ethernet MAC.
+ *  \param c_frontend   The streaming channel to xtcp_frontend(), which must be on the same tile.
+ *  \param ipconfig     The IP configuration, see xtcp_lwip().
+ *
+ *  \note Transmit timestamps from send_timed() and sendto_timed() are not available in pipelined mode and read as 0.
+ */
+void xtcp_lwip_pipelined(SERVER_INTERFACE_ARRAY(xtcp_if, i_xtcp, n_xtcp),
+                         static_const_unsigned n_xtcp,
+                         CLIENT_INTERFACE(ethernet_cfg_if, i_eth_cfg),
+                         streaming_chanend_t c_frontend,
+                         REFERENCE_PARAM(xtcp_ipconfig_t, ipconfig));
+
+/** Function implementing the frame front end for xtcp_lwip_pipelined().
+ *
+ *  Receives frames from the Ethernet MAC, drops frames with a malformed header or an EtherType the stack does not
+ *  handle, and queues the rest for the TCP/IP stack task. Frames output by the stack are queued back and sent to the
+ *  MAC. The queues are held in shared memory, so this task must run on the same tile as xtcp_lwip_pipelined().
+ *
+ *  \param i_eth_rx     The receive interface of the Ethernet MAC.
+ *  \param i_eth_tx     The transmit interface of the Ethernet MAC.
+ *  \param c_xtcp       The streaming channel to xtcp_lwip_pipelined().
+ */
+void xtcp_frontend(CLIENT_INTERFACE(ethernet_rx_if, i_eth_rx),
+                   CLIENT_INTERFACE(ethernet_tx_if, i_eth_tx),
+                   streaming_chanend_t c_xtcp);
 #endif /* __XC__ || __DOXYGEN__ */
 
 /** Configure the MAC address for a given network interface. Define in the client application to provide a MAC address.
@@ -567,6 +1429,74 @@ void xtcp_lwip(SERVER_INTERFACE_ARRAY(xtcp_if, i_xtcp, n_xtcp),
 */
 void xtcp_configure_mac(unsigned netif_id, uint8_t mac_address[MACADDR_NUM_BYTES]);
 
+/** Configure the resource limits for a given client. Define in the client application to provide per-client limits.
+ *
+ * This function is called by xtcp_lwip() during initialization, once for each client in the interface array, before
+ * any socket is created. The quota is pre-filled with the XTCP_CLIENT_MAX_SOCKETS, XTCP_CLIENT_MAX_RX_BYTES and
+ * XTCP_CLIENT_MAX_TX_BYTES defaults. A value of zero is unlimited. A non-zero max_rx_bytes below TCP_MSS or
+ * XTCP_UDP_MAX_DATAGRAM_SIZE would refuse every receive, so the defaults are used instead.
+ *
+ * \param client_num    The index of the client in the xtcp_if interface array.
+ * \param quota         The limits to apply to the client, in/out parameter.
+ *
+ * \note This is a weak function that may be overridden by the user to give latency-sensitive clients a reserved
+ * share of sockets and buffers.
+ * \warning This function is called from the xtcp_lwip() task and may not be on the same tile as the client application.
+ * Do not use shared memory or resources in this function.
+ */
+void xtcp_configure_client_quota(unsigned client_num, REFERENCE_PARAM(xtcp_client_quota_t, quota));
+
+/** Configure the servicing of a given client in the stack's select loop. Define in the client application to give
+ * clients different weights and priorities.
+ *
+ * This function is called by xtcp_lwip() during initialization, once for each client in the interface array. The
+ * servicing is pre-filled with a weight of XTCP_CLIENT_WEIGHT and XTCP_PRIORITY_NORMAL. It has no effect unless
+ * XTCP_CLIENT_SCHED_ENABLE is set.
+ *
+ * \param client_num    The index of the client in the xtcp_if interface array.
+ * \param sched         The weight and priority of the client, in/out parameter.
+ *
+ * \note This is a weak function that may be overridden by the user to keep a latency-sensitive client responsive
+ * while others send in bulk.
+ * \warning This function is called from the xtcp_lwip() task and may not be on the same tile as the client
+ * application. Do not use shared memory or resources in this function.
+ */
+void xtcp_configure_client_sched(unsigned client_num, REFERENCE_PARAM(xtcp_client_sched_t, sched));
+
+/** Create the sockets of protocol handlers using the direct C API in xtcp_direct.h.
+ *
+ * This function is called by xtcp_lwip() once the stack is initialized, before any packet is handled. Sockets created
+ * here with xtcp_c_socket() have their events handled by callbacks called from the xtcp_lwip() task, with no event
+ * queued for an xtcp_if client.
+ *
+ * \note This is a weak function that may be overridden by the user to run latency-sensitive protocol handlers on the
+ * same logical core as the stack.
+ * \warning This function and every callback run in the xtcp_lwip() task, they must not block.
+ */
+void xtcp_configure_direct_clients(void);
+
+/** Register the immutable regions that clients may send with send_static().
+ *
+ * This function is called by xtcp_lwip() once the stack is initialized, before any client call is handled. Regions are
+ * registered here with xtcp_register_static().
+ *
+ * \note This is a weak function that may be overridden by the user to serve constant content, such as web assets or
+ * firmware images, without copying it.
+ * \warning This function is called from the xtcp_lwip() task, so the regions must be in the memory of the stack's tile.
+ */
+void xtcp_configure_static_regions(void);
+
+/** Register an immutable region for send_static(), from xtcp_configure_static_regions().
+ *
+ * The stack hands references to the region to LwIP, so it must not change while the stack is running.
+ *
+ * \param data    The region, in the memory of the stack's tile.
+ * \param length  The length of the region in bytes.
+ * \returns       The region identifier to pass to send_static(), XTCP_EINVAL if the region is empty or XTCP_ENOMEM
+ *                if XTCP_STATIC_REGIONS regions are already registered.
+ */
+int32_t xtcp_register_static(const uint8_t data[], uint32_t length);
+
 /** Copy an IP address data structure.
  */
 #define XTCP_IPADDR_CPY(dest, src) do { dest[0] = src[0]; \
@@ -0,0 +1,37 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_capture_h__
+#define __xtcp_capture_h__
+
+/** \file xtcp_capture.h
+ *  \brief Packet capture read out over a TCP socket, run by an xtcp_if client.
+ *
+ *  The capture runs while a host is connected to the capture port, and the pcap stream from read_capture() is sent
+ *  to it, so a live capture can be viewed with
+ *
+ *    nc <address> <port> | wireshark -k -i -
+ *
+ *  Frames to or from the capture port are never captured. The library must be built with XTCP_CAPTURE_ENABLE.
+ */
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Interval at which the capture ring is read and sent to the connected host, in milliseconds. Default is 10. */
+#ifndef XTCP_CAPTURE_POLL_MS
+#define XTCP_CAPTURE_POLL_MS 10
+#endif
+
+#if defined(__XC__) || defined(__DOXYGEN__)
+/** Run a packet capture server as a client task, capturing while a host is connected.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param port     The local port hosts connect to for the capture.
+ *  \param filter   The frames to capture, ignore_port is set to port.
+ */
+void xtcp_capture_server(CLIENT_INTERFACE(xtcp_if, i_xtcp), uint16_t port, xtcp_capture_filter_t filter);
+#endif /* __XC__ || __DOXYGEN__ */
+
+#endif /* __xtcp_capture_h__ */
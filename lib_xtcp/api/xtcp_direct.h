@@ -0,0 +1,133 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_direct_h__
+#define __xtcp_direct_h__
+
+/** \file xtcp_direct.h
+ *  \brief Direct C API for protocol handlers running on the same logical core as the TCP/IP stack.
+ *
+ *  Sockets created with xtcp_c_socket() are not owned by any xtcp_if client. Their events are not queued, the
+ *  callbacks registered with the socket are called from inside LwIP while it processes the packet or timer causing the
+ *  event, so a handler can reply from its callback without waiting for an interface transaction.
+ *
+ *  These functions may only be called from the xtcp_lwip() task, from xtcp_configure_direct_clients() or from a
+ *  callback. Callbacks must not block, the stack does nothing else until they return.
+ */
+
+#ifndef __XC__
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/* LwIP headers */
+#include "lwip/pbuf.h"
+
+/** Callbacks for events on a direct socket.
+ *
+ *  Any callback may be NULL, the event is then ignored. Each callback is given the arg passed to xtcp_c_socket(),
+ *  connections accepted by a listening socket inherit its callbacks and arg. For stack analysis each function must be
+ *  marked with the matching function pointer group, for example
+ *  `__attribute__((fptrgroup("xtcp_c_recv_fn"))) static void my_recv(...)`.
+ */
+typedef struct xtcp_c_callbacks_t {
+  /** A TCP connection has been accepted by a listening socket, group xtcp_c_accept_fn. \p id is the new connection. */
+  __attribute__((fptrgroup("xtcp_c_accept_fn")))
+  void (*on_accept)(void *arg, int32_t listener_id, int32_t id);
+
+  /** A TCP connection started with xtcp_c_connect() has been established, group xtcp_c_connect_fn. */
+  __attribute__((fptrgroup("xtcp_c_connect_fn")))
+  void (*on_connect)(void *arg, int32_t id);
+
+  /** Data has been received, group xtcp_c_recv_fn.
+   *
+   *  The pbuf is only valid until the callback returns and is freed by the stack. A UDP datagram is given whole, with
+   *  the sender's address and port. TCP data is given as it arrives, possibly in a chain of pbufs, with the remote
+   *  address and port of the connection. */
+  __attribute__((fptrgroup("xtcp_c_recv_fn")))
+  void (*on_recv)(void *arg, int32_t id, const struct pbuf *p, const xtcp_ipaddr_t addr, uint16_t port);
+
+  /** Bytes sent on a TCP connection have been acknowledged, group xtcp_c_sent_fn. */
+  __attribute__((fptrgroup("xtcp_c_sent_fn")))
+  void (*on_sent)(void *arg, int32_t id, uint32_t length);
+
+  /** A TCP connection has ended, group xtcp_c_close_fn.
+   *
+   *  \p event is XTCP_CLOSED if the remote host closed the connection, the socket must still be closed with
+   *  xtcp_c_close(). It is XTCP_ABORTED or XTCP_TIMED_OUT if the connection failed, the socket has already gone. */
+  __attribute__((fptrgroup("xtcp_c_close_fn")))
+  void (*on_close)(void *arg, int32_t id, xtcp_event_type_t event);
+} xtcp_c_callbacks_t;
+
+/** Create a direct socket.
+ *
+ *  \param protocol   XTCP_PROTOCOL_TCP or XTCP_PROTOCOL_UDP.
+ *  \param callbacks  The callbacks for events on the socket, must remain valid while the socket is open.
+ *  \param arg        Passed to each callback.
+ *
+ *  \returns The socket identifier, or an error status if no socket is available.
+ */
+xtcp_error_int32_t xtcp_c_socket(xtcp_protocol_t protocol, const xtcp_c_callbacks_t *callbacks, void *arg);
+
+/** Close a direct socket, a TCP connection is closed gracefully.
+ *
+ *  \param id   The socket identifier.
+ */
+void xtcp_c_close(int32_t id);
+
+/** Bind a direct socket to a local port and address, a TCP socket then listens for connections.
+ *
+ *  \param id           The socket identifier.
+ *  \param port_number  The local port.
+ *  \param ipaddr       The local address, or all zeros for any.
+ *
+ *  \returns XTCP_SUCCESS, or an error status if the socket could not be bound.
+ */
+xtcp_error_code_t xtcp_c_listen(int32_t id, uint16_t port_number, xtcp_ipaddr_t ipaddr);
+
+/** Connect a direct socket to a remote host, for TCP on_connect() is called once the connection is established.
+ *
+ *  \param id           The socket identifier.
+ *  \param port_number  The remote port.
+ *  \param ipaddr       The remote address.
+ *
+ *  \returns XTCP_SUCCESS, or an error status if the connection could not be started.
+ */
+xtcp_error_code_t xtcp_c_connect(int32_t id, uint16_t port_number, xtcp_ipaddr_t ipaddr);
+
+/** Send data on a direct socket.
+ *
+ *  TCP data is copied straight into the LwIP send buffer and output at once. A UDP datagram is copied into a transmit
+ *  pbuf and sent to the connected remote host, through the cached route when XTCP_UDP_FAST_PATH is enabled. In both
+ *  cases the data may be reused as soon as the function returns.
+ *
+ *  \param id       The socket identifier.
+ *  \param data     The data to send.
+ *  \param length   The number of bytes to send.
+ *
+ *  \retval XTCP_SUCCESS  The data has been queued or sent.
+ *  \retval XTCP_EAGAIN   The TCP send buffer is full, retry from on_sent().
+ *  \retval XTCP_ENOMEM   No transmit pbuf is free for a UDP datagram.
+ *  \retval XTCP_EINVAL   Bad socket identifier or the data could not be sent.
+ */
+xtcp_error_code_t xtcp_c_send(int32_t id, const void *data, uint32_t length);
+
+/** Send a UDP datagram from a direct socket to a given remote host.
+ *
+ *  \param id           The socket identifier.
+ *  \param data         The datagram payload.
+ *  \param length       The number of bytes to send.
+ *  \param remote_addr  The remote address.
+ *  \param remote_port  The remote port.
+ *
+ *  \retval XTCP_SUCCESS          The datagram has been sent.
+ *  \retval XTCP_EPROTONOSUPPORT  The socket is a TCP socket.
+ *  \retval XTCP_EINVAL           Bad socket identifier or the datagram could not be sent.
+ */
+xtcp_error_code_t xtcp_c_sendto(int32_t id, const void *data, uint32_t length, xtcp_ipaddr_t remote_addr,
+                                uint16_t remote_port);
+
+#endif /* __XC__ */
+
+#endif /* __xtcp_direct_h__ */
@@ -0,0 +1,226 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_http_h__
+#define __xtcp_http_h__
+
+/** \file xtcp_http.h
+ *  \brief HTTP/1.1 server for static resources, run by an xtcp_if client.
+ *
+ *  Connections are persistent unless the request asks otherwise, and pipelined requests are answered in order. Each
+ *  connection takes a state from a fixed pool, reached through the connection's client data, and buffers its request
+ *  headers across as many segments as they arrive in. A response header is sent with send() and the resource's body
+ *  with send_static(), straight from a region registered on the stack's tile, so the server never copies the body.
+ *
+ *  The request parsing and response building run in C, independent of xtcp_if, so they can be tested and
+ *  benchmarked on their own. xtcp_http_event() drives them from the client's events.
+ */
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Build the HTTP server. Its connection states take about XTCP_HTTP_MAX_CONNECTIONS * (XTCP_HTTP_REQUEST_MAX +
+ * XTCP_HTTP_RX_BUFFER) bytes, so they are only allocated when this is 1, and an application calling the functions
+ * below without it fails to link. Default is 0. */
+#ifndef XTCP_HTTP_ENABLE
+#define XTCP_HTTP_ENABLE 0
+#endif
+
+/** Maximum number of concurrent HTTP connections, further connections are aborted. Default is 8. */
+#ifndef XTCP_HTTP_MAX_CONNECTIONS
+#define XTCP_HTTP_MAX_CONNECTIONS 8
+#endif
+
+/** Maximum length of a request line and its headers, a longer request is answered with status 431 and the
+ * connection closed. Default is 1024. */
+#ifndef XTCP_HTTP_REQUEST_MAX
+#define XTCP_HTTP_REQUEST_MAX 1024
+#endif
+
+/** Length of the buffer the server receives into, which must hold the largest segment the stack receives, so at
+ * least its TCP_MSS. Each connection buffers this many bytes beyond XTCP_HTTP_REQUEST_MAX. Default is 1500. */
+#ifndef XTCP_HTTP_RX_BUFFER
+#define XTCP_HTTP_RX_BUFFER 1500
+#endif
+
+/** Maximum number of resources that can be added with xtcp_http_add_resource(). Default is 16. */
+#ifndef XTCP_HTTP_MAX_RESOURCES
+#define XTCP_HTTP_MAX_RESOURCES 16
+#endif
+
+/** Maximum length of a response header, including the short body of an error response. Default is 192. */
+#ifndef XTCP_HTTP_HEADER_MAX
+#define XTCP_HTTP_HEADER_MAX 192
+#endif
+
+/** A response to the oldest request buffered on a connection */
+typedef struct xtcp_http_response_t {
+  uint8_t header[XTCP_HTTP_HEADER_MAX]; /**< The status line and headers, followed by the body of an error response */
+  uint32_t header_length;               /**< The number of bytes of header to send() */
+  int32_t region;                       /**< The static region holding the body, -1 if there is none to send */
+  uint32_t offset;                      /**< The offset of the body in the region */
+  uint32_t length;                      /**< The length of the body, 0 if there is none to send */
+  int close;                            /**< Non-zero if the connection closes once the response has been sent */
+} xtcp_http_response_t;
+
+/** Counts kept by the HTTP server since xtcp_http_init() */
+typedef struct xtcp_http_stats_t {
+  uint32_t connections; /**< Connections accepted */
+  uint32_t rejected;    /**< Connections aborted because every connection state was in use */
+  uint32_t requests;    /**< Requests answered */
+  uint32_t reused;      /**< Requests answered on a connection that had already answered one */
+  uint32_t errors;      /**< Requests answered with a 4xx or 5xx status */
+} xtcp_http_stats_t;
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Reset the HTTP server, forgetting its resources, connection states and statistics. */
+void xtcp_http_init(void);
+
+/** Add a resource served from a static region.
+ *
+ *  \param path           The absolute path of the resource, "/" for the default page. The string is not copied.
+ *  \param content_type   The value of the Content-Type header. The string is not copied.
+ *  \param region         The identifier returned for the region by xtcp_register_static() on the stack's tile.
+ *  \param offset         The offset of the resource's body in the region.
+ *  \param length         The length of the body.
+ *  \returns              XTCP_SUCCESS, XTCP_EINVAL if the path is not absolute or XTCP_ENOMEM if
+ *                        XTCP_HTTP_MAX_RESOURCES resources have already been added.
+ */
+xtcp_error_code_t xtcp_http_add_resource(const char path[], const char content_type[], int32_t region,
+                                         uint32_t offset, uint32_t length);
+
+/** Take a connection state from the pool for a new connection.
+ *
+ *  \param id   The connection descriptor.
+ *  \returns    The connection state, NULL if the pool is empty.
+ */
+void * unsafe xtcp_http_open(int32_t id);
+
+/** Return a connection's state to the pool.
+ *
+ *  \param conn   The connection state.
+ */
+void xtcp_http_close(void * unsafe conn);
+
+/** Find the state of a connection by its descriptor, for events raised once the stack has forgotten the
+ *  connection's client data.
+ *
+ *  \param id   The connection descriptor.
+ *  \returns    The connection state, NULL if the connection has none.
+ */
+void * unsafe xtcp_http_find(int32_t id);
+
+/** Check whether a connection's client data is an HTTP connection state.
+ *
+ *  \param conn   The connection's client data.
+ *  \returns      Non-zero if \p conn is a state taken from the pool.
+ */
+int xtcp_http_owns(void * unsafe conn);
+
+/** Check whether a connection takes received data now, rather than once its response has been sent.
+ *
+ *  Data is only taken while no whole request is buffered, so a connection buffers at most one request beyond
+ *  XTCP_HTTP_REQUEST_MAX and TCP flow control holds back the rest of a pipeline.
+ *
+ *  \param conn   The connection state.
+ *  \returns      Non-zero if the received data should be passed to xtcp_http_received() now.
+ */
+int xtcp_http_wants_data(void * unsafe conn);
+
+/** Note received data left with the stack, to be taken by xtcp_http_take_deferred() later.
+ *
+ *  \param conn   The connection state.
+ */
+void xtcp_http_defer(void * unsafe conn);
+
+/** Take a note of received data left with the stack, once the connection wants data again.
+ *
+ *  \param conn   The connection state.
+ *  \returns      Non-zero if received data was left with the stack and should be received now.
+ */
+int xtcp_http_take_deferred(void * unsafe conn);
+
+/** Buffer data received on a connection.
+ *
+ *  \param conn     The connection state.
+ *  \param data     The data received.
+ *  \param length   The number of bytes received.
+ *  \returns        XTCP_SUCCESS, or XTCP_ENOMEM if the data does not fit and the request is answered with status 431.
+ */
+xtcp_error_code_t xtcp_http_received(void * unsafe conn, const uint8_t data[], uint32_t length);
+
+/** Build the response to the oldest buffered request, leaving the request buffered until xtcp_http_commit().
+ *
+ *  \param conn       The connection state.
+ *  \param response   The response to send.
+ *  \returns          Non-zero if a response was built, 0 if a whole request has not been received or a response
+ *                    body is still being sent.
+ */
+int xtcp_http_next(void * unsafe conn, REFERENCE_PARAM(xtcp_http_response_t, response));
+
+/** Consume the request answered by the response from xtcp_http_next(), once its header has been sent.
+ *
+ *  A connection with a response body to send takes no further requests until xtcp_http_sent().
+ *
+ *  \param conn   The connection state.
+ */
+void xtcp_http_commit(void * unsafe conn);
+
+/** Note that a response body has been sent, on XTCP_SENT_STATIC.
+ *
+ *  \param conn   The connection state.
+ *  \returns      Non-zero if the connection should now be closed.
+ */
+int xtcp_http_sent(void * unsafe conn);
+
+/** Note that the remote host has closed its side of a connection, on XTCP_CLOSED.
+ *
+ *  \param conn   The connection state.
+ *  \returns      Non-zero if the connection should be closed now, 0 if it closes once its response body is sent.
+ */
+int xtcp_http_remote_closed(void * unsafe conn);
+
+/** Get the HTTP server's statistics.
+ *
+ *  \returns  The counts since xtcp_http_init().
+ */
+xtcp_http_stats_t xtcp_http_get_stats(void);
+
+#ifdef __XC__
+}
+#endif
+
+#if defined(__XC__) || defined(__DOXYGEN__)
+/** Listen for HTTP connections.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param port     The local port, usually 80.
+ *  \returns        The listening connection descriptor, or a negative xtcp_error_code_t.
+ */
+int32_t xtcp_http_listen(CLIENT_INTERFACE(xtcp_if, i_xtcp), uint16_t port);
+
+/** Handle a client event for the HTTP server.
+ *
+ *  Call for every event of a client that also has connections of its own, the HTTP server only acts on connections
+ *  accepted on the port passed to xtcp_http_listen().
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param event    The event returned by get_event().
+ *  \param id       The connection descriptor returned by get_event().
+ *  \returns        Non-zero if the event was for the HTTP server.
+ */
+int xtcp_http_event(CLIENT_INTERFACE(xtcp_if, i_xtcp), xtcp_event_type_t event, int32_t id);
+
+/** Run an HTTP server as a client task, serving the resources added since xtcp_http_init().
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param port     The local port, usually 80.
+ */
+void xtcp_http_server(CLIENT_INTERFACE(xtcp_if, i_xtcp), uint16_t port);
+#endif /* __XC__ || __DOXYGEN__ */
+
+#endif /* __xtcp_http_h__ */
@@ -0,0 +1,206 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_iperf_h__
+#define __xtcp_iperf_h__
+
+/** \file xtcp_iperf.h
+ *  \brief iperf2 compatible TCP throughput server and client, run by an xtcp_if client.
+ *
+ *  The server accepts connections from `iperf -c <address>` and counts the bytes received. The client connects to
+ *  `iperf -s` and sends for a given time, starting with the iperf2 client header as LwIP's lwiperf app does, so the
+ *  remote iperf reports the same test. Each connection is a session reporting its throughput every
+ *  XTCP_IPERF_INTERVAL_MS and once more when it ends, through xtcp_iperf_report().
+ *
+ *  Sessions are kept in C, independent of xtcp_if, so the accounting can be tested on its own. Times are reference
+ *  timer ticks, 100 per microsecond, and a session must be given the time at least once per period of the timer.
+ */
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Build the iperf tasks. Their sessions, send buffer and the printf() of the default xtcp_iperf_report() are only
+ * linked in when this is 1, and an application calling the functions below without it fails to link. Default is 0. */
+#ifndef XTCP_IPERF_ENABLE
+#define XTCP_IPERF_ENABLE 0
+#endif
+
+/** Default port of iperf2. */
+#define XTCP_IPERF_DEFAULT_PORT 5001
+
+/** Length of the iperf2 client header sent at the start of a client session. */
+#define XTCP_IPERF_HEADER_LENGTH 24
+
+/** Maximum number of concurrent iperf sessions, for `iperf -P` parallel streams. Default is 4. */
+#ifndef XTCP_IPERF_MAX_SESSIONS
+#define XTCP_IPERF_MAX_SESSIONS 4
+#endif
+
+/** Interval between throughput reports of a session, in milliseconds. Default is 1000. */
+#ifndef XTCP_IPERF_INTERVAL_MS
+#define XTCP_IPERF_INTERVAL_MS 1000
+#endif
+
+/** Length of the buffer the iperf tasks send and receive through, at least the stack's TCP_MSS. Default is 1460. */
+#ifndef XTCP_IPERF_BUFFER
+#define XTCP_IPERF_BUFFER 1460
+#endif
+
+/** Role of an iperf session */
+typedef enum xtcp_iperf_role_t {
+  XTCP_IPERF_SERVER, /**< Receiving from a remote iperf client */
+  XTCP_IPERF_CLIENT, /**< Sending to a remote iperf server */
+} xtcp_iperf_role_t;
+
+/** Throughput of a session over an interval, or over the whole session */
+typedef struct xtcp_iperf_report_t {
+  xtcp_iperf_role_t role;     /**< The role of the session */
+  int32_t id;                 /**< The session's connection descriptor */
+  uint32_t start_ms;          /**< The start of the interval, in milliseconds since the session started */
+  uint32_t end_ms;            /**< The end of the interval */
+  uint64_t bytes;             /**< The bytes received by a server or sent by a client in the interval */
+  uint32_t kbits_per_second;  /**< The throughput over the interval */
+  int final;                  /**< Non-zero for the report of the whole session, as it ends */
+} xtcp_iperf_report_t;
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Forget every iperf session. */
+void xtcp_iperf_init(void);
+
+/** Start a session for a connection.
+ *
+ *  \param id           The connection descriptor.
+ *  \param role         Whether the session receives or sends.
+ *  \param now          The reference time.
+ *  \param duration_ms  The time a client session sends for, ignored by a server.
+ *  \returns            XTCP_SUCCESS, XTCP_EINVAL if the connection already has a session, or XTCP_ENOMEM if
+ *                      XTCP_IPERF_MAX_SESSIONS sessions are running.
+ */
+xtcp_error_code_t xtcp_iperf_open(int32_t id, xtcp_iperf_role_t role, uint32_t now, uint32_t duration_ms);
+
+/** Check whether a connection has a session.
+ *
+ *  \param id   The connection descriptor.
+ *  \returns    Non-zero if the connection has a session.
+ */
+int xtcp_iperf_has_session(int32_t id);
+
+/** Count the bytes a session has received or sent.
+ *
+ *  \param id       The session's connection descriptor.
+ *  \param bytes    The number of bytes.
+ *  \param now      The reference time.
+ */
+void xtcp_iperf_count(int32_t id, uint32_t bytes, uint32_t now);
+
+/** Check whether a client session has sent for its duration.
+ *
+ *  \param id   The session's connection descriptor.
+ *  \param now  The reference time.
+ *  \returns    Non-zero if the session should stop sending and be closed.
+ */
+int xtcp_iperf_done(int32_t id, uint32_t now);
+
+/** Report the intervals that have passed for every session.
+ *
+ *  \param now  The reference time, called at least every XTCP_IPERF_INTERVAL_MS for reports to be on time.
+ *  \returns    The connection descriptor of a client session that has sent for its duration and should be closed,
+ *              -1 if there is none. Each session is returned once.
+ */
+int32_t xtcp_iperf_tick(uint32_t now);
+
+/** End a session, reporting the interval in progress and the whole session.
+ *
+ *  \param id   The session's connection descriptor.
+ *  \param now  The reference time.
+ */
+void xtcp_iperf_close(int32_t id, uint32_t now);
+
+/** Build the iperf2 client header for a timed test.
+ *
+ *  \param header       The header.
+ *  \param duration_ms  The time the client sends for.
+ */
+void xtcp_iperf_client_header(uint8_t header[XTCP_IPERF_HEADER_LENGTH], uint32_t duration_ms);
+
+/** Fill a buffer with the digits iperf sends, "0123456789" repeated.
+ *
+ *  \param buffer   The buffer.
+ *  \param length   The length of the buffer.
+ */
+void xtcp_iperf_fill(uint8_t buffer[], uint32_t length);
+
+/** Called with each report of a session.
+ *
+ *  \param report   The report.
+ *
+ *  \note This is a weak function printing the report in the format of iperf, which may be overridden by the user to
+ *  collect the reports instead.
+ */
+void xtcp_iperf_report(const REFERENCE_PARAM(xtcp_iperf_report_t, report));
+
+#ifdef __XC__
+}
+#endif
+
+#if defined(__XC__) || defined(__DOXYGEN__)
+/** Listen for connections from iperf clients.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param port     The local port, usually XTCP_IPERF_DEFAULT_PORT.
+ *  \returns        The listening connection descriptor, or a negative xtcp_error_code_t.
+ */
+int32_t xtcp_iperf_listen(CLIENT_INTERFACE(xtcp_if, i_xtcp), uint16_t port);
+
+/** Connect to an iperf server and send to it once connected.
+ *
+ *  \param i_xtcp       The client's interface to the stack.
+ *  \param addr         The address of the server.
+ *  \param port         The port of the server, usually XTCP_IPERF_DEFAULT_PORT.
+ *  \param duration_ms  The time to send for.
+ *  \returns            The connection descriptor, or a negative xtcp_error_code_t.
+ */
+int32_t xtcp_iperf_connect(CLIENT_INTERFACE(xtcp_if, i_xtcp), xtcp_ipaddr_t addr, uint16_t port,
+                           uint32_t duration_ms);
+
+/** Handle a client event for the iperf sessions.
+ *
+ *  Call for every event of a client that also has connections of its own, only connections accepted on the port
+ *  passed to xtcp_iperf_listen() or started by xtcp_iperf_connect() are handled.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param event    The event returned by get_event().
+ *  \param id       The connection descriptor returned by get_event().
+ *  \returns        Non-zero if the event was for an iperf session.
+ */
+int xtcp_iperf_event(CLIENT_INTERFACE(xtcp_if, i_xtcp), xtcp_event_type_t event, int32_t id);
+
+/** Report the intervals that have passed and close client sessions that have sent for their duration.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param now      The reference time, called at least every XTCP_IPERF_INTERVAL_MS for reports to be on time.
+ */
+void xtcp_iperf_poll(CLIENT_INTERFACE(xtcp_if, i_xtcp), uint32_t now);
+
+/** Run an iperf server as a client task.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param port     The local port, usually XTCP_IPERF_DEFAULT_PORT.
+ */
+void xtcp_iperf_server(CLIENT_INTERFACE(xtcp_if, i_xtcp), uint16_t port);
+
+/** Run an iperf client as a client task, sending to a server for a time once the interface is up.
+ *
+ *  \param i_xtcp       The client's interface to the stack.
+ *  \param addr         The address of the server.
+ *  \param port         The port of the server, usually XTCP_IPERF_DEFAULT_PORT.
+ *  \param duration_ms  The time to send for.
+ */
+void xtcp_iperf_client(CLIENT_INTERFACE(xtcp_if, i_xtcp), xtcp_ipaddr_t addr, uint16_t port, uint32_t duration_ms);
+#endif /* __XC__ || __DOXYGEN__ */
+
+#endif /* __xtcp_iperf_h__ */
@@ -0,0 +1,53 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_log_h__
+#define __xtcp_log_h__
+
+/** \file xtcp_log.h
+ *  \brief Deferred log formatting and printing, run by an xtcp_if client.
+ *
+ *  With XTCP_LOG_DEFERRED the stack stores its data path error messages as binary records, read with read_log().
+ *  The records are formatted here, on the reading core, so the stack never spends time formatting or printing.
+ */
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Interval at which the deferred log ring is read and printed, in milliseconds. Default is 10. */
+#ifndef XTCP_LOG_POLL_MS
+#define XTCP_LOG_POLL_MS 10
+#endif
+
+/** Length of the text of a formatted record, including its terminator. */
+#define XTCP_LOG_TEXT_LENGTH 96
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Format a record read with read_log() as a line of text, without a newline. The line starts with the time of the
+ *  record in microseconds of the reference timer and ends with the number of repeats of the message that were
+ *  over XTCP_LOG_RATE, if any. Text longer than the buffer is truncated.
+ *
+ *  \param record   The record, XTCP_LOG_RECORD_LENGTH bytes.
+ *  \param text     The buffer for the text.
+ *  \param length   The length of the buffer.
+ *  \returns        The length of the text, or XTCP_EINVAL if the record holds an unknown message.
+ */
+int xtcp_log_format(const uint8_t record[XTCP_LOG_RECORD_LENGTH], char text[], unsigned length);
+
+#ifdef __XC__
+}
+#endif
+
+#if defined(__XC__) || defined(__DOXYGEN__)
+/** Run a deferred log printer as a client task, printing the records of read_log() with printf().
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ */
+void xtcp_log_printer(CLIENT_INTERFACE(xtcp_if, i_xtcp));
+#endif /* __XC__ || __DOXYGEN__ */
+
+#endif /* __xtcp_log_h__ */
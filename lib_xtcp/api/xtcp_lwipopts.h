@@ -0,0 +1,88 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_LWIPOPTS_H
+#define XTCP_LWIPOPTS_H
+
+/* lwIP options set by lib_xtcp on top of an lwipopts.h profile.
+ *
+ * The profiles in lib_xtcp/lwipopts include this file after the lwIP port profile. An application using its own
+ * lwipopts.h should include it at the end of that file to use these options.
+ */
+
+#ifdef __xtcp_conf_h_exists__
+#include "xtcp_conf.h"
+#endif
+
+#include "xtcp_chksum.h"
+
+/** Copy TCP send data and compute its checksum in a single pass, instead of copying it in tcp_write() and
+ * reading it again to compute the checksum when the segment is sent. Default is 1. */
+#ifndef XTCP_CHECKSUM_ON_COPY
+#define XTCP_CHECKSUM_ON_COPY 1
+#endif
+
+#if XTCP_CHECKSUM_ON_COPY
+#undef LWIP_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY 1
+#undef LWIP_CHKSUM_COPY_ALGORITHM
+#define LWIP_CHKSUM_COPY_ALGORITHM 0
+#define LWIP_CHKSUM_COPY(dst, src, len) xtcp_chksum_copy(dst, src, len)
+#endif
+
+/** Use the lib_xtcp Internet checksum routine for every checksum generated and checked by lwIP. It sums 32-bit
+ * words with unrolled loops and folds the carries once at the end, instead of summing 16 bits at a time.
+ * Default is 1. */
+#ifndef XTCP_FAST_CHECKSUM
+#define XTCP_FAST_CHECKSUM 1
+#endif
+
+#if XTCP_FAST_CHECKSUM
+#undef LWIP_CHKSUM_ALGORITHM
+#define LWIP_CHKSUM_ALGORITHM 0
+#undef LWIP_CHKSUM
+#define LWIP_CHKSUM(dataptr, len) xtcp_chksum(dataptr, (uint16_t)(len))
+#endif
+
+/* Static ARP entries added by add_static_arp_entry() are held in the lwIP ARP table, unless XTCP_ARP_HASH_TABLE_SIZE
+ * is set */
+#undef ETHARP_SUPPORT_STATIC_ENTRIES
+#define ETHARP_SUPPORT_STATIC_ENTRIES 1
+
+/** Largest UDP datagram a client can send or receive. A received datagram held in a chain of pbufs, after IP
+ * reassembly, is copied to the client through a static buffer of this size, and larger received datagrams are
+ * dropped. When this is more than fits in one Ethernet frame, IP fragmentation and reassembly are enabled, and
+ * datagrams to send that are larger than the transmit pool classes are allocated from the lwIP heap, so MEM_SIZE
+ * must hold them. Default is 1472. */
+#ifndef XTCP_UDP_MAX_DATAGRAM_SIZE
+#define XTCP_UDP_MAX_DATAGRAM_SIZE 1472
+#endif
+
+/** Bytes of fragments held while received datagrams are reassembled, shared by every datagram being reassembled.
+ * When the budget is used the oldest incomplete datagram is dropped. Fragments are held in PBUF_POOL buffers, so
+ * PBUF_POOL_SIZE must cover the budget as well as other received frames. Only used when XTCP_UDP_MAX_DATAGRAM_SIZE is
+ * more than fits in one Ethernet frame. Default is two datagrams of XTCP_UDP_MAX_DATAGRAM_SIZE. */
+#ifndef XTCP_IP_REASSEMBLY_BUDGET
+#define XTCP_IP_REASSEMBLY_BUDGET (2 * (XTCP_UDP_MAX_DATAGRAM_SIZE + 8))
+#endif
+
+/* Bytes of a datagram carried by each fragment with a 1500 byte MTU, and fragments needed for a number of bytes */
+#define XTCP_IP_FRAGMENT_SIZE 1480
+#define XTCP_IP_FRAGMENTS(bytes) (((bytes) + XTCP_IP_FRAGMENT_SIZE - 1) / XTCP_IP_FRAGMENT_SIZE)
+
+#if XTCP_UDP_MAX_DATAGRAM_SIZE + 8 > XTCP_IP_FRAGMENT_SIZE
+#if XTCP_IP_REASSEMBLY_BUDGET < XTCP_UDP_MAX_DATAGRAM_SIZE + 8
+#error "XTCP_IP_REASSEMBLY_BUDGET must hold at least one datagram of XTCP_UDP_MAX_DATAGRAM_SIZE"
+#endif
+#undef IP_FRAG
+#define IP_FRAG 1
+#undef IP_REASSEMBLY
+#define IP_REASSEMBLY 1
+#undef IP_REASS_MAX_PBUFS
+#define IP_REASS_MAX_PBUFS XTCP_IP_FRAGMENTS(XTCP_IP_REASSEMBLY_BUDGET)
+/* As many datagrams are reassembled at once as the budget holds at their largest */
+#undef MEMP_NUM_REASSDATA
+#define MEMP_NUM_REASSDATA (IP_REASS_MAX_PBUFS / XTCP_IP_FRAGMENTS(XTCP_UDP_MAX_DATAGRAM_SIZE + 8))
+#endif
+
+#endif /* XTCP_LWIPOPTS_H */
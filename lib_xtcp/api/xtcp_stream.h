@@ -0,0 +1,125 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_stream_h__
+#define __xtcp_stream_h__
+
+/** \file xtcp_stream.h
+ *  \brief Bulk data stream between the TCP/IP stack and a client, usually on another tile.
+ *
+ *  A client's send() and recv() move their buffer as an argument of the xtcp_if call, paying the cost of an interface
+ *  transaction for every call. A client opens one stream, a streaming channel to the stack, and moves TCP data
+ *  through it with xtcp_send_stream() and xtcp_recv_stream() while the control calls stay on xtcp_if.
+ *
+ *  Each transfer on the channel is a length word followed by the data packed little endian into words, the last
+ *  word padded, and ends with a status word from the stack. Data is flow controlled in both directions: before each
+ *  block the receiving side writes a credit word giving the number of words it accepts, at most
+ *  XTCP_STREAM_BLOCK_WORDS. The stack only reads from a stream once the client's word has arrived, so a client that
+ *  is slow to write, or never writes, holds up its own transfer but not the stack.
+ */
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** The client end of a bulk data stream */
+typedef struct xtcp_stream_t {
+  unsigned c; /**< The client's channel end, 0 when the stream is closed */
+} xtcp_stream_t;
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Allocate the client's channel end of a stream.
+ *
+ *  \param stream   The stream.
+ *  \returns        The resource identifier of the channel end, 0 if none is available.
+ */
+unsigned xtcp_stream_alloc(REFERENCE_PARAM(xtcp_stream_t, stream));
+
+/** Connect the client's channel end to the stack's, as returned by open_stream().
+ *
+ *  A \p stack_end of 0, returned when open_stream() fails, frees the client's channel end instead.
+ *
+ *  \param stream       The stream.
+ *  \param stack_end    The resource identifier of the stack's channel end.
+ */
+void xtcp_stream_connect(REFERENCE_PARAM(xtcp_stream_t, stream), unsigned stack_end);
+
+/** Close the client's channel end, once close_stream() has returned, and free it.
+ *
+ *  \param stream   The stream.
+ */
+void xtcp_stream_release(REFERENCE_PARAM(xtcp_stream_t, stream));
+
+/** Write the data of a transfer accepted by send_stream() to the stream.
+ *
+ *  \param stream   The stream.
+ *  \param data     The data.
+ *  \param length   The number of bytes accepted by send_stream().
+ *  \returns        The status of the transfer reported by the stack.
+ */
+xtcp_error_code_t xtcp_stream_write(REFERENCE_PARAM(xtcp_stream_t, stream), const uint8_t data[], uint32_t length);
+
+/** Read the data of a transfer started by recv_stream() from the stream.
+ *
+ *  \param stream   The stream.
+ *  \param data     The buffer for the data.
+ *  \param length   The length of the buffer.
+ *  \returns        The number of bytes read, or the xtcp_error_code_t reported by the stack.
+ */
+int32_t xtcp_stream_read(REFERENCE_PARAM(xtcp_stream_t, stream), uint8_t data[], uint32_t length);
+
+#ifdef __XC__
+}
+#endif
+
+#if defined(__XC__) || defined(__DOXYGEN__)
+/** Open a client's bulk data stream to the TCP/IP stack.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param stream   The stream to open.
+ *  \returns        XTCP_SUCCESS, XTCP_ENOMEM if no channel end is available, or XTCP_EINVAL if the client already
+ *                  has a stream open or the library is built without XTCP_STREAM_ENABLE.
+ */
+xtcp_error_code_t xtcp_open_stream(CLIENT_INTERFACE(xtcp_if, i_xtcp), REFERENCE_PARAM(xtcp_stream_t, stream));
+
+/** Close a client's bulk data stream.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param stream   The stream to close.
+ */
+void xtcp_close_stream(CLIENT_INTERFACE(xtcp_if, i_xtcp), REFERENCE_PARAM(xtcp_stream_t, stream));
+
+/** Send TCP data through a bulk data stream.
+ *
+ *  As send(), the data is copied into the stack's send buffer, as much of it as there is space for.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param stream   The client's open stream.
+ *  \param id       The connection descriptor to act on.
+ *  \param buffer   The data to send.
+ *  \param length   The number of bytes to send.
+ *  \returns        The number of bytes sent, or a negative xtcp_error_code_t as send_stream().
+ */
+int32_t xtcp_send_stream(CLIENT_INTERFACE(xtcp_if, i_xtcp), REFERENCE_PARAM(xtcp_stream_t, stream), int32_t id,
+                         const uint8_t buffer[length], uint32_t length);
+
+/** Receive TCP data through a bulk data stream.
+ *
+ *  Unlike recv(), every whole received pbuf that fits in the buffer is taken.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param stream   The client's open stream.
+ *  \param id       The connection descriptor to act on.
+ *  \param buffer   The buffer for the data.
+ *  \param length   The length of the buffer.
+ *  \returns        The number of bytes received, 0 if none are queued, or a negative xtcp_error_code_t as
+ *                  recv_stream().
+ */
+int32_t xtcp_recv_stream(CLIENT_INTERFACE(xtcp_if, i_xtcp), REFERENCE_PARAM(xtcp_stream_t, stream), int32_t id,
+                         uint8_t buffer[length], uint32_t length);
+#endif /* __XC__ || __DOXYGEN__ */
+
+#endif /* __xtcp_stream_h__ */
@@ -0,0 +1,37 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef __xtcp_trace_h__
+#define __xtcp_trace_h__
+
+/** \file xtcp_trace.h
+ *  \brief Event trace read out over xscope, run by an xtcp_if client.
+ *
+ *  The records from read_trace() are sent to an xscope probe with datatype NONE, declared in the application's
+ *  config.xscope, for example
+ *
+ *    <Probe name="xtcp_trace" type="CONTINUOUS" datatype="NONE" units="Value" enabled="true"/>
+ *
+ *  The bytes received by the host for the probe, concatenated, are decoded by tests/xtcp_trace.py. The library must
+ *  be built with XTCP_TRACE_ENABLE.
+ */
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Interval at which the event trace ring is read and sent over xscope, in milliseconds. Default is 10. */
+#ifndef XTCP_TRACE_POLL_MS
+#define XTCP_TRACE_POLL_MS 10
+#endif
+
+#if defined(__XC__) || defined(__DOXYGEN__)
+/** Run an event trace reader as a client task, sending the trace to an xscope probe.
+ *
+ *  \param i_xtcp   The client's interface to the stack.
+ *  \param probe    The xscope probe, such as XSCOPE_XTCP_TRACE generated from config.xscope.
+ */
+void xtcp_trace_xscope(CLIENT_INTERFACE(xtcp_if, i_xtcp), unsigned probe);
+#endif /* __XC__ || __DOXYGEN__ */
+
+#endif /* __xtcp_trace_h__ */
@@ -5,7 +5,7 @@ set(LIB_VERSION             7.0.1)
 # Please note: LWIP_OPTS_PATH may be overridden in the application's CMakeLists.txt file
 if(NOT DEFINED LWIP_OPTS_PATH)
     message(STATUS "LWIP_OPTS_PATH not defined, setting to 'standard', may be overridden in the application's CMakeLists.txt file")
-    set(LWIP_OPTS_PATH      "../lwip/contrib/ports/xmos/lib/standard")
+    set(LWIP_OPTS_PATH      "lwipopts/standard")
 endif()
 
 # LWIP
@@ -25,7 +25,8 @@ if (LWIP_VERSION_STRING)
     set(XTCP_LWIP_VERSION_STRING ${LWIP_VERSION_STRING} CACHE STRING "")
 
     # TODO - future addition ${lwipmbedtls_SRCS}
-    # ${lwipallapps_SRCS} - Optional apps
+    # ${lwipallapps_SRCS} - Optional apps, these use the LwIP callback API, lib_xtcp builds with LWIP_EVENT_API.
+    #                       xtcp_iperf.h replaces lwiperf.
     # ${lwipcontribexamples_SRCS} - Optional examples
     # ${lwipcontribapps_SRCS} - Optional contrib apps
 
@@ -44,18 +45,43 @@ else()
 endif()
 
 # lib_xtcp
-set(LIB_C_SRCS              src/client_queue.c
+set(LIB_C_SRCS              src/capture.c
+                            src/client_queue.c
+                            src/client_sched.c
                             src/connection.c
+                            src/deferred_log.c
+                            src/direct_client.c
+                            src/http_server.c
+                            src/iperf.c
                             src/lwip_shim.c
                             src/pbuf_shim.c
+                            src/pipeline.c
+                            src/rate_limit.c
+                            src/rx_filter.c
+                            src/static_arp.c
+                            src/static_send.c
+                            src/stream.c
+                            src/stream_client.c
                             src/tcp_transport.c
+                            src/trace.c
+                            src/tx_pool.c
+                            src/udp_batch.c
+                            src/udp_fast_path.c
                             src/udp_recv.c
                             src/dns_found.c
+                            src/xtcp_chksum.c
                             src/xtcp_configure.c
                             ${XTCP_LWIP_CODE_LIST})
 
-set(LIB_XC_SRCS             src/xtcp_lwip.xc
-                            src/xtcp_shim.xc)
+set(LIB_XC_SRCS             src/xtcp_capture.xc
+                            src/xtcp_frontend.xc
+                            src/xtcp_lwip.xc
+                            src/xtcp_http.xc
+                            src/xtcp_iperf.xc
+                            src/xtcp_log.xc
+                            src/xtcp_shim.xc
+                            src/xtcp_stream.xc
+                            src/xtcp_trace.xc)
 
 set(LIB_INCLUDES            api
                             src
@@ -0,0 +1,60 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_LWIPOPTS_HIGH_THROUGHPUT_H
+#define XTCP_LWIPOPTS_HIGH_THROUGHPUT_H
+
+/* The lwIP port 'standard' profile, with TCP sized to keep a 100Mb/s link full over a LAN and the lib_xtcp options
+ * applied. The receive window is larger than 64KB so window scaling is enabled, out of order segments are queued
+ * and reported to the sender with SACK, and the pbuf pool holds a full window. */
+#include "../../../lwip/contrib/ports/xmos/lib/standard/lwipopts.h"
+
+#undef TCP_MSS
+#define TCP_MSS 1460
+
+/* Receive window of 48 segments, scaled by 2 so up to 128KB may be advertised */
+#undef LWIP_WND_SCALE
+#define LWIP_WND_SCALE 1
+#undef TCP_RCV_SCALE
+#define TCP_RCV_SCALE 1
+#undef TCP_WND
+#define TCP_WND (48 * TCP_MSS)
+
+/* Send buffer of 32 segments per connection, each segment may be sent in up to 4 pbufs */
+#undef TCP_SND_BUF
+#define TCP_SND_BUF (32 * TCP_MSS)
+#undef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN (4 * TCP_SND_BUF / TCP_MSS)
+#undef TCP_SNDLOWAT
+#define TCP_SNDLOWAT (TCP_SND_BUF / 2)
+#undef TCP_SNDQUEUELOWAT
+#define TCP_SNDQUEUELOWAT (TCP_SND_QUEUELEN / 2)
+#undef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG (2 * TCP_SND_QUEUELEN)
+
+/* Update the advertised window after a quarter of it has been read */
+#undef TCP_WND_UPDATE_THRESHOLD
+#define TCP_WND_UPDATE_THRESHOLD (TCP_WND / 4)
+
+/* Hold out of order segments and tell the sender which ones arrived */
+#undef TCP_QUEUE_OOSEQ
+#define TCP_QUEUE_OOSEQ 1
+#undef LWIP_TCP_SACK_OUT
+#define LWIP_TCP_SACK_OUT 1
+#undef LWIP_TCP_MAX_SACK_NUM
+#define LWIP_TCP_MAX_SACK_NUM 4
+#undef TCP_OOSEQ_MAX_PBUFS
+#define TCP_OOSEQ_MAX_PBUFS (TCP_WND / TCP_MSS)
+
+/* Received frames are held in the pbuf pool until the client reads them, so it holds a full window plus frames
+ * waiting for the stack */
+#undef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE (TCP_WND / TCP_MSS + 16)
+
+/* The heap holds the send buffers of two connections at once, and transmit buffers not taken from the pools */
+#undef MEM_SIZE
+#define MEM_SIZE (2 * TCP_SND_BUF + 16 * 1024)
+
+#include "xtcp_lwipopts.h"
+
+#endif /* XTCP_LWIPOPTS_HIGH_THROUGHPUT_H */
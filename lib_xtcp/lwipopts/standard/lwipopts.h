@@ -0,0 +1,11 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_LWIPOPTS_STANDARD_H
+#define XTCP_LWIPOPTS_STANDARD_H
+
+/* The lwIP port 'standard' profile, with the lib_xtcp options applied */
+#include "../../../lwip/contrib/ports/xmos/lib/standard/lwipopts.h"
+#include "xtcp_lwipopts.h"
+
+#endif /* XTCP_LWIPOPTS_STANDARD_H */
@@ -0,0 +1,330 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "capture.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <xs1.h>
+
+#include <xcore/hwtimer.h>
+
+/* LwIP headers */
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+
+/* pcap file header fields, the magic number of a file with nanosecond timestamps and the Ethernet link type */
+#define PCAP_MAGIC_NANOSECONDS 0xA1B23C4Du
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+#define PCAP_LINKTYPE_ETHERNET 1
+
+#define NS_PER_TICK (1000000000u / XS1_TIMER_HZ)
+
+/* A frame timestamped up to this long before the last one, such as one received while a frame was being sent, is
+ * placed before it rather than taken as the timer having wrapped */
+#define REORDER_TICKS XS1_TIMER_HZ
+
+#define ETH_HEADER_SIZE 14
+#define ETH_TYPE_OFFSET 12
+#define ETHTYPE_VLAN 0x8100
+#define VLAN_TAG_SIZE 4
+#define ETHTYPE_IPV4 0x0800
+#define IP_PROTOCOL_OFFSET 9
+#define IP_SRC_OFFSET 12
+#define IP_DST_OFFSET 16
+#define IP_FRAGMENT_OFFSET 6
+#define IP_PROTOCOL_TCP 6
+#define IP_PROTOCOL_UDP 17
+
+#if XTCP_CAPTURE_ENABLE
+
+#if XTCP_CAPTURE_RING_BYTES < (XTCP_CAPTURE_RECORD_HEADER_LENGTH + XTCP_CAPTURE_SNAPLEN)
+#error "XTCP_CAPTURE_RING_BYTES must hold at least one record of XTCP_CAPTURE_SNAPLEN bytes"
+#endif
+
+/* The ring holds each frame as it is read out, a pcap record header followed by the frame. head and tail count bytes
+ * written and read, so the ring is empty when they are equal. */
+static uint8_t ring[XTCP_CAPTURE_RING_BYTES];
+static uint32_t head;
+static uint32_t tail;
+
+static int running;
+static int header_pending;
+static xtcp_capture_filter_t filter;
+static xtcp_capture_stats_t stats;
+
+/* Ticks since capture_start(), added up from the reference timer so captures can run for longer than it takes to
+ * wrap */
+static uint32_t last_time;
+static uint64_t elapsed;
+
+static netif_linkoutput_fn saved_linkoutput;
+
+static void put_le32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static void put_le16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t load16_be(const uint8_t *p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+static void ring_write(uint32_t pos, const uint8_t *data, uint32_t len) {
+  uint32_t offset = pos % XTCP_CAPTURE_RING_BYTES;
+  uint32_t first = XTCP_CAPTURE_RING_BYTES - offset;
+  if (first > len) {
+    first = len;
+  }
+  memcpy(&ring[offset], data, first);
+  memcpy(ring, &data[first], len - first);
+}
+
+static void ring_read(uint32_t pos, uint8_t *data, uint32_t len) {
+  uint32_t offset = pos % XTCP_CAPTURE_RING_BYTES;
+  uint32_t first = XTCP_CAPTURE_RING_BYTES - offset;
+  if (first > len) {
+    first = len;
+  }
+  memcpy(data, &ring[offset], first);
+  memcpy(&data[first], ring, len - first);
+}
+
+/* Length of the record at a position, from the captured length in its header */
+static uint32_t record_length(uint32_t pos) {
+  uint8_t incl_len[4];
+  ring_read(pos + 8, incl_len, sizeof(incl_len));
+  return XTCP_CAPTURE_RECORD_HEADER_LENGTH + (uint32_t)(incl_len[0] | (incl_len[1] << 8));
+}
+
+/* Ticks since capture_start() at a reference time */
+static uint64_t capture_time(uint32_t timestamp) {
+  int32_t delta = (int32_t)(timestamp - last_time);
+  if ((delta < 0) && (delta > -(int32_t)REORDER_TICKS)) {
+    uint32_t before = (uint32_t)(-delta);
+    return (elapsed > before) ? elapsed - before : 0;
+  }
+  elapsed += (uint32_t)(timestamp - last_time);
+  last_time = timestamp;
+  return elapsed;
+}
+
+static int port_match(const uint8_t *transport, uint16_t port) {
+  return (load16_be(&transport[0]) == port) || (load16_be(&transport[2]) == port);
+}
+
+static int filter_accept(unsigned direction, const uint8_t frame[], uint32_t len) {
+  if (!(filter.directions & direction) || (len < ETH_HEADER_SIZE)) {
+    return 0;
+  }
+  uint32_t offset = ETH_TYPE_OFFSET;
+  uint16_t type = load16_be(&frame[offset]);
+  if ((type == ETHTYPE_VLAN) && (len >= ETH_HEADER_SIZE + VLAN_TAG_SIZE)) {
+    offset += VLAN_TAG_SIZE;
+    type = load16_be(&frame[offset]);
+  }
+  if (filter.ethertype && (type != filter.ethertype)) {
+    return 0;
+  }
+
+  int any_addr = !(filter.ipaddr[0] | filter.ipaddr[1] | filter.ipaddr[2] | filter.ipaddr[3]);
+  const uint8_t *ip = &frame[offset + 2];
+  uint32_t ip_len = len - (offset + 2);
+  if ((type != ETHTYPE_IPV4) || (ip_len < 20) || ((ip[0] >> 4) != 4)) {
+    return !filter.ip_protocol && !filter.port && any_addr;
+  }
+
+  if (filter.ip_protocol && (ip[IP_PROTOCOL_OFFSET] != filter.ip_protocol)) {
+    return 0;
+  }
+  if (!any_addr && memcmp(&ip[IP_SRC_OFFSET], filter.ipaddr, 4) && memcmp(&ip[IP_DST_OFFSET], filter.ipaddr, 4)) {
+    return 0;
+  }
+  if (!filter.port && !filter.ignore_port) {
+    return 1;
+  }
+
+  // Ports are only in the first fragment of a TCP or UDP packet
+  uint32_t header_len = (uint32_t)(ip[0] & 0x0F) * 4;
+  int has_ports = ((ip[IP_PROTOCOL_OFFSET] == IP_PROTOCOL_TCP) || (ip[IP_PROTOCOL_OFFSET] == IP_PROTOCOL_UDP)) &&
+                  ((load16_be(&ip[IP_FRAGMENT_OFFSET]) & 0x1FFF) == 0) && (ip_len >= header_len + 4);
+  if (!has_ports) {
+    return !filter.port;
+  }
+  if (filter.ignore_port && port_match(&ip[header_len], filter.ignore_port)) {
+    return 0;
+  }
+  return !filter.port || port_match(&ip[header_len], filter.port);
+}
+
+/* Store a frame as a pcap record, overwriting the oldest records to make room */
+static void capture_store(const uint8_t frame[], uint32_t incl_len, uint32_t orig_len, uint32_t timestamp) {
+  uint8_t header[XTCP_CAPTURE_RECORD_HEADER_LENGTH];
+  uint32_t length = XTCP_CAPTURE_RECORD_HEADER_LENGTH + incl_len;
+
+  while (XTCP_CAPTURE_RING_BYTES - (head - tail) < length) {
+    tail += record_length(tail);
+    stats.overwritten++;
+  }
+
+  uint64_t ns = capture_time(timestamp) * NS_PER_TICK;
+  put_le32(&header[0], (uint32_t)(ns / 1000000000u));
+  put_le32(&header[4], (uint32_t)(ns % 1000000000u));
+  put_le32(&header[8], incl_len);
+  put_le32(&header[12], orig_len);
+  ring_write(head, header, sizeof(header));
+  ring_write(head + XTCP_CAPTURE_RECORD_HEADER_LENGTH, frame, incl_len);
+  head += length;
+
+  stats.captured++;
+  if (incl_len < orig_len) {
+    stats.truncated++;
+  }
+}
+
+/* Wraps the netif linkoutput while the capture is running, so every frame sent is seen, whichever path built it */
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t capture_linkoutput(struct netif *netif, struct pbuf *p) {
+  uint8_t frame[XTCP_CAPTURE_SNAPLEN];
+  uint32_t timestamp = get_reference_time();
+  uint16_t snap_len = (p->tot_len < XTCP_CAPTURE_SNAPLEN) ? p->tot_len : XTCP_CAPTURE_SNAPLEN;
+  uint16_t incl_len = pbuf_copy_partial(p, frame, snap_len, 0);
+
+  if (filter_accept(XTCP_CAPTURE_TX, frame, incl_len)) {
+    capture_store(frame, incl_len, p->tot_len, timestamp);
+  } else {
+    stats.filtered++;
+  }
+  return saved_linkoutput(netif, p);
+}
+
+void capture_init(void) {
+  head = tail = 0;
+  running = 0;
+  header_pending = 0;
+  saved_linkoutput = NULL;
+  memset(&stats, 0, sizeof(stats));
+}
+
+xtcp_error_code_t capture_start(const xtcp_capture_filter_t *new_filter, uint32_t now) {
+  if (!(new_filter->directions & (XTCP_CAPTURE_RX | XTCP_CAPTURE_TX))) {
+    return XTCP_EINVAL;
+  }
+  capture_stop();
+  filter = *new_filter;
+  head = tail = 0;
+  memset(&stats, 0, sizeof(stats));
+  last_time = now;
+  elapsed = 0;
+  header_pending = 1;
+
+  if (netif_default != NULL) {
+    saved_linkoutput = netif_default->linkoutput;
+    netif_default->linkoutput = capture_linkoutput;
+  }
+  running = 1;
+  return XTCP_SUCCESS;
+}
+
+void capture_stop(void) {
+  if (!running) {
+    return;
+  }
+  if ((netif_default != NULL) && (saved_linkoutput != NULL)) {
+    netif_default->linkoutput = saved_linkoutput;
+  }
+  saved_linkoutput = NULL;
+  running = 0;
+}
+
+void capture_rx(const uint8_t frame[], uint32_t len, uint32_t timestamp) {
+  if (!running) {
+    return;
+  }
+  if (filter_accept(XTCP_CAPTURE_RX, frame, len)) {
+    capture_store(frame, (len < XTCP_CAPTURE_SNAPLEN) ? len : XTCP_CAPTURE_SNAPLEN, len, timestamp);
+  } else {
+    stats.filtered++;
+  }
+}
+
+void capture_tick(uint32_t now) {
+  if (running) {
+    (void)capture_time(now);
+  }
+}
+
+int32_t capture_read(uint8_t buffer[], uint32_t length) {
+  if (length < XTCP_CAPTURE_READ_MIN) {
+    return XTCP_EINVAL;
+  }
+
+  uint32_t n = 0;
+  if (header_pending) {
+    put_le32(&buffer[0], PCAP_MAGIC_NANOSECONDS);
+    put_le16(&buffer[4], PCAP_VERSION_MAJOR);
+    put_le16(&buffer[6], PCAP_VERSION_MINOR);
+    put_le32(&buffer[8], 0);   // Timestamps are in UTC
+    put_le32(&buffer[12], 0);  // Accuracy of the timestamps
+    put_le32(&buffer[16], XTCP_CAPTURE_SNAPLEN);
+    put_le32(&buffer[20], PCAP_LINKTYPE_ETHERNET);
+    n = XTCP_CAPTURE_PCAP_HEADER_LENGTH;
+    header_pending = 0;
+  }
+
+  while (tail != head) {
+    uint32_t record = record_length(tail);
+    if (record > length - n) {
+      break;
+    }
+    ring_read(tail, &buffer[n], record);
+    tail += record;
+    n += record;
+  }
+  return (int32_t)n;
+}
+
+xtcp_capture_stats_t capture_get_stats(void) {
+  xtcp_capture_stats_t result = stats;
+  result.running = running;
+  result.pending_bytes = head - tail;
+  return result;
+}
+
+#else
+
+void capture_init(void) {}
+
+xtcp_error_code_t capture_start(const xtcp_capture_filter_t *new_filter, uint32_t now) {
+  (void)new_filter;
+  (void)now;
+  return XTCP_EPROTONOSUPPORT;
+}
+
+void capture_stop(void) {}
+
+void capture_rx(const uint8_t frame[], uint32_t len, uint32_t timestamp) {
+  (void)frame;
+  (void)len;
+  (void)timestamp;
+}
+
+void capture_tick(uint32_t now) { (void)now; }
+
+int32_t capture_read(uint8_t buffer[], uint32_t length) {
+  (void)buffer;
+  return (length < XTCP_CAPTURE_READ_MIN) ? XTCP_EINVAL : 0;
+}
+
+xtcp_capture_stats_t capture_get_stats(void) {
+  xtcp_capture_stats_t result;
+  memset(&result, 0, sizeof(result));
+  return result;
+}
+
+#endif /* XTCP_CAPTURE_ENABLE */
@@ -0,0 +1,69 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_CAPTURE_H
+#define XTCP_CAPTURE_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Size of the buffer the stack reads the ring into for read_capture(), at least XTCP_CAPTURE_READ_MIN */
+#define CAPTURE_READ_MAX (XTCP_CAPTURE_READ_MIN > 1500 ? XTCP_CAPTURE_READ_MIN : 1500)
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Initialise the packet capture, stopped with an empty ring */
+void capture_init(void);
+
+/** Start capturing, clearing the ring and statistics and wrapping the linkoutput of the default netif.
+ *
+ * \param filter    The frames to keep.
+ * \param now       The reference time the capture's timestamps count from.
+ * \returns         XTCP_SUCCESS, XTCP_EINVAL if the filter selects no direction, or XTCP_EPROTONOSUPPORT when
+ *                  XTCP_CAPTURE_ENABLE is 0.
+ */
+xtcp_error_code_t capture_start(const REFERENCE_PARAM(xtcp_capture_filter_t, filter), uint32_t now);
+
+/** Stop capturing and restore the linkoutput of the default netif */
+void capture_stop(void);
+
+/** Capture a received frame, if the capture is running.
+ *
+ * \param frame     The frame, starting with the Ethernet header.
+ * \param len       The length of the frame in bytes.
+ * \param timestamp The reference time the frame was received.
+ */
+void capture_rx(const uint8_t frame[], uint32_t len, uint32_t timestamp);
+
+/** Bring the capture's clock up to the reference time, called at least once a second so timestamps survive the
+ * timer wrapping while no frames are captured */
+void capture_tick(uint32_t now);
+
+/** Read the pcap file header, if not yet read since capture_start(), and whole records from the ring.
+ *
+ * \param buffer    The buffer to read into.
+ * \param length    The length of the buffer.
+ * \returns         The number of bytes read, or XTCP_EINVAL if length is less than XTCP_CAPTURE_READ_MIN.
+ */
+int32_t capture_read(uint8_t buffer[], uint32_t length);
+
+/** Get the packet capture statistics */
+xtcp_capture_stats_t capture_get_stats(void);
+
+#ifdef __XC__
+}
+#endif
+
+/** The hooks called by the stack, compiled out when the capture is not built */
+#if XTCP_CAPTURE_ENABLE
+#define CAPTURE_RX(frame, len, timestamp) capture_rx(frame, len, timestamp)
+#define CAPTURE_TICK(now) capture_tick(now)
+#else
+#define CAPTURE_RX(frame, len, timestamp) do {} while (0)
+#define CAPTURE_TICK(now) do {} while (0)
+#endif
+
+#endif /* XTCP_CAPTURE_H */
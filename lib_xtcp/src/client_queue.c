@@ -5,19 +5,54 @@
 
 #include <string.h>
 
+#include <xcore/hwtimer.h>
+
+#include "client_sched.h"
 #include "debug_print.h"
 #include "netif/configure.h"
+#include "trace.h"
 #include "xtcp.h"
 
 /* A 2D array of queue items */
-static client_event_t client_queue[MAX_XTCP_CLIENTS][CLIENT_QUEUE_SIZE] = {{{.xtcp_event = 0, .id = 0}}};
+static client_event_t client_queue[MAX_XTCP_CLIENTS][CLIENT_QUEUE_SIZE] = {{{.xtcp_event = 0, .id = 0, .length = 0}}};
 static int32_t client_heads[MAX_XTCP_CLIENTS] = {0};
 static int32_t client_num_events[MAX_XTCP_CLIENTS] = {0};
+static xtcp_client_queue_stats_t client_stats[MAX_XTCP_CLIENTS];
+
+#if XTCP_EVENT_LATENCY_ENABLE
+static xtcp_event_latency_t client_latency[MAX_XTCP_CLIENTS][XTCP_EVENT_TYPES];
+
+/* Reference clock ticks per microsecond */
+#define TICKS_PER_US 100
+
+/* Bucket 0 for under a microsecond, then one bucket per power of two microseconds, the last taking the rest */
+static unsigned latency_bucket(uint32_t us) {
+  unsigned bucket = (us == 0) ? 0 : (32 - __builtin_clz(us));
+  return (bucket < XTCP_EVENT_LATENCY_BUCKETS) ? bucket : (XTCP_EVENT_LATENCY_BUCKETS - 1);
+}
+
+static void record_latency(unsigned client_num, const client_event_t *event) {
+  if ((unsigned)event->xtcp_event < XTCP_EVENT_TYPES) {
+    uint32_t us = (get_reference_time() - event->timestamp) / TICKS_PER_US;
+    xtcp_event_latency_t *latency = &client_latency[client_num][event->xtcp_event];
+    latency->count++;
+    latency->total_us += us;
+    if (us > latency->max_us) {
+      latency->max_us = us;
+    }
+    latency->buckets[latency_bucket(us)]++;
+  }
+}
+#endif /* XTCP_EVENT_LATENCY_ENABLE */
 
 void xtcp_init_queue(void) {
   memset(client_queue, 0, sizeof(client_queue));
   memset(client_heads, 0, sizeof(client_heads));
   memset(client_num_events, 0, sizeof(client_num_events));
+  memset(client_stats, 0, sizeof(client_stats));
+#if XTCP_EVENT_LATENCY_ENABLE
+  memset(client_latency, 0, sizeof(client_latency));
+#endif
 }
 
 void renotify(unsigned client_num) {
@@ -32,36 +67,61 @@ client_event_t dequeue_event(unsigned client_num) {
   if ((client_num < MAX_XTCP_CLIENTS) && (client_num_events[client_num] > 0)) {
     // TODO - refactor queue implementation
     client_num_events[client_num]--;
+    client_sched_queued(client_num, -1);
     int32_t position = client_heads[client_num];
     client_heads[client_num] = (client_heads[client_num] + 1) % CLIENT_QUEUE_SIZE;
+    TRACE(TRACE_EVENT_TAKEN, client_num, client_queue[client_num][position].id,
+          client_queue[client_num][position].xtcp_event, client_num_events[client_num]);
+#if XTCP_EVENT_LATENCY_ENABLE
+    record_latency(client_num, &client_queue[client_num][position]);
+#endif
     return client_queue[client_num][position];
   } else {
     // Return a dummy event if the queue is empty
-    client_event_t empty = {.xtcp_event = XTCP_EVENT_NONE, .id = -1};
+    client_event_t empty = {.xtcp_event = XTCP_EVENT_NONE, .id = -1, .length = 0};
     return empty;
   }
 }
 
 xtcp_error_code_t enqueue_event_and_notify(unsigned client_num, int32_t id, xtcp_event_type_t xtcp_event) {
+  return enqueue_event_length_and_notify(client_num, id, xtcp_event, 0);
+}
+
+xtcp_error_code_t enqueue_event_length_and_notify(unsigned client_num, int32_t id, xtcp_event_type_t xtcp_event,
+                                                  uint32_t length) {
   xtcp_error_code_t result = XTCP_EINVAL;
   if (client_num < MAX_XTCP_CLIENTS) {
     if (client_num_events[client_num] < CLIENT_QUEUE_SIZE) {
       unsigned position = (client_heads[client_num] + client_num_events[client_num]) % CLIENT_QUEUE_SIZE;
       client_queue[client_num][position].xtcp_event = xtcp_event;
       client_queue[client_num][position].id = id;
+      client_queue[client_num][position].length = length;
+#if XTCP_EVENT_LATENCY_ENABLE
+      client_queue[client_num][position].timestamp = get_reference_time();
+#endif
 
       client_num_events[client_num]++;
+      client_sched_queued(client_num, 1);
+      client_stats[client_num].queued++;
+      if ((uint32_t)client_num_events[client_num] > client_stats[client_num].high_water) {
+        client_stats[client_num].high_water = client_num_events[client_num];
+      }
+      TRACE(TRACE_EVENT_QUEUED, client_num, id, xtcp_event, client_num_events[client_num]);
 
       client_intf_notify(client_num);
       result = XTCP_SUCCESS;
     } else {
+      TRACE(TRACE_EVENT_DROPPED, client_num, id, xtcp_event, 0);
+      client_stats[client_num].dropped++;
       result = XTCP_ENOMEM;
     }
   }
   return result;
 }
 
-int32_t free_notifications_on_queue(unsigned client_num, int32_t id) {
+/* Removes up to max events for the connection, keeping the order of the rest. When recv_only is set only receive
+ * events are removed. */
+static int32_t remove_events(unsigned client_num, int32_t id, int recv_only, int32_t max) {
   int32_t result = 0;
 
   if (client_num < MAX_XTCP_CLIENTS) {
@@ -70,7 +130,10 @@ int32_t free_notifications_on_queue(unsigned client_num, int32_t id) {
     int32_t count = client_num_events[client_num];
 
     for (int32_t i = 0; i < count; ++i) {
-      if (client_queue[client_num][read_index].id == id) {
+      client_event_t *event = &client_queue[client_num][read_index];
+      int is_recv = (event->xtcp_event == XTCP_RECV_DATA) || (event->xtcp_event == XTCP_RECV_FROM_DATA);
+
+      if ((event->id == id) && (!recv_only || is_recv) && (result < max)) {
         // Remove matches
         result += 1;
         // Found match on 'id', so remove this event from the queue
@@ -79,7 +142,7 @@ int32_t free_notifications_on_queue(unsigned client_num, int32_t id) {
       } else {
         // Move non-matches to the write index
         if (write_index != read_index) {
-          client_queue[client_num][write_index] = client_queue[client_num][read_index];
+          client_queue[client_num][write_index] = *event;
         }
         write_index += 1;
         if (write_index >= CLIENT_QUEUE_SIZE) {
@@ -91,8 +154,50 @@ int32_t free_notifications_on_queue(unsigned client_num, int32_t id) {
         read_index = 0;
       }
     }
+    client_sched_queued(client_num, -result);
   }
   return result;
 }
 
+int32_t free_notifications_on_queue(unsigned client_num, int32_t id) {
+  return remove_events(client_num, id, 0, CLIENT_QUEUE_SIZE);
+}
+
+int32_t free_recv_notifications_on_queue(unsigned client_num, int32_t id, int32_t keep) {
+  int32_t queued = 0;
+
+  if (client_num < MAX_XTCP_CLIENTS) {
+    for (int32_t i = 0; i < client_num_events[client_num]; ++i) {
+      client_event_t *event = &client_queue[client_num][(client_heads[client_num] + i) % CLIENT_QUEUE_SIZE];
+      if ((event->id == id) && ((event->xtcp_event == XTCP_RECV_DATA) || (event->xtcp_event == XTCP_RECV_FROM_DATA))) {
+        queued++;
+      }
+    }
+  }
+  return (queued > keep) ? remove_events(client_num, id, 1, queued - keep) : 0;
+}
+
+xtcp_client_queue_stats_t client_queue_get_stats(unsigned client_num) {
+  xtcp_client_queue_stats_t stats = {0};
+  if (client_num < MAX_XTCP_CLIENTS) {
+    stats = client_stats[client_num];
+    stats.depth = client_num_events[client_num];
+  }
+  return stats;
+}
+
+xtcp_event_latency_t client_queue_get_latency(unsigned client_num, xtcp_event_type_t event) {
+  xtcp_event_latency_t latency;
+  memset(&latency, 0, sizeof(latency));
+#if XTCP_EVENT_LATENCY_ENABLE
+  if ((client_num < MAX_XTCP_CLIENTS) && ((unsigned)event < XTCP_EVENT_TYPES)) {
+    latency = client_latency[client_num][event];
+  }
+#else
+  (void)client_num;
+  (void)event;
+#endif
+  return latency;
+}
+
 __attribute__((weak)) void client_intf_notify(unsigned client_num) { (void)client_num; }
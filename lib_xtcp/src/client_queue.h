@@ -10,6 +10,8 @@
 typedef struct client_event_s {
   xtcp_event_type_t xtcp_event; /*!< XTCP event to notify the client of */
   int32_t id; /*!< Connection identifier the event relates to */
+  uint32_t length; /*!< Bytes acknowledged for XTCP_SENT_DATA and XTCP_SENT_STATIC, otherwise 0 */
+  uint32_t timestamp; /*!< Reference time the event was queued, when XTCP_EVENT_LATENCY_ENABLE is set */
 } client_event_t;
 
 /** Initialize the client event queue */
@@ -41,6 +43,20 @@ client_event_t dequeue_event(unsigned client_num);
  */
 xtcp_error_code_t enqueue_event_and_notify(unsigned client_num, int32_t id, xtcp_event_type_t xtcp_event);
 
+/** Enqueue an event with a length for a client and notify them
+ *
+ * \param client_num  The client to enqueue an event for.
+ * \param id          The connection identifier the event relates to.
+ * \param xtcp_event  The event to enqueue.
+ * \param length      The length given to the client with the event.
+ *
+ * \retval XTCP_SUCCESS If the event was successfully enqueued.
+ * \retval XTCP_ENOMEM  If the client's event queue is full, the event will be dropped.
+ * \retval XTCP_EINVAL  If the client number is invalid.
+ */
+xtcp_error_code_t enqueue_event_length_and_notify(unsigned client_num, int32_t id, xtcp_event_type_t xtcp_event,
+                                                  uint32_t length);
+
 /** Free any pending notifications on a client's event queue for a particular connection
  * 
  * This is typically used during close/abort to remove any pending events for a connection that is being closed.
@@ -56,6 +72,39 @@ xtcp_error_code_t enqueue_event_and_notify(unsigned client_num, int32_t id, xtcp
  */
 int32_t free_notifications_on_queue(unsigned client_num, int32_t id);
 
+/** Free the receive notifications for data a client has already taken from a connection
+ *
+ * Each queued datagram has one receive event. A batched receive takes several datagrams in one call, this removes
+ * the oldest XTCP_RECV_DATA and XTCP_RECV_FROM_DATA events for the connection until no more are left than datagrams
+ * still queued, so the client is not notified of data that has gone.
+ *
+ * \param client_num  The client to free notifications for.
+ * \param id          The connection identifier to free notifications for.
+ * \param keep        The number of datagrams still queued on the connection.
+ *
+ * \returns The number of events freed.
+ */
+int32_t free_recv_notifications_on_queue(unsigned client_num, int32_t id, int32_t keep);
+
+/** Get the event queue statistics of a client
+ *
+ * \param client_num The client to get the statistics of.
+ *
+ * \returns The events queued and dropped, and the current depth and high-water mark of the queue. All zero if the
+ *          client number is invalid.
+ */
+xtcp_client_queue_stats_t client_queue_get_stats(unsigned client_num);
+
+/** Get the latency histogram of one type of event for a client
+ *
+ * \param client_num The client to get the histogram of.
+ * \param event      The type of event.
+ *
+ * \returns The histogram of the time from events being queued to being dequeued. All zero if the client number or
+ *          event type is invalid, or XTCP_EVENT_LATENCY_ENABLE is 0.
+ */
+xtcp_event_latency_t client_queue_get_latency(unsigned client_num, xtcp_event_type_t event);
+
 #ifndef __XC__
 /**
  * Configure callback called during TCP/IP stack operations when events occur that require client notification.
@@ -0,0 +1,164 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "client_sched.h"
+
+#include <stdint.h>
+
+#if XTCP_CLIENT_SCHED_ENABLE
+
+static xtcp_client_sched_t config[MAX_XTCP_CLIENTS];
+static uint32_t credit[MAX_XTCP_CLIENTS];
+static uint32_t waiting[MAX_XTCP_CLIENTS];  // Iterations a high-priority client's events have been queued
+static int32_t depth[MAX_XTCP_CLIENTS];     // Events queued for each client
+static int32_t high_depth;                  // Events queued for the high-priority clients, none needs no checks
+static unsigned high_clients;               // Number of high-priority clients
+static unsigned exhausted;                  // Number of clients with no credit left in the round
+static uint32_t round_iterations;           // Iterations since a client used its credit in this round
+static int holding;                         // Normal-priority send calls held for a high-priority client
+static uint32_t held_iterations;            // Iterations the current hold has lasted
+
+void client_sched_init(void) {
+  for (unsigned i = 0; i < MAX_XTCP_CLIENTS; ++i) {
+    config[i].weight = (XTCP_CLIENT_WEIGHT > 0) ? XTCP_CLIENT_WEIGHT : 1;
+    config[i].priority = XTCP_PRIORITY_NORMAL;
+    waiting[i] = 0;
+    depth[i] = 0;
+  }
+  high_depth = 0;
+  high_clients = 0;
+  holding = 0;
+  held_iterations = 0;
+  client_sched_idle();
+}
+
+xtcp_error_code_t client_sched_set(unsigned client_num, xtcp_client_sched_t sched) {
+  if ((client_num >= MAX_XTCP_CLIENTS) || (sched.priority > XTCP_PRIORITY_HIGH)) {
+    return XTCP_EINVAL;
+  }
+  if (config[client_num].priority == XTCP_PRIORITY_HIGH) {
+    high_clients--;
+    high_depth -= depth[client_num];
+  }
+  if (sched.priority == XTCP_PRIORITY_HIGH) {
+    high_clients++;
+    high_depth += depth[client_num];
+  }
+  config[client_num].weight = sched.weight ? sched.weight : 1;
+  config[client_num].priority = sched.priority;
+  waiting[client_num] = 0;
+  client_sched_idle();
+  return XTCP_SUCCESS;
+}
+
+int client_sched_may_send(unsigned client_num) {
+  if (client_num >= MAX_XTCP_CLIENTS) {
+    return 0;
+  }
+  if (holding && (config[client_num].priority != XTCP_PRIORITY_HIGH)) {
+    return 0;
+  }
+  return credit[client_num] > 0;
+}
+
+void client_sched_sent(unsigned client_num) {
+  if ((client_num < MAX_XTCP_CLIENTS) && (credit[client_num] > 0)) {
+    credit[client_num]--;
+    if (credit[client_num] == 0) {
+      exhausted++;
+    }
+  }
+}
+
+void client_sched_served(unsigned client_num) {
+  if ((client_num < MAX_XTCP_CLIENTS) && (config[client_num].priority == XTCP_PRIORITY_HIGH)) {
+    waiting[client_num] = 0;
+  }
+}
+
+void client_sched_queued(unsigned client_num, int32_t change) {
+  if (client_num >= MAX_XTCP_CLIENTS) {
+    return;
+  }
+  depth[client_num] += change;
+  if (config[client_num].priority == XTCP_PRIORITY_HIGH) {
+    high_depth += change;
+    if (depth[client_num] == 0) {
+      waiting[client_num] = 0;
+    }
+  }
+}
+
+void client_sched_iteration(void) {
+  // A round that never sees an idle loop still ends, so a busy network cannot hold the send calls for ever
+  if ((exhausted > 0) && (++round_iterations >= XTCP_CLIENT_HOLD_MAX)) {
+    client_sched_idle();
+  }
+  if (high_depth == 0) {
+    holding = 0;
+    held_iterations = 0;
+    return;
+  }
+  int overdue = 0;
+  for (unsigned i = 0; i < MAX_XTCP_CLIENTS; ++i) {
+    if ((config[i].priority == XTCP_PRIORITY_HIGH) && (depth[i] > 0) &&
+        (++waiting[i] >= XTCP_CLIENT_PRIORITY_BOUND)) {
+      overdue = 1;
+    }
+  }
+  if (overdue && (++held_iterations > XTCP_CLIENT_HOLD_MAX)) {
+    // The high-priority client is not taking its events, let the others send before it waits its bound again
+    for (unsigned i = 0; i < MAX_XTCP_CLIENTS; ++i) {
+      waiting[i] = 0;
+    }
+    overdue = 0;
+  }
+  if (!overdue) {
+    held_iterations = 0;
+  }
+  holding = overdue;
+}
+
+int client_sched_throttled(void) { return exhausted > 0; }
+
+void client_sched_idle(void) {
+  // A hold is only released by the high-priority client taking its events, or at its limit, see
+  // client_sched_iteration()
+  for (unsigned i = 0; i < MAX_XTCP_CLIENTS; ++i) {
+    credit[i] = config[i].weight;
+  }
+  exhausted = 0;
+  round_iterations = 0;
+}
+
+#else
+
+void client_sched_init(void) {}
+
+xtcp_error_code_t client_sched_set(unsigned client_num, xtcp_client_sched_t sched) {
+  (void)client_num;
+  (void)sched;
+  return XTCP_SUCCESS;
+}
+
+int client_sched_may_send(unsigned client_num) {
+  (void)client_num;
+  return 1;
+}
+
+void client_sched_sent(unsigned client_num) { (void)client_num; }
+
+void client_sched_served(unsigned client_num) { (void)client_num; }
+
+void client_sched_queued(unsigned client_num, int32_t change) {
+  (void)client_num;
+  (void)change;
+}
+
+void client_sched_iteration(void) {}
+
+int client_sched_throttled(void) { return 0; }
+
+void client_sched_idle(void) {}
+
+#endif /* XTCP_CLIENT_SCHED_ENABLE */
@@ -0,0 +1,66 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_CLIENT_SCHED_H
+#define XTCP_CLIENT_SCHED_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/* Weighted servicing of client send calls in the select loop of xtcp_lwip(). The send cases are guarded by
+ * client_sched_may_send(), each client being served its weight of calls in a round. A round ends when the loop has
+ * nothing else to do, taken as the last case of its [[ordered]] select, so a client sending alone is never held back.
+ * The send calls of normal-priority clients are also held while the queued events of a high-priority client have
+ * waited XTCP_CLIENT_PRIORITY_BOUND iterations, until it takes them or XTCP_CLIENT_HOLD_MAX iterations pass. A round
+ * also ends after XTCP_CLIENT_HOLD_MAX iterations. The select is only ordered when XTCP_CLIENT_SCHED_ENABLE is set. */
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Initialise every client with a weight of XTCP_CLIENT_WEIGHT and normal priority, starting a round */
+void client_sched_init(void);
+
+/** Set the weight and priority of a client, a weight of zero is taken as one.
+ *
+ * \param client_num  The client.
+ * \param sched       The weight and priority.
+ * \returns           XTCP_SUCCESS, or XTCP_EINVAL if the client number or priority is invalid.
+ */
+xtcp_error_code_t client_sched_set(unsigned client_num, xtcp_client_sched_t sched);
+
+/** Check whether a client may be served a send call in this iteration of the loop.
+ *
+ * \param client_num  The client.
+ * \returns           Non-zero if the client has credit left in the round and is not held for a high-priority client.
+ */
+int client_sched_may_send(unsigned client_num);
+
+/** Take a send call from the client's credit for the round */
+void client_sched_sent(unsigned client_num);
+
+/** Note that a client has taken an event, so a high-priority client has been served */
+void client_sched_served(unsigned client_num);
+
+/** Count a change in the number of events queued for a client, called by the client queue */
+void client_sched_queued(unsigned client_num, int32_t change);
+
+/** Count an iteration of the loop against the high-priority clients with queued events, holding the send calls of
+ * normal-priority clients once one has waited XTCP_CLIENT_PRIORITY_BOUND iterations, for at most
+ * XTCP_CLIENT_HOLD_MAX iterations. A round that has lasted XTCP_CLIENT_HOLD_MAX iterations is ended. */
+void client_sched_iteration(void);
+
+/** Check whether any client has used its credit for the round, so the loop should call client_sched_idle() when it
+ * has nothing else to do */
+int client_sched_throttled(void);
+
+/** Start a new round, restoring every client's credit, as the loop has nothing else to do. Send calls held for a
+ * high-priority client stay held while its events are queued, up to XTCP_CLIENT_HOLD_MAX iterations. */
+void client_sched_idle(void);
+
+#ifdef __XC__
+}
+#endif
+
+#endif /* XTCP_CLIENT_SCHED_H */
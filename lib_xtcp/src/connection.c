@@ -4,7 +4,10 @@
 #include "connection.h"
 
 #include <stdint.h>
+#include <string.h>
 
+#include "static_send.h"
+#include "trace.h"
 #include "xtcp.h"
 
 /* Lwip headers */
@@ -20,12 +23,72 @@ typedef struct connection_entry_s {
   } pcb;
   struct pbuf *pbuf;          // UDP/TCP, Pointer to pbuf data received.
   void * unsafe client_data;  // Pointer to additional client data
+  uint32_t rx_bytes;          // Bytes held in the pbuf queue, charged to client_num
+  uint32_t tx_bytes;          // TCP bytes written but not yet acknowledged, charged to client_num
+  uint32_t acked_bytes;       // TCP bytes acknowledged and not yet reported by a XTCP_SENT_DATA event
+  uint32_t send_lowat;        // Free send space needed to raise XTCP_SENT_DATA, zero raises one per acknowledgement
+  int32_t writable_armed;     // Data has been sent since the last XTCP_SENT_DATA raised with a send low watermark
+  uint32_t recv_lowat;        // Queued bytes needed to raise XTCP_RECV_DATA, zero raises one per pbuf
+  uint32_t recv_held;         // Queued pbufs with their XTCP_RECV_DATA event held by the receive low watermark
 } connection_entry_t;
 
 #define DEINIT UINT32_MAX
 
 static connection_entry_t connections[MAX_OPEN_SOCKETS];
 
+/* A UDP datagram held in a chain of pbufs is copied here to give the client one contiguous payload */
+static uint32_t rx_datagram[(XTCP_UDP_MAX_DATAGRAM_SIZE + 3) / 4];
+
+/* Per-client limits and current usage, indexed by client number */
+static xtcp_client_usage_t client_usage[MAX_XTCP_CLIENTS];
+
+/* The smallest non-zero receive quota, the larger of a full TCP segment and a UDP datagram. Anything less refuses
+ * every receive. */
+#define CLIENT_MIN_RX_BYTES ((TCP_MSS > XTCP_UDP_MAX_DATAGRAM_SIZE) ? TCP_MSS : XTCP_UDP_MAX_DATAGRAM_SIZE)
+
+static inline int quota_exceeded(uint32_t limit, uint32_t used, uint32_t request) {
+  // A limit of zero means unlimited
+  return (limit != 0) && ((used + request) > limit);
+}
+
+static void release_rx_bytes(int32_t index, uint32_t length) {
+  unsigned client_num = connections[index].client_num;
+  if (length > connections[index].rx_bytes) {
+    length = connections[index].rx_bytes;
+  }
+  connections[index].rx_bytes -= length;
+  if (client_num < MAX_XTCP_CLIENTS) {
+    client_usage[client_num].rx_bytes -= length;
+  }
+}
+
+/* Queued packets are linked through pbuf->next, as an lwIP packet queue. The last pbuf of each packet has tot_len
+ * equal to len, so a packet in a chain of pbufs can be told apart from the packet after it. */
+static struct pbuf *packet_last(struct pbuf *pbuf) {
+  while ((pbuf->tot_len != pbuf->len) && (pbuf->next != NULL)) {
+    pbuf = pbuf->next;
+  }
+  return pbuf;
+}
+
+/* The last pbuf of the first entry in a connection's queue. A UDP entry is a whole datagram, a TCP entry is one pbuf
+ * of the stream. */
+static struct pbuf *entry_last(int32_t index, struct pbuf *pbuf) {
+  return (connections[index].protocol == XTCP_PROTOCOL_UDP) ? packet_last(pbuf) : pbuf;
+}
+
+static uint32_t entry_length(int32_t index, struct pbuf *pbuf) {
+  return (connections[index].protocol == XTCP_PROTOCOL_UDP) ? pbuf->tot_len : pbuf->len;
+}
+
+static void reset_events(int32_t index) {
+  connections[index].acked_bytes = 0;
+  connections[index].send_lowat = 0;
+  connections[index].writable_armed = 1;
+  connections[index].recv_lowat = 0;
+  connections[index].recv_held = 0;
+}
+
 void init_client_connections(void) {
   for (int32_t i = 0; i < MAX_OPEN_SOCKETS; ++i) {
     connections[i].is_active = 0;
@@ -34,7 +97,37 @@ void init_client_connections(void) {
     connections[i].pcb.tcp = NULL;
     connections[i].pbuf = NULL;
     connections[i].client_data = NULL;
+    connections[i].rx_bytes = 0;
+    connections[i].tx_bytes = 0;
+    reset_events(i);
+  }
+  memset(client_usage, 0, sizeof(client_usage));
+}
+
+xtcp_error_code_t set_client_quota(unsigned client_num, xtcp_client_quota_t quota) {
+  if (client_num < MAX_XTCP_CLIENTS) {
+    if ((quota.max_rx_bytes != 0) && (quota.max_rx_bytes < CLIENT_MIN_RX_BYTES)) {
+      return XTCP_EINVAL;
+    }
+    // A receive watermark above the quota would never be reached
+    for (int32_t i = 0; (quota.max_rx_bytes != 0) && (i < MAX_OPEN_SOCKETS); ++i) {
+      if (connections[i].is_active && (connections[i].client_num == client_num) &&
+          (connections[i].recv_lowat > quota.max_rx_bytes)) {
+        return XTCP_EINVAL;
+      }
+    }
+    client_usage[client_num].quota = quota;
+    return XTCP_SUCCESS;
   }
+  return XTCP_EINVAL;
+}
+
+xtcp_client_usage_t get_client_usage(unsigned client_num) {
+  xtcp_client_usage_t usage = {.quota = {0, 0, 0}, .sockets = 0, .rx_bytes = 0, .tx_bytes = 0};
+  if (client_num < MAX_XTCP_CLIENTS) {
+    usage = client_usage[client_num];
+  }
+  return usage;
 }
 
 xtcp_error_int32_t find_client_connection(unsigned client_num, int32_t id) {
@@ -60,11 +153,32 @@ void clear_pending_rx_data_on_connection(int32_t index) {
       pbuf_free(connections[index].pbuf);
       connections[index].pbuf = NULL;
     }
+    release_rx_bytes(index, connections[index].rx_bytes);
   }
 }
 
 void free_client_connection(int32_t index) {
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    unsigned client_num = connections[index].client_num;
+
+    // Any data still queued belongs to a PCB that is going away, so drop it without tcp_recved()
+    struct pbuf *pbuf = connections[index].pbuf;
+    while (pbuf != NULL) {
+      struct pbuf *next = pbuf->next;
+      pbuf->next = NULL;
+      pbuf_free(pbuf);
+      pbuf = next;
+    }
+    connections[index].pbuf = NULL;
+    release_rx_bytes(index, connections[index].rx_bytes);
+    release_tx_bytes(index, connections[index].tx_bytes);
+    static_send_forget(index);
+
+    if ((client_num < MAX_XTCP_CLIENTS) && connections[index].is_active &&
+        (client_usage[client_num].sockets > 0)) {
+      client_usage[client_num].sockets--;
+    }
+
     connections[index].is_active = 0;
     connections[index].client_num = DEINIT;
     connections[index].protocol = XTCP_PROTOCOL_NONE;
@@ -76,6 +190,14 @@ void free_client_connection(int32_t index) {
 xtcp_error_int32_t assign_client_connection(unsigned client_num, xtcp_protocol_t protocol) {
   static int32_t last_guid = 0;
   xtcp_error_int32_t result = {.status = XTCP_ENOMEM, .value = -1};
+
+  if (client_num < MAX_XTCP_CLIENTS) {
+    xtcp_client_usage_t *usage = &client_usage[client_num];
+    if (quota_exceeded(usage->quota.max_sockets, usage->sockets, 1)) {
+      return result;
+    }
+  }
+
   // Find a free connection
   for (int32_t i = 0; i < MAX_OPEN_SOCKETS; ++i) {
     int32_t index = last_guid + i;
@@ -95,6 +217,12 @@ xtcp_error_int32_t assign_client_connection(unsigned client_num, xtcp_protocol_t
     connections[index].client_num = client_num;
     connections[index].protocol = protocol;
     connections[index].pcb.tcp = NULL;
+    connections[index].rx_bytes = 0;
+    connections[index].tx_bytes = 0;
+    reset_events(index);
+    if (client_num < MAX_XTCP_CLIENTS) {
+      client_usage[client_num].sockets++;
+    }
   }
   return result;
 }
@@ -160,7 +288,17 @@ unsigned get_client_info(int32_t index) {
 xtcp_error_code_t set_remote(int32_t index, const ip_addr_t *remote, uint16_t port_number, struct pbuf *pbuf) {
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
     if (pbuf != NULL) {
-      
+      unsigned client_num = connections[index].client_num;
+      if (client_num < MAX_XTCP_CLIENTS) {
+        xtcp_client_usage_t *usage = &client_usage[client_num];
+        // A client holding nothing always takes the pbuf, lwIP can merge segments into more than the quota
+        if ((usage->rx_bytes != 0) && quota_exceeded(usage->quota.max_rx_bytes, usage->rx_bytes, pbuf->tot_len)) {
+          return XTCP_ENOMEM;
+        }
+        usage->rx_bytes += pbuf->tot_len;
+      }
+      connections[index].rx_bytes += pbuf->tot_len;
+
       if (remote != NULL) {
         memcpy(pbuf->remote.ipaddr, remote, sizeof(ip_addr_t));
       } else {
@@ -241,11 +379,18 @@ xtcp_error_int32_t get_remote_data(int32_t index, uint8_t **data, int32_t length
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
     struct pbuf *pbuf = connections[index].pbuf;
     if (pbuf != NULL) {
-      if (length < pbuf->len) {
+      int32_t copy_length = entry_length(index, pbuf);
+      int chained = (copy_length > pbuf->len);
+      if ((length < copy_length) || (chained && (copy_length > (int32_t)sizeof(rx_datagram)))) {
         result.status = XTCP_EAGAIN;
       } else {
-        int32_t copy_length = pbuf->len;
-        *data = pbuf->payload;
+        if (chained) {
+          // A datagram from IP reassembly, or larger than PBUF_POOL_BUFSIZE, is spread over a chain of pbufs
+          pbuf_copy_partial(pbuf, rx_datagram, (u16_t)copy_length, 0);
+          *data = (uint8_t *)rx_datagram;
+        } else {
+          *data = pbuf->payload;
+        }
 
         result.status = XTCP_SUCCESS;
         result.value = copy_length;
@@ -261,17 +406,20 @@ int32_t free_remote_data(int32_t index) {
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
     struct pbuf *pbuf = connections[index].pbuf;
     if (pbuf != NULL) {
-      // Remove the first pbuf from the queue and free it
-      uint16_t length = pbuf->len;
-      connections[index].pbuf = pbuf->next;
-      pbuf->next = NULL;
+      // Remove the first entry from the queue and free it
+      uint32_t length = entry_length(index, pbuf);
+      struct pbuf *last = entry_last(index, pbuf);
+      connections[index].pbuf = last->next;
+      last->next = NULL;
+      TRACE(TRACE_PBUF_FREE, TRACE_NO_CLIENT, index, length, (uintptr_t)pbuf);
       pbuf_free(pbuf);
+      release_rx_bytes(index, length);
 
       if (connections[index].protocol == XTCP_PROTOCOL_TCP) {
         // For TCP we need to indicate to LwIP that we have processed the data
         struct tcp_pcb* tcp_pcb = get_tcp_pcb(index);
         if (tcp_pcb != NULL) {
-          tcp_recved(tcp_pcb, length);
+          tcp_recved(tcp_pcb, (u16_t)length);
         }
       }
       return XTCP_SUCCESS;
@@ -280,6 +428,30 @@ int32_t free_remote_data(int32_t index) {
   return XTCP_EINVAL;
 }
 
+int32_t count_remote_data(int32_t index) {
+  int32_t count = 0;
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    for (struct pbuf *pbuf = connections[index].pbuf; pbuf != NULL; pbuf = entry_last(index, pbuf)->next) {
+      count++;
+    }
+  }
+  return count;
+}
+
+uint32_t count_remote_bytes(int32_t index, uint32_t length) {
+  uint32_t total = 0;
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    for (struct pbuf *pbuf = connections[index].pbuf; pbuf != NULL; pbuf = entry_last(index, pbuf)->next) {
+      uint32_t entry = entry_length(index, pbuf);
+      if (total + entry > length) {
+        break;
+      }
+      total += entry;
+    }
+  }
+  return total;
+}
+
 xtcp_error_code_t unlink_remote(int32_t index, struct pbuf *pbuf) {
   xtcp_error_code_t result = XTCP_EINVAL;
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS) && (pbuf != NULL)) {
@@ -288,14 +460,16 @@ xtcp_error_code_t unlink_remote(int32_t index, struct pbuf *pbuf) {
 
     for (current = connections[index].pbuf; current != NULL; current = current->next) {
       if (current == pbuf) {
-        // Found the pbuf to unlink
+        // Found the packet to unlink, lwIP keeps every pbuf of it
+        struct pbuf *last = packet_last(current);
         if (previous == NULL) {
           // It's the first pbuf in the list
-          connections[index].pbuf = current->next;
+          connections[index].pbuf = last->next;
         } else {
-          previous->next = current->next;
+          previous->next = last->next;
         }
-        current->next = NULL;
+        last->next = NULL;
+        release_rx_bytes(index, current->tot_len);
         result = XTCP_SUCCESS;
         break;
       }
@@ -305,6 +479,157 @@ xtcp_error_code_t unlink_remote(int32_t index, struct pbuf *pbuf) {
   return result;
 }
 
+xtcp_error_code_t charge_tx_bytes(int32_t index, uint32_t length) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    unsigned client_num = connections[index].client_num;
+    if (client_num < MAX_XTCP_CLIENTS) {
+      xtcp_client_usage_t *usage = &client_usage[client_num];
+      if (quota_exceeded(usage->quota.max_tx_bytes, usage->tx_bytes, length)) {
+        return XTCP_ENOMEM;
+      }
+      usage->tx_bytes += length;
+    }
+    connections[index].tx_bytes += length;
+    return XTCP_SUCCESS;
+  }
+  return XTCP_EINVAL;
+}
+
+void release_tx_bytes(int32_t index, uint32_t length) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    unsigned client_num = connections[index].client_num;
+    if (length > connections[index].tx_bytes) {
+      length = connections[index].tx_bytes;
+    }
+    connections[index].tx_bytes -= length;
+    if (client_num < MAX_XTCP_CLIENTS) {
+      client_usage[client_num].tx_bytes -= length;
+    }
+  }
+}
+
+uint32_t get_tx_bytes(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    return connections[index].tx_bytes;
+  }
+  return 0;
+}
+
+uint32_t get_tcp_send_space(int32_t index) {
+  struct tcp_pcb *tcp_pcb = get_tcp_pcb(index);
+  if ((tcp_pcb == NULL) || ((tcp_pcb->state != ESTABLISHED) && (tcp_pcb->state != CLOSE_WAIT) &&
+                            (tcp_pcb->state != SYN_SENT) && (tcp_pcb->state != SYN_RCVD))) {
+    // Listening, closing or closed, tcp_write() would fail
+    return 0;
+  }
+
+  // Each segment written takes at least one pbuf from the send queue
+  uint32_t queued = tcp_sndqueuelen(tcp_pcb);
+  uint32_t queue_free = (queued < TCP_SND_QUEUELEN) ? TCP_SND_QUEUELEN - queued : 0;
+  uint32_t space = tcp_sndbuf(tcp_pcb);
+  if (space > queue_free * TCP_MSS) {
+    space = queue_free * TCP_MSS;
+  }
+
+  unsigned client_num = connections[index].client_num;
+  if ((client_num < MAX_XTCP_CLIENTS) && (client_usage[client_num].quota.max_tx_bytes != 0)) {
+    xtcp_client_usage_t *usage = &client_usage[client_num];
+    uint32_t quota_free =
+        (usage->tx_bytes < usage->quota.max_tx_bytes) ? usage->quota.max_tx_bytes - usage->tx_bytes : 0;
+    if (space > quota_free) {
+      space = quota_free;
+    }
+  }
+  return space;
+}
+
+int sent_event_due(int32_t index, uint32_t length) {
+  if ((index < 0) || (index >= MAX_OPEN_SOCKETS)) {
+    return 0;
+  }
+  connections[index].acked_bytes += length;
+  if (connections[index].send_lowat == 0) {
+    return 1;
+  }
+  // Only one event is raised for each time the free space rises above the watermark after a send
+  return connections[index].writable_armed && (get_tcp_send_space(index) > connections[index].send_lowat);
+}
+
+uint32_t get_acked_bytes(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    return connections[index].acked_bytes;
+  }
+  return 0;
+}
+
+void clear_acked_bytes(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    connections[index].acked_bytes = 0;
+    connections[index].writable_armed = 0;
+  }
+}
+
+void arm_writable_event(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    connections[index].writable_armed = 1;
+  }
+}
+
+uint32_t take_recv_events(int32_t index, uint32_t received, int flush) {
+  uint32_t due = 0;
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    connections[index].recv_held += received;
+    if (flush || (connections[index].rx_bytes >= connections[index].recv_lowat)) {
+      due = connections[index].recv_held;
+      connections[index].recv_held = 0;
+    }
+  }
+  return due;
+}
+
+void hold_recv_events(int32_t index, uint32_t count) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    connections[index].recv_held += count;
+  }
+}
+
+xtcp_error_code_t set_send_lowat(int32_t index, uint32_t bytes) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS) && (connections[index].protocol == XTCP_PROTOCOL_TCP)) {
+    connections[index].send_lowat = bytes;
+    return XTCP_SUCCESS;
+  }
+  return XTCP_EINVAL;
+}
+
+uint32_t get_send_lowat(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    return connections[index].send_lowat;
+  }
+  return 0;
+}
+
+xtcp_error_code_t set_recv_lowat(int32_t index, uint32_t bytes) {
+  // More than a window can never be queued, the remote host would wait for the window to open
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS) && (connections[index].protocol == XTCP_PROTOCOL_TCP) &&
+      (bytes <= TCP_WND)) {
+    // Nor more than the client's receive quota, the stack would refuse the data before the watermark
+    unsigned client_num = connections[index].client_num;
+    if ((client_num < MAX_XTCP_CLIENTS) && quota_exceeded(client_usage[client_num].quota.max_rx_bytes, 0, bytes)) {
+      return XTCP_EINVAL;
+    }
+    connections[index].recv_lowat = bytes;
+    return XTCP_SUCCESS;
+  }
+  return XTCP_EINVAL;
+}
+
+uint32_t get_recv_lowat(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    return connections[index].recv_lowat;
+  }
+  return 0;
+}
+
 int32_t set_connection_client_data(int32_t index, void * unsafe data) {
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
     connections[index].client_data = data;
@@ -29,8 +29,68 @@ unsigned get_client_info(int32_t index);
 xtcp_error_int32_t get_remote_data(int32_t index, uint8_t * unsafe * unsafe data, int32_t length, uint32_t *unsafe timestamp);
 int32_t free_remote_data(int32_t index);
 
+/** Get the number of received pbufs queued on a connection */
+int32_t count_remote_data(int32_t index);
+
+/** Get the bytes in the whole received entries at the front of a connection's queue that fit in a buffer
+ *
+ * \param index   The connection.
+ * \param length  The size of the buffer.
+ * \returns       The bytes of the entries that fit, 0 if the first entry does not fit or nothing is queued.
+ */
+uint32_t count_remote_bytes(int32_t index, uint32_t length);
+
 xtcp_protocol_t get_protocol(int32_t index);
 
+/** Set the resource limits for a client, a limit of zero is unlimited. XTCP_EINVAL if max_rx_bytes is below one
+ * segment or datagram, or below the receive low watermark of one of the client's sockets. */
+xtcp_error_code_t set_client_quota(unsigned client_num, xtcp_client_quota_t quota);
+
+/** Get the resource limits and current usage of a client */
+xtcp_client_usage_t get_client_usage(unsigned client_num);
+
+/** Charge TCP bytes written to the stack against the connection's client, XTCP_ENOMEM if over quota */
+xtcp_error_code_t charge_tx_bytes(int32_t index, uint32_t length);
+
+/** Return bytes previously charged with charge_tx_bytes(), when acknowledged or no longer in flight */
+void release_tx_bytes(int32_t index, uint32_t length);
+
+/** Get the TCP bytes charged to a connection that have not been released */
+uint32_t get_tx_bytes(int32_t index);
+
+/** Get the bytes a TCP connection can accept in one send, limited by the lwIP send buffer and queue and the client's
+ * quota. Zero if the connection cannot send. */
+uint32_t get_tcp_send_space(int32_t index);
+
+/** Add bytes acknowledged by the remote host, returns 1 when a XTCP_SENT_DATA event should be raised for them */
+int sent_event_due(int32_t index, uint32_t length);
+
+/** Get the bytes acknowledged since the last XTCP_SENT_DATA event raised */
+uint32_t get_acked_bytes(int32_t index);
+
+/** Clear the acknowledged bytes once a XTCP_SENT_DATA event has been raised for them */
+void clear_acked_bytes(int32_t index);
+
+/** Allow another XTCP_SENT_DATA event with a send low watermark, after data has been sent */
+void arm_writable_event(int32_t index);
+
+/** Count received pbufs queued on a connection, and get the number of XTCP_RECV_DATA events now due.
+ *
+ * With a receive low watermark the events are held until the bytes queued reach it, or until flush is set.
+ */
+uint32_t take_recv_events(int32_t index, uint32_t received, int flush);
+
+/** Hold XTCP_RECV_DATA events that were due but could not be raised */
+void hold_recv_events(int32_t index, uint32_t count);
+
+/** Set the free send space needed to raise XTCP_SENT_DATA, TCP only */
+xtcp_error_code_t set_send_lowat(int32_t index, uint32_t bytes);
+uint32_t get_send_lowat(int32_t index);
+
+/** Set the queued bytes needed to raise XTCP_RECV_DATA, TCP only and at most TCP_WND and the client's max_rx_bytes */
+xtcp_error_code_t set_recv_lowat(int32_t index, uint32_t bytes);
+uint32_t get_recv_lowat(int32_t index);
+
 int32_t set_connection_client_data(int32_t index, void * unsafe data);
 void * unsafe get_connection_client_data(int32_t index);
 
@@ -0,0 +1,190 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#define DEBUG_UNIT LIB_XTCP
+
+#include "deferred_log.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xcore/hwtimer.h>
+
+/* XTCP headers */
+#include "debug_print.h"
+#include "rate_limit.h"
+#include "xtcp_log.h"
+
+/* Formats of the messages, each taking two integer arguments, the second unused by most */
+static const char *const formats[LOG_MESSAGES] = {
+  [LOG_LOST] = "deferred_log: %d records lost\n",
+  [LOG_TCP_CLOSE_LOST] = "lwip_tcp_event: CLOSE event lost: %d\n",
+  [LOG_TCP_RECV_EVENTS_LOST] = "lwip_tcp_event: RECV failed: %d events\n",
+  [LOG_TCP_RECV_UNLINK_FAILED] = "lwip_tcp_event: RECV unlink failed: %d\n",
+  [LOG_TCP_RECV_UNLINKED] = "lwip_tcp_event: RECV unlink succeeded: %d\n",
+  [LOG_TCP_SENT_DELAYED] = "lwip_tcp_event: SENT event delayed: %d\n",
+  [LOG_TCP_SENT_STATIC_DELAYED] = "lwip_tcp_event: SENT_STATIC event delayed\n",
+  [LOG_TCP_ERR_LOST] = "lwip_tcp_event: ERR event lost: %d (%d)\n",
+  [LOG_UDP_DATAGRAM_DROPPED] = "xtcp_udp_recv: datagram of %d bytes dropped\n",
+  [LOG_UDP_ENQUEUE_FAILED] = "xtcp_udp_recv: enqueue_event_and_notify failed: %d\n",
+  [LOG_PBUF_ALLOC_FAILED] = "Failed to allocate pbuf of type %d and length %d\n",
+  [LOG_DIRECT_TCP_ERR] = "direct_client_tcp_event: %d error: %d\n",
+  [LOG_TCP_ACCEPT_LOST] = "lwip_tcp_event: accept failed: %d\n",
+  [LOG_TCP_CONNECTED_LOST] = "lwip_tcp_event: connected failed to queue event: %d\n",
+  [LOG_TCP_ERR] = "lwip_tcp_event: ERR event on %d: %d\n",
+  [LOG_TCP_ERR_UNKNOWN] = "lwip_tcp_event: unknown connection %d error: %d\n",
+  [LOG_UDP_BAD_RECV] = "xtcp_udp_recv: bad index %d or NULL pbuf, skipping\n",
+  [LOG_PBUF_BAD_LENGTH] = "pbuf_shim: bad parameter, pbuf length %d\n",
+  [LOG_PBUF_BAD_TOKEN] = "pbuf_shim: bad parameter, pbuf token\n",
+};
+
+static void put_le32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static void put_le16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_le16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+#if XTCP_LOG_DEFERRED
+
+#if XTCP_LOG_RECORDS == 0
+#error "XTCP_LOG_RECORDS must be at least one"
+#endif
+
+typedef struct log_entry_t {
+  uint32_t timestamp;
+  uint16_t message;
+  uint16_t repeats;   // Times the message was over its rate since its previous record
+  int32_t arg0;
+  int32_t arg1;
+} log_entry_t;
+
+/* head and tail count records written and read, so the ring is empty when they are equal */
+static log_entry_t ring[XTCP_LOG_RECORDS];
+static uint32_t head;
+static uint32_t tail;
+static uint32_t lost;
+
+static rate_limit_t limits[LOG_MESSAGES];
+static uint32_t repeats[LOG_MESSAGES];
+
+static void put_entry(uint8_t *p, const log_entry_t *entry) {
+  put_le32(&p[0], entry->timestamp);
+  put_le16(&p[4], entry->message);
+  put_le16(&p[6], entry->repeats);
+  put_le32(&p[8], (uint32_t)entry->arg0);
+  put_le32(&p[12], (uint32_t)entry->arg1);
+}
+
+void deferred_log_init(void) {
+  head = 0;
+  tail = 0;
+  lost = 0;
+  memset(repeats, 0, sizeof(repeats));
+  for (int i = 0; i < LOG_MESSAGES; ++i) {
+    rate_limit_init(&limits[i], XTCP_LOG_RATE, XTCP_LOG_BURST);
+  }
+}
+
+void deferred_log_write(log_message_t message, int32_t arg0, int32_t arg1) {
+  if ((unsigned)message >= LOG_MESSAGES) {
+    return;
+  }
+  uint32_t now = get_reference_time();
+  if (!rate_limit_take(&limits[message], now)) {
+    repeats[message]++;
+    return;
+  }
+
+  if (head - tail == XTCP_LOG_RECORDS) {
+    tail++;
+    lost++;
+  }
+  log_entry_t *entry = &ring[head % XTCP_LOG_RECORDS];
+  entry->timestamp = now;
+  entry->message = (uint16_t)message;
+  entry->repeats = (uint16_t)(repeats[message] > UINT16_MAX ? UINT16_MAX : repeats[message]);
+  entry->arg0 = arg0;
+  entry->arg1 = arg1;
+  repeats[message] = 0;
+  head++;
+}
+
+int32_t deferred_log_read(uint8_t buffer[], uint32_t length) {
+  if (length < XTCP_LOG_RECORD_LENGTH) {
+    return XTCP_EINVAL;
+  }
+
+  uint32_t n = 0;
+  if (lost) {
+    // The records lost were all older than those still in the ring, so it takes the time of the oldest
+    uint32_t timestamp = (tail != head) ? ring[tail % XTCP_LOG_RECORDS].timestamp : get_reference_time();
+    log_entry_t entry = {timestamp, LOG_LOST, 0, (int32_t)lost, 0};
+    put_entry(buffer, &entry);
+    n = XTCP_LOG_RECORD_LENGTH;
+    lost = 0;
+  }
+
+  while ((tail != head) && (length - n >= XTCP_LOG_RECORD_LENGTH)) {
+    put_entry(&buffer[n], &ring[tail % XTCP_LOG_RECORDS]);
+    tail++;
+    n += XTCP_LOG_RECORD_LENGTH;
+  }
+  return (int32_t)n;
+}
+
+#else
+
+void deferred_log_init(void) {}
+
+void deferred_log_write(log_message_t message, int32_t arg0, int32_t arg1) {
+  deferred_log_print(message, arg0, arg1);
+}
+
+int32_t deferred_log_read(uint8_t buffer[], uint32_t length) {
+  (void)buffer;
+  (void)length;
+  return XTCP_EPROTONOSUPPORT;
+}
+
+#endif /* XTCP_LOG_DEFERRED */
+
+void deferred_log_print(log_message_t message, int32_t arg0, int32_t arg1) {
+  if ((unsigned)message < LOG_MESSAGES) {
+    debug_printf(formats[message], arg0, arg1);
+  }
+}
+
+int xtcp_log_format(const uint8_t record[XTCP_LOG_RECORD_LENGTH], char text[], unsigned length) {
+  unsigned message = get_le16(&record[4]);
+  if ((message >= LOG_MESSAGES) || (length == 0)) {
+    return XTCP_EINVAL;
+  }
+
+  // Microseconds of the reference timer, which wraps every 43 seconds
+  int n = snprintf(text, length, "[%10lu] ", (unsigned long)(get_le32(&record[0]) / 100));
+  if ((n >= 0) && ((unsigned)n < length)) {
+    n += snprintf(&text[n], length - (unsigned)n, formats[message], (int)get_le32(&record[8]),
+                  (int)get_le32(&record[12]));
+  }
+  if ((n > 0) && ((unsigned)n < length) && (text[n - 1] == '\n')) {
+    text[--n] = '\0';
+  }
+  uint16_t repeats = get_le16(&record[6]);
+  if (repeats && (n >= 0) && ((unsigned)n < length)) {
+    n += snprintf(&text[n], length - (unsigned)n, " (repeated %u times)", repeats);
+  }
+  return ((n < 0) || ((unsigned)n >= length)) ? (int)strlen(text) : n;
+}
@@ -0,0 +1,77 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_DEFERRED_LOG_H
+#define XTCP_DEFERRED_LOG_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Size of the buffer the stack reads the ring into for read_log() */
+#define DEFERRED_LOG_READ_MAX (8 * XTCP_LOG_RECORD_LENGTH)
+
+/** Messages of the deferred log, formatted by xtcp_log_format() from the table in deferred_log.c */
+typedef enum log_message_t {
+  LOG_LOST,
+  LOG_TCP_CLOSE_LOST,
+  LOG_TCP_RECV_EVENTS_LOST,
+  LOG_TCP_RECV_UNLINK_FAILED,
+  LOG_TCP_RECV_UNLINKED,
+  LOG_TCP_SENT_DELAYED,
+  LOG_TCP_SENT_STATIC_DELAYED,
+  LOG_TCP_ERR_LOST,
+  LOG_UDP_DATAGRAM_DROPPED,
+  LOG_UDP_ENQUEUE_FAILED,
+  LOG_PBUF_ALLOC_FAILED,
+  LOG_DIRECT_TCP_ERR,
+  LOG_TCP_ACCEPT_LOST,
+  LOG_TCP_CONNECTED_LOST,
+  LOG_TCP_ERR,
+  LOG_TCP_ERR_UNKNOWN,
+  LOG_UDP_BAD_RECV,
+  LOG_PBUF_BAD_LENGTH,
+  LOG_PBUF_BAD_TOKEN,
+  LOG_MESSAGES,
+} log_message_t;
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Initialise the deferred log with an empty ring and the rate limits of every message full */
+void deferred_log_init(void);
+
+/** Store a message as a record timestamped with the reference timer, or count it as a repeat if the message is over
+ * its rate. The oldest record is overwritten when the ring is full.
+ *
+ * \param message   The message.
+ * \param arg0      The first argument of its format.
+ * \param arg1      The second argument of its format.
+ */
+void deferred_log_write(log_message_t message, int32_t arg0, int32_t arg1);
+
+/** Print a message with debug_printf() as it happens, when the log is not deferred */
+void deferred_log_print(log_message_t message, int32_t arg0, int32_t arg1);
+
+/** Read whole records from the ring.
+ *
+ * \param buffer    The buffer to read into.
+ * \param length    The length of the buffer.
+ * \returns         The number of bytes read, XTCP_EINVAL if length is less than XTCP_LOG_RECORD_LENGTH, or
+ *                  XTCP_EPROTONOSUPPORT when XTCP_LOG_DEFERRED is 0.
+ */
+int32_t deferred_log_read(uint8_t buffer[], uint32_t length);
+
+#ifdef __XC__
+}
+#endif
+
+/** Log a data path error message, deferred or printed as XTCP_LOG_DEFERRED selects */
+#if XTCP_LOG_DEFERRED
+#define DEFERRED_LOG(message, arg0, arg1) deferred_log_write(message, (int32_t)(arg0), (int32_t)(arg1))
+#else
+#define DEFERRED_LOG(message, arg0, arg1) deferred_log_print(message, (int32_t)(arg0), (int32_t)(arg1))
+#endif
+
+#endif /* XTCP_DEFERRED_LOG_H */
@@ -0,0 +1,216 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "direct_client.h"
+
+#include <string.h>
+
+/* XTCP headers */
+#include "connection.h"
+#include "deferred_log.h"
+#include "lwip_shim.h"
+#include "pbuf_shim.h"
+#include "xtcp_direct.h"
+
+/* LwIP headers */
+#include "lwip/ip_addr.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+
+/* Callbacks and argument of each direct socket, indexed by connection */
+static const xtcp_c_callbacks_t *callbacks[MAX_OPEN_SOCKETS];
+static void *callback_args[MAX_OPEN_SOCKETS];
+
+static inline int is_direct(int32_t id) {
+  return (id >= 0) && (id < MAX_OPEN_SOCKETS) && (get_client_info(id) == DIRECT_CLIENT_NUM);
+}
+
+static void forget_callbacks(int32_t index) {
+  callbacks[index] = NULL;
+  callback_args[index] = NULL;
+}
+
+void direct_client_init(void) {
+  for (int32_t i = 0; i < MAX_OPEN_SOCKETS; ++i) {
+    forget_callbacks(i);
+  }
+}
+
+xtcp_error_int32_t xtcp_c_socket(xtcp_protocol_t protocol, const xtcp_c_callbacks_t *socket_callbacks, void *arg) {
+  xtcp_error_int32_t socket = {.status = XTCP_EINVAL, .value = -1};
+  if (socket_callbacks == NULL) {
+    return socket;
+  }
+
+  socket = shim_new_socket(DIRECT_CLIENT_NUM, protocol);
+  if (socket.status == XTCP_SUCCESS) {
+    callbacks[socket.value] = socket_callbacks;
+    callback_args[socket.value] = arg;
+  }
+  return socket;
+}
+
+void xtcp_c_close(int32_t id) {
+  if (is_direct(id)) {
+    shim_close_socket(DIRECT_CLIENT_NUM, id);
+    forget_callbacks(id);
+  }
+}
+
+xtcp_error_code_t xtcp_c_listen(int32_t id, uint16_t port_number, xtcp_ipaddr_t ipaddr) {
+  return shim_listen(DIRECT_CLIENT_NUM, id, port_number, ipaddr);
+}
+
+xtcp_error_code_t xtcp_c_connect(int32_t id, uint16_t port_number, xtcp_ipaddr_t ipaddr) {
+  return shim_connect(DIRECT_CLIENT_NUM, id, port_number, ipaddr);
+}
+
+/* Copy a datagram into a transmit pbuf, giving it to the shim as an interface client's send would */
+static void *udp_token(const void *data, uint32_t length) {
+  if (length > XTCP_UDP_MAX_DATAGRAM_SIZE) {
+    return NULL;
+  }
+  void *token = pbuf_shim_alloc_tx(length, 0);
+  if (token != NULL) {
+    memcpy(pbuf_shim_token_payload(token), data, length);
+  }
+  return token;
+}
+
+xtcp_error_code_t xtcp_c_send(int32_t id, const void *data, uint32_t length) {
+  if (!is_direct(id) || ((data == NULL) && (length != 0))) {
+    return XTCP_EINVAL;
+  }
+
+  if (get_protocol(id) == XTCP_PROTOCOL_UDP) {
+    void *token = udp_token(data, length);
+    return (token != NULL) ? shim_send(DIRECT_CLIENT_NUM, id, token) : XTCP_ENOMEM;
+  }
+
+  // TCP is written straight from the caller's buffer, skipping the transmit pbuf an interface client fills
+  struct tcp_pcb *tcp_pcb = get_tcp_pcb(id);
+  if ((tcp_pcb == NULL) || (length > UINT16_MAX)) {
+    return XTCP_EINVAL;
+  }
+  // Unacknowledged data is counted until LWIP_EVENT_SENT, as for an interface client
+  if (charge_tx_bytes(id, length) != XTCP_SUCCESS) {
+    return XTCP_ENOMEM;
+  }
+  err_t error = tcp_write(tcp_pcb, data, (u16_t)length, TCP_WRITE_FLAG_COPY);
+  if (error != ERR_OK) {
+    release_tx_bytes(id, length);
+    return (error == ERR_MEM) ? XTCP_EAGAIN : XTCP_EINVAL;
+  }
+  // Inside a receive callback LwIP defers the output until the received segment has been processed. With a full
+  // output queue the data stays queued in LwIP, which sends it from its timer, so it must not be sent again.
+  err_t output = tcp_output(tcp_pcb);
+  return ((output == ERR_OK) || (output == ERR_MEM)) ? XTCP_SUCCESS : XTCP_EINVAL;
+}
+
+xtcp_error_code_t xtcp_c_sendto(int32_t id, const void *data, uint32_t length, xtcp_ipaddr_t remote_addr,
+                                uint16_t remote_port) {
+  if (!is_direct(id) || ((data == NULL) && (length != 0))) {
+    return XTCP_EINVAL;
+  } else if (get_protocol(id) != XTCP_PROTOCOL_UDP) {
+    return XTCP_EPROTONOSUPPORT;
+  }
+
+  void *token = udp_token(data, length);
+  return (token != NULL) ? shim_sendto(DIRECT_CLIENT_NUM, id, token, remote_addr, remote_port) : XTCP_ENOMEM;
+}
+
+static void call_recv(int32_t index, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+  const xtcp_c_callbacks_t *cb = callbacks[index];
+  if ((cb != NULL) && (cb->on_recv != NULL)) {
+    xtcp_ipaddr_t remote_addr = {0, 0, 0, 0};
+    if (addr != NULL) {
+      memcpy(remote_addr, addr, sizeof(xtcp_ipaddr_t));
+    }
+    cb->on_recv(callback_args[index], index, p, remote_addr, port);
+  }
+}
+
+static void call_close(int32_t index, xtcp_event_type_t event) {
+  const xtcp_c_callbacks_t *cb = callbacks[index];
+  if ((cb != NULL) && (cb->on_close != NULL)) {
+    cb->on_close(callback_args[index], index, event);
+  }
+}
+
+void direct_client_udp_recv(int32_t index, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+  call_recv(index, p, addr, port);
+  pbuf_free(p);
+}
+
+#if LWIP_EVENT_API == 1
+err_t direct_client_tcp_event(int32_t index, struct tcp_pcb *pcb, enum lwip_event e, struct pbuf *p, u16_t size,
+                              err_t err) {
+  const xtcp_c_callbacks_t *cb = callbacks[index];
+  void *arg = callback_args[index];
+  err_t result = ERR_OK;
+
+  switch (e) {
+    case LWIP_EVENT_ACCEPT: {
+      if ((err != ERR_OK) || (pcb == NULL)) {
+        result = ERR_VAL;
+        break;
+      }
+      tcp_setprio(pcb, TCP_PRIO_MIN);
+      xtcp_error_int32_t accepted = shim_accept(DIRECT_CLIENT_NUM, pcb, index);
+      if (accepted.status != XTCP_SUCCESS) {
+        result = ERR_MEM;
+        break;
+      }
+      callbacks[accepted.value] = cb;
+      callback_args[accepted.value] = arg;
+      if ((cb != NULL) && (cb->on_accept != NULL)) {
+        cb->on_accept(arg, index, accepted.value);
+      }
+      break;
+    }
+
+    case LWIP_EVENT_CONNECTED: {
+      if ((cb != NULL) && (cb->on_connect != NULL)) {
+        cb->on_connect(arg, index);
+      }
+      break;
+    }
+
+    case LWIP_EVENT_RECV: {
+      if (p == NULL) {
+        call_close(index, XTCP_CLOSED);
+        break;
+      }
+      // The data is consumed by the callback, so open the window first. A connection closed by the callback then
+      // has no unread data, which would make tcp_close() reset it.
+      uint16_t length = p->tot_len;
+      tcp_recved(pcb, length);
+      call_recv(index, p, &pcb->remote_ip, pcb->remote_port);
+      pbuf_free(p);
+      break;
+    }
+
+    case LWIP_EVENT_SENT: {
+      release_tx_bytes(index, size);
+      if ((cb != NULL) && (cb->on_sent != NULL)) {
+        cb->on_sent(arg, index, size);
+      }
+      break;
+    }
+
+    case LWIP_EVENT_ERR: {
+      // LwIP has already freed the PCB, so the socket goes now
+      DEFERRED_LOG(LOG_DIRECT_TCP_ERR, index, err);
+      call_close(index, (err == ERR_ABRT) ? XTCP_ABORTED : XTCP_TIMED_OUT);
+      free_client_connection(index);
+      forget_callbacks(index);
+      break;
+    }
+
+    case LWIP_EVENT_POLL: {
+      break;
+    }
+  }
+  return result;
+}
+#endif /* LWIP_EVENT_API == 1 */
@@ -0,0 +1,43 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_DIRECT_CLIENT_H
+#define XTCP_DIRECT_CLIENT_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Client number owning the sockets of the direct C API. It is above every xtcp_if client, so the sockets are never
+ * found by an interface client and no client quota applies to them. */
+#define DIRECT_CLIENT_NUM MAX_XTCP_CLIENTS
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Forget the callbacks of every direct socket, called once at start up */
+void direct_client_init(void);
+
+#ifdef __XC__
+}
+#endif
+
+#ifndef __XC__
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+
+#if LWIP_EVENT_API == 1
+/** Handle a TCP event on a direct socket, called from lwip_tcp_event() in place of queueing a client event.
+ *
+ * \returns The result to give LwIP, as for lwip_tcp_event().
+ */
+err_t direct_client_tcp_event(int32_t index, struct tcp_pcb *pcb, enum lwip_event e, struct pbuf *p, u16_t size,
+                              err_t err);
+#endif
+
+/** Give a received UDP datagram to a direct socket, called from xtcp_udp_recv(). Frees the pbuf. */
+void direct_client_udp_recv(int32_t index, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+#endif /* __XC__ */
+
+#endif /* XTCP_DIRECT_CLIENT_H */
@@ -0,0 +1,503 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "xtcp_http.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if XTCP_HTTP_ENABLE
+
+/* A connection buffers the request being received, and any pipelined requests that arrived with it, from the start
+ * of the oldest unanswered request. Its response is built from the buffer without consuming it, so a header that
+ * could not be sent is simply built again, and the request is only dropped by xtcp_http_commit(). */
+
+#define HTTP_BUFFER_SIZE (XTCP_HTTP_REQUEST_MAX + XTCP_HTTP_RX_BUFFER)
+
+typedef enum http_method_t {
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_OTHER,
+} http_method_t;
+
+typedef struct http_conn_t {
+  int32_t id;
+  int in_use;
+  uint32_t used;            // Bytes buffered
+  uint32_t scanned;         // Bytes already searched for the end of the oldest request's headers
+  uint32_t skip;            // Bytes of a request body still to arrive and be discarded
+  uint32_t deferred;        // Receive events whose data was left with the stack
+  uint32_t requests;        // Requests answered on this connection
+  int overflow;             // The oldest request is longer than can be buffered
+  int busy;                 // A response body is being sent
+  int closing;              // Close once the response body has been sent, take no further requests
+  uint32_t request_length;  // Length of the request answered by the last response built
+  uint32_t body_length;     // Length of that request's body
+  int response_closes;      // That response closes the connection
+  int response_error;       // That response has an error status
+  int response_has_body;    // That response has a body to send with send_static()
+  uint8_t buffer[HTTP_BUFFER_SIZE];
+} http_conn_t;
+
+typedef struct http_resource_t {
+  const char *path;
+  uint32_t path_length;
+  const char *content_type;
+  int32_t region;
+  uint32_t offset;
+  uint32_t length;
+} http_resource_t;
+
+typedef struct http_request_t {
+  http_method_t method;
+  const uint8_t *path;
+  uint32_t path_length;
+  int keep_alive;
+  int http_1_0;
+  int bad;
+  int chunked;
+  uint32_t content_length;
+} http_request_t;
+
+static http_conn_t conns[XTCP_HTTP_MAX_CONNECTIONS];
+static http_conn_t *free_conns[XTCP_HTTP_MAX_CONNECTIONS];
+static uint32_t num_free;
+
+static http_resource_t resources[XTCP_HTTP_MAX_RESOURCES];
+static uint32_t num_resources;
+
+static xtcp_http_stats_t stats;
+
+void xtcp_http_init(void) {
+  for (uint32_t i = 0; i < XTCP_HTTP_MAX_CONNECTIONS; ++i) {
+    conns[i].in_use = 0;
+    conns[i].id = -1;
+    free_conns[i] = &conns[XTCP_HTTP_MAX_CONNECTIONS - 1 - i];
+  }
+  num_free = XTCP_HTTP_MAX_CONNECTIONS;
+  num_resources = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+xtcp_error_code_t xtcp_http_add_resource(const char path[], const char content_type[], int32_t region,
+                                         uint32_t offset, uint32_t length) {
+  if ((path == NULL) || (path[0] != '/') || (content_type == NULL) || (region < 0)) {
+    return XTCP_EINVAL;
+  } else if (num_resources == XTCP_HTTP_MAX_RESOURCES) {
+    return XTCP_ENOMEM;
+  }
+  http_resource_t *resource = &resources[num_resources++];
+  resource->path = path;
+  resource->path_length = (uint32_t)strlen(path);
+  resource->content_type = content_type;
+  resource->region = region;
+  resource->offset = offset;
+  resource->length = length;
+  return XTCP_SUCCESS;
+}
+
+void *xtcp_http_open(int32_t id) {
+  if (num_free == 0) {
+    stats.rejected++;
+    return NULL;
+  }
+  http_conn_t *conn = free_conns[--num_free];
+  memset(conn, 0, offsetof(http_conn_t, buffer));
+  conn->id = id;
+  conn->in_use = 1;
+  stats.connections++;
+  return conn;
+}
+
+int xtcp_http_owns(void *conn) {
+  http_conn_t *c = conn;
+  return (c >= &conns[0]) && (c < &conns[XTCP_HTTP_MAX_CONNECTIONS]) && c->in_use;
+}
+
+void xtcp_http_close(void *conn) {
+  http_conn_t *c = conn;
+  if (xtcp_http_owns(c)) {
+    c->in_use = 0;
+    c->id = -1;
+    free_conns[num_free++] = c;
+  }
+}
+
+void *xtcp_http_find(int32_t id) {
+  // Only used as a connection ends, every other event reaches the state through the connection's client data
+  for (uint32_t i = 0; i < XTCP_HTTP_MAX_CONNECTIONS; ++i) {
+    if (conns[i].in_use && (conns[i].id == id)) {
+      return &conns[i];
+    }
+  }
+  return NULL;
+}
+
+/* Search the buffer for the blank line ending the oldest request's headers, returning the request's length or 0 */
+static uint32_t find_end_of_headers(http_conn_t *c) {
+  const uint8_t *b = c->buffer;
+  for (uint32_t i = c->scanned; i < c->used; ++i) {
+    if (b[i] != '\n') {
+      continue;
+    }
+    if ((i + 1 < c->used) && (b[i + 1] == '\n')) {
+      return i + 2;
+    }
+    if ((i + 2 < c->used) && (b[i + 1] == '\r') && (b[i + 2] == '\n')) {
+      return i + 3;
+    }
+  }
+  // The end may start in the last two bytes
+  c->scanned = (c->used > 2) ? c->used - 2 : 0;
+  return 0;
+}
+
+int xtcp_http_wants_data(void *conn) {
+  http_conn_t *c = conn;
+  return !c->busy && !c->closing && !c->overflow && (find_end_of_headers(c) == 0);
+}
+
+void xtcp_http_defer(void *conn) {
+  http_conn_t *c = conn;
+  c->deferred++;
+}
+
+int xtcp_http_take_deferred(void *conn) {
+  http_conn_t *c = conn;
+  if ((c->deferred == 0) || !xtcp_http_wants_data(c)) {
+    return 0;
+  }
+  c->deferred--;
+  return 1;
+}
+
+xtcp_error_code_t xtcp_http_received(void *conn, const uint8_t data[], uint32_t length) {
+  http_conn_t *c = conn;
+  // The body of an answered request is discarded as it arrives
+  uint32_t skipped = (c->skip < length) ? c->skip : length;
+  c->skip -= skipped;
+  data += skipped;
+  length -= skipped;
+
+  if (length > HTTP_BUFFER_SIZE - c->used) {
+    c->overflow = 1;
+    return XTCP_ENOMEM;
+  }
+  memcpy(&c->buffer[c->used], data, length);
+  c->used += length;
+  return XTCP_SUCCESS;
+}
+
+static inline uint8_t to_lower(uint8_t ch) { return ((ch >= 'A') && (ch <= 'Z')) ? (uint8_t)(ch + ('a' - 'A')) : ch; }
+
+static int equals_nocase(const uint8_t *s, uint32_t length, const char *lower) {
+  uint32_t i = 0;
+  for (; (i < length) && (lower[i] != '\0'); ++i) {
+    if (to_lower(s[i]) != (uint8_t)lower[i]) {
+      return 0;
+    }
+  }
+  return (i == length) && (lower[i] == '\0');
+}
+
+static const uint8_t *trim(const uint8_t *s, const uint8_t *end, uint32_t *length) {
+  while ((s < end) && ((*s == ' ') || (*s == '\t'))) {
+    s++;
+  }
+  while ((end > s) && ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r'))) {
+    end--;
+  }
+  *length = (uint32_t)(end - s);
+  return s;
+}
+
+static void parse_connection(http_request_t *request, const uint8_t *value, const uint8_t *end) {
+  // A comma separated list of options
+  while (value < end) {
+    const uint8_t *comma = memchr(value, ',', (size_t)(end - value));
+    const uint8_t *option_end = (comma != NULL) ? comma : end;
+    uint32_t length;
+    const uint8_t *option = trim(value, option_end, &length);
+    if (equals_nocase(option, length, "close")) {
+      request->keep_alive = 0;
+    } else if (equals_nocase(option, length, "keep-alive")) {
+      request->keep_alive = 1;
+    }
+    value = option_end + 1;
+  }
+}
+
+static void parse_content_length(http_request_t *request, const uint8_t *value, uint32_t length) {
+  uint32_t n = 0;
+  if ((length == 0) || (length > 9)) {
+    request->bad = 1;
+    return;
+  }
+  for (uint32_t i = 0; i < length; ++i) {
+    if ((value[i] < '0') || (value[i] > '9')) {
+      request->bad = 1;
+      return;
+    }
+    n = (n * 10) + (uint32_t)(value[i] - '0');
+  }
+  request->content_length = n;
+}
+
+static void parse_header(http_request_t *request, const uint8_t *line, const uint8_t *end) {
+  const uint8_t *colon = memchr(line, ':', (size_t)(end - line));
+  if ((colon == NULL) || (colon == line)) {
+    request->bad = 1;
+    return;
+  }
+  uint32_t name_length = (uint32_t)(colon - line);
+  uint32_t value_length;
+  const uint8_t *value = trim(colon + 1, end, &value_length);
+
+  if (equals_nocase(line, name_length, "connection")) {
+    parse_connection(request, value, value + value_length);
+  } else if (equals_nocase(line, name_length, "content-length")) {
+    parse_content_length(request, value, value_length);
+  } else if (equals_nocase(line, name_length, "transfer-encoding")) {
+    request->chunked = 1;
+  }
+}
+
+static void parse_request_line(http_request_t *request, const uint8_t *line, const uint8_t *end) {
+  const uint8_t *space = memchr(line, ' ', (size_t)(end - line));
+  if (space == NULL) {
+    request->bad = 1;
+    return;
+  }
+  uint32_t method_length = (uint32_t)(space - line);
+  if ((method_length == 3) && (memcmp(line, "GET", 3) == 0)) {
+    request->method = HTTP_GET;
+  } else if ((method_length == 4) && (memcmp(line, "HEAD", 4) == 0)) {
+    request->method = HTTP_HEAD;
+  } else {
+    request->method = HTTP_OTHER;
+  }
+
+  request->path = space + 1;
+  space = memchr(request->path, ' ', (size_t)(end - request->path));
+  if ((space == NULL) || (request->path[0] != '/')) {
+    request->bad = 1;
+    return;
+  }
+  request->path_length = (uint32_t)(space - request->path);
+  // The query is not part of the resource's name
+  const uint8_t *query = memchr(request->path, '?', request->path_length);
+  if (query != NULL) {
+    request->path_length = (uint32_t)(query - request->path);
+  }
+
+  uint32_t version_length;
+  const uint8_t *version = trim(space + 1, end, &version_length);
+  if ((version_length == 8) && (memcmp(version, "HTTP/1.1", 8) == 0)) {
+    request->keep_alive = 1;
+  } else if ((version_length == 8) && (memcmp(version, "HTTP/1.0", 8) == 0)) {
+    request->keep_alive = 0;
+    request->http_1_0 = 1;
+  } else {
+    request->bad = 1;
+  }
+}
+
+static void parse_request(http_request_t *request, const uint8_t *b, uint32_t length) {
+  memset(request, 0, sizeof(*request));
+  const uint8_t *end = b + length;
+  const uint8_t *line = b;
+  int first = 1;
+  while (line < end) {
+    const uint8_t *newline = memchr(line, '\n', (size_t)(end - line));
+    const uint8_t *line_end = (newline != NULL) ? newline : end;
+    if ((line_end > line) && (line_end[-1] == '\r')) {
+      line_end--;
+    }
+    if (first) {
+      parse_request_line(request, line, line_end);
+      first = 0;
+    } else if (line_end > line) {
+      parse_header(request, line, line_end);
+    }
+    if (request->bad || (newline == NULL)) {
+      break;
+    }
+    line = newline + 1;
+  }
+}
+
+static const http_resource_t *find_resource(const uint8_t *path, uint32_t length) {
+  for (uint32_t i = 0; i < num_resources; ++i) {
+    if ((resources[i].path_length == length) && (memcmp(resources[i].path, path, length) == 0)) {
+      return &resources[i];
+    }
+  }
+  return NULL;
+}
+
+typedef struct header_builder_t {
+  uint8_t *b;
+  uint32_t length;
+} header_builder_t;
+
+static void append(header_builder_t *h, const char *s) {
+  uint32_t length = (uint32_t)strlen(s);
+  if (h->length + length > XTCP_HTTP_HEADER_MAX) {
+    length = XTCP_HTTP_HEADER_MAX - h->length;
+  }
+  memcpy(&h->b[h->length], s, length);
+  h->length += length;
+}
+
+static void append_number(header_builder_t *h, uint32_t n) {
+  char digits[11];
+  uint32_t i = sizeof(digits) - 1;
+  digits[i] = '\0';
+  do {
+    digits[--i] = (char)('0' + (n % 10));
+    n /= 10;
+  } while (n != 0);
+  append(h, &digits[i]);
+}
+
+static void build_header(xtcp_http_response_t *response, const char *status, const char *content_type,
+                         uint32_t content_length, int close, int announce_keep_alive) {
+  header_builder_t h = {response->header, 0};
+  append(&h, "HTTP/1.1 ");
+  append(&h, status);
+  append(&h, "\r\nContent-Type: ");
+  append(&h, content_type);
+  append(&h, "\r\nContent-Length: ");
+  append_number(&h, content_length);
+  if (close) {
+    append(&h, "\r\nConnection: close");
+  } else if (announce_keep_alive) {
+    append(&h, "\r\nConnection: keep-alive");
+  }
+  append(&h, "\r\n\r\n");
+  response->header_length = h.length;
+}
+
+static void build_error(xtcp_http_response_t *response, const char *status, const char *body, int close,
+                        int announce_keep_alive) {
+  build_header(response, status, "text/plain", (uint32_t)strlen(body), close, announce_keep_alive);
+  header_builder_t h = {response->header, response->header_length};
+  append(&h, body);
+  response->header_length = h.length;
+}
+
+int xtcp_http_next(void *conn, xtcp_http_response_t *response) {
+  http_conn_t *c = conn;
+  if (c->busy || c->closing) {
+    return 0;
+  }
+
+  response->region = -1;
+  response->offset = 0;
+  response->length = 0;
+  c->response_has_body = 0;
+  c->body_length = 0;
+
+  uint32_t length = find_end_of_headers(c);
+  if (length == 0) {
+    if (!c->overflow && (c->used < XTCP_HTTP_REQUEST_MAX)) {
+      return 0;
+    }
+    // The request cannot be framed, so it is answered and the connection closed
+    build_error(response, "431 Request Header Fields Too Large", "Request header too large\n", 1, 0);
+    c->request_length = c->used;
+    c->response_closes = 1;
+    c->response_error = 1;
+    response->close = 1;
+    return 1;
+  }
+
+  http_request_t request;
+  parse_request(&request, c->buffer, length);
+  c->request_length = length;
+  c->response_error = 1;
+
+  if (request.bad || request.chunked) {
+    // Without a valid request the end of its body is unknown, so the connection cannot be reused
+    if (request.chunked) {
+      build_error(response, "501 Not Implemented", "Chunked requests not supported\n", 1, 0);
+    } else {
+      build_error(response, "400 Bad Request", "Bad request\n", 1, 0);
+    }
+    c->response_closes = 1;
+    response->close = 1;
+    return 1;
+  }
+
+  c->body_length = request.content_length;
+  // HTTP/1.0 clients only keep a connection open if they asked to, so are told that it stays open
+  int announce = request.keep_alive && request.http_1_0;
+  int close = !request.keep_alive;
+  const http_resource_t *resource = NULL;
+
+  if (request.method == HTTP_OTHER) {
+    build_error(response, "405 Method Not Allowed", "Method not allowed\n", close, announce);
+  } else if ((resource = find_resource(request.path, request.path_length)) == NULL) {
+    build_error(response, "404 Not Found", "Not found\n", close, announce);
+  } else {
+    build_header(response, "200 OK", resource->content_type, resource->length, close, announce);
+    c->response_error = 0;
+    if ((request.method == HTTP_GET) && (resource->length != 0)) {
+      response->region = resource->region;
+      response->offset = resource->offset;
+      response->length = resource->length;
+      c->response_has_body = 1;
+    }
+  }
+  c->response_closes = close;
+  response->close = close;
+  return 1;
+}
+
+void xtcp_http_commit(void *conn) {
+  http_conn_t *c = conn;
+  stats.requests++;
+  if (c->requests++ != 0) {
+    stats.reused++;
+  }
+  if (c->response_error) {
+    stats.errors++;
+  }
+
+  // Drop the request, and as much of its body as has arrived, keeping any pipelined requests behind it
+  uint32_t consumed = c->request_length;
+  uint32_t body = c->used - consumed;
+  if (body > c->body_length) {
+    body = c->body_length;
+  }
+  consumed += body;
+  c->skip = c->body_length - body;
+  // Blank lines between requests are ignored
+  while ((consumed < c->used) && ((c->buffer[consumed] == '\r') || (c->buffer[consumed] == '\n'))) {
+    consumed++;
+  }
+  c->used -= consumed;
+  memmove(c->buffer, &c->buffer[consumed], c->used);
+  c->scanned = 0;
+  c->overflow = 0;
+
+  c->busy = c->response_has_body;
+  c->closing = c->response_closes;
+}
+
+int xtcp_http_sent(void *conn) {
+  http_conn_t *c = conn;
+  c->busy = 0;
+  return c->closing;
+}
+
+int xtcp_http_remote_closed(void *conn) {
+  http_conn_t *c = conn;
+  // No further requests can arrive, but the response being sent is allowed to finish
+  c->closing = 1;
+  return !c->busy;
+}
+
+xtcp_http_stats_t xtcp_http_get_stats(void) { return stats; }
+
+#endif /* XTCP_HTTP_ENABLE */
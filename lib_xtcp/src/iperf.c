@@ -0,0 +1,168 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "xtcp_iperf.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if XTCP_IPERF_ENABLE
+
+#define TICKS_PER_MS 100000u
+#define INTERVAL_TICKS ((uint64_t)XTCP_IPERF_INTERVAL_MS * TICKS_PER_MS)
+
+/* A session's time is kept as the ticks elapsed since it started, added up from the reference timer so that sessions
+ * can run for longer than the timer takes to wrap. */
+typedef struct iperf_session_t {
+  int32_t id;
+  int active;
+  int expired;              // Already returned by xtcp_iperf_tick()
+  xtcp_iperf_role_t role;
+  uint32_t last;            // Reference time elapsed was last brought up to
+  uint64_t elapsed;
+  uint64_t interval_start;  // Elapsed ticks at the start of the interval in progress
+  uint64_t interval_bytes;
+  uint64_t total_bytes;
+  uint64_t duration;        // Ticks a client sends for
+} iperf_session_t;
+
+static iperf_session_t sessions[XTCP_IPERF_MAX_SESSIONS];
+
+void xtcp_iperf_init(void) { memset(sessions, 0, sizeof(sessions)); }
+
+static iperf_session_t *find_session(int32_t id) {
+  for (uint32_t i = 0; i < XTCP_IPERF_MAX_SESSIONS; ++i) {
+    if (sessions[i].active && (sessions[i].id == id)) {
+      return &sessions[i];
+    }
+  }
+  return NULL;
+}
+
+static void report(const iperf_session_t *s, uint64_t start, uint64_t end, uint64_t bytes, int final) {
+  xtcp_iperf_report_t r;
+  r.role = s->role;
+  r.id = s->id;
+  r.start_ms = (uint32_t)(start / TICKS_PER_MS);
+  r.end_ms = (uint32_t)(end / TICKS_PER_MS);
+  r.bytes = bytes;
+  // Kbit/s is bits per millisecond
+  uint64_t ms = (end - start) / TICKS_PER_MS;
+  r.kbits_per_second = (ms != 0) ? (uint32_t)((bytes * 8) / ms) : 0;
+  r.final = final;
+  xtcp_iperf_report(&r);
+}
+
+/* Bring a session up to the reference time, reporting each interval that has passed */
+static void advance(iperf_session_t *s, uint32_t now) {
+  s->elapsed += (uint32_t)(now - s->last);
+  s->last = now;
+  while (s->elapsed - s->interval_start >= INTERVAL_TICKS) {
+    report(s, s->interval_start, s->interval_start + INTERVAL_TICKS, s->interval_bytes, 0);
+    s->interval_start += INTERVAL_TICKS;
+    s->interval_bytes = 0;
+  }
+}
+
+xtcp_error_code_t xtcp_iperf_open(int32_t id, xtcp_iperf_role_t role, uint32_t now, uint32_t duration_ms) {
+  if (find_session(id) != NULL) {
+    return XTCP_EINVAL;
+  }
+  for (uint32_t i = 0; i < XTCP_IPERF_MAX_SESSIONS; ++i) {
+    iperf_session_t *s = &sessions[i];
+    if (!s->active) {
+      memset(s, 0, sizeof(*s));
+      s->id = id;
+      s->active = 1;
+      s->role = role;
+      s->last = now;
+      s->duration = (uint64_t)duration_ms * TICKS_PER_MS;
+      return XTCP_SUCCESS;
+    }
+  }
+  return XTCP_ENOMEM;
+}
+
+int xtcp_iperf_has_session(int32_t id) { return find_session(id) != NULL; }
+
+void xtcp_iperf_count(int32_t id, uint32_t bytes, uint32_t now) {
+  iperf_session_t *s = find_session(id);
+  if (s != NULL) {
+    // Bytes arriving after an interval has ended belong to the next one
+    advance(s, now);
+    s->interval_bytes += bytes;
+    s->total_bytes += bytes;
+  }
+}
+
+int xtcp_iperf_done(int32_t id, uint32_t now) {
+  iperf_session_t *s = find_session(id);
+  if ((s == NULL) || (s->role != XTCP_IPERF_CLIENT)) {
+    return 0;
+  }
+  advance(s, now);
+  return s->elapsed >= s->duration;
+}
+
+int32_t xtcp_iperf_tick(uint32_t now) {
+  int32_t expired = -1;
+  for (uint32_t i = 0; i < XTCP_IPERF_MAX_SESSIONS; ++i) {
+    iperf_session_t *s = &sessions[i];
+    if (!s->active) {
+      continue;
+    }
+    advance(s, now);
+    if ((expired < 0) && (s->role == XTCP_IPERF_CLIENT) && !s->expired && (s->elapsed >= s->duration)) {
+      s->expired = 1;
+      expired = s->id;
+    }
+  }
+  return expired;
+}
+
+void xtcp_iperf_close(int32_t id, uint32_t now) {
+  iperf_session_t *s = find_session(id);
+  if (s == NULL) {
+    return;
+  }
+  advance(s, now);
+  if (s->elapsed > s->interval_start) {
+    report(s, s->interval_start, s->elapsed, s->interval_bytes, 0);
+  }
+  report(s, 0, s->elapsed, s->total_bytes, 1);
+  s->active = 0;
+}
+
+static void put_be32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value >> 24);
+  p[1] = (uint8_t)(value >> 16);
+  p[2] = (uint8_t)(value >> 8);
+  p[3] = (uint8_t)value;
+}
+
+void xtcp_iperf_client_header(uint8_t header[XTCP_IPERF_HEADER_LENGTH], uint32_t duration_ms) {
+  // flags, number of threads, port, buffer length, window/bandwidth and amount, as lwiperf sends them. No flags asks
+  // for no test in the other direction, a negative amount is the test's time in 10ms units.
+  put_be32(&header[0], 0);
+  put_be32(&header[4], 1);
+  put_be32(&header[8], XTCP_IPERF_DEFAULT_PORT);
+  put_be32(&header[12], 0);
+  put_be32(&header[16], 0);
+  put_be32(&header[20], (uint32_t)(-(int32_t)(duration_ms / 10)));
+}
+
+void xtcp_iperf_fill(uint8_t buffer[], uint32_t length) {
+  for (uint32_t i = 0; i < length; ++i) {
+    buffer[i] = (uint8_t)('0' + (i % 10));
+  }
+}
+
+__attribute__((weak)) void xtcp_iperf_report(const xtcp_iperf_report_t *report) {
+  printf("[%3ld] %3lu.%01lu-%3lu.%01lu sec %8lu KBytes %8lu Kbits/sec%s\n", (long)report->id,
+         (unsigned long)(report->start_ms / 1000), (unsigned long)((report->start_ms % 1000) / 100),
+         (unsigned long)(report->end_ms / 1000), (unsigned long)((report->end_ms % 1000) / 100),
+         (unsigned long)(report->bytes / 1024), (unsigned long)report->kbits_per_second,
+         report->final ? ((report->role == XTCP_IPERF_SERVER) ? " received" : " sent") : "");
+}
+
+#endif /* XTCP_IPERF_ENABLE */
@@ -11,6 +11,11 @@
 #include "connection.h"
 #include "debug_print.h"
 #include "dns_found.h"
+#include "rx_filter.h"
+#include "static_send.h"
+#include "tcp_transport.h"
+#include "trace.h"
+#include "udp_fast_path.h"
 #include "udp_recv.h"
 
 /* LwIP headers */
@@ -83,6 +88,7 @@ void shim_close_socket(unsigned client_num, int32_t id) {
     }
   }
   free_client_connection(id);
+  rx_filter_sync();
 }
 
 xtcp_error_code_t shim_listen(unsigned client_num, int32_t id, uint16_t port_number, xtcp_ipaddr_t ipaddr) {
@@ -127,6 +133,9 @@ xtcp_error_code_t shim_listen(unsigned client_num, int32_t id, uint16_t port_num
     }
   }
 
+  if (result == XTCP_SUCCESS) {
+    rx_filter_sync();
+  }
   return result;
 }
 
@@ -149,6 +158,10 @@ xtcp_error_int32_t shim_accept(unsigned client_num, struct tcp_pcb* new_pcb, int
 
       set_tcp_pcb(new_index, new_pcb);
       tcp_arg(new_pcb, (void*)new_index);
+
+      // Low watermarks set on the listening socket apply to the connections it accepts
+      (void)set_send_lowat(new_index, get_send_lowat(old_id));
+      (void)set_recv_lowat(new_index, get_recv_lowat(old_id));
     }
   }
 
@@ -169,6 +182,8 @@ xtcp_error_code_t shim_connect(unsigned client_num, int32_t id, uint16_t port_nu
   if (protocol == XTCP_PROTOCOL_TCP) {
     struct tcp_pcb* tcp_pcb = get_tcp_pcb(id);
     if (tcp_pcb != NULL) {
+      // Events on the connection are raised against its index
+      tcp_arg(tcp_pcb, (void*)id);
       err_t err = tcp_connect(tcp_pcb, &remote_addr, port_number, NULL);
       if (err == ERR_OK) {
         result = XTCP_SUCCESS;
@@ -187,6 +202,9 @@ xtcp_error_code_t shim_connect(unsigned client_num, int32_t id, uint16_t port_nu
     }
   }
 
+  if (result == XTCP_SUCCESS) {
+    rx_filter_sync();
+  }
   return result;
 }
 
@@ -206,23 +224,55 @@ xtcp_error_code_t shim_send(unsigned client_num, int32_t id, void* buffer_token)
   xtcp_protocol_t protocol = get_protocol(id);
   if (protocol == XTCP_PROTOCOL_UDP) {
     struct udp_pcb* udp_pcb = get_udp_pcb(id);
-    if (udp_pcb != NULL) {
-      err_t error = udp_send(udp_pcb, new_pbuf);
+    // Larger datagrams need more fragments than the stack is configured for
+    if ((udp_pcb != NULL) && (new_pbuf->tot_len <= XTCP_UDP_MAX_DATAGRAM_SIZE)) {
+      u16_t local_port = udp_pcb->local_port;
+      err_t error;
+      if (!udp_fast_path_send(id, udp_pcb, new_pbuf, &error)) {
+        void *payload = new_pbuf->payload;
+        error = udp_send(udp_pcb, new_pbuf);
+        udp_fast_path_update(id, udp_pcb, new_pbuf, payload);
+      }
       if (error == ERR_OK) {
         result = XTCP_SUCCESS;
+      } else if (error == ERR_MEM) {
+        // No buffer or output queue space, the datagram was not sent and the client can retry
+        result = XTCP_ENOMEM;
+      }
+      if (local_port != udp_pcb->local_port) {
+        // Sending from an unbound socket binds it, replies must reach it
+        rx_filter_sync();
       }
     }
     pbuf_free(new_pbuf);
 
   } else if (protocol == XTCP_PROTOCOL_TCP) {
     struct tcp_pcb* tcp_pcb = get_tcp_pcb(id);
-    if (tcp_pcb != NULL) {
-      // TODO - move tcp write to new function, using memory pools of other buffer
-      err_t error = tcp_write(tcp_pcb, new_pbuf->payload, new_pbuf->len, TCP_WRITE_FLAG_COPY);
-      if (error == ERR_OK) {
-        err_t output = tcp_output(tcp_pcb);  // Ensure data is sent immediately
-        if (output == ERR_OK) {
-          result = XTCP_SUCCESS;
+    if (static_send_pending(id)) {
+      // Data sent now would be acknowledged inside the static send
+      result = XTCP_EAGAIN;
+    } else if (tcp_pcb != NULL) {
+      // Unacknowledged data counts against the client's quota until LWIP_EVENT_SENT
+      result = charge_tx_bytes(id, new_pbuf->len);
+      if (result == XTCP_SUCCESS) {
+        result = XTCP_EINVAL;
+        // TODO - move tcp write to new function, using memory pools of other buffer
+        err_t error = tcp_write(tcp_pcb, new_pbuf->payload, new_pbuf->len, TCP_WRITE_FLAG_COPY);
+        TRACE(TRACE_TCP_WRITE, client_num, id, new_pbuf->len, error);
+        if (error == ERR_OK) {
+          arm_writable_event(id);
+          err_t output = tcp_output(tcp_pcb);  // Ensure data is sent immediately
+          TRACE(TRACE_TCP_OUTPUT, client_num, id, 0, output);
+          // With a full output queue the data stays queued in LwIP, which sends it from its timer
+          if ((output == ERR_OK) || (output == ERR_MEM)) {
+            result = XTCP_SUCCESS;
+          }
+        } else {
+          release_tx_bytes(id, new_pbuf->len);
+          if (error == ERR_MEM) {
+            // Send buffer or queue full, the client can retry once get_send_space() allows
+            result = XTCP_EAGAIN;
+          }
         }
       }
     }
@@ -231,6 +281,22 @@ xtcp_error_code_t shim_send(unsigned client_num, int32_t id, void* buffer_token)
   return result;
 }
 
+xtcp_error_int32_t shim_get_send_space(unsigned client_num, int32_t id) {
+  xtcp_error_int32_t result = find_client_connection(client_num, id);
+  if (result.status != XTCP_SUCCESS) {
+    // Bad parameter or inactive connection
+    return result;
+  }
+
+  if (get_protocol(id) != XTCP_PROTOCOL_TCP) {
+    result.status = XTCP_EPROTONOSUPPORT;
+    result.value = -1;
+  } else {
+    result.value = static_send_pending(id) ? 0 : (int32_t)get_tcp_send_space(id);
+  }
+  return result;
+}
+
 xtcp_error_code_t shim_sendto(unsigned client_num, int32_t id, void* buffer_token, xtcp_ipaddr_t remote_addr, uint16_t remote_port) {
   xtcp_error_code_t result = XTCP_EINVAL;
   if (buffer_token == NULL) {
@@ -246,12 +312,21 @@ xtcp_error_code_t shim_sendto(unsigned client_num, int32_t id, void* buffer_toke
   xtcp_protocol_t protocol = get_protocol(id);
   if (protocol == XTCP_PROTOCOL_UDP) {
     struct udp_pcb* udp_pcb = get_udp_pcb(id);
-    if (udp_pcb != NULL) {
+    // Larger datagrams need more fragments than the stack is configured for
+    if ((udp_pcb != NULL) && (new_pbuf->tot_len <= XTCP_UDP_MAX_DATAGRAM_SIZE)) {
       ip_addr_t addr;
       memcpy(&addr, remote_addr, sizeof(ip_addr_t));
+      u16_t local_port = udp_pcb->local_port;
       err_t error = udp_sendto(udp_pcb, new_pbuf, &addr, remote_port);
       if (error == ERR_OK) {
         result = XTCP_SUCCESS;
+      } else if (error == ERR_MEM) {
+        // No buffer or output queue space, the datagram was not sent and the client can retry
+        result = XTCP_ENOMEM;
+      }
+      if (local_port != udp_pcb->local_port) {
+        // Sending from an unbound socket binds it, replies must reach it
+        rx_filter_sync();
       }
     }
     pbuf_free(new_pbuf);
@@ -274,6 +349,7 @@ xtcp_error_code_t shim_join_multicast_group(xtcp_ipaddr_t addr) {
   err_t err = igmp_joingroup(&netif_addr, &group_addr);
   if (err == ERR_OK) {
     result = XTCP_SUCCESS;
+    rx_filter_sync();
   }
   return result;
 }
@@ -289,6 +365,7 @@ xtcp_error_code_t shim_leave_multicast_group(xtcp_ipaddr_t addr) {
   err_t err = igmp_leavegroup(&netif_addr, &group_addr);
   if (err == ERR_OK) {
     result = XTCP_SUCCESS;
+    rx_filter_sync();
   }
   return result;
 }
@@ -306,6 +383,8 @@ xtcp_host_t shim_request_host_by_name(unsigned client_num, const uint8_t hostnam
     memcpy(result.ipaddr, &ipaddr, sizeof(ip_addr_t));
   } else if (dns_result == ERR_INPROGRESS) {
     // DNS request is in progress, result will be available when XTCP_DNS_RESULT event is received
+    // The query may use a newly bound source port
+    rx_filter_sync();
   } else {
     debug_printf("shim_request_host_by_name: DNS request failed for %s, err %d\n", hostname, dns_result);
   }
@@ -377,6 +456,30 @@ static xtcp_error_code_t shim_ip_getsockopt(int32_t id, uint32_t option, uint8_t
   return XTCP_SUCCESS;
 }
 
+static xtcp_error_code_t shim_socket_getsockopt(int32_t id, uint32_t option, uint8_t value[], uint32_t *length) {
+  uint32_t bytes;
+
+  if (get_protocol(id) != XTCP_PROTOCOL_TCP)
+    return XTCP_EPROTONOSUPPORT;
+  if (*length < sizeof(bytes))
+    return XTCP_EINVAL;
+
+  switch ((xtcp_socket_option_t)option) {
+  case XTCP_SOCKET_OPTION_SNDLOWAT:
+    bytes = get_send_lowat(id);
+    break;
+  case XTCP_SOCKET_OPTION_RCVLOWAT:
+    bytes = get_recv_lowat(id);
+    break;
+  default:
+    return XTCP_EINVAL;
+  }
+
+  memcpy(value, &bytes, sizeof(bytes));
+  *length = sizeof(bytes);
+  return XTCP_SUCCESS;
+}
+
 xtcp_error_code_t shim_getsockopt(unsigned client_num, int32_t id, xtcp_socket_level_t level, uint32_t option, uint8_t value[], uint32_t *length) {
   xtcp_error_int32_t connection = find_client_connection(client_num, id);
   if (connection.status != XTCP_SUCCESS) {
@@ -390,6 +493,9 @@ xtcp_error_code_t shim_getsockopt(unsigned client_num, int32_t id, xtcp_socket_l
   case XTCP_SOCKET_LEVEL_IP:
     result = shim_ip_getsockopt(id, option, value, length);
     break;
+  case XTCP_SOCKET_LEVEL_SOCKET:
+    result = shim_socket_getsockopt(id, option, value, length);
+    break;
   default:
     result = XTCP_EINVAL;
     break;
@@ -458,6 +564,32 @@ static xtcp_error_code_t shim_ip_setsockopt(int32_t id, uint32_t option, const u
   return XTCP_SUCCESS;
 }
 
+static xtcp_error_code_t shim_socket_setsockopt(unsigned client_num, int32_t id, uint32_t option, const uint8_t value[],
+                                                uint32_t length) {
+  uint32_t bytes;
+
+  if (get_protocol(id) != XTCP_PROTOCOL_TCP)
+    return XTCP_EPROTONOSUPPORT;
+  if (length < sizeof(bytes))
+    return XTCP_EINVAL;
+  memcpy(&bytes, value, sizeof(bytes));
+
+  switch ((xtcp_socket_option_t)option) {
+  case XTCP_SOCKET_OPTION_SNDLOWAT:
+    return set_send_lowat(id, bytes);
+  case XTCP_SOCKET_OPTION_RCVLOWAT: {
+    xtcp_error_code_t result = set_recv_lowat(id, bytes);
+    if (result == XTCP_SUCCESS) {
+      // A lower watermark may already be reached by the data held
+      release_held_recv_events(client_num, id);
+    }
+    return result;
+  }
+  default:
+    return XTCP_EINVAL;
+  }
+}
+
 xtcp_error_code_t shim_setsockopt(unsigned client_num, int32_t id, xtcp_socket_level_t level, uint32_t option, const uint8_t value[], uint32_t length) {
   xtcp_error_int32_t connection = find_client_connection(client_num, id);
   if (connection.status != XTCP_SUCCESS) {
@@ -471,6 +603,9 @@ xtcp_error_code_t shim_setsockopt(unsigned client_num, int32_t id, xtcp_socket_l
   case XTCP_SOCKET_LEVEL_IP:
     result = shim_ip_setsockopt(id, option, value, length);
     break;
+  case XTCP_SOCKET_LEVEL_SOCKET:
+    result = shim_socket_setsockopt(client_num, id, option, value, length);
+    break;
   default:
     result = XTCP_EINVAL;
     break;
@@ -22,6 +22,7 @@ xtcp_error_code_t shim_connect(unsigned client_num, int32_t id, uint16_t port_nu
 
 xtcp_error_code_t shim_send(unsigned client_num, int32_t id, void* unsafe buffer_token);
 xtcp_error_code_t shim_sendto(unsigned client_num, int32_t id, void* unsafe buffer_token, xtcp_ipaddr_t remote_addr, uint16_t remote_port);
+xtcp_error_int32_t shim_get_send_space(unsigned client_num, int32_t id);
 
 xtcp_error_code_t shim_join_multicast_group(xtcp_ipaddr_t addr);
 xtcp_error_code_t shim_leave_multicast_group(xtcp_ipaddr_t addr);
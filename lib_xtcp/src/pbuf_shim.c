@@ -7,16 +7,23 @@
 #include <string.h>
 
 /* XTCP headers */
-#include "debug_print.h"
+#include "deferred_log.h"
+#include "trace.h"
+#include "tx_pool.h"
 
 /* LwIP headers */
 #include "lwip/pbuf.h"
 
 
-void* pbuf_shim_alloc_tx(uint16_t length, int send_timed) {
-  struct pbuf* p = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+void* pbuf_shim_alloc_tx(uint32_t length, int send_timed) {
+  if (length > UINT16_MAX) {
+    DEFERRED_LOG(LOG_PBUF_BAD_LENGTH, length, 0);
+    return NULL;
+  }
+  struct pbuf* p = tx_pool_alloc((uint16_t)length);
+  TRACE(TRACE_PBUF_ALLOC, TRACE_NO_CLIENT, TRACE_NO_ID, length, (uintptr_t)p);
   if (p == NULL) {
-    debug_printf("Failed to allocate pbuf of type %d and length %d/%d\n", PBUF_TRANSPORT, length, p->tot_len);
+    DEFERRED_LOG(LOG_PBUF_ALLOC_FAILED, PBUF_TRANSPORT, length);
   } else if (send_timed) {
     p->flags |= PBUF_FLAG_TX_TIMESTAMP;
   }
@@ -26,7 +33,7 @@ void* pbuf_shim_alloc_tx(uint16_t length, int send_timed) {
 void* unsafe pbuf_shim_token_payload(void* unsafe buffer_token) {
   struct pbuf* p = buffer_token;
   if (p == NULL) {
-    debug_printf("Bad parameter, pbuf token\n");
+    DEFERRED_LOG(LOG_PBUF_BAD_TOKEN, 0, 0);
     return NULL;
   }
   return p->payload;
@@ -35,7 +42,7 @@ void* unsafe pbuf_shim_token_payload(void* unsafe buffer_token) {
 uint32_t unsafe pbuf_shim_token_timestamp(void* unsafe buffer_token) {
   struct pbuf* p = buffer_token;
   if (p == NULL) {
-    debug_printf("Bad parameter, pbuf token\n");
+    DEFERRED_LOG(LOG_PBUF_BAD_TOKEN, 0, 0);
     return 0;
   }
   return p->timestamp;
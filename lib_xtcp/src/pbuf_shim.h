@@ -10,7 +10,7 @@
 #include "xtcp.h"
 
 /* allocate a lwip 'struct pbuf' from XC code. Returns pointer to pbuf as a void*, or buffer token. */
-void* unsafe pbuf_shim_alloc_tx(uint16_t length, int send_timed);
+void* unsafe pbuf_shim_alloc_tx(uint32_t length, int send_timed);
 
 /* Converts a buffer token (void*) to a pointer to the pbuf payload. */
 void* unsafe pbuf_shim_token_payload(void* unsafe buffer_token);
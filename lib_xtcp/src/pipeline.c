@@ -0,0 +1,236 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "pipeline.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <xcore/channel_streaming.h>
+
+/* XTCP headers */
+#include "capture.h"
+#include "rx_filter.h"
+#include "trace.h"
+#include "xtcp_chksum.h"
+
+/* LwIP headers, opt.h for the TCP_SND_BUF and TCP_MSS of the XTCP_PIPELINE_TX_FRAMES default */
+#include "lwip/netif.h"
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "lwip/prot/ethernet.h"
+#include "lwip/prot/ip4.h"
+#include "netif/ethernetif.h"
+
+#define ARP_PACKET_SIZE 28
+
+pipeline_rx_class_t pipeline_rx_classify(const uint8_t frame[], uint32_t len) {
+  if (len < SIZEOF_ETH_HDR) {
+    return PIPELINE_RX_INVALID;
+  }
+
+  uint16_t type = (uint16_t)((frame[12] << 8) | frame[13]);
+  if (type == ETHTYPE_ARP) {
+    return (len < SIZEOF_ETH_HDR + ARP_PACKET_SIZE) ? PIPELINE_RX_INVALID : PIPELINE_RX_PASS;
+  } else if (type != ETHTYPE_IP) {
+    return PIPELINE_RX_UNSUPPORTED;
+  }
+
+  const uint8_t *ip = &frame[SIZEOF_ETH_HDR];
+  uint32_t ip_len = len - SIZEOF_ETH_HDR;
+  if (ip_len < IP_HLEN || (ip[0] >> 4) != 4) {
+    return PIPELINE_RX_INVALID;
+  }
+  uint32_t header_len = (uint32_t)(ip[0] & 0x0F) * 4;
+  uint32_t total_len = (uint32_t)((ip[2] << 8) | ip[3]);
+  if (header_len < IP_HLEN || header_len > ip_len || total_len < header_len || total_len > ip_len) {
+    return PIPELINE_RX_INVALID;
+  }
+  // The sum of a valid header including its checksum is all ones
+  if (xtcp_chksum(ip, (uint16_t)header_len) != 0xFFFF) {
+    return PIPELINE_RX_INVALID;
+  }
+  return PIPELINE_RX_PASS;
+}
+
+#if XTCP_PIPELINE_ENABLE
+
+/* The queues are single producer, single consumer rings shared by two logical cores on the same tile. The producer
+ * only writes head and the consumer only writes tail, both count up and wrap, so no lock is needed. A frame is
+ * written before head is advanced and read before tail is advanced. The indices are volatile but the frames are not,
+ * so a compiler barrier keeps the frame accesses after each read of the other side's index and before each publish
+ * of this side's. */
+
+#define PIPELINE_BARRIER() asm volatile("" ::: "memory")
+
+typedef struct pipeline_frame_t {
+  uint32_t len;
+  uint32_t timestamp;
+  uint32_t data[(ETHERNET_MAX_PACKET_SIZE + 3) / 4];
+} pipeline_frame_t;
+
+typedef struct pipeline_ring_t {
+  volatile uint32_t head;
+  volatile uint32_t tail;
+} pipeline_ring_t;
+
+static pipeline_ring_t rx_ring;
+static pipeline_ring_t tx_ring;
+static pipeline_frame_t rx_frames[XTCP_PIPELINE_RX_FRAMES];
+static pipeline_frame_t tx_frames[XTCP_PIPELINE_TX_FRAMES];
+
+/* Latest link status from the front end, the sequence number counts changes so none are missed by the stack task */
+static volatile int link_status;
+static volatile uint32_t link_status_seq;
+static uint32_t link_status_seen;
+
+static xtcp_pipeline_stats_t stats;
+static streaming_chanend_t c_notify_frontend;
+
+/* Replaces the netif linkoutput in pipelined mode, the frame is copied to the transmit queue for the front end */
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t pipeline_linkoutput(struct netif *netif, struct pbuf *p) {
+  (void)netif;
+  uint32_t head = tx_ring.head;
+
+  if (head - tx_ring.tail >= XTCP_PIPELINE_TX_FRAMES) {
+    stats.tx_queue_full++;
+    return ERR_MEM;
+  }
+  PIPELINE_BARRIER();
+  if (p->tot_len > ETHERNET_MAX_PACKET_SIZE) {
+    return ERR_BUF;
+  }
+
+  pipeline_frame_t *frame = &tx_frames[head % XTCP_PIPELINE_TX_FRAMES];
+  frame->len = pbuf_copy_partial(p, frame->data, p->tot_len, 0);
+  frame->timestamp = 0;
+  PIPELINE_BARRIER();
+  tx_ring.head = head + 1;
+
+  // Only notify when the front end has sent every earlier frame, otherwise it is still draining the queue
+  if (tx_ring.tail == head) {
+    s_chan_out_word((chanend_t)c_notify_frontend, 0);
+  }
+  return ERR_OK;
+}
+
+void pipeline_init(streaming_chanend_t c_frontend) {
+  memset(&stats, 0, sizeof(stats));
+  rx_ring.head = rx_ring.tail = 0;
+  tx_ring.head = tx_ring.tail = 0;
+  link_status_seq = link_status_seen = 0;
+  c_notify_frontend = c_frontend;
+
+  netif_default->linkoutput = pipeline_linkoutput;
+}
+
+int pipeline_rx_push(const uint8_t frame[], uint32_t len, uint32_t timestamp, unsigned type) {
+  if (type == ETH_IF_STATUS) {
+    link_status = frame[0];
+    PIPELINE_BARRIER();
+    link_status_seq++;
+    return 1;
+  } else if (type != ETH_DATA) {
+    return 0;
+  }
+
+  pipeline_rx_class_t rx_class = pipeline_rx_classify(frame, len);
+  if (rx_class == PIPELINE_RX_INVALID) {
+    stats.rx_invalid++;
+    return 0;
+  } else if (rx_class == PIPELINE_RX_UNSUPPORTED) {
+    stats.rx_unsupported++;
+    return 0;
+  }
+
+  uint32_t head = rx_ring.head;
+  if (head - rx_ring.tail >= XTCP_PIPELINE_RX_FRAMES) {
+    stats.rx_queue_full++;
+    return 0;
+  }
+  PIPELINE_BARRIER();
+
+  pipeline_frame_t *slot = &rx_frames[head % XTCP_PIPELINE_RX_FRAMES];
+  memcpy(slot->data, frame, len);
+  slot->len = len;
+  slot->timestamp = timestamp;
+  PIPELINE_BARRIER();
+  rx_ring.head = head + 1;
+  stats.rx_frames++;
+
+  // Only notify when the stack task has taken every earlier frame, otherwise it is still draining the queue
+  return rx_ring.tail == head;
+}
+
+int pipeline_rx_drain(void) {
+  int status = PIPELINE_NO_LINK_CHANGE;
+  uint32_t seq = link_status_seq;
+  PIPELINE_BARRIER();
+  if (seq != link_status_seen) {
+    link_status_seen = seq;
+    status = link_status;
+  }
+
+  uint32_t tail = rx_ring.tail;
+  while (tail != rx_ring.head) {
+    PIPELINE_BARRIER();
+    pipeline_frame_t *frame = &rx_frames[tail % XTCP_PIPELINE_RX_FRAMES];
+    CAPTURE_RX((const uint8_t *)frame->data, frame->len, frame->timestamp);
+    TRACE(TRACE_RX_FRAME, TRACE_NO_CLIENT, TRACE_NO_ID, frame->len, frame->timestamp);
+    if (rx_filter_accept((const uint8_t *)frame->data, frame->len, frame->timestamp)) {
+      ethernetif_input((uint8_t *)frame->data, frame->len, frame->timestamp);
+    }
+    tail++;
+    PIPELINE_BARRIER();
+    rx_ring.tail = tail;
+  }
+  return status;
+}
+
+uint32_t pipeline_tx_pop(uint8_t frame[]) {
+  uint32_t tail = tx_ring.tail;
+  if (tail == tx_ring.head) {
+    return 0;
+  }
+  PIPELINE_BARRIER();
+
+  pipeline_frame_t *slot = &tx_frames[tail % XTCP_PIPELINE_TX_FRAMES];
+  uint32_t len = slot->len;
+  memcpy(frame, slot->data, len);
+  PIPELINE_BARRIER();
+  tx_ring.tail = tail + 1;
+  stats.tx_frames++;
+  return len;
+}
+
+xtcp_pipeline_stats_t pipeline_get_stats(void) {
+  return stats;
+}
+
+#else
+
+void pipeline_init(streaming_chanend_t c_frontend) { (void)c_frontend; }
+
+int pipeline_rx_push(const uint8_t frame[], uint32_t len, uint32_t timestamp, unsigned type) {
+  (void)frame;
+  (void)len;
+  (void)timestamp;
+  (void)type;
+  return 0;
+}
+
+int pipeline_rx_drain(void) { return PIPELINE_NO_LINK_CHANGE; }
+
+uint32_t pipeline_tx_pop(uint8_t frame[]) {
+  (void)frame;
+  return 0;
+}
+
+xtcp_pipeline_stats_t pipeline_get_stats(void) {
+  xtcp_pipeline_stats_t result;
+  memset(&result, 0, sizeof(result));
+  return result;
+}
+
+#endif /* XTCP_PIPELINE_ENABLE */
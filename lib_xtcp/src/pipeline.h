@@ -0,0 +1,73 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_PIPELINE_H
+#define XTCP_PIPELINE_H
+
+#include <stdint.h>
+#include <xccompat.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** No link status change is pending */
+#define PIPELINE_NO_LINK_CHANGE (-1)
+
+/** Front end classification of a received frame */
+typedef enum pipeline_rx_class_t {
+  PIPELINE_RX_PASS,         /**< Pass the frame to lwIP */
+  PIPELINE_RX_INVALID,      /**< Malformed Ethernet, ARP or IPv4 header */
+  PIPELINE_RX_UNSUPPORTED,  /**< EtherType other than ARP or IPv4 */
+} pipeline_rx_class_t;
+
+/** Check the headers of a received frame, for the frames lwIP would drop.
+ *
+ * \param frame       The frame, starting with the Ethernet header.
+ * \param len         The length of the frame in bytes.
+ * \returns           The classification of the frame.
+ */
+pipeline_rx_class_t pipeline_rx_classify(const uint8_t frame[], uint32_t len);
+
+/** Initialise the frame queues and direct lwIP output to the transmit queue.
+ *
+ * Called by the TCP/IP stack task after the network interface is initialised, before the front end is started.
+ *
+ * \param c_frontend  The streaming channel used to notify the front end of frames to send.
+ */
+void pipeline_init(streaming_chanend_t c_frontend);
+
+/** Check a received frame and add it to the receive queue. Called by the front end.
+ *
+ * \param frame       The frame, or the link status for an ETH_IF_STATUS frame.
+ * \param len         The length of the frame in bytes.
+ * \param timestamp   The receive timestamp.
+ * \param type        The eth_packet_type_t of the frame.
+ * \returns           Non-zero if the TCP/IP stack task must be notified, zero if it has frames still to process or
+ *                    the frame was dropped.
+ */
+int pipeline_rx_push(const uint8_t frame[], uint32_t len, uint32_t timestamp, unsigned type);
+
+/** Pass every queued received frame to lwIP. Called by the TCP/IP stack task when notified.
+ *
+ * \returns           The latest link status from the front end, or PIPELINE_NO_LINK_CHANGE.
+ */
+int pipeline_rx_drain(void);
+
+/** Take the next frame to send from the transmit queue. Called by the front end when notified.
+ *
+ * \param frame       Buffer of at least ETHERNET_MAX_PACKET_SIZE bytes.
+ * \returns           The length of the frame, or zero if the queue is empty.
+ */
+uint32_t pipeline_tx_pop(uint8_t frame[]);
+
+/** Get the pipelined mode statistics */
+xtcp_pipeline_stats_t pipeline_get_stats(void);
+
+#ifdef __XC__
+}
+#endif
+
+#endif /* XTCP_PIPELINE_H */
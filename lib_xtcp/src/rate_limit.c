@@ -0,0 +1,36 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "rate_limit.h"
+
+#include <stdint.h>
+
+void rate_limit_init(rate_limit_t *limit, uint32_t rate, uint32_t burst) {
+  if (burst == 0) {
+    burst = 1;
+  }
+  limit->ticks_per_token = rate ? (RATE_LIMIT_TICKS_PER_SECOND + rate - 1) / rate : 0;
+  limit->capacity = (uint64_t)limit->ticks_per_token * burst;
+  limit->credit = limit->capacity;
+  limit->last = 0;
+}
+
+int rate_limit_take(rate_limit_t *limit, uint32_t now) {
+  if (limit->ticks_per_token == 0) {
+    return 1;
+  }
+
+  // The reference clock wraps every 43 seconds, an idle period longer than that refills by less than it should
+  uint32_t elapsed = now - limit->last;
+  limit->last = now;
+  limit->credit += elapsed;
+  if (limit->credit > limit->capacity) {
+    limit->credit = limit->capacity;
+  }
+
+  if (limit->credit < limit->ticks_per_token) {
+    return 0;
+  }
+  limit->credit -= limit->ticks_per_token;
+  return 1;
+}
@@ -0,0 +1,36 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_RATE_LIMIT_H
+#define XTCP_RATE_LIMIT_H
+
+#include <stdint.h>
+
+/** Reference clock ticks per second, the unit of the times passed to rate_limit_take() */
+#define RATE_LIMIT_TICKS_PER_SECOND 100000000
+
+/** Token bucket. Credit is held in reference clock ticks, one token being worth ticks_per_token. */
+typedef struct rate_limit_t {
+  uint64_t credit;          // Ticks of credit available, up to capacity
+  uint64_t capacity;        // Credit of a full bucket, burst tokens
+  uint32_t ticks_per_token; // Zero when unlimited
+  uint32_t last;            // Time credit was last added
+} rate_limit_t;
+
+/** Initialise a token bucket, starting full.
+ *
+ * \param limit   The bucket.
+ * \param rate    Tokens added per second, zero for no limit.
+ * \param burst   Maximum number of tokens held, at least one is always allowed.
+ */
+void rate_limit_init(rate_limit_t *limit, uint32_t rate, uint32_t burst);
+
+/** Take a token from the bucket.
+ *
+ * \param limit   The bucket.
+ * \param now     The reference clock time.
+ * \returns       Non-zero if a token was available, zero if the limit was exceeded.
+ */
+int rate_limit_take(rate_limit_t *limit, uint32_t now);
+
+#endif /* XTCP_RATE_LIMIT_H */
@@ -0,0 +1,287 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "rx_filter.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* XTCP headers */
+#include "rate_limit.h"
+
+/* LwIP headers */
+#include "lwip/igmp.h"
+#include "lwip/netif.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/prot/ethernet.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/udp.h"
+
+/* The tables hold one entry per lwIP socket or group, so they cannot fill while they match the lwIP pools. If one
+ * does fill, for example with a custom lwipopts.h, the filter passes everything for that table rather than drop
+ * traffic for a socket it does not know about. */
+#define MAX_UDP_PORTS   MEMP_NUM_UDP_PCB
+#define MAX_TCP_PORTS   MEMP_NUM_TCP_PCB_LISTEN
+#if LWIP_IGMP
+#define MAX_GROUPS      MEMP_NUM_IGMP_GROUP
+#else
+#define MAX_GROUPS      1
+#endif
+
+#define UDP_HEADER_SIZE 8
+#define TCP_HEADER_SIZE 20
+#define TCP_FLAGS_OFFSET 13
+#define TCP_FLAG_SYN 0x02
+#define TCP_FLAG_ACK 0x10
+#define ARP_OPCODE_OFFSET 6
+#define ARP_OPCODE_REQUEST 1
+#define ARP_TARGET_IP_OFFSET 24
+#define ICMP_TYPE_ECHO 8
+
+typedef struct port_table_t {
+  uint16_t ports[MAX_UDP_PORTS > MAX_TCP_PORTS ? MAX_UDP_PORTS : MAX_TCP_PORTS];
+  uint32_t count;
+  uint32_t max;
+  int overflow;
+} port_table_t;
+
+static port_table_t udp_ports = {.max = MAX_UDP_PORTS};
+static port_table_t tcp_listen_ports = {.max = MAX_TCP_PORTS};
+
+static uint32_t groups[MAX_GROUPS];
+static uint32_t num_groups;
+static int groups_overflow;
+
+static rate_limit_t arp_limit;
+static rate_limit_t arp_local_limit;
+static rate_limit_t icmp_echo_limit;
+static rate_limit_t unreachable_limit;
+static rate_limit_t broadcast_udp_limit;
+
+static xtcp_rx_filter_stats_t stats;
+
+static void table_add(port_table_t *table, uint16_t port) {
+  if (table->count < table->max) {
+    table->ports[table->count++] = port;
+  } else {
+    table->overflow = 1;
+  }
+}
+
+static int table_contains(const port_table_t *table, uint16_t port) {
+  if (table->overflow) {
+    return 1;
+  }
+  for (uint32_t i = 0; i < table->count; ++i) {
+    if (table->ports[i] == port) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+#if XTCP_RX_FILTER_ENABLE
+static int group_joined(const uint8_t addr[4]) {
+  if (groups_overflow) {
+    return 1;
+  }
+  uint32_t group;
+  memcpy(&group, addr, sizeof(group));
+  for (uint32_t i = 0; i < num_groups; ++i) {
+    if (groups[i] == group) {
+      return 1;
+    }
+  }
+  return 0;
+}
+#endif
+
+void rx_filter_clear(void) {
+  udp_ports.count = 0;
+  udp_ports.overflow = 0;
+  tcp_listen_ports.count = 0;
+  tcp_listen_ports.overflow = 0;
+  num_groups = 0;
+  groups_overflow = 0;
+}
+
+void rx_filter_add_udp_port(uint16_t port) {
+  table_add(&udp_ports, port);
+}
+
+void rx_filter_add_tcp_listen_port(uint16_t port) {
+  table_add(&tcp_listen_ports, port);
+}
+
+void rx_filter_add_group(const uint8_t group[4]) {
+  if (num_groups < MAX_GROUPS) {
+    memcpy(&groups[num_groups++], group, sizeof(uint32_t));
+  } else {
+    groups_overflow = 1;
+  }
+}
+
+void rx_filter_init(void) {
+  memset(&stats, 0, sizeof(stats));
+  rate_limit_init(&arp_limit, XTCP_RATE_LIMIT_ARP_REQUESTS, XTCP_RATE_LIMIT_ARP_BURST);
+  rate_limit_init(&arp_local_limit, XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS, XTCP_RATE_LIMIT_ARP_LOCAL_BURST);
+  rate_limit_init(&icmp_echo_limit, XTCP_RATE_LIMIT_ICMP_ECHO, XTCP_RATE_LIMIT_ICMP_ECHO_BURST);
+  rate_limit_init(&unreachable_limit, XTCP_RATE_LIMIT_ICMP_UNREACHABLE, XTCP_RATE_LIMIT_ICMP_UNREACHABLE_BURST);
+  rate_limit_init(&broadcast_udp_limit, XTCP_RATE_LIMIT_BROADCAST_UDP, XTCP_RATE_LIMIT_BROADCAST_UDP_BURST);
+  rx_filter_sync();
+}
+
+void rx_filter_sync(void) {
+  rx_filter_clear();
+
+  // Includes the sockets lwIP uses itself, such as DHCP and DNS
+  for (struct udp_pcb *pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+    if (pcb->local_port != 0) {
+      rx_filter_add_udp_port(pcb->local_port);
+    }
+  }
+  for (struct tcp_pcb_listen *pcb = tcp_listen_pcbs.listen_pcbs; pcb != NULL; pcb = pcb->next) {
+    rx_filter_add_tcp_listen_port(pcb->local_port);
+  }
+#if LWIP_IGMP
+  if (netif_default != NULL) {
+    for (struct igmp_group *group = netif_igmp_data(netif_default); group != NULL; group = group->next) {
+      rx_filter_add_group((const uint8_t *)&group->group_address);
+    }
+  }
+#endif
+}
+
+static int is_broadcast_mac(const uint8_t frame[]) {
+  for (uint32_t i = 0; i < 6; ++i) {
+    if (frame[i] != 0xFF) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Packets lwIP answers with an ICMP destination unreachable message, it never replies to a broadcast */
+static int accept_unreachable(const uint8_t frame[], uint32_t timestamp) {
+  if (is_broadcast_mac(frame) || rate_limit_take(&unreachable_limit, timestamp)) {
+    return 1;
+  }
+  stats.icmp_unreachable_rate_limited++;
+  return 0;
+}
+
+/* ARP requests for our own address, which a host must get answered to reach us */
+static int arp_for_netif(const uint8_t frame[], uint32_t len) {
+  if (netif_default == NULL || len < SIZEOF_ETH_HDR + ARP_TARGET_IP_OFFSET + 4) {
+    return 0;
+  }
+  const ip4_addr_t *addr = netif_ip4_addr(netif_default);
+  return !ip4_addr_isany(addr) && memcmp(&frame[SIZEOF_ETH_HDR + ARP_TARGET_IP_OFFSET], &addr->addr, 4) == 0;
+}
+
+/* Requests for our address have their own limit, so a storm of requests for other hosts cannot make us unreachable */
+static int accept_arp(const uint8_t frame[], uint32_t len, uint32_t timestamp) {
+  if (len < SIZEOF_ETH_HDR + ARP_OPCODE_OFFSET + 2 || frame[SIZEOF_ETH_HDR + ARP_OPCODE_OFFSET] != 0 ||
+      frame[SIZEOF_ETH_HDR + ARP_OPCODE_OFFSET + 1] != ARP_OPCODE_REQUEST) {
+    return 1;
+  }
+  rate_limit_t *limit = arp_for_netif(frame, len) ? &arp_local_limit : &arp_limit;
+  if (!rate_limit_take(limit, timestamp)) {
+    stats.arp_rate_limited++;
+    return 0;
+  }
+  return 1;
+}
+
+static int accept_ipv4(const uint8_t frame[], uint32_t len, uint32_t timestamp) {
+  const uint8_t *ip = &frame[SIZEOF_ETH_HDR];
+  const uint8_t *dest = &ip[16];
+  int multicast = (dest[0] & 0xF0) == 0xE0;
+#if XTCP_RX_FILTER_ENABLE
+  if (multicast && !group_joined(dest)) {
+    stats.multicast_not_joined++;
+    return 0;
+  }
+#endif
+
+  // Only the first fragment carries the transport header
+  if (((ip[6] & 0x1F) | ip[7]) != 0) {
+    return 1;
+  }
+
+  uint32_t header_len = (uint32_t)(ip[0] & 0x0F) * 4;
+  uint32_t ip_len = len - SIZEOF_ETH_HDR;
+  const uint8_t *transport = &ip[header_len];
+  if (header_len < IP_HLEN) {
+    // Malformed, lwIP drops and counts it
+    return 1;
+  }
+
+  switch (ip[9]) {
+  case IP_PROTO_UDP:
+    if (header_len + UDP_HEADER_SIZE <= ip_len) {
+      uint16_t port = (uint16_t)((transport[2] << 8) | transport[3]);
+      if (!table_contains(&udp_ports, port)) {
+#if XTCP_RX_FILTER_ENABLE
+        stats.udp_no_socket++;
+        return 0;
+#else
+        return multicast || accept_unreachable(frame, timestamp);
+#endif
+      }
+      if (is_broadcast_mac(frame) && !rate_limit_take(&broadcast_udp_limit, timestamp)) {
+        stats.broadcast_udp_rate_limited++;
+        return 0;
+      }
+    }
+    return 1;
+
+  case IP_PROTO_TCP:
+    if (header_len + TCP_HEADER_SIZE <= ip_len) {
+      // Only new connection requests are dropped, segments for existing and closing connections always reach lwIP
+      uint8_t flags = transport[TCP_FLAGS_OFFSET];
+      uint16_t port = (uint16_t)((transport[2] << 8) | transport[3]);
+      if (XTCP_RX_FILTER_ENABLE && (flags & (TCP_FLAG_SYN | TCP_FLAG_ACK)) == TCP_FLAG_SYN &&
+          !table_contains(&tcp_listen_ports, port)) {
+        stats.tcp_no_listener++;
+        return 0;
+      }
+    }
+    return 1;
+
+  case IP_PROTO_ICMP:
+    if (header_len < ip_len && transport[0] == ICMP_TYPE_ECHO && !rate_limit_take(&icmp_echo_limit, timestamp)) {
+      stats.icmp_echo_rate_limited++;
+      return 0;
+    }
+    return 1;
+
+  case IP_PROTO_IGMP:
+    return 1;
+
+  default:
+    return multicast || accept_unreachable(frame, timestamp);
+  }
+}
+
+int rx_filter_accept(const uint8_t frame[], uint32_t len, uint32_t timestamp) {
+  int accept = 1;
+  if (len >= SIZEOF_ETH_HDR) {
+    uint16_t type = (uint16_t)((frame[12] << 8) | frame[13]);
+    if (type == ETHTYPE_ARP) {
+      accept = accept_arp(frame, len, timestamp);
+    } else if (type == ETHTYPE_IP && len >= SIZEOF_ETH_HDR + IP_HLEN) {
+      accept = accept_ipv4(frame, len, timestamp);
+    }
+  }
+
+  if (accept) {
+    stats.accepted++;
+  }
+  return accept;
+}
+
+xtcp_rx_filter_stats_t rx_filter_get_stats(void) {
+  return stats;
+}
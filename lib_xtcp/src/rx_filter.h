@@ -0,0 +1,48 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_RX_FILTER_H
+#define XTCP_RX_FILTER_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Initialise the receive filter statistics and tables */
+void rx_filter_init(void);
+
+/** Rebuild the receive filter tables from the lwIP UDP sockets, TCP listening sockets and joined multicast groups.
+ *
+ * Called by the stack whenever it binds, connects or closes a socket, or joins or leaves a group.
+ */
+void rx_filter_sync(void);
+
+/** Check a received frame against the socket tables and rate limits before it is passed to lwIP.
+ *
+ * \param frame     The frame, starting with the Ethernet header.
+ * \param len       The length of the frame in bytes.
+ * \param timestamp The reference clock time the frame was received, used by the rate limits.
+ * \returns         Non-zero if the frame should be passed to lwIP, zero if it was dropped.
+ */
+int rx_filter_accept(const uint8_t frame[], uint32_t len, uint32_t timestamp);
+
+/** Get the receive filter statistics */
+xtcp_rx_filter_stats_t rx_filter_get_stats(void);
+
+#ifdef __XC__
+}
+#endif
+
+#ifndef __XC__
+/** Functions used by rx_filter_sync() to fill the tables, available for testing */
+void rx_filter_clear(void);
+void rx_filter_add_udp_port(uint16_t port);
+void rx_filter_add_tcp_listen_port(uint16_t port);
+void rx_filter_add_group(const uint8_t group[4]);
+#endif /* __XC__ */
+
+#endif /* XTCP_RX_FILTER_H */
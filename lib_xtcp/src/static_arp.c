@@ -0,0 +1,188 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "static_arp.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* XTCP headers */
+#include "udp_fast_path.h"
+
+/* LwIP headers */
+#include "lwip/def.h"
+#include "lwip/etharp.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/netif.h"
+#include "netif/ethernet.h"
+
+#if XTCP_ARP_HASH_TABLE_SIZE
+
+#if ((XTCP_ARP_HASH_TABLE_SIZE & (XTCP_ARP_HASH_TABLE_SIZE - 1)) != 0) || (XTCP_ARP_HASH_TABLE_SIZE < 2)
+#error "XTCP_ARP_HASH_TABLE_SIZE must be a power of two, at least 2"
+#endif
+
+#define ARP_HASH_BITS ((uint32_t)__builtin_ctz(XTCP_ARP_HASH_TABLE_SIZE))
+
+/* Open addressing with linear probing. A removed entry leaves a tombstone so later entries on the same probe
+ * sequence are still found, and is reused by the next insertion. */
+typedef enum slot_state_t {
+  SLOT_EMPTY = 0,
+  SLOT_USED,
+  SLOT_REMOVED,
+} slot_state_t;
+
+typedef struct arp_slot_t {
+  uint32_t addr;              // IPv4 address as stored by lwIP, network byte order in memory
+  struct eth_addr mac;
+  uint8_t state;
+} arp_slot_t;
+
+static arp_slot_t arp_table[XTCP_ARP_HASH_TABLE_SIZE];
+static uint32_t num_entries;
+
+static inline uint32_t arp_hash(uint32_t addr) {
+  // Fibonacci hashing of the address in host order, the last octet is in the low bits and the multiply carries them
+  // into the top bits, which are taken as the index. The low bits of the product depend only on the first octet.
+  return (lwip_ntohl(addr) * 2654435761u) >> (32 - ARP_HASH_BITS);
+}
+
+/* Finds the slot holding the address, counting the slots examined */
+static arp_slot_t *probe_slots(uint32_t addr, uint32_t *probes) {
+  uint32_t index = arp_hash(addr);
+  for (uint32_t probe = 0; probe < XTCP_ARP_HASH_TABLE_SIZE; ++probe) {
+    arp_slot_t *slot = &arp_table[(index + probe) & (XTCP_ARP_HASH_TABLE_SIZE - 1)];
+    *probes = probe + 1;
+    if (slot->state == SLOT_EMPTY) {
+      return NULL;
+    }
+    if (slot->state == SLOT_USED && slot->addr == addr) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+static arp_slot_t *find_slot(uint32_t addr) {
+  uint32_t probes;
+  return probe_slots(addr, &probes);
+}
+
+/* Replaces the netif IPv4 output. Destinations with a static entry, directly or as the gateway, are sent without
+ * going through the lwIP ARP table. Everything else, including broadcast and multicast, goes to etharp_output(). */
+__attribute__((fptrgroup("netif_output_fn")))
+static err_t static_arp_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr) {
+  if (num_entries != 0 && !ip4_addr_ismulticast(ipaddr) && !ip4_addr_isbroadcast(ipaddr, netif)) {
+    const ip4_addr_t *next_hop = ipaddr;
+    uint32_t mask = ip4_addr_get_u32(netif_ip4_netmask(netif));
+    if ((ip4_addr_get_u32(ipaddr) & mask) != (ip4_addr_get_u32(netif_ip4_addr(netif)) & mask) &&
+        !ip4_addr_islinklocal(ipaddr)) {
+      next_hop = netif_ip4_gw(netif);
+    }
+
+    arp_slot_t *slot = find_slot(ip4_addr_get_u32(next_hop));
+    if (slot != NULL) {
+      return ethernet_output(netif, p, (const struct eth_addr *)netif->hwaddr, &slot->mac, ETHTYPE_IP);
+    }
+  }
+  return etharp_output(netif, p, ipaddr);
+}
+
+const uint8_t *static_arp_lookup(const uint8_t ipaddr[4]) {
+  uint32_t addr;
+  memcpy(&addr, ipaddr, sizeof(addr));
+  arp_slot_t *slot = find_slot(addr);
+  return slot ? slot->mac.addr : NULL;
+}
+
+uint32_t static_arp_probes(const uint8_t ipaddr[4]) {
+  uint32_t addr;
+  uint32_t probes = 0;
+  memcpy(&addr, ipaddr, sizeof(addr));
+  (void)probe_slots(addr, &probes);
+  return probes;
+}
+
+#endif /* XTCP_ARP_HASH_TABLE_SIZE */
+
+void static_arp_init(void) {
+#if XTCP_ARP_HASH_TABLE_SIZE
+  memset(arp_table, 0, sizeof(arp_table));
+  num_entries = 0;
+  netif_default->output = static_arp_output;
+#endif
+}
+
+static int is_unicast(const ip4_addr_t *addr) {
+  return !ip4_addr_isany(addr) && !ip4_addr_ismulticast(addr) && ip4_addr_get_u32(addr) != IPADDR_BROADCAST;
+}
+
+xtcp_error_code_t static_arp_add(const uint8_t ipaddr[4], const uint8_t mac_address[6]) {
+  ip4_addr_t addr;
+  memcpy(&addr, ipaddr, sizeof(addr));
+  if (!is_unicast(&addr)) {
+    return XTCP_EINVAL;
+  }
+  // Cached UDP routes may use the previous entry for the address
+  udp_fast_path_invalidate();
+
+#if XTCP_ARP_HASH_TABLE_SIZE
+  uint32_t key = ip4_addr_get_u32(&addr);
+  arp_slot_t *slot = find_slot(key);
+  if (slot == NULL) {
+    if (num_entries >= STATIC_ARP_MAX_ENTRIES) {
+      return XTCP_ENOMEM;
+    }
+    // The table is never full, so there is always an empty or removed slot on the probe sequence
+    uint32_t index = arp_hash(key);
+    do {
+      slot = &arp_table[index];
+      index = (index + 1) & (XTCP_ARP_HASH_TABLE_SIZE - 1);
+    } while (slot->state == SLOT_USED);
+    slot->addr = key;
+    slot->state = SLOT_USED;
+    num_entries++;
+  }
+  memcpy(slot->mac.addr, mac_address, ETH_HWADDR_LEN);
+  return XTCP_SUCCESS;
+
+#elif ETHARP_SUPPORT_STATIC_ENTRIES
+  struct eth_addr mac;
+  memcpy(mac.addr, mac_address, ETH_HWADDR_LEN);
+  err_t err = etharp_add_static_entry(&addr, &mac);
+  if (err == ERR_MEM) {
+    return XTCP_ENOMEM;
+  }
+  return (err == ERR_OK) ? XTCP_SUCCESS : XTCP_EINVAL;
+
+#else
+  (void)mac_address;
+  return XTCP_EPROTONOSUPPORT;
+#endif
+}
+
+xtcp_error_code_t static_arp_remove(const uint8_t ipaddr[4]) {
+  ip4_addr_t addr;
+  memcpy(&addr, ipaddr, sizeof(addr));
+  udp_fast_path_invalidate();
+
+#if XTCP_ARP_HASH_TABLE_SIZE
+  arp_slot_t *slot = find_slot(ip4_addr_get_u32(&addr));
+  if (slot == NULL) {
+    return XTCP_EINVAL;
+  }
+  slot->state = SLOT_REMOVED;
+  num_entries--;
+  if (num_entries == 0) {
+    // Clear the tombstones
+    memset(arp_table, 0, sizeof(arp_table));
+  }
+  return XTCP_SUCCESS;
+
+#elif ETHARP_SUPPORT_STATIC_ENTRIES
+  return (etharp_remove_static_entry(&addr) == ERR_OK) ? XTCP_SUCCESS : XTCP_EINVAL;
+
+#else
+  return XTCP_EPROTONOSUPPORT;
+#endif
+}
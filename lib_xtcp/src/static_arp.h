@@ -0,0 +1,59 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_STATIC_ARP_H
+#define XTCP_STATIC_ARP_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Clear the static ARP entries, and when XTCP_ARP_HASH_TABLE_SIZE is set direct lwIP IPv4 output through the hashed
+ * table. Called by the TCP/IP stack task after the network interface is initialised.
+ */
+void static_arp_init(void);
+
+/** Add a static ARP entry, replacing any existing entry for the address.
+ *
+ * \param ipaddr      The IPv4 address of the neighbour.
+ * \param mac_address The MAC address of the neighbour.
+ * \returns           XTCP_SUCCESS, XTCP_EINVAL if the address is not a unicast address, or XTCP_ENOMEM if the table
+ *                    is full.
+ */
+xtcp_error_code_t static_arp_add(const uint8_t ipaddr[4], const uint8_t mac_address[6]);
+
+/** Remove a static ARP entry.
+ *
+ * \param ipaddr      The IPv4 address of the neighbour.
+ * \returns           XTCP_SUCCESS, or XTCP_EINVAL if there is no static entry for the address.
+ */
+xtcp_error_code_t static_arp_remove(const uint8_t ipaddr[4]);
+
+#ifdef __XC__
+}
+#endif
+
+#ifndef __XC__
+/** Number of entries the hashed table holds, leaving free slots so that lookups of missing addresses stop early */
+#define STATIC_ARP_MAX_ENTRIES ((XTCP_ARP_HASH_TABLE_SIZE * 3) / 4)
+
+/** Find the MAC address of a neighbour in the hashed table.
+ *
+ * \param ipaddr      The IPv4 address of the neighbour.
+ * \returns           The MAC address, or NULL if there is no static entry for the address.
+ */
+const uint8_t *static_arp_lookup(const uint8_t ipaddr[4]);
+
+/** Count the slots of the hashed table a lookup of an address examines.
+ *
+ * \param ipaddr      The IPv4 address.
+ * eturns           The number of slots examined, at least one.
+ */
+uint32_t static_arp_probes(const uint8_t ipaddr[4]);
+#endif /* __XC__ */
+
+#endif /* XTCP_STATIC_ARP_H */
@@ -0,0 +1,162 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "static_send.h"
+
+#include <string.h>
+
+/* XTCP headers */
+#include "connection.h"
+
+/* LwIP headers */
+#include "lwip/tcp.h"
+
+/* Registered regions are immutable, so LwIP can hold references to them in its send queue until the data is
+ * acknowledged. Written without TCP_WRITE_FLAG_COPY, each chunk becomes a PBUF_ROM pbuf pointing into the region. */
+
+typedef struct static_region_t {
+  const uint8_t *data;
+  uint32_t length;
+} static_region_t;
+
+typedef struct static_job_t {
+  const uint8_t *next;  // Next byte to write to LwIP
+  uint32_t unwritten;
+  uint32_t unacked;     // Bytes written but not yet acknowledged
+  uint32_t ahead;       // Bytes from send() still unacknowledged when the static send started
+  uint32_t length;
+  int active;
+} static_job_t;
+
+static static_region_t regions[XTCP_STATIC_REGIONS];
+static uint32_t num_regions;
+static static_job_t jobs[MAX_OPEN_SOCKETS];
+
+static inline uint32_t min_u32(uint32_t a, uint32_t b) {
+  return (a < b) ? a : b;
+}
+
+void static_send_init(void) {
+  memset(regions, 0, sizeof(regions));
+  memset(jobs, 0, sizeof(jobs));
+  num_regions = 0;
+}
+
+int32_t xtcp_register_static(const uint8_t data[], uint32_t length) {
+  if ((data == NULL) || (length == 0)) {
+    return XTCP_EINVAL;
+  } else if (num_regions == XTCP_STATIC_REGIONS) {
+    return XTCP_ENOMEM;
+  }
+  regions[num_regions].data = data;
+  regions[num_regions].length = length;
+  return (int32_t)num_regions++;
+}
+
+static inline int is_job(int32_t index) {
+  return (index >= 0) && (index < MAX_OPEN_SOCKETS) && jobs[index].active;
+}
+
+int static_send_pending(int32_t index) {
+  return is_job(index);
+}
+
+void static_send_forget(int32_t index) {
+  if ((index >= 0) && (index < MAX_OPEN_SOCKETS)) {
+    jobs[index].active = 0;
+  }
+}
+
+xtcp_error_code_t static_send_start(unsigned client_num, int32_t id, uint32_t region, uint32_t offset,
+                                    uint32_t length) {
+  xtcp_error_int32_t connection = find_client_connection(client_num, id);
+  if (connection.status != XTCP_SUCCESS) {
+    return connection.status;
+  } else if (get_protocol(id) != XTCP_PROTOCOL_TCP) {
+    return XTCP_EPROTONOSUPPORT;
+  } else if ((region >= num_regions) || (length == 0) || (offset > regions[region].length) ||
+             (length > regions[region].length - offset)) {
+    return XTCP_EINVAL;
+  } else if (jobs[id].active) {
+    // One static send at a time, the client waits for XTCP_SENT_STATIC
+    return XTCP_EAGAIN;
+  }
+
+  struct tcp_pcb *tcp_pcb = get_tcp_pcb(id);
+  if ((tcp_pcb == NULL) || ((tcp_pcb->state != ESTABLISHED) && (tcp_pcb->state != CLOSE_WAIT) &&
+                            (tcp_pcb->state != SYN_SENT) && (tcp_pcb->state != SYN_RCVD))) {
+    return XTCP_EINVAL;
+  }
+
+  static_job_t *job = &jobs[id];
+  job->next = regions[region].data + offset;
+  job->unwritten = length;
+  job->unacked = 0;
+  job->ahead = get_tx_bytes(id);
+  job->length = length;
+  job->active = 1;
+  static_send_push(id);
+  return XTCP_SUCCESS;
+}
+
+void static_send_push(int32_t index) {
+  if (!is_job(index)) {
+    return;
+  }
+  static_job_t *job = &jobs[index];
+  struct tcp_pcb *tcp_pcb = get_tcp_pcb(index);
+  if (tcp_pcb == NULL) {
+    return;
+  }
+
+  int written = 0;
+  while (job->unwritten > 0) {
+    // Each segment of referenced data takes a pbuf for its headers as well as the PBUF_ROM from the send queue, so
+    // chunks are sized to half the free queue as well as to the TCP_SND_BUF space
+    uint32_t queued = tcp_sndqueuelen(tcp_pcb);
+    uint32_t queue_free = (queued < TCP_SND_QUEUELEN) ? TCP_SND_QUEUELEN - queued : 0;
+    uint32_t chunk = min_u32(job->unwritten, get_tcp_send_space(index));
+    chunk = min_u32(chunk, (queue_free / 2) * TCP_MSS);
+    chunk = min_u32(chunk, UINT16_MAX);
+    if (chunk == 0) {
+      break;
+    }
+
+    u8_t flags = (chunk < job->unwritten) ? TCP_WRITE_FLAG_MORE : 0;
+    if (tcp_write(tcp_pcb, job->next, (u16_t)chunk, flags) != ERR_OK) {
+      // Retried when more data is acknowledged, or from the connection's poll
+      break;
+    }
+    // The space was checked above, so the charge is within the client's quota
+    (void)charge_tx_bytes(index, chunk);
+    job->next += chunk;
+    job->unwritten -= chunk;
+    job->unacked += chunk;
+    written = 1;
+  }
+
+  if (written) {
+    (void)tcp_output(tcp_pcb);
+  }
+}
+
+uint32_t static_send_acked(int32_t index, uint32_t length) {
+  if (!is_job(index)) {
+    return length;
+  }
+  static_job_t *job = &jobs[index];
+
+  // Data is acknowledged in the order it was written, first any from send() then the static send
+  uint32_t ahead = min_u32(length, job->ahead);
+  job->ahead -= ahead;
+  job->unacked -= min_u32(length - ahead, job->unacked);
+  static_send_push(index);
+  return ahead;
+}
+
+uint32_t static_send_done(int32_t index) {
+  if (is_job(index) && (jobs[index].unwritten == 0) && (jobs[index].unacked == 0)) {
+    return jobs[index].length;
+  }
+  return 0;
+}
@@ -0,0 +1,46 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_STATIC_SEND_H
+#define XTCP_STATIC_SEND_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Forget every registered region and static send, called once at start up before xtcp_configure_static_regions() */
+void static_send_init(void);
+
+/** Start sending part of a registered region on a TCP connection, see send_static() in xtcp_if */
+xtcp_error_code_t static_send_start(unsigned client_num, int32_t id, uint32_t region, uint32_t offset,
+                                    uint32_t length);
+
+/** Non-zero while a connection has a static send that has not completed, other sends must wait for it */
+int static_send_pending(int32_t index);
+
+/** Forget the static send of a connection, when it completes or the connection is freed */
+void static_send_forget(int32_t index);
+
+/** Account for bytes acknowledged on a connection, and write more of its static send into the space freed.
+ *
+ * \param index   The connection.
+ * \param length  The bytes acknowledged.
+ * \returns       The bytes acknowledged that were sent by send() before the static send started.
+ */
+uint32_t static_send_acked(int32_t index, uint32_t length);
+
+/** Get the length of a connection's static send once every byte of it has been acknowledged, otherwise 0 */
+uint32_t static_send_done(int32_t index);
+
+/** Write as much of a connection's static send as the send buffer and queue allow */
+void static_send_push(int32_t index);
+
+#ifdef __XC__
+}
+#endif
+
+#endif /* XTCP_STATIC_SEND_H */
@@ -0,0 +1,386 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "stream.h"
+
+#include <string.h>
+
+#include <xcore/chanend.h>
+#include <xcore/channel_streaming.h>
+#include <xcore/select.h>
+
+/* XTCP headers */
+#include "client_queue.h"
+#include "connection.h"
+#include "static_send.h"
+
+/* LwIP headers */
+#include "lwip/tcp.h"
+
+#if XTCP_STREAM_ENABLE
+
+/* The stack's half of the protocol described in xtcp_stream.h. A transfer is moved one block per call of stream_poll(),
+ * so the stack keeps servicing its other clients and the network while a large transfer is in progress.
+ *
+ * The stack never waits for a client to start writing: the length word of a send, each block of a send, the credit
+ * word before each block of a receive and the end token of a close are only read once they have arrived. A client
+ * that has written the first word is inside xtcp_stream_write() or xtcp_stream_read(), which move the rest of the
+ * block without pausing, so the stack's channel operations for that block complete. */
+
+typedef enum stream_state_t {
+  STREAM_CLOSED,
+  STREAM_IDLE,
+  STREAM_SEND,
+  STREAM_RECV,
+  STREAM_CLOSING,
+} stream_state_t;
+
+typedef struct stream_t {
+  stream_state_t state;
+  chanend_t c;
+  int32_t id;
+  uint32_t length;       // Bytes in the transfer
+  uint32_t done;         // Bytes written to LwIP, or taken from the receive queue
+  uint32_t words;        // Words moved on the channel
+  uint32_t offset;       // Bytes of the head received pbuf already streamed
+  uint32_t carry;        // Received bytes waiting to fill a word
+  uint32_t carry_bytes;
+  uint32_t granted;      // Words of credit written to the client and not yet read
+  uint32_t staged;       // Words of block read from the client but not yet accepted by LwIP
+  int started;           // The length word has been moved
+  xtcp_error_code_t status;
+  uint32_t block[XTCP_STREAM_BLOCK_WORDS];
+} stream_t;
+
+static stream_t streams[MAX_XTCP_CLIENTS];
+static unsigned active;
+
+static inline uint32_t min_u32(uint32_t a, uint32_t b) {
+  return (a < b) ? a : b;
+}
+
+static inline uint32_t word_count(uint32_t bytes) {
+  return (bytes + 3) / 4;
+}
+
+static void start_transfer(stream_t *s, stream_state_t state, int32_t id, uint32_t length) {
+  s->state = state;
+  s->id = id;
+  s->length = length;
+  s->done = 0;
+  s->words = 0;
+  s->offset = 0;
+  s->carry = 0;
+  s->carry_bytes = 0;
+  s->granted = 0;
+  s->staged = 0;
+  s->started = 0;
+  s->status = XTCP_SUCCESS;
+  active++;
+}
+
+/* Check whether the client has written to its stream, without waiting for it */
+static int client_ready(chanend_t c) {
+  int ready = 0;
+  SELECT_RES(CASE_THEN(c, on_token), DEFAULT_THEN(on_empty)) {
+  on_token:
+    ready = 1;
+    break;
+  on_empty:
+    break;
+  }
+  return ready;
+}
+
+static void end_transfer(stream_t *s) {
+  s_chan_out_word((streaming_chanend_t)s->c, (uint32_t)s->status);
+  s->state = STREAM_IDLE;
+  active--;
+}
+
+void stream_init(void) {
+  memset(streams, 0, sizeof(streams));
+  active = 0;
+}
+
+unsigned stream_open(unsigned client_num, unsigned client_end) {
+  if ((client_num >= MAX_XTCP_CLIENTS) || (streams[client_num].state != STREAM_CLOSED) || (client_end == 0)) {
+    return 0;
+  }
+  chanend_t c = chanend_alloc();
+  if (c == 0) {
+    return 0;
+  }
+  chanend_set_dest(c, (resource_t)client_end);
+  streams[client_num].c = c;
+  streams[client_num].state = STREAM_IDLE;
+  return (unsigned)c;
+}
+
+void stream_close(unsigned client_num) {
+  // The client only closes between transfers, its calls are synchronous
+  if ((client_num < MAX_XTCP_CLIENTS) && (streams[client_num].state == STREAM_IDLE)) {
+    chanend_out_end_token(streams[client_num].c);
+    streams[client_num].state = STREAM_CLOSING;
+    active++;
+  }
+}
+
+static xtcp_error_code_t check_transfer(unsigned client_num, int32_t id) {
+  if ((client_num >= MAX_XTCP_CLIENTS) || (streams[client_num].state != STREAM_IDLE)) {
+    return XTCP_EINVAL;
+  }
+  xtcp_error_int32_t connection = find_client_connection(client_num, id);
+  if (connection.status != XTCP_SUCCESS) {
+    return connection.status;
+  } else if (get_protocol(id) != XTCP_PROTOCOL_TCP) {
+    return XTCP_EPROTONOSUPPORT;
+  }
+  return XTCP_SUCCESS;
+}
+
+int32_t stream_send(unsigned client_num, int32_t id, uint32_t length) {
+  xtcp_error_code_t status = check_transfer(client_num, id);
+  if (status != XTCP_SUCCESS) {
+    return status;
+  } else if (length == 0) {
+    return 0;
+  }
+
+  uint32_t accepted = static_send_pending(id) ? 0 : min_u32(length, get_tcp_send_space(id));
+  if (accepted == 0) {
+    return XTCP_EAGAIN;
+  }
+  // The space was checked above, so the charge is within the client's quota
+  (void)charge_tx_bytes(id, accepted);
+  start_transfer(&streams[client_num], STREAM_SEND, id, accepted);
+  return (int32_t)accepted;
+}
+
+int32_t stream_recv(unsigned client_num, int32_t id, uint32_t length) {
+  xtcp_error_code_t status = check_transfer(client_num, id);
+  if (status != XTCP_SUCCESS) {
+    return status;
+  }
+
+  uint32_t available = count_remote_bytes(id, length);
+  if (available == 0) {
+    return (count_remote_data(id) != 0) ? XTCP_EAGAIN : 0;
+  }
+  start_transfer(&streams[client_num], STREAM_RECV, id, available);
+  return (int32_t)available;
+}
+
+int stream_busy(void) {
+  return active != 0;
+}
+
+/* Read a block from the client and write it to LwIP. A block LwIP has no room for is kept and written again on the
+ * next call, without granting the client more credit. Returns non-zero if the transfer moved. */
+static int poll_send(unsigned client_num, stream_t *s) {
+  streaming_chanend_t c = (streaming_chanend_t)s->c;
+  int moved = 0;
+  if (!s->started) {
+    if (!client_ready(s->c)) {
+      return 0;
+    }
+    (void)s_chan_in_word(c);
+    s->started = 1;
+  }
+
+  if (s->staged == 0) {
+    if (s->granted == 0) {
+      // The client is waiting for this credit, having written the length or the previous block
+      s->granted = min_u32(XTCP_STREAM_BLOCK_WORDS, word_count(s->length) - s->words);
+      s_chan_out_word(c, s->granted);
+      moved = 1;
+    }
+    if (!client_ready(s->c)) {
+      return moved;
+    }
+    for (uint32_t w = 0; w < s->granted; ++w) {
+      s->block[w] = s_chan_in_word(c);
+    }
+    s->words += s->granted;
+    s->staged = s->granted;
+    s->granted = 0;
+    moved = 1;
+  }
+
+  uint32_t remaining = s->length - s->done;
+  uint32_t bytes = min_u32(remaining, s->staged * 4);
+  if (s->status == XTCP_SUCCESS) {
+    struct tcp_pcb *tcp_pcb = NULL;
+    if (find_client_connection(client_num, s->id).status == XTCP_SUCCESS) {
+      tcp_pcb = get_tcp_pcb(s->id);
+      if (tcp_pcb == NULL) {
+        release_tx_bytes(s->id, remaining);
+      }
+    }
+    if (tcp_pcb == NULL) {
+      // The connection has gone, the rest of the data is read and dropped
+      s->status = XTCP_EINVAL;
+    } else {
+      u8_t flags = (bytes < remaining) ? (TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) : TCP_WRITE_FLAG_COPY;
+      err_t error = tcp_write(tcp_pcb, s->block, (u16_t)bytes, flags);
+      if (error == ERR_MEM) {
+        // The block waits until LwIP has sent and freed some of its queue
+        (void)tcp_output(tcp_pcb);
+        return moved;
+      } else if (error != ERR_OK) {
+        release_tx_bytes(s->id, remaining);
+        s->status = XTCP_EINVAL;
+      }
+    }
+  }
+  s->done += bytes;
+  s->staged = 0;
+
+  if (s->done == s->length) {
+    if (s->status == XTCP_SUCCESS) {
+      (void)tcp_output(get_tcp_pcb(s->id));
+      arm_writable_event(s->id);
+    }
+    end_transfer(s);
+  }
+  return 1;
+}
+
+static inline void push_byte(streaming_chanend_t c, stream_t *s, uint8_t byte) {
+  s->carry |= (uint32_t)byte << (8 * s->carry_bytes);
+  if (++s->carry_bytes == 4) {
+    s_chan_out_word(c, s->carry);
+    s->words++;
+    s->carry = 0;
+    s->carry_bytes = 0;
+  }
+}
+
+/* Write a block of received data to the client, straight from the queued pbufs, once the client has written its
+ * credit for the block. Returns non-zero if the transfer moved. */
+static int poll_recv(unsigned client_num, stream_t *s) {
+  streaming_chanend_t c = (streaming_chanend_t)s->c;
+  if (!client_ready(s->c)) {
+    return 0;
+  }
+  uint32_t credit = min_u32(s_chan_in_word(c), XTCP_STREAM_BLOCK_WORDS);
+  if (!s->started) {
+    s_chan_out_word(c, s->length);
+    s->started = 1;
+  }
+
+  uint32_t limit = min_u32(s->words + credit, word_count(s->length));
+  while ((s->done < s->length) && (s->words < limit)) {
+    uint8_t *data = NULL;
+    xtcp_error_int32_t entry = {.status = XTCP_EINVAL, .value = 0};
+    if (find_client_connection(client_num, s->id).status == XTCP_SUCCESS) {
+      entry = get_remote_data(s->id, &data, INT32_MAX, NULL);
+    }
+    if (entry.status != XTCP_SUCCESS) {
+      // The connection has gone with its queued data, pad out the transfer
+      s->status = XTCP_EINVAL;
+      s->done = s->length;
+      break;
+    }
+
+    uint32_t available = (uint32_t)entry.value - s->offset;
+    const uint8_t *p = data + s->offset;
+    uint32_t taken = 0;
+    while ((taken < available) && (s->words < limit)) {
+      if ((s->carry_bytes == 0) && (available - taken >= 4)) {
+        uint32_t word;
+        memcpy(&word, p + taken, 4);
+        s_chan_out_word(c, word);
+        s->words++;
+        taken += 4;
+      } else {
+        push_byte(c, s, p[taken++]);
+      }
+    }
+    s->offset += taken;
+    s->done += taken;
+
+    if (s->offset == (uint32_t)entry.value) {
+      (void)free_remote_data(s->id);
+      s->offset = 0;
+    }
+  }
+
+  if (s->done == s->length) {
+    // The last word and any padding are sent within the credit, the client counts every word of the transfer
+    if ((s->carry_bytes != 0) && (s->words < limit)) {
+      s_chan_out_word(c, s->carry);
+      s->words++;
+      s->carry_bytes = 0;
+    }
+    while (s->words < limit) {
+      s_chan_out_word(c, 0);
+      s->words++;
+    }
+    if (s->words == word_count(s->length)) {
+      if (s->status == XTCP_SUCCESS) {
+        // One receive event was queued for each pbuf, keep those of the pbufs still queued
+        (void)free_recv_notifications_on_queue(client_num, s->id, count_remote_data(s->id));
+      }
+      end_transfer(s);
+    }
+  }
+  return 1;
+}
+
+int stream_poll(void) {
+  int moved = 0;
+  for (unsigned client_num = 0; client_num < MAX_XTCP_CLIENTS; ++client_num) {
+    stream_t *s = &streams[client_num];
+    if (s->state == STREAM_SEND) {
+      moved |= poll_send(client_num, s);
+    } else if (s->state == STREAM_RECV) {
+      moved |= poll_recv(client_num, s);
+    } else if ((s->state == STREAM_CLOSING) && client_ready(s->c)) {
+      // The client closes its end once close_stream() has returned
+      chanend_check_end_token(s->c);
+      chanend_free(s->c);
+      s->c = 0;
+      s->state = STREAM_CLOSED;
+      active--;
+      moved = 1;
+    }
+  }
+  return moved;
+}
+
+#else
+
+void stream_init(void) {}
+
+unsigned stream_open(unsigned client_num, unsigned client_end) {
+  (void)client_num;
+  (void)client_end;
+  return 0;
+}
+
+void stream_close(unsigned client_num) { (void)client_num; }
+
+int32_t stream_send(unsigned client_num, int32_t id, uint32_t length) {
+  (void)client_num;
+  (void)id;
+  (void)length;
+  return XTCP_EINVAL;
+}
+
+int32_t stream_recv(unsigned client_num, int32_t id, uint32_t length) {
+  (void)client_num;
+  (void)id;
+  (void)length;
+  return XTCP_EINVAL;
+}
+
+int stream_busy(void) {
+  return 0;
+}
+
+int stream_poll(void) {
+  return 0;
+}
+
+#endif /* XTCP_STREAM_ENABLE */
@@ -0,0 +1,53 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_STREAM_H
+#define XTCP_STREAM_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Close every client's stream, called once at start up */
+void stream_init(void);
+
+/** Allocate the stack's end of a client's stream and connect it to the client's end.
+ *
+ * \param client_num  The client.
+ * \param client_end  The resource identifier of the client's channel end.
+ * \returns           The resource identifier of the stack's channel end, 0 if the stream is already open, no
+ *                    channel end is available or streams are not built.
+ */
+unsigned stream_open(unsigned client_num, unsigned client_end);
+
+/** Close a client's stream. The channel end is freed by stream_poll() once the client has closed its end. */
+void stream_close(unsigned client_num);
+
+/** Start a send through a client's stream, see send_stream() in xtcp_if */
+int32_t stream_send(unsigned client_num, int32_t id, uint32_t length);
+
+/** Start a receive through a client's stream, see recv_stream() in xtcp_if */
+int32_t stream_recv(unsigned client_num, int32_t id, uint32_t length);
+
+/** Reference timer ticks the stack task waits before calling stream_poll() again when no stream could move, 1us */
+#define STREAM_RETRY_TICKS 100
+
+/** Non-zero while any stream has a transfer or close to complete */
+int stream_busy(void);
+
+/** Move one block of each stream transfer in progress whose client is ready, called by the stack task while
+ * stream_busy(). Never waits for a client that has not started writing.
+ *
+ * \returns Non-zero if any stream moved, zero if every stream is waiting for its client or for LwIP.
+ */
+int stream_poll(void);
+
+#ifdef __XC__
+}
+#endif
+
+#endif /* XTCP_STREAM_H */
@@ -0,0 +1,81 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "xtcp_stream.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <xcore/chanend.h>
+#include <xcore/channel_streaming.h>
+
+/* Client half of the stream protocol described in xtcp_stream.h, run on the client's logical core */
+
+unsigned xtcp_stream_alloc(xtcp_stream_t *stream) {
+  stream->c = (unsigned)chanend_alloc();
+  return stream->c;
+}
+
+void xtcp_stream_connect(xtcp_stream_t *stream, unsigned stack_end) {
+  if (stack_end == 0) {
+    // Nothing was sent on the channel end, so it can be freed without end tokens
+    chanend_free((chanend_t)stream->c);
+    stream->c = 0;
+  } else {
+    chanend_set_dest((chanend_t)stream->c, (resource_t)stack_end);
+  }
+}
+
+void xtcp_stream_release(xtcp_stream_t *stream) {
+  if (stream->c != 0) {
+    // The stack has sent its end token from close_stream(), both are needed to free the route between the tiles
+    chanend_out_end_token((chanend_t)stream->c);
+    chanend_check_end_token((chanend_t)stream->c);
+    chanend_free((chanend_t)stream->c);
+    stream->c = 0;
+  }
+}
+
+xtcp_error_code_t xtcp_stream_write(xtcp_stream_t *stream, const uint8_t data[], uint32_t length) {
+  streaming_chanend_t c = (streaming_chanend_t)stream->c;
+  uint32_t offset = 0;
+
+  s_chan_out_word(c, length);
+  while (offset < length) {
+    uint32_t credit = s_chan_in_word(c);
+    for (uint32_t w = 0; (w < credit) && (offset < length); ++w) {
+      uint32_t word = 0;
+      uint32_t bytes = (length - offset < 4) ? length - offset : 4;
+      memcpy(&word, &data[offset], bytes);
+      s_chan_out_word(c, word);
+      offset += bytes;
+    }
+  }
+  return (xtcp_error_code_t)s_chan_in_word(c);
+}
+
+int32_t xtcp_stream_read(xtcp_stream_t *stream, uint8_t data[], uint32_t length) {
+  streaming_chanend_t c = (streaming_chanend_t)stream->c;
+
+  // The stack writes each block once it has the credit for it
+  s_chan_out_word(c, XTCP_STREAM_BLOCK_WORDS);
+  uint32_t total = s_chan_in_word(c);
+  uint32_t words = (total + 3) / 4;
+
+  for (uint32_t w = 0; w < words; ++w) {
+    if ((w != 0) && (w % XTCP_STREAM_BLOCK_WORDS == 0)) {
+      s_chan_out_word(c, XTCP_STREAM_BLOCK_WORDS);
+    }
+    uint32_t word = s_chan_in_word(c);
+    uint32_t offset = w * 4;
+    if (offset < length) {
+      uint32_t bytes = (length - offset < 4) ? length - offset : 4;
+      memcpy(&data[offset], &word, bytes);
+    }
+  }
+  xtcp_error_code_t status = (xtcp_error_code_t)s_chan_in_word(c);
+  if (status != XTCP_SUCCESS) {
+    return status;
+  }
+  return (int32_t)((total < length) ? total : length);
+}
@@ -13,15 +13,44 @@
 /* XMOS library headers */
 #include "client_queue.h"
 #include "connection.h"
-#include "debug_print.h"
+#include "deferred_log.h"
+#include "direct_client.h"
 #include "lwip_shim.h"
+#include "static_send.h"
 
 
+/* Raise the XTCP_RECV_DATA events due on a connection, counting received pbufs newly queued. Returns the number of
+ * events that could not be raised as the client's queue is full. */
+static uint32_t raise_recv_events(unsigned client_num, int32_t index, uint32_t received, int flush) {
+  uint32_t due = take_recv_events(index, received, flush);
+  while (due > 0) {
+    if (enqueue_event_and_notify(client_num, index, XTCP_RECV_DATA) != XTCP_SUCCESS) {
+      break;
+    }
+    due--;
+  }
+  return due;
+}
+
+void release_held_recv_events(unsigned client_num, int32_t index) {
+  hold_recv_events(index, raise_recv_events(client_num, index, 0, 0));
+}
+
+/* Raise XTCP_SENT_STATIC once a static send has been acknowledged, it stays pending until the event is queued */
+static void raise_static_sent(unsigned client_num, int32_t index) {
+  uint32_t length = static_send_done(index);
+  if (length != 0) {
+    if (enqueue_event_length_and_notify(client_num, index, XTCP_SENT_STATIC, length) == XTCP_SUCCESS) {
+      static_send_forget(index);
+    } else {
+      DEFERRED_LOG(LOG_TCP_SENT_STATIC_DELAYED, 0, 0);
+    }
+  }
+}
+
 #if LWIP_EVENT_API == 1
 /* Function called by lwIP when any TCP event happens on a connection */
 err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct pbuf *p, u16_t size, err_t err) {
-  (void)size;
-
   err_t result = ERR_OK;
 
   int32_t index = (int32_t)arg;  // arg is the index in the connection array
@@ -32,6 +61,10 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
   }
 
   unsigned client_num = get_client_info(index);
+  if (client_num == DIRECT_CLIENT_NUM) {
+    // Direct C clients handle the event inline, nothing is queued
+    return direct_client_tcp_event(index, pcb, e, p, size, err);
+  }
 
   switch (e) {
     case LWIP_EVENT_ACCEPT: {
@@ -56,7 +89,7 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
         } else {
           xtcp_error_code_t enqueue = enqueue_event_and_notify(client_num, accepted.value, XTCP_ACCEPTED);
           if (enqueue != XTCP_SUCCESS) {
-            debug_printf("lwip_tcp_event: accept failed: %d\n", enqueue);
+            DEFERRED_LOG(LOG_TCP_ACCEPT_LOST, enqueue, 0);
             result = ERR_INPROGRESS; // Have lwip abort the connection
           } else {
             result = ERR_OK;
@@ -74,7 +107,7 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
 
       xtcp_error_code_t enqueue = enqueue_event_and_notify(client_num, index, XTCP_NEW_CONNECTION);
       if (enqueue != XTCP_SUCCESS) {
-        debug_printf("lwip_tcp_event: connected failed to queue event: %d\n", enqueue);
+        DEFERRED_LOG(LOG_TCP_CONNECTED_LOST, enqueue, 0);
         // TODO - should we abort the connection here?
         
       } else {
@@ -93,24 +126,29 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
       //  - any other err_t: Data 'refused', the pbuf will be retried in future.
 
       if (p == NULL) {
-        // Closed by remote host
+        // Closed by remote host, no more data will arrive to reach a receive low watermark
+        hold_recv_events(index, raise_recv_events(client_num, index, 0, 1));
         xtcp_error_code_t enqueue = enqueue_event_and_notify(client_num, index, XTCP_CLOSED);
         if (enqueue != XTCP_SUCCESS) {
-          debug_printf("lwip_tcp_event: CLOSE event lost: %d\n", enqueue);
+          DEFERRED_LOG(LOG_TCP_CLOSE_LOST, enqueue, 0);
         }
         result = ERR_OK;
 
-      } else {
-        set_remote(index, NULL, 0, p);
+      } else if (set_remote(index, NULL, 0, p) != XTCP_SUCCESS) {
+        // Client is over its receive quota, refuse data so lwIP retries it later
+        result = ERR_INPROGRESS;
 
-        xtcp_error_code_t enqueue = enqueue_event_and_notify(client_num, index, XTCP_RECV_DATA);
-        if (enqueue != XTCP_SUCCESS) {
-          debug_printf("lwip_tcp_event: RECV failed: %d\n", enqueue);
+      } else {
+        uint32_t lost = raise_recv_events(client_num, index, 1, 0);
+        if (lost > 0) {
+          DEFERRED_LOG(LOG_TCP_RECV_EVENTS_LOST, lost, 0);
+          // One of the events not raised is for this pbuf, which is refused, the rest stay held
+          hold_recv_events(index, lost - 1);
           xtcp_error_code_t unlink = unlink_remote(index, p);
           if (unlink != XTCP_SUCCESS) {
-            debug_printf("lwip_tcp_event: RECV unlink failed: %d\n", unlink);
+            DEFERRED_LOG(LOG_TCP_RECV_UNLINK_FAILED, unlink, 0);
           } else {
-            debug_printf("lwip_tcp_event: RECV unlink succeeded: %d\n", unlink);
+            DEFERRED_LOG(LOG_TCP_RECV_UNLINKED, unlink, 0);
           }
           result = ERR_INPROGRESS; // refuse data as queue failed
         } else {
@@ -128,10 +166,20 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
 
       // debug_printf("sent: %d, %d\n", pcb->local_port, size);
 
-      xtcp_error_code_t enqueue = enqueue_event_and_notify(client_num, index, XTCP_SENT_DATA);
-      if (enqueue != XTCP_SUCCESS) {
-        debug_printf("lwip_tcp_event: SENT event lost: %d\n", enqueue);
+      release_tx_bytes(index, size);
+      uint32_t sent = static_send_acked(index, size);
+
+      // Bytes acknowledged while no event is raised are reported by the next XTCP_SENT_DATA
+      if ((sent > 0) && sent_event_due(index, sent)) {
+        xtcp_error_code_t enqueue =
+            enqueue_event_length_and_notify(client_num, index, XTCP_SENT_DATA, get_acked_bytes(index));
+        if (enqueue != XTCP_SUCCESS) {
+          DEFERRED_LOG(LOG_TCP_SENT_DELAYED, enqueue, 0);
+        } else {
+          clear_acked_bytes(index);
+        }
       }
+      raise_static_sent(client_num, index);
       result = ERR_OK;
       break;
     }
@@ -144,7 +192,7 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
       // notify client, lwip will clean up PCB after. Returns: ignored
 
       xtcp_error_code_t enqueue = XTCP_EINVAL;
-      debug_printf("LWIP_EVENT_ERR: %s\n", lwip_strerr(err));
+      DEFERRED_LOG(LOG_TCP_ERR, index, err);
       if (err == ERR_ABRT) {
         enqueue = enqueue_event_and_notify(client_num, index, XTCP_ABORTED);
 
@@ -152,11 +200,11 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
         enqueue = enqueue_event_and_notify(client_num, index, XTCP_TIMED_OUT);
 
       } else {
-        debug_printf("Unknown Connection %d error: %d\n", index, err);
+        DEFERRED_LOG(LOG_TCP_ERR_UNKNOWN, index, err);
       }
 
       if (enqueue != XTCP_SUCCESS) {
-        debug_printf("lwip_tcp_event: ERR event lost: %d (%d)\n", enqueue, err);
+        DEFERRED_LOG(LOG_TCP_ERR_LOST, enqueue, err);
       }
 
       // do we free here, the application then has no connection to reference?
@@ -172,6 +220,9 @@ err_t lwip_tcp_event(void *arg, struct tcp_pcb *pcb, enum lwip_event e, struct p
       //  - ERR_OK: Happy, LwIP will attempt to send more data.
       //  - ERR_ABRT: Aborts the connection and we must call tcp_abort() and free the pcb/pbuf.
 
+      // Retry a static send stalled on a full send queue, or a completion the client's queue had no room for
+      static_send_push(index);
+      raise_static_sent(client_num, index);
       result = ERR_OK;
       break;
     }
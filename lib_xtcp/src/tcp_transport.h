@@ -4,4 +4,13 @@
 #ifndef TCP_TRANSPORT_H
 #define TCP_TRANSPORT_H
 
+#include <stdint.h>
+
+/** Raise the XTCP_RECV_DATA events held on a connection if the bytes queued now reach its receive low watermark
+ *
+ * \param client_num  The client owning the connection.
+ * \param index       The connection.
+ */
+void release_held_recv_events(unsigned client_num, int32_t index);
+
 #endif /* TCP_TRANSPORT_H */
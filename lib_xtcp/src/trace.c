@@ -0,0 +1,132 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "trace.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <xs1.h>
+
+#include <xcore/hwtimer.h>
+
+/* Trace header fields, "XTRC" read as a little-endian word */
+#define TRACE_MAGIC 0x43525458u
+#define TRACE_VERSION 1
+
+#if XTCP_TRACE_ENABLE
+
+#if (XTCP_TRACE_RECORDS & (XTCP_TRACE_RECORDS - 1)) || (XTCP_TRACE_RECORDS == 0)
+#error "XTCP_TRACE_RECORDS must be a power of two"
+#endif
+
+typedef struct trace_entry_t {
+  uint32_t timestamp;
+  uint8_t site;
+  uint8_t client;
+  int16_t id;
+  uint32_t arg0;
+  uint32_t arg1;
+} trace_entry_t;
+
+/* head and tail count records written and read, so the ring is empty when they are equal */
+static trace_entry_t ring[XTCP_TRACE_RECORDS];
+static uint32_t head;
+static uint32_t tail;
+static uint32_t lost;
+static int header_pending;
+
+static void put_le32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static void put_le16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_entry(uint8_t *p, const trace_entry_t *entry) {
+  put_le32(&p[0], entry->timestamp);
+  p[4] = entry->site;
+  p[5] = entry->client;
+  put_le16(&p[6], (uint16_t)entry->id);
+  put_le32(&p[8], entry->arg0);
+  put_le32(&p[12], entry->arg1);
+}
+
+void trace_init(void) {
+  head = 0;
+  tail = 0;
+  lost = 0;
+  header_pending = 1;
+}
+
+void trace_record(trace_site_t site, unsigned client, int32_t id, uint32_t arg0, uint32_t arg1) {
+  if (head - tail == XTCP_TRACE_RECORDS) {
+    tail++;
+    lost++;
+  }
+  trace_entry_t *entry = &ring[head % XTCP_TRACE_RECORDS];
+  entry->timestamp = get_reference_time();
+  entry->site = (uint8_t)site;
+  entry->client = (uint8_t)client;
+  entry->id = (int16_t)id;
+  entry->arg0 = arg0;
+  entry->arg1 = arg1;
+  head++;
+}
+
+int32_t trace_read(uint8_t buffer[], uint32_t length) {
+  if (length < XTCP_TRACE_READ_MIN) {
+    return XTCP_EINVAL;
+  }
+
+  uint32_t n = 0;
+  if (header_pending) {
+    put_le32(&buffer[0], TRACE_MAGIC);
+    put_le16(&buffer[4], TRACE_VERSION);
+    put_le16(&buffer[6], XTCP_TRACE_RECORD_LENGTH);
+    put_le32(&buffer[8], XS1_TIMER_HZ);
+    put_le32(&buffer[12], 0);
+    n = XTCP_TRACE_HEADER_LENGTH;
+    header_pending = 0;
+  }
+
+  if (lost) {
+    // The records lost were all older than those still in the ring, so it takes the time of the oldest
+    uint32_t timestamp = (tail != head) ? ring[tail % XTCP_TRACE_RECORDS].timestamp : get_reference_time();
+    trace_entry_t entry = {timestamp, TRACE_LOST, TRACE_NO_CLIENT, TRACE_NO_ID, lost, 0};
+    put_entry(&buffer[n], &entry);
+    n += XTCP_TRACE_RECORD_LENGTH;
+    lost = 0;
+  }
+
+  while ((tail != head) && (length - n >= XTCP_TRACE_RECORD_LENGTH)) {
+    put_entry(&buffer[n], &ring[tail % XTCP_TRACE_RECORDS]);
+    tail++;
+    n += XTCP_TRACE_RECORD_LENGTH;
+  }
+  return (int32_t)n;
+}
+
+#else
+
+void trace_init(void) {}
+
+void trace_record(trace_site_t site, unsigned client, int32_t id, uint32_t arg0, uint32_t arg1) {
+  (void)site;
+  (void)client;
+  (void)id;
+  (void)arg0;
+  (void)arg1;
+}
+
+int32_t trace_read(uint8_t buffer[], uint32_t length) {
+  (void)buffer;
+  (void)length;
+  return XTCP_EPROTONOSUPPORT;
+}
+
+#endif /* XTCP_TRACE_ENABLE */
@@ -0,0 +1,78 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_TRACE_H
+#define XTCP_TRACE_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+/** Size of the buffer the stack reads the ring into for read_trace(), at least XTCP_TRACE_READ_MIN */
+#define TRACE_READ_MAX (XTCP_TRACE_READ_MIN > 512 ? XTCP_TRACE_READ_MIN : 512)
+
+/** Trace points, the upper nibble selecting the class of XTCP_TRACE_CLASSES. The decoder in tests/xtcp_trace.py
+ * names them, so existing values must not change. */
+typedef enum trace_site_t {
+  TRACE_LOST = 0x01,           // arg0: records overwritten before being read
+  TRACE_EVENT_QUEUED = 0x10,   // arg0: xtcp_event_type_t, arg1: events queued for the client
+  TRACE_EVENT_TAKEN = 0x11,    // arg0: xtcp_event_type_t, arg1: events still queued for the client
+  TRACE_EVENT_DROPPED = 0x12,  // arg0: xtcp_event_type_t, the client's queue is full
+  TRACE_PBUF_ALLOC = 0x20,     // arg0: length, arg1: pbuf, zero when the allocation failed
+  TRACE_PBUF_FREE = 0x21,      // arg0: length, arg1: pbuf, for received data the client has read
+  TRACE_TCP_WRITE = 0x30,      // arg0: length, arg1: err_t
+  TRACE_TCP_OUTPUT = 0x31,     // arg1: err_t
+  TRACE_RX_FRAME = 0x40,       // arg0: length, arg1: MAC timestamp
+  TRACE_TIMER = 0x50,          // arg0: timer index
+} trace_site_t;
+
+/** Client and connection of trace points with neither */
+#define TRACE_NO_CLIENT 0xFF
+#define TRACE_NO_ID (-1)
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Initialise the event trace with an empty ring, the next read starting with the header */
+void trace_init(void);
+
+/** Record a trace point, timestamped with the reference timer, overwriting the oldest record when the ring is full.
+ *
+ * \param site      The trace point.
+ * \param client    The client it concerns, or TRACE_NO_CLIENT.
+ * \param id        The connection it concerns, or TRACE_NO_ID.
+ * \param arg0      The first argument of the trace point.
+ * \param arg1      The second argument of the trace point.
+ */
+void trace_record(trace_site_t site, unsigned client, int32_t id, uint32_t arg0, uint32_t arg1);
+
+/** Read the header, if not yet read since trace_init(), and whole records from the ring.
+ *
+ * \param buffer    The buffer to read into.
+ * \param length    The length of the buffer.
+ * \returns         The number of bytes read, XTCP_EINVAL if length is less than XTCP_TRACE_READ_MIN, or
+ *                  XTCP_EPROTONOSUPPORT when XTCP_TRACE_ENABLE is 0.
+ */
+int32_t trace_read(uint8_t buffer[], uint32_t length);
+
+#ifdef __XC__
+}
+#endif
+
+/** Class of XTCP_TRACE_CLASSES a trace point belongs to */
+#define TRACE_CLASS(site) (1u << (((unsigned)(site) >> 4) - 1))
+
+/** The trace points in the stack, compiled out when the trace is not built or the class is not selected */
+#if XTCP_TRACE_ENABLE
+#define TRACE(site, client, id, arg0, arg1)                                                   \
+  do {                                                                                        \
+    if (XTCP_TRACE_CLASSES & TRACE_CLASS(site)) {                                             \
+      trace_record(site, client, id, (uint32_t)(arg0), (uint32_t)(arg1));                     \
+    }                                                                                         \
+  } while (0)
+#else
+#define TRACE(site, client, id, arg0, arg1) do {} while (0)
+#endif
+
+#endif /* XTCP_TRACE_H */
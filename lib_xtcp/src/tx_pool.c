@@ -0,0 +1,143 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "tx_pool.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* LwIP headers */
+#include "lwip/pbuf.h"
+
+#if TX_POOL_ACTIVE
+
+/* Each buffer is a block holding the custom pbuf, followed by the header room and the payload. Keeping the payload
+ * after the pbuf structure gives the same layout as a PBUF_POOL pbuf, so lwIP can add headers in front of it. */
+typedef struct tx_block_s {
+  struct pbuf_custom pc;       // Must be first, lwIP passes &pc.pbuf to the free function
+  struct tx_block_s *next;     // Next block in the free list
+  uint32_t size_class;         // Class the block returns to when freed
+} tx_block_t;
+
+#define TX_BLOCK_HEADER_SIZE    LWIP_MEM_ALIGN_SIZE(sizeof(tx_block_t))
+#define TX_BLOCK_HEADROOM       LWIP_MEM_ALIGN_SIZE(PBUF_TRANSPORT)
+#define TX_BLOCK_STRIDE(size)   (TX_BLOCK_HEADER_SIZE + TX_BLOCK_HEADROOM + LWIP_MEM_ALIGN_SIZE(size))
+#define TX_BLOCK_WORDS(size, count) ((TX_BLOCK_STRIDE(size) * (count) + 3) / 4)
+
+static uint32_t tx_storage_small[TX_BLOCK_WORDS(XTCP_TX_POOL_SMALL_SIZE, XTCP_TX_POOL_SMALL_COUNT)];
+static uint32_t tx_storage_medium[TX_BLOCK_WORDS(XTCP_TX_POOL_MEDIUM_SIZE, XTCP_TX_POOL_MEDIUM_COUNT)];
+static uint32_t tx_storage_mss[TX_BLOCK_WORDS(XTCP_TX_POOL_MSS_SIZE, XTCP_TX_POOL_MSS_COUNT)];
+static uint32_t tx_storage_frame[TX_BLOCK_WORDS(XTCP_TX_POOL_FRAME_SIZE, XTCP_TX_POOL_FRAME_COUNT)];
+
+typedef struct tx_class_s {
+  uint8_t *storage;
+  tx_block_t *free_list;
+} tx_class_t;
+
+static tx_class_t tx_classes[XTCP_TX_POOL_NUM_CLASSES];
+
+#endif /* TX_POOL_ACTIVE */
+
+static xtcp_tx_pool_stats_t tx_stats;
+
+static const uint16_t tx_class_sizes[XTCP_TX_POOL_NUM_CLASSES] = {
+  XTCP_TX_POOL_SMALL_SIZE, XTCP_TX_POOL_MEDIUM_SIZE, XTCP_TX_POOL_MSS_SIZE, XTCP_TX_POOL_FRAME_SIZE};
+
+#if TX_POOL_ACTIVE
+
+static const uint16_t tx_class_counts[XTCP_TX_POOL_NUM_CLASSES] = {
+  XTCP_TX_POOL_SMALL_COUNT, XTCP_TX_POOL_MEDIUM_COUNT, XTCP_TX_POOL_MSS_COUNT, XTCP_TX_POOL_FRAME_COUNT};
+
+__attribute__((fptrgroup("pbuf_free_custom_fn")))
+static void tx_pool_free(struct pbuf *p) {
+  tx_block_t *block = (tx_block_t *)p;
+  uint32_t size_class = block->size_class;
+
+  block->next = tx_classes[size_class].free_list;
+  tx_classes[size_class].free_list = block;
+  tx_stats.size_class[size_class].in_use--;
+}
+
+static struct pbuf *tx_pool_take(uint32_t size_class, uint16_t length) {
+  tx_block_t *block = tx_classes[size_class].free_list;
+  xtcp_tx_pool_class_stats_t *stats = &tx_stats.size_class[size_class];
+
+  tx_classes[size_class].free_list = block->next;
+  block->next = NULL;
+
+  stats->allocs++;
+  stats->in_use++;
+  if (stats->in_use > stats->high_water) {
+    stats->high_water = stats->in_use;
+  }
+
+  block->pc.custom_free_function = tx_pool_free;
+  uint8_t *payload_mem = (uint8_t *)block + TX_BLOCK_HEADER_SIZE;
+  return pbuf_alloced_custom(PBUF_TRANSPORT, length, PBUF_POOL, &block->pc, payload_mem,
+                             (u16_t)(TX_BLOCK_HEADROOM + LWIP_MEM_ALIGN_SIZE(tx_class_sizes[size_class])));
+}
+
+#endif /* TX_POOL_ACTIVE */
+
+void tx_pool_init(void) {
+  memset(&tx_stats, 0, sizeof(tx_stats));
+  for (uint32_t c = 0; c < XTCP_TX_POOL_NUM_CLASSES; ++c) {
+    tx_stats.size_class[c].block_size = tx_class_sizes[c];
+#if TX_POOL_ACTIVE
+    tx_stats.size_class[c].num_blocks = tx_class_counts[c];
+#endif
+  }
+
+#if TX_POOL_ACTIVE
+  tx_classes[0].storage = (uint8_t *)tx_storage_small;
+  tx_classes[1].storage = (uint8_t *)tx_storage_medium;
+  tx_classes[2].storage = (uint8_t *)tx_storage_mss;
+  tx_classes[3].storage = (uint8_t *)tx_storage_frame;
+
+  for (uint32_t c = 0; c < XTCP_TX_POOL_NUM_CLASSES; ++c) {
+    tx_classes[c].free_list = NULL;
+    // Build the free list backwards so the first block is handed out first
+    for (int32_t b = tx_class_counts[c] - 1; b >= 0; --b) {
+      tx_block_t *block = (tx_block_t *)(tx_classes[c].storage + (TX_BLOCK_STRIDE(tx_class_sizes[c]) * (uint32_t)b));
+      block->size_class = c;
+      block->next = tx_classes[c].free_list;
+      tx_classes[c].free_list = block;
+    }
+  }
+#endif
+}
+
+struct pbuf *tx_pool_alloc(uint16_t length) {
+  struct pbuf *p = NULL;
+
+#if TX_POOL_ACTIVE
+  int exhausted = 0;
+  for (uint32_t c = 0; c < XTCP_TX_POOL_NUM_CLASSES; ++c) {
+    if (length <= tx_class_sizes[c]) {
+      if (tx_classes[c].free_list != NULL) {
+        return tx_pool_take(c, length);
+      }
+      if (!exhausted) {
+        // Smallest fitting class is empty, record it and fall back to the next larger class
+        exhausted = 1;
+        tx_stats.size_class[c].exhausted++;
+      }
+    }
+  }
+#endif
+
+#if XTCP_TX_POOL_FALLBACK_HEAP || !TX_POOL_ACTIVE
+  p = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+  if (p != NULL) {
+    tx_stats.heap_allocs++;
+    return p;
+  }
+#endif
+
+  tx_stats.failures++;
+  return p;
+}
+
+xtcp_tx_pool_stats_t tx_pool_get_stats(void) {
+  return tx_stats;
+}
@@ -0,0 +1,42 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_TX_POOL_H
+#define XTCP_TX_POOL_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Initialise the transmit buffer pools, all buffers are returned to their free lists */
+void tx_pool_init(void);
+
+/** Get the transmit buffer pool statistics */
+xtcp_tx_pool_stats_t tx_pool_get_stats(void);
+
+#ifdef __XC__
+}
+#endif
+
+#ifndef __XC__
+#include "lwip/pbuf.h"
+
+/** Pools are only used when lwIP can return custom pbufs to them on pbuf_free() */
+#define TX_POOL_ACTIVE (XTCP_TX_POOL_ENABLE && LWIP_SUPPORT_CUSTOM_PBUF)
+
+/** Allocate a transmit pbuf with room for the transport, IP and link headers.
+ *
+ * The buffer comes from the smallest size class that fits, then from a larger class if that one is exhausted, then
+ * from the lwIP heap if XTCP_TX_POOL_FALLBACK_HEAP is set. Pool buffers are returned by pbuf_free().
+ *
+ * \param length  The payload length.
+ * \returns       The pbuf, or NULL if no buffer is available.
+ */
+struct pbuf *tx_pool_alloc(uint16_t length);
+#endif /* __XC__ */
+
+#endif /* XTCP_TX_POOL_H */
@@ -0,0 +1,170 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "udp_batch.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* XTCP headers */
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "pbuf_shim.h"
+
+/* LwIP headers */
+#include "lwip/pbuf.h"
+
+#if XTCP_UDP_BATCH_ENABLE
+
+/* Payloads are staged here so the client's buffer crosses the interface in a single transfer, which is where a batch
+ * saves over one call per datagram. Word aligned so the copies between it and the pbufs are word copies. */
+static uint32_t batch_buffer[(XTCP_BATCH_MAX_BYTES + 3) / 4];
+
+static const xtcp_ipaddr_t any_addr = {0, 0, 0, 0};
+
+static xtcp_error_code_t check_udp_connection(unsigned client_num, int32_t id) {
+  xtcp_error_int32_t connection = find_client_connection(client_num, id);
+  if (connection.status != XTCP_SUCCESS) {
+    // Bad parameter or inactive connection
+    return connection.status;
+  } else if (get_protocol(id) == XTCP_PROTOCOL_TCP) {
+    // Batches are datagrams, TCP has no message boundaries
+    return XTCP_EPROTONOSUPPORT;
+  }
+  return XTCP_SUCCESS;
+}
+
+uint8_t *udp_batch_buffer(void) {
+  return (uint8_t *)batch_buffer;
+}
+
+int32_t udp_batch_recvfrom(unsigned client_num, int32_t id, uint32_t length, xtcp_datagram_t datagrams[], uint32_t max) {
+  xtcp_error_code_t status = check_udp_connection(client_num, id);
+  if (status != XTCP_SUCCESS) {
+    return status;
+  }
+  if (length > XTCP_BATCH_MAX_BYTES) {
+    length = XTCP_BATCH_MAX_BYTES;
+  }
+  if (max > XTCP_BATCH_MAX_DATAGRAMS) {
+    max = XTCP_BATCH_MAX_DATAGRAMS;
+  }
+
+  uint8_t *buffer = (uint8_t *)batch_buffer;
+  uint32_t offset = 0;
+  int32_t count = 0;
+  int32_t result = 0;
+
+  while ((uint32_t)count < max) {
+    xtcp_host_t remote = get_remote(id);
+    uint8_t *data = NULL;
+    uint32_t timestamp;
+    xtcp_error_int32_t copy_length = get_remote_data(id, &data, (int32_t)(length - offset), &timestamp);
+
+    if ((copy_length.status == XTCP_EAGAIN) && (count == 0)) {
+      // As recvfrom(), a datagram longer than the whole buffer can never be received so is discarded
+      (void)free_remote_data(id);
+      result = XTCP_EAGAIN;
+      break;
+    } else if (copy_length.status != XTCP_SUCCESS) {
+      // Queue empty, or the next datagram is left for the next call
+      break;
+    }
+
+    memcpy(&buffer[offset], data, copy_length.value);
+    xtcp_datagram_t *datagram = &datagrams[count];
+    datagram->offset = offset;
+    datagram->length = copy_length.value;
+    memcpy(datagram->ipaddr, remote.ipaddr, sizeof(xtcp_ipaddr_t));
+    datagram->port_number = remote.port_number;
+    datagram->timestamp = timestamp;
+
+    // Keep the next payload word aligned
+    offset += (copy_length.value + 3) & ~3u;
+    if (offset > length) {
+      offset = length;
+    }
+    count++;
+    result = count;
+    (void)free_remote_data(id);
+  }
+
+  (void)free_recv_notifications_on_queue(client_num, id, count_remote_data(id));
+  return result;
+}
+
+int32_t udp_batch_sendto(unsigned client_num, int32_t id, uint32_t length, xtcp_datagram_t datagrams[], uint32_t count) {
+  xtcp_error_code_t status = check_udp_connection(client_num, id);
+  if (status != XTCP_SUCCESS) {
+    return status;
+  }
+  if (length > XTCP_BATCH_MAX_BYTES) {
+    length = XTCP_BATCH_MAX_BYTES;
+  }
+  if (count > XTCP_BATCH_MAX_DATAGRAMS) {
+    count = XTCP_BATCH_MAX_DATAGRAMS;
+  }
+
+  const uint8_t *buffer = (const uint8_t *)batch_buffer;
+  int32_t sent = 0;
+
+  for (uint32_t d = 0; d < count; ++d) {
+    xtcp_datagram_t *datagram = &datagrams[d];
+    if ((datagram->offset > length) || (datagram->length > length - datagram->offset) ||
+        (datagram->length > UINT16_MAX)) {
+      status = XTCP_EINVAL;
+      break;
+    }
+
+    void *buffer_token = pbuf_shim_alloc_tx((uint16_t)datagram->length, 1);
+    if (buffer_token == NULL) {
+      status = XTCP_ENOMEM;
+      break;
+    }
+    memcpy(pbuf_shim_token_payload(buffer_token), &buffer[datagram->offset], datagram->length);
+
+    // The send frees the pbuf, hold it until its transmit timestamp has been read
+    pbuf_ref(buffer_token);
+    if (memcmp(datagram->ipaddr, any_addr, sizeof(xtcp_ipaddr_t)) == 0) {
+      // Connected remote host, this send can take the cached route
+      status = shim_send(client_num, id, buffer_token);
+    } else {
+      status = shim_sendto(client_num, id, buffer_token, datagram->ipaddr, datagram->port_number);
+    }
+    datagram->timestamp = pbuf_shim_token_timestamp(buffer_token);
+    pbuf_free(buffer_token);
+    if (status != XTCP_SUCCESS) {
+      break;
+    }
+    sent++;
+  }
+
+  return (sent == 0) ? status : sent;
+}
+
+#else
+
+uint8_t *udp_batch_buffer(void) {
+  return NULL;
+}
+
+int32_t udp_batch_recvfrom(unsigned client_num, int32_t id, uint32_t length, xtcp_datagram_t datagrams[], uint32_t max) {
+  (void)client_num;
+  (void)id;
+  (void)length;
+  (void)datagrams;
+  (void)max;
+  return XTCP_EPROTONOSUPPORT;
+}
+
+int32_t udp_batch_sendto(unsigned client_num, int32_t id, uint32_t length, xtcp_datagram_t datagrams[], uint32_t count) {
+  (void)client_num;
+  (void)id;
+  (void)length;
+  (void)datagrams;
+  (void)count;
+  return XTCP_EPROTONOSUPPORT;
+}
+
+#endif /* XTCP_UDP_BATCH_ENABLE */
@@ -0,0 +1,50 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_UDP_BATCH_H
+#define XTCP_UDP_BATCH_H
+
+#include <stdint.h>
+
+#include "xc2compat.h"
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Get the buffer holding the payloads of a batch, XTCP_BATCH_MAX_BYTES long. The payloads of a received batch are
+ * copied from it to the client in one transfer, and those of a batch to send are copied to it in one transfer. NULL
+ * when the library is built without XTCP_UDP_BATCH_ENABLE. */
+uint8_t * unsafe udp_batch_buffer(void);
+
+/** Take queued datagrams from a UDP connection into the batch buffer.
+ *
+ * Datagrams are copied back to back from the start of the buffer, copying stops when the next one does not fit. The
+ * receive events of the datagrams taken are removed from the client's queue.
+ *
+ * \param client_num  The client that owns the connection.
+ * \param id          The connection to receive on.
+ * \param length      The number of bytes of the batch buffer that can be used.
+ * \param datagrams   Filled in with the offset, length, remote host and timestamp of each datagram.
+ * \param max         The maximum number of datagrams to take.
+ * \returns           The number of datagrams taken, or an xtcp_error_code_t.
+ */
+int32_t udp_batch_recvfrom(unsigned client_num, int32_t id, uint32_t length, xtcp_datagram_t datagrams[], uint32_t max);
+
+/** Send datagrams from the batch buffer on a UDP connection.
+ *
+ * \param client_num  The client that owns the connection.
+ * \param id          The connection to send on.
+ * \param length      The number of bytes of the batch buffer holding payloads.
+ * \param datagrams   The offset, length and remote host of each datagram, the transmit timestamp is written back.
+ * \param count       The number of datagrams to send.
+ * \returns           The number of datagrams sent, or an xtcp_error_code_t if the first fails.
+ */
+int32_t udp_batch_sendto(unsigned client_num, int32_t id, uint32_t length, xtcp_datagram_t datagrams[], uint32_t count);
+
+#ifdef __XC__
+}
+#endif
+
+#endif /* XTCP_UDP_BATCH_H */
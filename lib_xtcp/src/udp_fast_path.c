@@ -0,0 +1,261 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "udp_fast_path.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <xs1.h>
+
+#include <xcore/hwtimer.h>
+
+/* XTCP headers */
+#include "connection.h"
+#include "static_arp.h"
+#include "xtcp_chksum.h"
+
+/* LwIP headers */
+#include "lwip/etharp.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/prot/ethernet.h"
+#include "lwip/prot/ip.h"
+#include "lwip/stats.h"
+
+#define ETH_HEADER_SIZE 14
+#define IP_HEADER_SIZE 20
+#define UDP_HEADER_SIZE 8
+
+/* Offsets of the fields written for each datagram */
+#define IP_OFFSET         ETH_HEADER_SIZE
+#define IP_LEN_OFFSET     (IP_OFFSET + 2)
+#define IP_ID_OFFSET      (IP_OFFSET + 4)
+#define IP_CHKSUM_OFFSET  (IP_OFFSET + 10)
+#define UDP_OFFSET        (IP_OFFSET + IP_HEADER_SIZE)
+#define UDP_LEN_OFFSET    (UDP_OFFSET + 4)
+#define UDP_CHKSUM_OFFSET (UDP_OFFSET + 6)
+
+#define REVALIDATE_TICKS ((uint32_t)XTCP_UDP_FAST_PATH_REVALIDATE_MS * XS1_TIMER_KHZ)
+
+/* Cached route for a connected socket. Checksums of the template fields that do not change are kept as one's
+ * complement sums, so each datagram only adds in its length and ID. */
+typedef struct udp_route_t {
+  struct udp_pcb *pcb;          // Socket the route was built for, NULL when there is none
+  struct netif *netif;
+  ip_addr_t local_ip;           // Addresses, ports and options of the socket when built
+  ip_addr_t remote_ip;
+  uint16_t local_port;
+  uint16_t remote_port;
+  uint8_t ttl;
+  uint8_t tos;
+  uint32_t generation;
+  uint32_t built_at;
+  uint32_t ip_sum;              // Sum of the IPv4 header with zero length, ID and checksum
+  uint32_t pseudo_sum;          // Sum of the UDP pseudo header without the length
+  uint8_t header[UDP_FAST_PATH_HEADER_SIZE];
+} udp_route_t;
+
+#if UDP_FAST_PATH_ACTIVE
+static udp_route_t routes[MAX_OPEN_SOCKETS];
+#endif
+static uint32_t generation;
+
+/* IP identification of the next datagram. lwIP keeps its own counter private to ip4.c, so this follows on from the ID
+ * lwIP gave the last datagram sent through it by udp_fast_path_update(). */
+static uint16_t ip_id;
+
+static inline uint32_t load16(const uint8_t *p) {
+  uint16_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline void store16(uint8_t *p, uint32_t value) {
+  uint16_t v = (uint16_t)value;
+  memcpy(p, &v, sizeof(v));
+}
+
+static inline void store16_be(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value >> 8);
+  p[1] = (uint8_t)value;
+}
+
+static inline uint32_t fold16(uint32_t sum) {
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  return (sum & 0xFFFF) + (sum >> 16);
+}
+
+void udp_fast_path_invalidate(void) {
+  generation++;
+}
+
+#if UDP_FAST_PATH_ACTIVE
+
+static int route_valid(const udp_route_t *route, const struct udp_pcb *pcb, uint32_t now) {
+  if (route->pcb != pcb || route->generation != generation || (now - route->built_at) >= REVALIDATE_TICKS) {
+    return 0;
+  }
+  // Catch connect(), bind() and option changes since the route was built
+  if (!ip_addr_cmp(&route->local_ip, &pcb->local_ip) || !ip_addr_cmp(&route->remote_ip, &pcb->remote_ip) ||
+      route->local_port != pcb->local_port || route->remote_port != pcb->remote_port || route->ttl != pcb->ttl ||
+      route->tos != pcb->tos || !(pcb->flags & UDP_FLAGS_CONNECTED)) {
+    return 0;
+  }
+  // The interface address can change under a socket bound to any address, for example on DHCP renewal
+  struct netif *netif = route->netif;
+  return netif_is_up(netif) && netif_is_link_up(netif) &&
+         memcmp(&route->header[IP_OFFSET + 12], netif_ip4_addr(netif), 4) == 0;
+}
+
+#endif /* UDP_FAST_PATH_ACTIVE */
+
+int udp_fast_path_send(int32_t id, struct udp_pcb *pcb, struct pbuf *p, err_t *err) {
+#if UDP_FAST_PATH_ACTIVE
+  if (id < 0 || id >= MAX_OPEN_SOCKETS || p->next != NULL ||
+      p->len > 0xFFFF - IP_HEADER_SIZE - UDP_HEADER_SIZE) {
+    return 0;
+  }
+  udp_route_t *route = &routes[id];
+  if (!route_valid(route, pcb, get_reference_time())) {
+    return 0;
+  }
+  // Datagrams that need fragmenting go through lwIP
+  if (p->len + IP_HEADER_SIZE + UDP_HEADER_SIZE > route->netif->mtu ||
+      pbuf_add_header(p, UDP_FAST_PATH_HEADER_SIZE) != 0) {
+    return 0;
+  }
+
+  uint8_t *frame = p->payload;
+  uint32_t udp_len = p->len - (UDP_FAST_PATH_HEADER_SIZE - UDP_HEADER_SIZE);
+  memcpy(frame, route->header, UDP_FAST_PATH_HEADER_SIZE);
+
+  store16_be(&frame[IP_LEN_OFFSET], udp_len + IP_HEADER_SIZE);
+  store16_be(&frame[IP_ID_OFFSET], ip_id++);
+  uint32_t ip_sum = route->ip_sum + load16(&frame[IP_LEN_OFFSET]) + load16(&frame[IP_ID_OFFSET]);
+  store16(&frame[IP_CHKSUM_OFFSET], ~fold16(ip_sum));
+
+  store16_be(&frame[UDP_LEN_OFFSET], udp_len);
+  if (!(pcb->flags & UDP_FLAGS_NOCHKSUM)) {
+    // The length appears in both the pseudo header and the UDP header
+    uint32_t udp_sum = route->pseudo_sum + load16(&frame[UDP_LEN_OFFSET]) +
+                       xtcp_chksum(&frame[UDP_OFFSET], (uint16_t)udp_len);
+    uint32_t chksum = ~fold16(udp_sum) & 0xFFFF;
+    store16(&frame[UDP_CHKSUM_OFFSET], chksum ? chksum : 0xFFFF);
+  }
+
+  // Counted as lwIP's udp_send() and ip4_output_if() would
+  UDP_STATS_INC(udp.xmit);
+  MIB2_STATS_INC(mib2.udpoutdatagrams);
+  IP_STATS_INC(ip.xmit);
+  MIB2_STATS_INC(mib2.ipoutrequests);
+  *err = route->netif->linkoutput(route->netif, p);
+  return 1;
+#else
+  (void)id;
+  (void)pcb;
+  (void)p;
+  (void)err;
+  return 0;
+#endif
+}
+
+void udp_fast_path_update(int32_t id, struct udp_pcb *pcb, const struct pbuf *p, const void *payload) {
+#if UDP_FAST_PATH_ACTIVE
+  if (id < 0 || id >= MAX_OPEN_SOCKETS) {
+    return;
+  }
+  // lwIP writes its headers in front of the payload when the pbuf has room for them
+  uintptr_t sent_ip = (uintptr_t)payload - (IP_HEADER_SIZE + UDP_HEADER_SIZE);
+  if ((uintptr_t)p->payload <= sent_ip) {
+    const uint8_t *ip = (const uint8_t *)sent_ip;
+    ip_id = (uint16_t)(((ip[4] << 8) | ip[5]) + 1);
+  }
+
+  udp_route_t *route = &routes[id];
+  route->pcb = NULL;
+
+  if (!(pcb->flags & UDP_FLAGS_CONNECTED) || !IP_IS_V4(&pcb->remote_ip)) {
+    return;
+  }
+  const ip4_addr_t *remote = ip_2_ip4(&pcb->remote_ip);
+  struct netif *netif = ip4_route(remote);
+  if (netif == NULL || !(netif->flags & NETIF_FLAG_ETHARP) || !netif_is_up(netif) || !netif_is_link_up(netif)) {
+    return;
+  }
+  // Broadcast, multicast and loopback destinations keep using lwIP
+  if (ip4_addr_isany(remote) || ip4_addr_ismulticast(remote) || ip4_addr_isbroadcast(remote, netif) ||
+      ip4_addr_cmp(remote, netif_ip4_addr(netif))) {
+    return;
+  }
+
+  const ip4_addr_t *local = ip_2_ip4(&pcb->local_ip);
+  const ip4_addr_t *source = ip4_addr_isany(local) ? netif_ip4_addr(netif) : local;
+  if (!ip4_addr_cmp(source, netif_ip4_addr(netif))) {
+    return;
+  }
+
+  const ip4_addr_t *next_hop = remote;
+  uint32_t mask = ip4_addr_get_u32(netif_ip4_netmask(netif));
+  if ((ip4_addr_get_u32(remote) & mask) != (ip4_addr_get_u32(source) & mask) && !ip4_addr_islinklocal(remote)) {
+    next_hop = netif_ip4_gw(netif);
+    if (ip4_addr_isany(next_hop)) {
+      return;
+    }
+  }
+
+  const uint8_t *mac = NULL;
+#if XTCP_ARP_HASH_TABLE_SIZE
+  mac = static_arp_lookup((const uint8_t *)next_hop);
+#endif
+  if (mac == NULL) {
+    struct eth_addr *eth_ret;
+    const ip4_addr_t *ip_ret;
+    if (etharp_find_addr(netif, next_hop, &eth_ret, &ip_ret) < 0) {
+      // Not resolved yet, the send through lwIP will have started ARP
+      return;
+    }
+    mac = eth_ret->addr;
+  }
+
+  uint8_t *header = route->header;
+  memset(header, 0, UDP_FAST_PATH_HEADER_SIZE);
+  memcpy(&header[0], mac, ETH_HWADDR_LEN);
+  memcpy(&header[ETH_HWADDR_LEN], netif->hwaddr, ETH_HWADDR_LEN);
+  store16_be(&header[12], ETHTYPE_IP);
+
+  uint8_t *ip = &header[IP_OFFSET];
+  ip[0] = 0x45;
+  ip[1] = pcb->tos;
+  ip[8] = pcb->ttl;
+  ip[9] = IP_PROTO_UDP;
+  memcpy(&ip[12], source, 4);
+  memcpy(&ip[16], remote, 4);
+  route->ip_sum = xtcp_chksum(ip, IP_HEADER_SIZE);
+
+  uint8_t *udp = &header[UDP_OFFSET];
+  store16_be(&udp[0], pcb->local_port);
+  store16_be(&udp[2], pcb->remote_port);
+
+  uint8_t pseudo[12] = {0};
+  memcpy(&pseudo[0], source, 4);
+  memcpy(&pseudo[4], remote, 4);
+  pseudo[9] = IP_PROTO_UDP;
+  route->pseudo_sum = xtcp_chksum(pseudo, sizeof(pseudo));
+
+  route->netif = netif;
+  ip_addr_copy(route->local_ip, pcb->local_ip);
+  ip_addr_copy(route->remote_ip, pcb->remote_ip);
+  route->local_port = pcb->local_port;
+  route->remote_port = pcb->remote_port;
+  route->ttl = pcb->ttl;
+  route->tos = pcb->tos;
+  route->generation = generation;
+  route->built_at = get_reference_time();
+  route->pcb = pcb;
+#else
+  (void)id;
+  (void)pcb;
+  (void)p;
+  (void)payload;
+#endif
+}
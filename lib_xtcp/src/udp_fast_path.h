@@ -0,0 +1,57 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_UDP_FAST_PATH_H
+#define XTCP_UDP_FAST_PATH_H
+
+#include <stdint.h>
+
+#include "xtcp.h"
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Discard every cached route, called when the link, the interface address or a static ARP entry changes */
+void udp_fast_path_invalidate(void);
+
+#ifdef __XC__
+}
+#endif
+
+#ifndef __XC__
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+
+/** The cached header assumes lwIP does not pad the Ethernet header */
+#define UDP_FAST_PATH_ACTIVE (XTCP_UDP_FAST_PATH && ETH_PAD_SIZE == 0)
+
+/** Ethernet, IPv4 and UDP header bytes added in front of the payload */
+#define UDP_FAST_PATH_HEADER_SIZE (14 + 20 + 8)
+
+/** Send a datagram on a connected UDP socket using its cached route and headers.
+ *
+ * The cache for the connection is built on the first send after connect(), and rebuilt after
+ * XTCP_UDP_FAST_PATH_REVALIDATE_MS or udp_fast_path_invalidate(). A send that finds the cache missing or stale is
+ * not taken, so goes through udp_send(), which keeps the lwIP ARP entry for the destination refreshed.
+ *
+ * \param id      The connection the socket belongs to.
+ * \param pcb     The socket.
+ * \param p       The datagram payload, a single pbuf with room for the headers in front of it.
+ * \param err     Set to the result of the send when it was taken.
+ * \returns       Non-zero if the datagram was sent, zero if it must be sent with udp_send().
+ */
+int udp_fast_path_send(int32_t id, struct udp_pcb *pcb, struct pbuf *p, err_t *err);
+
+/** Build the cached route and headers for a connected socket, after a send through udp_send(). The IP identification
+ * of later datagrams follows on from the one lwIP gave this datagram.
+ *
+ * \param id      The connection the socket belongs to.
+ * \param pcb     The socket.
+ * \param p       The datagram just sent.
+ * \param payload The payload pointer of p before udp_send() added its headers.
+ */
+void udp_fast_path_update(int32_t id, struct udp_pcb *pcb, const struct pbuf *p, const void *payload);
+#endif /* __XC__ */
+
+#endif /* XTCP_UDP_FAST_PATH_H */
@@ -8,7 +8,8 @@
 /* XMOS library headers */
 #include "client_queue.h"
 #include "connection.h"
-#include "debug_print.h"
+#include "deferred_log.h"
+#include "direct_client.h"
 
 /* LwIP headers */
 #include "lwip/ip.h"
@@ -20,7 +21,21 @@ void xtcp_udp_recv(void* arg, struct udp_pcb* upcb,  struct pbuf* p, const ip_ad
   int32_t index = (int32_t)arg;  // arg is the index in the connection array
 
   if ((index >= 0) && (index < MAX_OPEN_SOCKETS) && (p != NULL)) {
-    set_remote(index, addr, port, p);
+    if (p->tot_len > XTCP_UDP_MAX_DATAGRAM_SIZE) {
+      // Reassembled datagram larger than a client can receive
+      DEFERRED_LOG(LOG_UDP_DATAGRAM_DROPPED, p->tot_len, 0);
+      pbuf_free(p);
+      return;
+    }
+    if (get_client_info(index) == DIRECT_CLIENT_NUM) {
+      direct_client_udp_recv(index, p, addr, port);
+      return;
+    }
+    if (set_remote(index, addr, port, p) != XTCP_SUCCESS) {
+      // Client is over its receive quota, drop the datagram
+      pbuf_free(p);
+      return;
+    }
 
     xtcp_event_type_t event;
     if (upcb->flags & UDP_FLAGS_CONNECTED) {
@@ -30,11 +45,12 @@ void xtcp_udp_recv(void* arg, struct udp_pcb* upcb,  struct pbuf* p, const ip_ad
     }
     xtcp_error_code_t result = enqueue_event_and_notify(get_client_info(index), index, event);
     if (result != XTCP_SUCCESS) {
-      debug_printf("xtcp_udp_recv: enqueue_event_and_notify failed: %d\n", result);
-      // Free the pbuf since we couldn't enqueue the event
+      DEFERRED_LOG(LOG_UDP_ENQUEUE_FAILED, result, 0);
+      // Free the pbuf since we couldn't enqueue the event, unlinking it first so it is not left on the queue
+      (void)unlink_remote(index, p);
       pbuf_free(p);
     }
   } else {
-    debug_printf("Received bad index or NULL pbuf, skipping\n");
+    DEFERRED_LOG(LOG_UDP_BAD_RECV, index, 0);
   }
 }
@@ -0,0 +1,206 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include "xtcp_chksum.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Words are summed into a 64-bit accumulator, deferring every carry fold to the end. 2^32 and 2^16 are both 1 in one's
+ * complement arithmetic, so folding the accumulator gives the same result as summing 16-bit words. The main loops
+ * are unrolled so the loop overhead is paid once per CHKSUM_UNROLL words. */
+#define CHKSUM_UNROLL 8
+
+/* Fold a 32-bit one's complement sum to 16 bits */
+static inline uint32_t fold16(uint32_t sum) {
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  return (sum & 0xFFFF) + (sum >> 16);
+}
+
+/* Fold a 64-bit word sum to 16 bits, 2^32 is 1 in one's complement arithmetic so the high word adds to the low */
+static inline uint32_t fold64(uint64_t acc) {
+  uint32_t low = (uint32_t)acc;
+  uint32_t sum = low + (uint32_t)(acc >> 32);
+  if (sum < low) {
+    sum++;
+  }
+  return fold16(sum);
+}
+
+#if defined(__xcore__)
+
+/* The xcore is little endian and only supports aligned word loads. Bytes before and after the aligned words are
+ * summed into the 16-bit lane given by their offset from the start of the data. A word region starting at an odd
+ * offset is summed as if even and byte swapped afterwards. */
+
+static inline uint32_t sum_byte(uint8_t byte, uint32_t offset) {
+  return (offset & 1) ? ((uint32_t)byte << 8) : byte;
+}
+
+/* Swap the bytes of a folded 16-bit sum */
+static inline uint32_t swap16(uint32_t sum) {
+  return ((sum & 0xFF) << 8) | ((sum >> 8) & 0xFF);
+}
+
+static uint64_t sum_words(const uint32_t *sw, uint32_t words) {
+  uint64_t acc = 0;
+  uint32_t w = 0;
+  for (; w + CHKSUM_UNROLL <= words; w += CHKSUM_UNROLL) {
+    acc += sw[w + 0];
+    acc += sw[w + 1];
+    acc += sw[w + 2];
+    acc += sw[w + 3];
+    acc += sw[w + 4];
+    acc += sw[w + 5];
+    acc += sw[w + 6];
+    acc += sw[w + 7];
+  }
+  for (; w < words; ++w) {
+    acc += sw[w];
+  }
+  return acc;
+}
+
+static uint64_t copy_sum_words(uint32_t *dw, const uint32_t *sw, uint32_t words) {
+  uint64_t acc = 0;
+  uint32_t w = 0;
+  for (; w + CHKSUM_UNROLL <= words; w += CHKSUM_UNROLL) {
+    uint32_t v0 = sw[w + 0], v1 = sw[w + 1], v2 = sw[w + 2], v3 = sw[w + 3];
+    uint32_t v4 = sw[w + 4], v5 = sw[w + 5], v6 = sw[w + 6], v7 = sw[w + 7];
+    dw[w + 0] = v0; dw[w + 1] = v1; dw[w + 2] = v2; dw[w + 3] = v3;
+    dw[w + 4] = v4; dw[w + 5] = v5; dw[w + 6] = v6; dw[w + 7] = v7;
+    acc += v0; acc += v1; acc += v2; acc += v3;
+    acc += v4; acc += v5; acc += v6; acc += v7;
+  }
+  for (; w < words; ++w) {
+    uint32_t value = sw[w];
+    dw[w] = value;
+    acc += value;
+  }
+  return acc;
+}
+
+uint16_t xtcp_chksum(const void *data, uint16_t len) {
+  const uint8_t *s = data;
+  uint32_t offset = 0;
+  uint32_t sum = 0;
+
+  while (offset < len && ((uintptr_t)s & 3)) {
+    sum += sum_byte(*s++, offset++);
+  }
+
+  uint32_t words = (len - offset) / 4;
+  uint32_t word_sum = fold64(sum_words((const uint32_t *)s, words));
+  sum += (offset & 1) ? swap16(word_sum) : word_sum;
+  s += words * 4;
+  offset += words * 4;
+
+  while (offset < len) {
+    sum += sum_byte(*s++, offset++);
+  }
+  return (uint16_t)fold16(sum);
+}
+
+uint16_t xtcp_chksum_copy(void *dst, const void *src, uint16_t len) {
+  if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) != 0) {
+    // Source and destination can never both be word aligned, copy then sum the aligned destination
+    memcpy(dst, src, len);
+    return xtcp_chksum(dst, len);
+  }
+
+  uint8_t *d = dst;
+  const uint8_t *s = src;
+  uint32_t offset = 0;
+  uint32_t sum = 0;
+
+  while (offset < len && ((uintptr_t)s & 3)) {
+    *d++ = *s;
+    sum += sum_byte(*s++, offset++);
+  }
+
+  uint32_t words = (len - offset) / 4;
+  uint32_t word_sum = fold64(copy_sum_words((uint32_t *)d, (const uint32_t *)s, words));
+  sum += (offset & 1) ? swap16(word_sum) : word_sum;
+  d += words * 4;
+  s += words * 4;
+  offset += words * 4;
+
+  while (offset < len) {
+    *d++ = *s;
+    sum += sum_byte(*s++, offset++);
+  }
+  return (uint16_t)fold16(sum);
+}
+
+#else /* Portable fallback */
+
+/* Loads 32-bit words in memory order with memcpy, so works with any alignment and byte order, and the data is
+ * always summed from an even offset. Independent accumulators let the compiler vectorise the unrolled loop. A
+ * trailing odd byte is loaded into the first byte of a zeroed word, which places it in the correct lane on both big
+ * and little endian hosts. */
+
+static inline uint32_t load32(const uint8_t *s) {
+  uint32_t value;
+  memcpy(&value, s, sizeof(value));
+  return value;
+}
+
+static uint32_t sum_tail(const uint8_t *s, uint32_t remaining) {
+  uint32_t sum = 0;
+  if (remaining >= 2) {
+    uint16_t value;
+    memcpy(&value, s, sizeof(value));
+    sum += value;
+    s += 2;
+    remaining -= 2;
+  }
+  if (remaining) {
+    uint16_t value = 0;
+    memcpy(&value, s, 1);
+    sum += value;
+  }
+  return sum;
+}
+
+uint16_t xtcp_chksum(const void *data, uint16_t len) {
+  const uint8_t *s = data;
+  uint32_t remaining = len;
+  uint64_t acc[4] = {0, 0, 0, 0};
+
+  for (; remaining >= 4 * CHKSUM_UNROLL; remaining -= 4 * CHKSUM_UNROLL, s += 4 * CHKSUM_UNROLL) {
+    for (uint32_t w = 0; w < CHKSUM_UNROLL; ++w) {
+      acc[w & 3] += load32(&s[4 * w]);
+    }
+  }
+  for (; remaining >= 4; remaining -= 4, s += 4) {
+    acc[0] += load32(s);
+  }
+
+  uint64_t total = acc[0] + acc[1] + acc[2] + acc[3];
+  return (uint16_t)fold16(fold64(total) + sum_tail(s, remaining));
+}
+
+uint16_t xtcp_chksum_copy(void *dst, const void *src, uint16_t len) {
+  uint8_t *d = dst;
+  const uint8_t *s = src;
+  uint32_t remaining = len;
+  uint64_t acc[4] = {0, 0, 0, 0};
+
+  for (; remaining >= 4 * CHKSUM_UNROLL; remaining -= 4 * CHKSUM_UNROLL, s += 4 * CHKSUM_UNROLL, d += 4 * CHKSUM_UNROLL) {
+    memcpy(d, s, 4 * CHKSUM_UNROLL);
+    for (uint32_t w = 0; w < CHKSUM_UNROLL; ++w) {
+      acc[w & 3] += load32(&s[4 * w]);
+    }
+  }
+  for (; remaining >= 4; remaining -= 4, s += 4, d += 4) {
+    uint32_t value = load32(s);
+    memcpy(d, &value, sizeof(value));
+    acc[0] += value;
+  }
+  memcpy(d, s, remaining);
+
+  uint64_t total = acc[0] + acc[1] + acc[2] + acc[3];
+  return (uint16_t)fold16(fold64(total) + sum_tail(s, remaining));
+}
+
+#endif /* __xcore__ */
@@ -0,0 +1,24 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_CHKSUM_H
+#define XTCP_CHKSUM_H
+
+#include <stdint.h>
+
+/* Note: this header is included from lwipopts.h, so must not depend on lwIP or XTCP headers */
+
+/** Copy data and compute its Internet checksum in a single pass, used as LWIP_CHKSUM_COPY.
+ *
+ * \param dst   The destination buffer.
+ * \param src   The source buffer, must not overlap dst.
+ * \param len   The number of bytes to copy.
+ * \returns     The one's complement sum of the data as 16-bit words in memory order, folded and not complemented,
+ *              the same as LWIP_CHKSUM(dst, len).
+ */
+uint16_t xtcp_chksum_copy(void *dst, const void *src, uint16_t len);
+
+/** Compute the Internet checksum of data, returning the same as xtcp_chksum_copy() without the copy. */
+uint16_t xtcp_chksum(const void *data, uint16_t len);
+
+#endif /* XTCP_CHKSUM_H */
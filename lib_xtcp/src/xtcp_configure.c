@@ -13,3 +13,23 @@ __attribute__((weak)) void xtcp_configure_mac(unsigned netif_id, uint8_t mac_add
   memset(mac_address, 0, MACADDR_NUM_BYTES);
   debug_printf("xtcp_configure_mac: Override this function to set a valid MAC address, returning zero MAC address\n");
 }
+
+__attribute__((weak)) void xtcp_configure_client_quota(unsigned client_num, xtcp_client_quota_t *quota) {
+  // Keep the XTCP_CLIENT_MAX_* defaults supplied by the caller
+  (void)client_num;
+  (void)quota;
+}
+
+__attribute__((weak)) void xtcp_configure_client_sched(unsigned client_num, xtcp_client_sched_t *sched) {
+  // Keep the XTCP_CLIENT_WEIGHT and normal priority supplied by the caller
+  (void)client_num;
+  (void)sched;
+}
+
+__attribute__((weak)) void xtcp_configure_direct_clients(void) {
+  // No direct C clients
+}
+
+__attribute__((weak)) void xtcp_configure_static_regions(void) {
+  // No static regions
+}
@@ -0,0 +1,168 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Send latency through the IPv4 output path with neighbours learned by ARP and with static entries. Packets are sent
+ * round robin to many peers on a netif whose frames are captured rather than sent. For each case the benchmark
+ * reports the time per send and how many sends left as an IPv4 frame straight away, rather than being held for an ARP
+ * round trip: at startup, with every entry resolved, and after the ARP entries have aged out. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "static_arp.h"
+
+/* LwIP headers */
+#include "lwip/etharp.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "netif/ethernet.h"
+
+#define SEND_ROUNDS 100
+#define PAYLOAD_SIZE 64
+
+static struct netif netif;
+static const uint8_t our_mac[ETH_HWADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static uint32_t ip_frames;
+static uint32_t arp_frames;
+
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t capture_linkoutput(struct netif *n, struct pbuf *p) {
+  (void)n;
+  const uint8_t *frame = p->payload;
+  uint16_t type = (uint16_t)((frame[12] << 8) | frame[13]);
+  if (type == ETHTYPE_IP) {
+    ip_frames++;
+  } else if (type == ETHTYPE_ARP) {
+    arp_frames++;
+  }
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t bench_netif_init(struct netif *n) {
+  n->hwaddr_len = ETH_HWADDR_LEN;
+  memcpy(n->hwaddr, our_mac, ETH_HWADDR_LEN);
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+  n->output = etharp_output;
+  n->linkoutput = capture_linkoutput;
+  return ERR_OK;
+}
+
+static void peer_addr(ip4_addr_t *addr, uint32_t peer) {
+  uint32_t host = peer + 2;
+  IP4_ADDR(addr, 10, 0, (uint8_t)(host >> 8), (uint8_t)host);
+}
+
+static void peer_mac(uint8_t mac[ETH_HWADDR_LEN], uint32_t peer) {
+  memcpy(mac, our_mac, ETH_HWADDR_LEN);
+  mac[4] = (uint8_t)(peer >> 8);
+  mac[5] = (uint8_t)(peer + 2);
+}
+
+/* Receive an ARP reply from the peer, which adds a dynamic entry to the lwIP ARP table */
+static void learn_peer(uint32_t peer) {
+  uint8_t frame[SIZEOF_ETH_HDR + 28] = {0};
+  uint8_t *arp = &frame[SIZEOF_ETH_HDR];
+  ip4_addr_t addr;
+
+  memcpy(&frame[0], our_mac, ETH_HWADDR_LEN);
+  peer_mac(&frame[6], peer);
+  frame[12] = ETHTYPE_ARP >> 8;
+  frame[13] = ETHTYPE_ARP & 0xFF;
+
+  static const uint8_t arp_header[8] = {0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x02};
+  memcpy(arp, arp_header, sizeof(arp_header));
+  peer_mac(&arp[8], peer);
+  peer_addr(&addr, peer);
+  memcpy(&arp[14], &addr, 4);
+  memcpy(&arp[18], our_mac, ETH_HWADDR_LEN);
+  memcpy(&arp[24], netif_ip4_addr(&netif), 4);
+
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, sizeof(frame), PBUF_RAM);
+  pbuf_take(p, frame, sizeof(frame));
+  netif.input(p, &netif);
+}
+
+static void age_out_arp_entries(void) {
+  for (uint32_t i = 0; i <= ARP_MAXAGE; ++i) {
+    etharp_tmr();
+  }
+}
+
+/* Send one packet to each peer, returning the number that left as an IPv4 frame at once */
+static uint32_t send_round(uint32_t num_peers, uint32_t *ticks) {
+  uint32_t sent_before = ip_frames;
+  for (uint32_t peer = 0; peer < num_peers; ++peer) {
+    ip4_addr_t addr;
+    peer_addr(&addr, peer);
+    struct pbuf *p = pbuf_alloc(PBUF_IP, PAYLOAD_SIZE, PBUF_RAM);
+
+    uint32_t start = bench_time();
+    netif.output(&netif, p, &addr);
+    *ticks += bench_time() - start;
+    pbuf_free(p);
+  }
+  return ip_frames - sent_before;
+}
+
+static void report_rounds(const char *name, uint32_t num_peers) {
+  uint32_t ticks = 0;
+  uint32_t immediate = 0;
+  for (uint32_t round = 0; round < SEND_ROUNDS; ++round) {
+    immediate += send_round(num_peers, &ticks);
+  }
+  bench_report(name, "peers", (int32_t)num_peers);
+  bench_report(name, "ns_per_send", (int32_t)((ticks * (1000 / BENCH_TICKS_PER_US)) / (SEND_ROUNDS * num_peers)));
+  bench_report(name, "immediate_percent", (int32_t)((immediate * 100) / (SEND_ROUNDS * num_peers)));
+}
+
+int main(void) {
+  ip4_addr_t ipaddr, netmask, gw;
+  IP4_ADDR(&ipaddr, 10, 0, 0, 1);
+  IP4_ADDR(&netmask, 255, 255, 0, 0);
+  IP4_ADDR(&gw, 10, 0, 0, 254);
+
+  lwip_init();
+  netif_add(&netif, &ipaddr, &netmask, &gw, NULL, bench_netif_init, ethernet_input);
+  netif_set_default(&netif);
+  netif_set_up(&netif);
+  netif_set_link_up(&netif);
+  static_arp_init();
+
+  uint32_t ticks = 0;
+  uint32_t dynamic_peers = ARP_TABLE_SIZE;
+
+  // Dynamic entries: the first send to each peer waits for ARP
+  bench_report("arp_dynamic", "startup_immediate", (int32_t)send_round(dynamic_peers, &ticks));
+  for (uint32_t peer = 0; peer < dynamic_peers; ++peer) {
+    learn_peer(peer);
+  }
+  report_rounds("arp_dynamic", dynamic_peers);
+  age_out_arp_entries();
+  bench_report("arp_dynamic", "expiry_immediate", (int32_t)send_round(dynamic_peers, &ticks));
+
+  // Static entries in the hashed table, for many more peers than the lwIP ARP table holds
+  uint32_t static_peers = STATIC_ARP_MAX_ENTRIES;
+  uint32_t failures = 0;
+  uint32_t dynamic_arp_frames = arp_frames;
+  for (uint32_t peer = 0; peer < static_peers; ++peer) {
+    ip4_addr_t addr;
+    uint8_t mac[ETH_HWADDR_LEN];
+    peer_addr(&addr, peer);
+    peer_mac(mac, peer);
+    if (static_arp_add((const uint8_t *)&addr, mac) != XTCP_SUCCESS) {
+      failures++;
+    }
+  }
+  failures += static_peers - send_round(static_peers, &ticks);
+  report_rounds("arp_static", static_peers);
+  age_out_arp_entries();
+  failures += static_peers - send_round(static_peers, &ticks);
+
+  // A peer with a static entry is never resolved by ARP
+  failures += arp_frames - dynamic_arp_frames;
+  bench_report("arp_static", "failures", (int32_t)failures);
+  return 0;
+}
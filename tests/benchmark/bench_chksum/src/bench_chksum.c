@@ -0,0 +1,111 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Throughput of the send path copy with the checksum off, with a separate checksum pass, and with the checksum
+ * computed while copying (LWIP_CHKSUM_COPY). Also the cost in core cycles per byte of the checksum (LWIP_CHKSUM)
+ * against lwIP's standard 16-bit algorithm. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "xtcp_chksum.h"
+
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS 1000
+#endif
+
+#ifndef BENCH_CORE_MHZ
+#define BENCH_CORE_MHZ 600
+#endif
+
+#define MAX_LENGTH 1460
+
+static uint32_t src_buffer[MAX_LENGTH / 4];
+static uint32_t dst_buffer[MAX_LENGTH / 4];
+static volatile uint16_t sink;
+
+static uint16_t copy_only(void *dst, const void *src, uint16_t len) {
+  memcpy(dst, src, len);
+  return 0;
+}
+
+static uint16_t copy_then_chksum(void *dst, const void *src, uint16_t len) {
+  memcpy(dst, src, len);
+  return xtcp_chksum(dst, len);
+}
+
+/* lwIP's lwip_standard_chksum() algorithm 2, summing 16 bits at a time */
+static uint16_t standard_chksum(const void *data, uint16_t len) {
+  const uint8_t *pb = data;
+  uint32_t sum = 0;
+  int odd = ((uintptr_t)pb & 1);
+
+  uint16_t t = 0;
+  if (odd && len > 0) {
+    ((uint8_t *)&t)[1] = *pb++;
+    len--;
+  }
+  const uint16_t *ps = (const uint16_t *)(const void *)pb;
+  while (len > 1) {
+    sum += *ps++;
+    len -= 2;
+  }
+  if (len > 0) {
+    ((uint8_t *)&t)[0] = *(const uint8_t *)ps;
+  }
+  sum += t;
+  sum = (sum >> 16) + (sum & 0xFFFF);
+  sum = (sum >> 16) + (sum & 0xFFFF);
+  if (odd) {
+    sum = ((sum & 0xFF) << 8) | ((sum >> 8) & 0xFF);
+  }
+  return (uint16_t)sum;
+}
+
+static void run_chksum(const char *name, uint16_t (*chksum)(const void *, uint16_t), uint32_t offset, uint16_t len) {
+  const uint8_t *data = (const uint8_t *)src_buffer + offset;
+  uint32_t start = bench_time();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; ++i) {
+    sink = chksum(data, len);
+  }
+  uint32_t ticks = bench_time() - start;
+
+  char metric[40];
+  snprintf(metric, sizeof(metric), "centicycles_per_byte_%u_offset_%lu", len, (unsigned long)offset);
+  uint64_t cycles = (uint64_t)ticks * BENCH_CORE_MHZ / BENCH_TICKS_PER_US;
+  bench_report(name, metric, (int32_t)((cycles * 100) / ((uint64_t)len * BENCH_ITERATIONS)));
+}
+
+static void run(const char *name, uint16_t (*copy)(void *, const void *, uint16_t), uint16_t len) {
+  uint32_t start = bench_time();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; ++i) {
+    sink = copy(dst_buffer, src_buffer, len);
+  }
+  uint32_t ticks = bench_time() - start;
+
+  char metric[32];
+  snprintf(metric, sizeof(metric), "mbit_per_s_%u", len);
+  bench_report(name, metric, (int32_t)(((uint64_t)len * BENCH_ITERATIONS * 8 * BENCH_TICKS_PER_US) / ticks));
+}
+
+int main(void) {
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < MAX_LENGTH / 4; ++i) {
+    src_buffer[i] = bench_rand(&seed);
+  }
+
+  static const uint16_t lengths[] = {64, 536, MAX_LENGTH};
+  for (uint32_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+    run("chksum_off", copy_only, lengths[l]);
+    run("chksum_unfused", copy_then_chksum, lengths[l]);
+    run("chksum_fused", xtcp_chksum_copy, lengths[l]);
+  }
+  for (uint32_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+    for (uint32_t offset = 0; offset < 2; ++offset) {
+      uint16_t len = (uint16_t)(lengths[l] - offset);
+      run_chksum("chksum_standard", standard_chksum, offset, len);
+      run_chksum("chksum_xtcp", xtcp_chksum, offset, len);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Requests per second through the HTTP server's request handling, without the stack. Each request is received in
+ * segments, parsed, answered with a header and a static body, and the body acknowledged, as xtcp_http_event() drives
+ * it. Browser-sized requests are run on one persistent connection, pipelined BENCH_PIPELINE deep, and again with a new
+ * connection and Connection: close for each request, reporting the rate of each and the share of reused requests.
+ * The handshakes a new connection costs in the stack are not included. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "xtcp_http.h"
+
+#ifndef BENCH_REQUESTS
+#define BENCH_REQUESTS 20000
+#endif
+
+#ifndef BENCH_PIPELINE
+#define BENCH_PIPELINE 8
+#endif
+
+/* Segment size the requests are received in, a typical TCP_MSS */
+#define BENCH_SEGMENT 536
+
+#define BODY_REGION 0
+#define BODY_LENGTH 4096
+
+static const char keep_alive_request[] = "GET /index.html HTTP/1.1\r\n"
+                                         "Host: 192.168.200.198\r\n"
+                                         "User-Agent: bench_http\r\n"
+                                         "Accept: text/html,application/xhtml+xml\r\n"
+                                         "Accept-Encoding: gzip, deflate\r\n"
+                                         "\r\n";
+
+static const char close_request[] = "GET /index.html HTTP/1.1\r\n"
+                                    "Host: 192.168.200.198\r\n"
+                                    "User-Agent: bench_http\r\n"
+                                    "Accept: text/html,application/xhtml+xml\r\n"
+                                    "Connection: close\r\n"
+                                    "\r\n";
+
+static uint8_t pipeline[BENCH_PIPELINE * sizeof(keep_alive_request)];
+static uint32_t failures;
+
+/* Feed data to a connection a segment at a time, as the server receives it */
+static void feed(void *conn, const uint8_t *data, uint32_t length) {
+  while (length != 0) {
+    uint32_t segment = (length < BENCH_SEGMENT) ? length : BENCH_SEGMENT;
+    if (xtcp_http_received(conn, data, segment) != XTCP_SUCCESS) {
+      failures++;
+    }
+    data += segment;
+    length -= segment;
+  }
+}
+
+/* Answer every buffered request, checking each is a 200 with the body. Returns the number answered. */
+static uint32_t answer(void *conn, int expect_close) {
+  xtcp_http_response_t response;
+  uint32_t answered = 0;
+  while (xtcp_http_next(conn, &response)) {
+    if ((response.region != BODY_REGION) || (response.length != BODY_LENGTH) || (response.close != expect_close) ||
+        (memcmp(response.header, "HTTP/1.1 200 ", 13) != 0)) {
+      failures++;
+    }
+    xtcp_http_commit(conn);
+    (void)xtcp_http_sent(conn);
+    answered++;
+  }
+  return answered;
+}
+
+/* Report a run's rate and share of requests answered on a reused connection */
+static void report(const char *name, uint32_t requests, uint32_t ticks) {
+  xtcp_http_stats_t stats = xtcp_http_get_stats();
+  uint64_t per_second = ((uint64_t)requests * BENCH_TICKS_PER_US * 1000000) / (ticks ? ticks : 1);
+  bench_report(name, "requests_per_second", (int32_t)per_second);
+  bench_report(name, "ns_per_request", (int32_t)(((uint64_t)ticks * (1000 / BENCH_TICKS_PER_US)) / requests));
+  bench_report(name, "connections", (int32_t)stats.connections);
+  bench_report(name, "reuse_percent", (int32_t)(((uint64_t)stats.reused * 100) / stats.requests));
+  failures += stats.errors + stats.rejected;
+}
+
+static void reset(void) {
+  xtcp_http_init();
+  if (xtcp_http_add_resource("/index.html", "text/html", BODY_REGION, 0, BODY_LENGTH) != XTCP_SUCCESS) {
+    failures++;
+  }
+}
+
+static void keep_alive(void) {
+  reset();
+  uint32_t length = 0;
+  for (uint32_t i = 0; i < BENCH_PIPELINE; ++i) {
+    memcpy(&pipeline[length], keep_alive_request, sizeof(keep_alive_request) - 1);
+    length += sizeof(keep_alive_request) - 1;
+  }
+
+  void *conn = xtcp_http_open(0);
+  uint32_t answered = 0;
+  uint32_t start = bench_time();
+  for (uint32_t sent = 0; sent < BENCH_REQUESTS; sent += BENCH_PIPELINE) {
+    // A pipeline's requests are taken as they arrive, once the previous response's body has gone
+    const uint8_t *data = pipeline;
+    uint32_t remaining = length;
+    while (remaining != 0) {
+      uint32_t segment = (remaining < BENCH_SEGMENT) ? remaining : BENCH_SEGMENT;
+      feed(conn, data, segment);
+      answered += answer(conn, 0);
+      data += segment;
+      remaining -= segment;
+    }
+  }
+  uint32_t ticks = bench_time() - start;
+  xtcp_http_close(conn);
+
+  if (answered != ((BENCH_REQUESTS + BENCH_PIPELINE - 1) / BENCH_PIPELINE) * BENCH_PIPELINE) {
+    failures++;
+  }
+  report("keep_alive", answered, ticks);
+}
+
+static void new_connections(void) {
+  reset();
+  uint32_t answered = 0;
+  uint32_t start = bench_time();
+  for (uint32_t i = 0; i < BENCH_REQUESTS; ++i) {
+    void *conn = xtcp_http_open((int32_t)i);
+    feed(conn, (const uint8_t *)close_request, sizeof(close_request) - 1);
+    answered += answer(conn, 1);
+    xtcp_http_close(conn);
+  }
+  uint32_t ticks = bench_time() - start;
+
+  if (answered != BENCH_REQUESTS) {
+    failures++;
+  }
+  report("new_connection", answered, ticks);
+}
+
+int main(void) {
+  keep_alive();
+  new_connections();
+  bench_report("http", "failures", (int32_t)failures);
+  return 0;
+}
@@ -0,0 +1,303 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Bulk TCP transfer between two clients of the stack over an impaired link, for each of a list of scenarios. Each
+ * direction of the link is an impair_link_t, with the rate and round trip of bench_tcp_throughput and the loss, delay,
+ * jitter, reordering, duplication and rate cap of the scenario on top. Time is virtual, so the goodput reported is what
+ * the lwIP options in use achieve under those conditions. For each scenario the benchmark reports the goodput, the
+ * segments the sender retransmitted, the XTCP_SENT_DATA and XTCP_RESEND_DATA events the sending client was given and
+ * what the link did to the frames.
+ *
+ * Scenarios are given as simulator arguments of the form name:impairments, for example
+ *
+ *   xsim --args bin/bench_impair/benchmark_bench_impair.xe lossy:loss=2,jitter_us=300
+ *
+ * or through the benchmark runner with --bench-args. Without arguments the default scenarios are run. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "client_queue.h"
+#include "connection.h"
+#include "impair.h"
+#include "lwip_shim.h"
+#include "pbuf_shim.h"
+#include "tx_pool.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/tcp.h"
+
+#ifndef BENCH_KBYTES
+#define BENCH_KBYTES 256
+#endif
+
+#ifndef BENCH_LINK_MBPS
+#define BENCH_LINK_MBPS 100
+#endif
+
+#ifndef BENCH_RTT_US
+#define BENCH_RTT_US 1000
+#endif
+
+#ifndef BENCH_SEND_LENGTH
+#define BENCH_SEND_LENGTH 1460
+#endif
+
+#define BENCH_BYTES ((uint32_t)BENCH_KBYTES * 1024)
+
+/* Transfers taking longer than this in link time have stalled */
+#define BENCH_LIMIT_TICKS (20 * 1000000 * BENCH_TICKS_PER_US)
+
+/* Link time allowed after each transfer for the connection to close */
+#define BENCH_CLOSE_TICKS (1000000 * BENCH_TICKS_PER_US)
+
+#define RECEIVER 0
+#define SENDER 1
+#define PORT 15533
+
+#define IP_HEADER_SIZE 20
+#define TCP_HEADER_SIZE 20
+#define IP_PROTOCOL_TCP 6
+
+static const char *const default_scenarios[] = {
+  "ideal:",
+  "loss_1:loss=1",
+  "loss_5:loss=5",
+  "jitter:jitter_us=500",
+  "reorder:reorder=2,reorder_us=2000",
+  "duplicate:duplicate=2",
+  "capped:rate_kbps=10000,queue_frames=32",
+};
+
+static struct netif netif_sender;
+static struct netif netif_receiver;
+static impair_link_t links[2];
+static uint32_t now;
+
+/* Highest sequence number sent, so segments sent again are counted */
+static uint32_t sent_seq_end;
+static int sent_any;
+static uint32_t retransmits;
+
+static uint8_t pattern[256 + BENCH_SEND_LENGTH];
+static uint8_t client_buffer[TCP_MSS];
+
+/* Count the data segments from the sender that do not go beyond the data already sent */
+static void count_retransmit(struct pbuf *p) {
+  uint8_t headers[IP_HEADER_SIZE + TCP_HEADER_SIZE];
+  if (pbuf_copy_partial(p, headers, sizeof(headers), 0) != sizeof(headers) || headers[9] != IP_PROTOCOL_TCP) {
+    return;
+  }
+  uint32_t ip_length = (uint32_t)((headers[2] << 8) | headers[3]);
+  uint32_t header_length = (uint32_t)(headers[0] & 0x0F) * 4 + (uint32_t)(headers[IP_HEADER_SIZE + 12] >> 4) * 4;
+  if (ip_length <= header_length) {
+    return;
+  }
+  const uint8_t *seq = &headers[IP_HEADER_SIZE + 4];
+  uint32_t seq_end = (((uint32_t)seq[0] << 24) | ((uint32_t)seq[1] << 16) | ((uint32_t)seq[2] << 8) | seq[3]) +
+                     ip_length - header_length;
+  if (sent_any && !impair_before(sent_seq_end, seq_end)) {
+    retransmits++;
+  } else {
+    sent_seq_end = seq_end;
+    sent_any = 1;
+  }
+}
+
+__attribute__((fptrgroup("netif_output_fn")))
+static err_t link_output(struct netif *n, struct pbuf *p, const ip4_addr_t *ipaddr) {
+  (void)ipaddr;
+  if (n == &netif_sender) {
+    count_retransmit(p);
+  }
+  impair_send(&links[n == &netif_sender ? 0 : 1], p, now);
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t bench_netif_init(struct netif *n) {
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST;
+  n->output = link_output;
+  return ERR_OK;
+}
+
+static void add_netif(struct netif *n, uint8_t subnet) {
+  ip4_addr_t ipaddr, netmask, gw;
+  IP4_ADDR(&ipaddr, 10, 0, subnet, 1);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gw, 10, 0, subnet, 254);
+  netif_add(n, &ipaddr, &netmask, &gw, NULL, bench_netif_init, ip4_input);
+  netif_set_up(n);
+  netif_set_link_up(n);
+}
+
+/* Move on to the next frame arrival or timer, no later than the limit */
+static void advance(uint32_t *next_timer, uint32_t limit) {
+  uint32_t next = impair_before(*next_timer, limit) ? *next_timer : limit;
+  now = impair_next_arrival(&links[1], impair_next_arrival(&links[0], next));
+  impair_deliver(&links[0], now);
+  impair_deliver(&links[1], now);
+  if (!impair_before(now, *next_timer)) {
+    tcp_tmr();
+    *next_timer += TCP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+  }
+}
+
+/* Transfer the data over a link with the impairments given, reporting the results as benchmark name */
+static void run_scenario(const char *name, const char *spec, uint16_t port) {
+  uint32_t failures = 0;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  uint32_t sent_events = 0;
+  uint32_t resend_events = 0;
+  int32_t receiver_id = -1;
+  int connected = 0;
+  int can_send = 0;
+
+  impair_config_t config = {
+    .rate_kbps = BENCH_LINK_MBPS * 1000,
+    .delay_us = BENCH_RTT_US / 2,
+  };
+  if (impair_parse(&config, spec) != 0) {
+    printf("Bad impairments for %s: %s\n", name, spec);
+    bench_report(name, "failures", 1);
+    return;
+  }
+  impair_init(&links[0], &config, &netif_receiver, 0x1234567 + port);
+  impair_init(&links[1], &config, &netif_sender, 0x7654321 + port);
+  sent_any = 0;
+  retransmits = 0;
+
+  xtcp_ipaddr_t receiver_addr = {10, 0, 2, 1};
+  xtcp_error_int32_t listener = shim_new_socket(RECEIVER, XTCP_PROTOCOL_TCP);
+  xtcp_error_int32_t sender = shim_new_socket(SENDER, XTCP_PROTOCOL_TCP);
+  if (listener.status != XTCP_SUCCESS || sender.status != XTCP_SUCCESS) {
+    bench_report(name, "failures", 1);
+    return;
+  }
+  tcp_bind_netif(get_tcp_pcb(listener.value), &netif_receiver);
+  failures += shim_listen(RECEIVER, listener.value, port, receiver_addr) != XTCP_SUCCESS;
+  tcp_bind_netif(get_tcp_pcb(sender.value), &netif_sender);
+  failures += shim_connect(SENDER, sender.value, port, receiver_addr) != XTCP_SUCCESS;
+
+  uint32_t start = now;
+  uint32_t next_timer = now + TCP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+
+  while (received < BENCH_BYTES && !failures) {
+    client_event_t event;
+    while ((event = dequeue_event(RECEIVER)).xtcp_event != XTCP_EVENT_NONE) {
+      if (event.xtcp_event == XTCP_ACCEPTED) {
+        receiver_id = event.id;
+        tcp_bind_netif(get_tcp_pcb(receiver_id), &netif_receiver);
+      } else if (event.xtcp_event == XTCP_RECV_DATA && event.id == receiver_id) {
+        uint8_t *data = NULL;
+        xtcp_error_int32_t length = get_remote_data(receiver_id, &data, sizeof(client_buffer), NULL);
+        if (length.status == XTCP_SUCCESS) {
+          memcpy(client_buffer, data, (size_t)length.value);
+          // Loss, reordering and duplication must never reach the client
+          failures += client_buffer[0] != (uint8_t)received;
+          received += (uint32_t)length.value;
+          failures += client_buffer[length.value - 1] != (uint8_t)(received - 1);
+        }
+        (void)free_remote_data(receiver_id);
+      } else if (event.xtcp_event == XTCP_ABORTED || event.xtcp_event == XTCP_TIMED_OUT) {
+        failures++;
+      }
+    }
+
+    while ((event = dequeue_event(SENDER)).xtcp_event != XTCP_EVENT_NONE) {
+      if (event.xtcp_event == XTCP_NEW_CONNECTION || event.xtcp_event == XTCP_SENT_DATA) {
+        sent_events += event.xtcp_event == XTCP_SENT_DATA;
+        connected = 1;
+        can_send = 1;
+      } else if (event.xtcp_event == XTCP_RESEND_DATA) {
+        resend_events++;
+      } else if (event.xtcp_event == XTCP_ABORTED || event.xtcp_event == XTCP_TIMED_OUT) {
+        failures++;
+      }
+    }
+
+    while (connected && can_send && sent < BENCH_BYTES) {
+      uint32_t length = BENCH_BYTES - sent < BENCH_SEND_LENGTH ? BENCH_BYTES - sent : BENCH_SEND_LENGTH;
+      void *token = pbuf_shim_alloc_tx(length, 0);
+      if (token == NULL) {
+        can_send = 0;
+        break;
+      }
+      memcpy(pbuf_shim_token_payload(token), &pattern[sent & 0xFF], length);
+      if (shim_send(SENDER, sender.value, token) != XTCP_SUCCESS) {
+        can_send = 0;
+      } else {
+        sent += length;
+      }
+    }
+
+    advance(&next_timer, next_timer);
+    if (!impair_before(now - start, BENCH_LIMIT_TICKS)) {
+      failures++;
+    }
+  }
+  uint32_t link_us = (now - start) / BENCH_TICKS_PER_US;
+
+  // Close both ends and let the connection finish closing before the next scenario
+  shim_close_socket(SENDER, sender.value);
+  if (receiver_id >= 0) {
+    shim_close_socket(RECEIVER, receiver_id);
+  }
+  shim_close_socket(RECEIVER, listener.value);
+  uint32_t closed = now + BENCH_CLOSE_TICKS;
+  while (impair_before(now, closed)) {
+    advance(&next_timer, closed);
+    while (dequeue_event(RECEIVER).xtcp_event != XTCP_EVENT_NONE) {
+    }
+    while (dequeue_event(SENDER).xtcp_event != XTCP_EVENT_NONE) {
+    }
+  }
+
+  const impair_stats_t *data = &links[0].stats;
+  const impair_stats_t *acks = &links[1].stats;
+  bench_report(name, "kbits_per_second", link_us ? (int32_t)(((uint64_t)received * 8 * 1000) / link_us) : 0);
+  bench_report(name, "retransmits", (int32_t)retransmits);
+  bench_report(name, "sent_data_events", (int32_t)sent_events);
+  bench_report(name, "resend_data_events", (int32_t)resend_events);
+  bench_report(name, "frames_lost", (int32_t)(data->lost + acks->lost));
+  bench_report(name, "frames_duplicated", (int32_t)(data->duplicated + acks->duplicated));
+  bench_report(name, "frames_reordered", (int32_t)(data->reordered + acks->reordered));
+  bench_report(name, "queue_drops", (int32_t)(data->queue_drops + acks->queue_drops));
+  bench_report(name, "pool_drops", (int32_t)(data->pool_drops + acks->pool_drops));
+  bench_report(name, "failures", (int32_t)failures);
+}
+
+int main(int argc, char *argv[]) {
+  for (uint32_t i = 0; i < sizeof(pattern); ++i) {
+    pattern[i] = (uint8_t)i;
+  }
+
+  lwip_init();
+  add_netif(&netif_sender, 1);
+  add_netif(&netif_receiver, 2);
+  netif_set_default(&netif_sender);
+  init_client_connections();
+  xtcp_init_queue();
+  tx_pool_init();
+
+  uint32_t scenarios = argc > 1 ? (uint32_t)(argc - 1) : sizeof(default_scenarios) / sizeof(default_scenarios[0]);
+  for (uint32_t i = 0; i < scenarios; ++i) {
+    const char *scenario = argc > 1 ? argv[i + 1] : default_scenarios[i];
+    const char *colon = strchr(scenario, ':');
+    char name[32] = "impair_";
+    size_t name_length = colon ? (size_t)(colon - scenario) : strlen(scenario);
+    if (name_length > sizeof(name) - 8) {
+      name_length = sizeof(name) - 8;
+    }
+    strncat(name, scenario, name_length);
+    run_scenario(name, colon ? colon + 1 : "", (uint16_t)(PORT + i));
+  }
+  return 0;
+}
@@ -0,0 +1,193 @@
+# Copyright 2025 XMOS LIMITED.
+# This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+import argparse
+import struct
+from pathlib import Path
+
+# Writes the synthetic trace replayed by bench_replay, as a capture of a DUT taken with start_capture() would be: a
+# pcap file with nanosecond timestamps holding the frames in both directions. A host resolves the DUT by ARP, pings it,
+# uploads over TCP at the link rate within the DUT's receive window, closes the connection and sends a burst of UDP
+# datagrams. The DUT's frames are only used by the replay to learn the sequence numbers it chose. The benchmark run
+# writes the trace before building, so the output is not checked in.
+#
+#   python make_trace.py --output traces/tcp_upload.pcap
+
+DUT_MAC = bytes([0x00, 0x22, 0x97, 0x00, 0x00, 0x01])
+HOST_MAC = bytes([0x02, 0x00, 0x00, 0x00, 0x00, 0x02])
+BROADCAST_MAC = b'\xff' * 6
+DUT_IP = bytes([192, 168, 200, 198])
+HOST_IP = bytes([192, 168, 200, 1])
+
+TCP_PORT = 15533
+UDP_PORT = 15534
+HOST_PORT = 40000
+HOST_ISN = 0x20000000
+DUT_ISN = 0x00001000
+
+# Ethernet header, FCS, preamble and inter-frame gap
+ETH_OVERHEAD_BYTES = 38
+LINK_NS_PER_BYTE = 80  # 100Mb/s
+
+FIN, SYN, RST, PSH, ACK = 0x01, 0x02, 0x04, 0x08, 0x10
+
+
+def checksum(data):
+    if len(data) % 2:
+        data += b'\0'
+    total = sum(struct.unpack(f'!{len(data) // 2}H', data))
+    while total >> 16:
+        total = (total & 0xFFFF) + (total >> 16)
+    return ~total & 0xFFFF
+
+
+class Ipv4:
+    def __init__(self):
+        self.ident = {DUT_IP: 0x100, HOST_IP: 0x4000}
+
+    def packet(self, src, dst, protocol, payload):
+        self.ident[src] = (self.ident[src] + 1) & 0xFFFF
+        header = struct.pack('!BBHHHBBH4s4s', 0x45, 0, 20 + len(payload), self.ident[src], 0x4000, 64, protocol, 0,
+                             src, dst)
+        header = header[:10] + struct.pack('!H', checksum(header)) + header[12:]
+        return header + payload
+
+
+def ethernet(dst, src, ethertype, payload):
+    frame = dst + src + struct.pack('!H', ethertype) + payload
+    return frame + b'\0' * max(0, 60 - len(frame))
+
+
+def tcp(src_ip, dst_ip, src_port, dst_port, seq, ack, flags, window, payload=b'', mss=None):
+    options = struct.pack('!BBH', 2, 4, mss) if mss else b''
+    offset = (20 + len(options)) // 4
+    header = struct.pack('!HHIIBBHHH', src_port, dst_port, seq & 0xFFFFFFFF, ack & 0xFFFFFFFF, offset << 4, flags,
+                         window, 0, 0) + options
+    segment = header + payload
+    pseudo = src_ip + dst_ip + struct.pack('!BBH', 0, 6, len(segment))
+    return segment[:16] + struct.pack('!H', checksum(pseudo + segment)) + segment[18:]
+
+
+def udp(src_ip, dst_ip, src_port, dst_port, payload):
+    datagram = struct.pack('!HHHH', src_port, dst_port, 8 + len(payload), 0) + payload
+    pseudo = src_ip + dst_ip + struct.pack('!BBH', 0, 17, len(datagram))
+    return datagram[:6] + struct.pack('!H', checksum(pseudo + datagram) or 0xFFFF) + datagram[8:]
+
+
+def icmp_echo(icmp_type, ident, seq, payload):
+    message = struct.pack('!BBHHH', icmp_type, 0, 0, ident, seq) + payload
+    return message[:2] + struct.pack('!H', checksum(message)) + message[4:]
+
+
+def arp(op, sender_mac, sender_ip, target_mac, target_ip):
+    return struct.pack('!HHBBH6s4s6s4s', 1, 0x0800, 6, 4, op, sender_mac, sender_ip, target_mac, target_ip)
+
+
+class Trace:
+    def __init__(self):
+        self.frames = []
+        self.ip = Ipv4()
+
+    def add(self, time_ns, frame):
+        self.frames.append((time_ns, frame))
+
+    def host(self, time_ns, protocol, payload):
+        self.add(time_ns, ethernet(DUT_MAC, HOST_MAC, 0x0800, self.ip.packet(HOST_IP, DUT_IP, protocol, payload)))
+
+    def dut(self, time_ns, protocol, payload):
+        self.add(time_ns, ethernet(HOST_MAC, DUT_MAC, 0x0800, self.ip.packet(DUT_IP, HOST_IP, protocol, payload)))
+
+    def write(self, path):
+        Path(path).parent.mkdir(parents=True, exist_ok=True)
+        with open(path, 'wb') as f:
+            f.write(struct.pack('<IHHiIII', 0xA1B23C4D, 2, 4, 0, 0, 65535, 1))
+            for time_ns, frame in sorted(self.frames, key=lambda entry: entry[0]):
+                f.write(struct.pack('<IIII', time_ns // 1000000000, time_ns % 1000000000, len(frame), len(frame)))
+                f.write(frame)
+
+
+def wire_ns(length):
+    return (length + ETH_OVERHEAD_BYTES) * LINK_NS_PER_BYTE
+
+
+def upload(trace, start, total, mss, window, ack_delay):
+    """A host sending total bytes as fast as the link and the DUT's window allow, the DUT acking every second
+    segment. Returns the time the transfer ends."""
+    t = start
+    trace.host(t, 6, tcp(HOST_IP, DUT_IP, HOST_PORT, TCP_PORT, HOST_ISN, 0, SYN, 65535, mss=1460))
+    t += 30000
+    trace.dut(t, 6, tcp(DUT_IP, HOST_IP, TCP_PORT, HOST_PORT, DUT_ISN, HOST_ISN + 1, SYN | ACK, window, mss=mss))
+    t += 30000
+    trace.host(t, 6, tcp(HOST_IP, DUT_IP, HOST_PORT, TCP_PORT, HOST_ISN + 1, DUT_ISN + 1, ACK, 65535))
+
+    sent = 0
+    acked = 0
+    acks = []  # (time, bytes acknowledged) of the DUT's acknowledgements still to arrive at the host
+    segments = 0
+    link_free = t
+    while acked < total:
+        while acks and acks[0][0] <= link_free:
+            acked = max(acked, acks.pop(0)[1])
+        if sent < total and sent - acked < window:
+            length = min(mss, total - sent, window - (sent - acked))
+            t = link_free
+            payload = bytes((sent + i) & 0xFF for i in range(length))
+            trace.host(t, 6, tcp(HOST_IP, DUT_IP, HOST_PORT, TCP_PORT, HOST_ISN + 1 + sent, DUT_ISN + 1, PSH | ACK,
+                                 65535, payload))
+            link_free = t + wire_ns(54 + length)
+            sent += length
+            segments += 1
+            if segments % 2 == 0 or sent == total:
+                ack_time = link_free + ack_delay
+                trace.dut(ack_time, 6, tcp(DUT_IP, HOST_IP, TCP_PORT, HOST_PORT, DUT_ISN + 1, HOST_ISN + 1 + sent,
+                                           ACK, window))
+                acks.append((ack_time + wire_ns(54), sent))
+        elif acks:
+            link_free = max(link_free, acks[0][0])
+        else:
+            break
+
+    # The host closes, the DUT's client closes once it sees the connection closed
+    t = link_free + 100000
+    trace.host(t, 6, tcp(HOST_IP, DUT_IP, HOST_PORT, TCP_PORT, HOST_ISN + 1 + sent, DUT_ISN + 1, FIN | ACK, 65535))
+    t += 30000
+    trace.dut(t, 6, tcp(DUT_IP, HOST_IP, TCP_PORT, HOST_PORT, DUT_ISN + 1, HOST_ISN + 2 + sent, FIN | ACK, window))
+    t += 30000
+    trace.host(t, 6, tcp(HOST_IP, DUT_IP, HOST_PORT, TCP_PORT, HOST_ISN + 2 + sent, DUT_ISN + 2, ACK, 65535))
+    return t
+
+
+def make_trace(total, mss, window, datagrams, ack_delay):
+    trace = Trace()
+    t = 0
+    trace.add(t, ethernet(BROADCAST_MAC, HOST_MAC, 0x0806, arp(1, HOST_MAC, HOST_IP, b'\0' * 6, DUT_IP)))
+    t += 20000
+    trace.add(t, ethernet(HOST_MAC, DUT_MAC, 0x0806, arp(2, DUT_MAC, DUT_IP, HOST_MAC, HOST_IP)))
+
+    for seq in range(4):
+        t += 1000000
+        payload = bytes(range(56))
+        trace.host(t, 1, icmp_echo(8, 0x1234, seq, payload))
+        trace.dut(t + 40000, 1, icmp_echo(0, 0x1234, seq, payload))
+
+    t = upload(trace, t + 1000000, total, mss, window, ack_delay)
+
+    t += 1000000
+    for seq in range(datagrams):
+        payload = bytes((seq + i) & 0xFF for i in range(512))
+        trace.host(t, 17, udp(HOST_IP, DUT_IP, HOST_PORT + 1, UDP_PORT, payload))
+        t += 200000
+    return trace
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Write the synthetic trace replayed by bench_replay')
+    parser.add_argument('--output', type=str, default='traces/tcp_upload.pcap', help="pcap file to write")
+    parser.add_argument('--bytes', type=int, default=65536, help="Bytes uploaded over TCP")
+    parser.add_argument('--mss', type=int, default=1460, help="Segment size of the upload")
+    parser.add_argument('--window', type=int, default=4 * 1460, help="Receive window the DUT advertises")
+    parser.add_argument('--datagrams', type=int, default=64, help="UDP datagrams sent after the upload")
+    parser.add_argument('--ack-delay', type=int, default=20000, help="Time the DUT takes to acknowledge, in ns")
+    args = parser.parse_args()
+
+    make_trace(args.bytes, args.mss, args.window, args.datagrams, args.ack_delay).write(args.output)
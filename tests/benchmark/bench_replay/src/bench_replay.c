@@ -0,0 +1,484 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Replays a recorded pcap trace through the stack, for regression testing the receive path without a board or a
+ * host. The frames sent to the DUT are passed through the receive filter and copied into PBUF_POOL pbufs as the
+ * Ethernet receive path does, at the times recorded scaled by BENCH_REPLAY_RATE_PERCENT. Time is virtual, so each run
+ * of a trace is the same. A scripted client listens and binds as the application did and reads everything it is
+ * given through the calls behind xtcp_if.
+ *
+ * The stack chooses its own initial sequence numbers, so the acknowledgement numbers of the host's TCP segments are
+ * moved by the difference between the DUT's SYN recorded in the trace and the stack's SYN. Remote hosts are given
+ * static ARP entries as they are first seen, so replies are never held for an ARP round trip the trace cannot answer.
+ *
+ * Reports the rates of frames and client data in virtual time, the core time per frame, the frames dropped by the
+ * filter and for lack of pbufs, the resets sent, and for each event type the time from the frame being input to the
+ * client taking the event. Traces are captured with start_capture() or tcpdump, or made by bench_replay/make_trace.py
+ * and read from the host's file system through the simulator. */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "rx_filter.h"
+#include "static_arp.h"
+#include "tx_pool.h"
+
+/* LwIP headers */
+#include "lwip/etharp.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/tcp.h"
+#include "netif/ethernet.h"
+
+/* The trace, relative to the directory the simulator is run from */
+#ifndef BENCH_TRACE
+#define BENCH_TRACE "bench_replay/traces/tcp_upload.pcap"
+#endif
+
+/* Rate the trace is replayed at, 200 replays it in half the recorded time */
+#ifndef BENCH_REPLAY_RATE_PERCENT
+#define BENCH_REPLAY_RATE_PERCENT 100
+#endif
+
+/* The DUT in the trace, frames from its MAC address were sent by it */
+#ifndef BENCH_DUT_MAC
+#define BENCH_DUT_MAC {0x00, 0x22, 0x97, 0x00, 0x00, 0x01}
+#endif
+
+#ifndef BENCH_DUT_IP
+#define BENCH_DUT_IP {192, 168, 200, 198}
+#endif
+
+#define CLIENT 0
+#define MAX_FLOWS 16
+#define MAX_HOSTS 16
+#define MAX_SOCKETS 8
+#define NUM_EVENT_TYPES (XTCP_SENT_STATIC + 1)
+#define MAX_FRAME_SIZE 1518
+
+#define PCAP_MAGIC_MICROSECONDS 0xA1B2C3D4u
+#define PCAP_MAGIC_NANOSECONDS 0xA1B23C4Du
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_HEADER_LENGTH 24
+#define PCAP_RECORD_HEADER_LENGTH 16
+
+#define ETH_HEADER_SIZE 14
+#define IP_HEADER_SIZE 20
+#define TCP_SEQ_OFFSET 4
+#define TCP_ACK_OFFSET 8
+#define TCP_FLAGS_OFFSET 13
+#define TCP_CHKSUM_OFFSET 16
+#define TCP_FLAG_RST 0x04
+#define TCP_FLAG_SYN 0x02
+#define TCP_FLAG_ACK 0x10
+#define IP_PROTOCOL_TCP 6
+
+/* What the scripted client does, and when in the trace it does it */
+typedef enum replay_action_t {
+  LISTEN_TCP,
+  BIND_UDP,
+  CLOSE_PORT,
+} replay_action_t;
+
+typedef struct replay_step_t {
+  uint32_t at_us;
+  replay_action_t action;
+  uint16_t port;
+} replay_step_t;
+
+/* The application the trace was captured from, as it set up its sockets */
+static const replay_step_t script[] = {
+  {0, LISTEN_TCP, 15533},
+  {0, BIND_UDP, 15534},
+};
+
+#define SCRIPT_STEPS (sizeof(script) / sizeof(script[0]))
+
+/* A TCP connection of the DUT, with the DUT's initial sequence number in the trace and as chosen by the stack */
+typedef struct flow_t {
+  uint8_t remote_ip[4];
+  uint16_t remote_port;
+  uint16_t local_port;
+  uint32_t trace_isn;
+  uint32_t stack_isn;
+  int have_trace;
+  int have_stack;
+} flow_t;
+
+typedef struct event_latency_t {
+  uint32_t count;
+  uint64_t ticks;
+  uint32_t max_ticks;
+} event_latency_t;
+
+static const char *const event_names[NUM_EVENT_TYPES] = {
+  "none", "new_connection", "accepted", "recv_data", "recv_from_data", "sent_data", "resend_data", "timed_out",
+  "aborted", "closed", "ifup", "ifdown", "dns_result", "sent_static",
+};
+
+static const uint8_t dut_mac[ETH_HWADDR_LEN] = BENCH_DUT_MAC;
+static const uint8_t dut_ip[4] = BENCH_DUT_IP;
+
+static struct netif netif;
+static flow_t flows[MAX_FLOWS];
+static uint32_t num_flows;
+static uint8_t hosts[MAX_HOSTS][4];
+static uint32_t num_hosts;
+static struct {
+  uint16_t port;
+  int32_t id;
+} sockets[MAX_SOCKETS];
+static uint32_t num_sockets;
+
+static event_latency_t latency[NUM_EVENT_TYPES];
+static uint8_t frame[MAX_FRAME_SIZE];
+static uint8_t client_buffer[MAX_FRAME_SIZE];
+
+static uint32_t tx_frames;
+static uint32_t tx_resets;
+static uint32_t filter_drops;
+static uint32_t pool_drops;
+static uint32_t unmapped_acks;
+static uint32_t client_bytes;
+static uint32_t failures;
+
+static uint16_t load16_be(const uint8_t *p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+static uint32_t load32_be(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void store32_be(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value >> 24);
+  p[1] = (uint8_t)(value >> 16);
+  p[2] = (uint8_t)(value >> 8);
+  p[3] = (uint8_t)value;
+}
+
+static uint32_t load32(const uint8_t *p, int swapped) {
+  return swapped ? load32_be(p) : ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+/* The TCP header of an IPv4 frame, or NULL for any other frame */
+static uint8_t *tcp_header(uint8_t *eth, uint32_t len) {
+  if (len < ETH_HEADER_SIZE + IP_HEADER_SIZE + 20 || load16_be(&eth[12]) != ETHTYPE_IP) {
+    return NULL;
+  }
+  uint8_t *ip = &eth[ETH_HEADER_SIZE];
+  uint32_t header_len = (uint32_t)(ip[0] & 0x0F) * 4;
+  if (ip[9] != IP_PROTOCOL_TCP || ETH_HEADER_SIZE + header_len + 20 > len) {
+    return NULL;
+  }
+  return &ip[header_len];
+}
+
+/* The flow of a TCP segment, from the address and ports of the remote end */
+static flow_t *find_flow(const uint8_t remote_ip[4], uint16_t remote_port, uint16_t local_port, int add) {
+  for (uint32_t i = 0; i < num_flows; ++i) {
+    flow_t *flow = &flows[i];
+    if (!memcmp(flow->remote_ip, remote_ip, 4) && flow->remote_port == remote_port && flow->local_port == local_port) {
+      return flow;
+    }
+  }
+  if (!add || num_flows == MAX_FLOWS) {
+    return NULL;
+  }
+  flow_t *flow = &flows[num_flows++];
+  memset(flow, 0, sizeof(*flow));
+  memcpy(flow->remote_ip, remote_ip, 4);
+  flow->remote_port = remote_port;
+  flow->local_port = local_port;
+  return flow;
+}
+
+/* Learn a DUT initial sequence number from a SYN sent by the DUT, in the trace or by the stack */
+static void learn_isn(uint8_t *eth, uint32_t len, int from_stack) {
+  uint8_t *tcp = tcp_header(eth, len);
+  if (tcp == NULL || !(tcp[TCP_FLAGS_OFFSET] & TCP_FLAG_SYN)) {
+    return;
+  }
+  const uint8_t *ip = &eth[ETH_HEADER_SIZE];
+  flow_t *flow = find_flow(&ip[16], load16_be(&tcp[2]), load16_be(&tcp[0]), 1);
+  if (flow == NULL) {
+    return;
+  }
+  if (from_stack) {
+    flow->stack_isn = load32_be(&tcp[TCP_SEQ_OFFSET]);
+    flow->have_stack = 1;
+  } else {
+    flow->trace_isn = load32_be(&tcp[TCP_SEQ_OFFSET]);
+    flow->have_trace = 1;
+  }
+}
+
+/* Move the acknowledgement number of a segment from the host to the DUT onto the stack's sequence numbers */
+static void map_ack(uint8_t *eth, uint32_t len) {
+  uint8_t *tcp = tcp_header(eth, len);
+  if (tcp == NULL || !(tcp[TCP_FLAGS_OFFSET] & TCP_FLAG_ACK)) {
+    return;
+  }
+  const uint8_t *ip = &eth[ETH_HEADER_SIZE];
+  flow_t *flow = find_flow(&ip[12], load16_be(&tcp[0]), load16_be(&tcp[2]), 0);
+  if (flow == NULL || !flow->have_trace || !flow->have_stack) {
+    unmapped_acks++;
+    return;
+  }
+
+  // Update the checksum for the changed field as RFC 1624 does
+  uint32_t old_ack = load32_be(&tcp[TCP_ACK_OFFSET]);
+  uint32_t new_ack = old_ack + (flow->stack_isn - flow->trace_isn);
+  uint32_t sum = (uint16_t)~load16_be(&tcp[TCP_CHKSUM_OFFSET]);
+  sum += (uint16_t)~(old_ack >> 16) + (uint16_t)~old_ack + (new_ack >> 16) + (new_ack & 0xFFFF);
+  while (sum >> 16) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  store32_be(&tcp[TCP_ACK_OFFSET], new_ack);
+  tcp[TCP_CHKSUM_OFFSET] = (uint8_t)(~sum >> 8);
+  tcp[TCP_CHKSUM_OFFSET + 1] = (uint8_t)~sum;
+}
+
+/* Give a remote host a static ARP entry the first time it sends an IPv4 frame */
+static void learn_host(const uint8_t *eth, uint32_t len) {
+  if (len < ETH_HEADER_SIZE + IP_HEADER_SIZE || load16_be(&eth[12]) != ETHTYPE_IP || (eth[6] & 0x01)) {
+    return;
+  }
+  const uint8_t *src_ip = &eth[ETH_HEADER_SIZE + 12];
+  for (uint32_t i = 0; i < num_hosts; ++i) {
+    if (!memcmp(hosts[i], src_ip, 4)) {
+      return;
+    }
+  }
+  if (num_hosts < MAX_HOSTS && static_arp_add(src_ip, &eth[6]) == XTCP_SUCCESS) {
+    memcpy(hosts[num_hosts++], src_ip, 4);
+  }
+}
+
+/* Frames sent by the stack are counted rather than sent */
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t replay_linkoutput(struct netif *n, struct pbuf *p) {
+  (void)n;
+  uint8_t headers[ETH_HEADER_SIZE + 60 + 20];
+  uint16_t len = pbuf_copy_partial(p, headers, sizeof(headers), 0);
+  uint8_t *tcp = tcp_header(headers, len);
+
+  tx_frames++;
+  if (tcp != NULL && (tcp[TCP_FLAGS_OFFSET] & TCP_FLAG_RST)) {
+    tx_resets++;
+  }
+  learn_isn(headers, len, 1);
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t replay_netif_init(struct netif *n) {
+  n->hwaddr_len = ETH_HWADDR_LEN;
+  memcpy(n->hwaddr, dut_mac, ETH_HWADDR_LEN);
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+  n->output = etharp_output;
+  n->linkoutput = replay_linkoutput;
+  return ERR_OK;
+}
+
+static void run_step(const replay_step_t *step) {
+  xtcp_ipaddr_t any_addr = {0, 0, 0, 0};
+
+  if (step->action == CLOSE_PORT) {
+    for (uint32_t i = 0; i < num_sockets; ++i) {
+      if (sockets[i].port == step->port) {
+        shim_close_socket(CLIENT, sockets[i].id);
+        sockets[i] = sockets[--num_sockets];
+        return;
+      }
+    }
+    return;
+  }
+
+  xtcp_error_int32_t id = shim_new_socket(CLIENT, step->action == LISTEN_TCP ? XTCP_PROTOCOL_TCP : XTCP_PROTOCOL_UDP);
+  if (id.status != XTCP_SUCCESS || shim_listen(CLIENT, id.value, step->port, any_addr) != XTCP_SUCCESS ||
+      num_sockets == MAX_SOCKETS) {
+    failures++;
+    return;
+  }
+  sockets[num_sockets].port = step->port;
+  sockets[num_sockets].id = id.value;
+  num_sockets++;
+}
+
+/* Take the client's events as its task would, reading all data it is given */
+static void run_client(uint32_t input_time) {
+  client_event_t event;
+  while ((event = dequeue_event(CLIENT)).xtcp_event != XTCP_EVENT_NONE) {
+    uint32_t ticks = bench_time() - input_time;
+    event_latency_t *l = &latency[event.xtcp_event < NUM_EVENT_TYPES ? event.xtcp_event : XTCP_EVENT_NONE];
+    l->count++;
+    l->ticks += ticks;
+    l->max_ticks = ticks > l->max_ticks ? ticks : l->max_ticks;
+
+    if (event.xtcp_event == XTCP_RECV_DATA || event.xtcp_event == XTCP_RECV_FROM_DATA) {
+      uint8_t *data = NULL;
+      xtcp_error_int32_t length = get_remote_data(event.id, &data, sizeof(client_buffer), NULL);
+      if (length.status == XTCP_SUCCESS) {
+        memcpy(client_buffer, data, (size_t)length.value);
+        client_bytes += (uint32_t)length.value;
+      }
+      (void)free_remote_data(event.id);
+    } else if (event.xtcp_event == XTCP_CLOSED) {
+      shim_close_socket(CLIENT, event.id);
+    }
+  }
+}
+
+/* Input a frame from the trace as the Ethernet receive path does, returning the core time taken */
+static uint32_t input_frame(uint32_t len, uint32_t timestamp) {
+  uint32_t start = bench_time();
+  if (!rx_filter_accept(frame, len, timestamp)) {
+    filter_drops++;
+  } else {
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)len, PBUF_POOL);
+    if (p == NULL) {
+      pool_drops++;
+    } else {
+      pbuf_take(p, frame, (u16_t)len);
+      if (netif.input(p, &netif) != ERR_OK) {
+        pbuf_free(p);
+      }
+    }
+  }
+  uint32_t ticks = bench_time() - start;
+  run_client(start);
+  return ticks;
+}
+
+static void report_latency(void) {
+  char metric[48];
+  for (uint32_t i = 0; i < NUM_EVENT_TYPES; ++i) {
+    const event_latency_t *l = &latency[i];
+    if (l->count == 0) {
+      continue;
+    }
+    snprintf(metric, sizeof(metric), "%s_events", event_names[i]);
+    bench_report("replay", metric, (int32_t)l->count);
+    snprintf(metric, sizeof(metric), "%s_latency_ns_mean", event_names[i]);
+    bench_report("replay", metric, (int32_t)((l->ticks * (1000 / BENCH_TICKS_PER_US)) / l->count));
+    snprintf(metric, sizeof(metric), "%s_latency_ns_max", event_names[i]);
+    bench_report("replay", metric, (int32_t)(l->max_ticks * (1000 / BENCH_TICKS_PER_US)));
+  }
+}
+
+int main(void) {
+  ip4_addr_t ipaddr, netmask, gw;
+  IP4_ADDR(&ipaddr, dut_ip[0], dut_ip[1], dut_ip[2], dut_ip[3]);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gw, dut_ip[0], dut_ip[1], dut_ip[2], 1);
+
+  lwip_init();
+  netif_add(&netif, &ipaddr, &netmask, &gw, NULL, replay_netif_init, ethernet_input);
+  netif_set_default(&netif);
+  netif_set_up(&netif);
+  netif_set_link_up(&netif);
+  init_client_connections();
+  xtcp_init_queue();
+  tx_pool_init();
+  rx_filter_init();
+  static_arp_init();
+
+  FILE *trace = fopen(BENCH_TRACE, "rb");
+  uint8_t header[PCAP_HEADER_LENGTH];
+  if (trace == NULL || fread(header, 1, sizeof(header), trace) != sizeof(header)) {
+    printf("Cannot read %s\n", BENCH_TRACE);
+    bench_report("replay", "failures", 1);
+    return 0;
+  }
+  uint32_t magic = load32(header, 0);
+  int swapped = (magic != PCAP_MAGIC_MICROSECONDS && magic != PCAP_MAGIC_NANOSECONDS);
+  magic = load32(header, swapped);
+  uint32_t ns_per_unit = (magic == PCAP_MAGIC_NANOSECONDS) ? 1 : 1000;
+  if ((magic != PCAP_MAGIC_MICROSECONDS && magic != PCAP_MAGIC_NANOSECONDS) ||
+      load32(&header[20], swapped) != PCAP_LINKTYPE_ETHERNET) {
+    printf("%s is not a pcap file of Ethernet frames\n", BENCH_TRACE);
+    bench_report("replay", "failures", 1);
+    return 0;
+  }
+
+  uint64_t first_ns = 0;
+  uint64_t now = 0;  // Virtual time since the start of the trace, in reference clock ticks
+  uint64_t next_tcp_timer = TCP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+  uint64_t next_arp_timer = ARP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+  uint32_t next_step = 0;
+  uint32_t records = 0;
+  uint32_t frames = 0;
+  uint64_t cpu_ticks = 0;
+  uint8_t record[PCAP_RECORD_HEADER_LENGTH];
+
+  while (fread(record, 1, sizeof(record), trace) == sizeof(record)) {
+    uint32_t incl_len = load32(&record[8], swapped);
+    if (incl_len > sizeof(frame) || fread(frame, 1, incl_len, trace) != incl_len) {
+      printf("Record %lu of %s is truncated or too long\n", (unsigned long)records, BENCH_TRACE);
+      failures++;
+      break;
+    }
+    uint64_t ns = (uint64_t)load32(&record[0], swapped) * 1000000000u +
+                  (uint64_t)load32(&record[4], swapped) * ns_per_unit;
+    if (records++ == 0) {
+      first_ns = ns;
+    }
+    uint64_t frame_time = ((ns - first_ns) * BENCH_TICKS_PER_US * 100) / (1000 * BENCH_REPLAY_RATE_PERCENT);
+    if (frame_time > now) {
+      now = frame_time;
+    }
+
+    // Timers and script steps due before the frame
+    while (next_tcp_timer <= now || next_arp_timer <= now) {
+      if (next_tcp_timer <= next_arp_timer) {
+        tcp_tmr();
+        next_tcp_timer += TCP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+      } else {
+        etharp_tmr();
+        next_arp_timer += ARP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+      }
+    }
+    while (next_step < SCRIPT_STEPS && (uint64_t)script[next_step].at_us * BENCH_TICKS_PER_US <= now) {
+      run_step(&script[next_step++]);
+    }
+    run_client(bench_time());
+
+    if (incl_len < ETH_HEADER_SIZE) {
+      continue;
+    }
+    if (!memcmp(&frame[6], dut_mac, ETH_HWADDR_LEN)) {
+      learn_isn(frame, incl_len, 0);
+    } else if (!memcmp(&frame[0], dut_mac, ETH_HWADDR_LEN) || (frame[0] & 0x01)) {
+      learn_host(frame, incl_len);
+      map_ack(frame, incl_len);
+      cpu_ticks += input_frame(incl_len, (uint32_t)now);
+      frames++;
+    }
+  }
+  fclose(trace);
+
+  uint64_t trace_us = now / BENCH_TICKS_PER_US;
+  bench_report("replay", "frames", (int32_t)frames);
+  bench_report("replay", "trace_us", (int32_t)trace_us);
+  bench_report("replay", "frames_per_second", trace_us ? (int32_t)(((uint64_t)frames * 1000000) / trace_us) : 0);
+  bench_report("replay", "client_kbits_per_second",
+               trace_us ? (int32_t)(((uint64_t)client_bytes * 8 * 1000) / trace_us) : 0);
+  bench_report("replay", "client_bytes", (int32_t)client_bytes);
+  bench_report("replay", "ns_per_frame",
+               frames ? (int32_t)((cpu_ticks * (1000 / BENCH_TICKS_PER_US)) / frames) : 0);
+  bench_report("replay", "cpu_load_percent", now ? (int32_t)((cpu_ticks * 100) / now) : 0);
+  bench_report("replay", "tx_frames", (int32_t)tx_frames);
+  bench_report("replay", "tx_resets", (int32_t)tx_resets);
+  bench_report("replay", "filter_drops", (int32_t)filter_drops);
+  bench_report("replay", "pool_drops", (int32_t)pool_drops);
+  bench_report("replay", "unmapped_acks", (int32_t)unmapped_acks);
+  report_latency();
+  bench_report("replay", "failures", (int32_t)(failures + (frames == 0)));
+  return 0;
+}
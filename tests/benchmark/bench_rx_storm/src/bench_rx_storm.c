@@ -0,0 +1,138 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Replays a broadcast storm through the receive filter. Broadcast ARP requests for other hosts, broadcast UDP to a
+ * bound port and ICMP echo requests arrive at minimum frame spacing on a 100Mb/s link, interleaved with unicast UDP and
+ * TCP frames for bound sockets and occasional ARP requests for the stack's own address. Reports how many storm frames
+ * would reach lwIP, the time the filter spends per frame, and the number of socket frames and requests for the stack's
+ * address lost, which must be zero. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "rx_filter.h"
+
+/* LwIP headers */
+#include "lwip/netif.h"
+
+#ifndef BENCH_SECONDS
+#define BENCH_SECONDS 10
+#endif
+
+#define ETH_HEADER_SIZE 14
+#define IP_HEADER_SIZE 20
+#define MIN_FRAME_SIZE 60
+#define TCP_FRAME_SIZE (ETH_HEADER_SIZE + IP_HEADER_SIZE + 20)
+
+/* A minimum size frame with preamble and inter-frame gap takes 6.72us at 100Mb/s */
+#define FRAME_TICKS 672
+#define FRAMES_PER_SECOND (1000000 * BENCH_TICKS_PER_US / FRAME_TICKS)
+
+/* One in SOCKET_EVERY frames is for a bound socket, the rest are the storm */
+#define SOCKET_EVERY 8
+
+/* One in LOCAL_ARP_EVERY frames is an ARP request for the stack's address, about ten a second */
+#define LOCAL_ARP_EVERY 15000
+
+#define UDP_PORT 15533
+#define TCP_PORT 80
+
+#define ARP_TARGET_IP_OFFSET 24
+
+enum { ARP_REQUEST, BROADCAST_UDP, ICMP_ECHO, UNICAST_UDP, UNICAST_TCP, LOCAL_ARP, NUM_KINDS };
+
+static uint8_t frames[NUM_KINDS][TCP_FRAME_SIZE];
+static const uint32_t frame_lengths[NUM_KINDS] = {MIN_FRAME_SIZE, MIN_FRAME_SIZE, MIN_FRAME_SIZE, MIN_FRAME_SIZE,
+                                                  TCP_FRAME_SIZE, MIN_FRAME_SIZE};
+
+static const uint8_t netif_addr[4] = {192, 168, 200, 198};
+static struct netif bench_netif;
+
+static void build_ipv4(uint8_t frame[], int broadcast, uint8_t protocol, uint16_t port) {
+  static const uint8_t ip_header[IP_HEADER_SIZE] = {
+    0x45, 0x00, 0x00, 0x2e, 0x12, 0x34, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+    192, 168, 200, 1, 192, 168, 200, 198};
+
+  memset(frame, broadcast ? 0xFF : 0x02, 6);
+  frame[12] = 0x08;
+  frame[13] = 0x00;
+  memcpy(&frame[ETH_HEADER_SIZE], ip_header, sizeof(ip_header));
+  frame[ETH_HEADER_SIZE + 9] = protocol;
+  frame[ETH_HEADER_SIZE + IP_HEADER_SIZE + 2] = (uint8_t)(port >> 8);
+  frame[ETH_HEADER_SIZE + IP_HEADER_SIZE + 3] = (uint8_t)port;
+}
+
+static void build_arp_request(uint8_t frame[], const uint8_t target[4]) {
+  static const uint8_t other_host[4] = {192, 168, 200, 2};
+  memset(frame, 0xFF, 6);
+  frame[12] = 0x08;
+  frame[13] = 0x06;
+  frame[ETH_HEADER_SIZE + 7] = 1;
+  memcpy(&frame[ETH_HEADER_SIZE + ARP_TARGET_IP_OFFSET], target != NULL ? target : other_host, 4);
+}
+
+static void build_frames(void) {
+  build_arp_request(frames[ARP_REQUEST], NULL);
+  build_arp_request(frames[LOCAL_ARP], netif_addr);
+
+  build_ipv4(frames[BROADCAST_UDP], 1, 17, UDP_PORT);
+  build_ipv4(frames[ICMP_ECHO], 0, 1, 0);
+  frames[ICMP_ECHO][ETH_HEADER_SIZE + IP_HEADER_SIZE] = 8;
+  build_ipv4(frames[UNICAST_UDP], 0, 17, UDP_PORT);
+  build_ipv4(frames[UNICAST_TCP], 0, 6, TCP_PORT);
+  frames[UNICAST_TCP][ETH_HEADER_SIZE + IP_HEADER_SIZE + 13] = 0x10;
+}
+
+int main(void) {
+  uint32_t offered[NUM_KINDS] = {0};
+  uint32_t accepted[NUM_KINDS] = {0};
+  uint32_t seed = 0x1234567;
+  uint32_t ticks = 0;
+  uint32_t now = 0;
+
+  build_frames();
+  memcpy(&bench_netif.ip_addr, netif_addr, sizeof(netif_addr));
+  netif_default = &bench_netif;
+  rx_filter_init();
+  rx_filter_clear();
+  rx_filter_add_udp_port(UDP_PORT);
+  rx_filter_add_tcp_listen_port(TCP_PORT);
+
+  for (uint32_t i = 0; i < BENCH_SECONDS * FRAMES_PER_SECOND; ++i) {
+    uint32_t kind;
+    if (i % LOCAL_ARP_EVERY == LOCAL_ARP_EVERY - 1) {
+      kind = LOCAL_ARP;
+    } else if (i % SOCKET_EVERY == 0) {
+      kind = UNICAST_UDP + (bench_rand(&seed) & 1);
+    } else {
+      kind = bench_rand(&seed) % UNICAST_UDP;
+    }
+    now += FRAME_TICKS;
+
+    uint32_t start = bench_time();
+    int accept = rx_filter_accept(frames[kind], frame_lengths[kind], now);
+    ticks += bench_time() - start;
+
+    offered[kind]++;
+    accepted[kind] += (uint32_t)accept;
+  }
+
+  uint32_t storm_offered = offered[ARP_REQUEST] + offered[BROADCAST_UDP] + offered[ICMP_ECHO];
+  uint32_t storm_accepted = accepted[ARP_REQUEST] + accepted[BROADCAST_UDP] + accepted[ICMP_ECHO];
+  uint32_t socket_lost = (offered[UNICAST_UDP] - accepted[UNICAST_UDP]) + (offered[UNICAST_TCP] - accepted[UNICAST_TCP]);
+  uint32_t local_arp_lost = offered[LOCAL_ARP] - accepted[LOCAL_ARP];
+  uint32_t total = BENCH_SECONDS * FRAMES_PER_SECOND;
+
+  bench_report("rx_storm", "storm_frames_per_second", (int32_t)(storm_offered / BENCH_SECONDS));
+  bench_report("rx_storm", "storm_frames_to_lwip_per_second", (int32_t)(storm_accepted / BENCH_SECONDS));
+  bench_report("rx_storm", "socket_frames_per_second",
+               (int32_t)((offered[UNICAST_UDP] + offered[UNICAST_TCP]) / BENCH_SECONDS));
+  bench_report("rx_storm", "ns_per_frame", (int32_t)((ticks * (1000 / BENCH_TICKS_PER_US)) / total));
+  bench_report("rx_storm", "local_arp_drops", (int32_t)local_arp_lost);
+  bench_report("rx_storm", "failures", (int32_t)(socket_lost + local_arp_lost));
+
+  xtcp_rx_filter_stats_t stats = rx_filter_get_stats();
+  printf("dropped: arp %lu, icmp echo %lu, broadcast udp %lu\n", (unsigned long)stats.arp_rate_limited,
+         (unsigned long)stats.icmp_echo_rate_limited, (unsigned long)stats.broadcast_udp_rate_limited);
+  return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Event latency of clients sharing xtcp_lwip() with clients sending in a loop, with and without weighted servicing.
+ * Each tile runs its own stack on a loopback MAC with four clients. Clients 0 and 1 are each sent a UDP datagram from
+ * the peer every BENCH_EVENT_PERIOD_US, injected into the MAC with the time in its payload, and receive it with
+ * recvfrom() on XTCP_RECV_FROM_DATA. Clients 2 and 3 call sendto() to the peer back to back.
+ *
+ * On tile 0 every client has an unbounded weight, so the select serves whichever call it chooses. On tile 1 client 0
+ * has high priority, and the senders have weights of 3 and 1. For each tile the benchmark reports the median, 99th
+ * percentile and longest time from a datagram reaching the MAC to its client receiving it, the events dropped for a
+ * full queue, and the send calls served to each sender.
+ *
+ * main() and the tasks are in bench_sched_main.xc, as only XC can place tasks on both tiles. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "bench_loopback.h"
+
+#define EVENT_CLIENTS 2
+
+#ifndef BENCH_EVENTS
+#define BENCH_EVENTS 200
+#endif
+
+static uint32_t latencies[EVENT_CLIENTS][BENCH_EVENTS];
+static uint32_t received[EVENT_CLIENTS];
+
+unsigned bench_sched_frame(uint8_t frame[], uint16_t port, uint32_t now) {
+  return bench_udp_frame(frame, port, (const uint8_t *)&now, sizeof(now));
+}
+
+void bench_sched_received(unsigned client_num, const uint8_t payload[], int32_t length, uint32_t now) {
+  uint32_t injected;
+  if ((client_num >= EVENT_CLIENTS) || (length != sizeof(injected)) || (received[client_num] >= BENCH_EVENTS)) {
+    return;
+  }
+  memcpy(&injected, payload, sizeof(injected));
+  latencies[client_num][received[client_num]++] = now - injected;
+}
+
+static const char *bench_name(int weighted) { return weighted ? "sched_weighted" : "sched_unweighted"; }
+
+static int compare_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void report_percentile(const char *name, unsigned client_num, const char *metric, uint32_t ticks) {
+  char label[32];
+  snprintf(label, sizeof(label), "client%u_%s_latency_ns", client_num, metric);
+  bench_report(name, label, (int32_t)(ticks * (1000 / BENCH_TICKS_PER_US)));
+}
+
+void bench_sched_report_events(int weighted, unsigned client_num, uint32_t dropped) {
+  const char *name = bench_name(weighted);
+  char label[32];
+  if (client_num >= EVENT_CLIENTS) {
+    return;
+  }
+  uint32_t n = received[client_num];
+  if (n > 0) {
+    qsort(latencies[client_num], n, sizeof(uint32_t), compare_u32);
+    report_percentile(name, client_num, "p50", latencies[client_num][n / 2]);
+    report_percentile(name, client_num, "p99", latencies[client_num][(n * 99) / 100]);
+    report_percentile(name, client_num, "max", latencies[client_num][n - 1]);
+  }
+  snprintf(label, sizeof(label), "client%u_drops", client_num);
+  bench_report(name, label, (int32_t)dropped);
+}
+
+void bench_sched_report_sends(int weighted, unsigned client_num, uint32_t sends) {
+  char label[32];
+  snprintf(label, sizeof(label), "client%u_sends", client_num);
+  bench_report(bench_name(weighted), label, (int32_t)sends);
+}
+
+void bench_sched_report_loopback(int weighted) { bench_loopback_report(bench_name(weighted)); }
@@ -0,0 +1,52 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Client TCP data moved through xtcp_lwip() by send() against send_stream(). A client on tile 0 sends BENCH_KBYTES
+ * in BENCH_SEND_LENGTH writes over a TCP connection to a client on tile 1, through the stack on tile 1 and the
+ * loopback MAC of tests/benchmark/common. The receiving client checks every byte.
+ *
+ * For send() each write is one interface call carrying the buffer. For send_stream() each write is an interface call
+ * carrying the length, then the data through the client's stream, which the stack services between its other work.
+ * Both the stack's TCP work and the transfer between the tiles are measured, from the sender starting until the
+ * receiver has taken the last byte.
+ *
+ * main() and the clients are in bench_stream_main.xc, as only XC can place tasks on both tiles. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "bench_loopback.h"
+
+#ifndef BENCH_SEND_LENGTH
+#define BENCH_SEND_LENGTH 1460
+#endif
+
+/* The pattern repeats every BENCH_SEND_LENGTH bytes, so the sender's buffer only changes after a partial write */
+static inline uint8_t pattern_byte(uint32_t offset) {
+  uint32_t k = offset % BENCH_SEND_LENGTH;
+  return (uint8_t)(k * 7 + (k >> 8));
+}
+
+void bench_stream_fill(uint8_t buffer[], uint32_t offset, uint32_t length) {
+  for (uint32_t i = 0; i < length; ++i) {
+    buffer[i] = pattern_byte(offset + i);
+  }
+}
+
+/* Check data received at an offset in the transfer against the pattern, returning 1 if any byte is wrong */
+uint32_t bench_stream_check(const uint8_t data[], uint32_t offset, uint32_t length) {
+  for (uint32_t i = 0; i < length; ++i) {
+    if (data[i] != pattern_byte(offset + i)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void bench_stream_report(const char *name, uint32_t bytes, uint32_t ticks, uint32_t failures) {
+  ticks = ticks ? ticks : 1;
+  bench_report(name, "kbits_per_second", (int32_t)(((uint64_t)bytes * 8 * BENCH_TICKS_PER_US * 1000) / ticks));
+  bench_report(name, "ns_per_kbyte", (int32_t)(((uint64_t)ticks * (1000 / BENCH_TICKS_PER_US) * 1024) / bytes));
+  bench_report(name, "failures", (int32_t)failures);
+  bench_loopback_report(name);
+}
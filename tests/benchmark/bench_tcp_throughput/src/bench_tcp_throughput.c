@@ -0,0 +1,260 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Bulk TCP transfer between two clients of the stack, over a modelled full duplex link between two netifs. Frames
+ * leaving a netif are held until they have been serialised at the link rate and have crossed the link, then copied into
+ * a PBUF_POOL pbuf as the Ethernet receive path does and passed to IP. Link time is virtual, so the throughput reported
+ * is what the lwIP options in use allow at that link rate and round trip time, independent of how fast this core runs
+ * the stack. The core time spent running the stack is reported as a percentage of the link time, over 100 the core
+ * could not keep up with the link.
+ *
+ * Build with -DLWIP_OPTS_PATH=lwipopts/high_throughput to measure the high throughput profile. */
+
+#include <string.h>
+
+#include "bench.h"
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "pbuf_shim.h"
+#include "tx_pool.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/tcp.h"
+
+#ifndef BENCH_KBYTES
+#define BENCH_KBYTES 1024
+#endif
+
+#ifndef BENCH_LINK_MBPS
+#define BENCH_LINK_MBPS 100
+#endif
+
+/* Round trip time of the link without queueing, a switched LAN and a host stack */
+#ifndef BENCH_RTT_US
+#define BENCH_RTT_US 1000
+#endif
+
+/* Length of each send by the client, as the largest message of tests/test_bandwidth.py */
+#ifndef BENCH_SEND_LENGTH
+#define BENCH_SEND_LENGTH 1460
+#endif
+
+#define BENCH_BYTES ((uint32_t)BENCH_KBYTES * 1024)
+
+/* Transfers taking longer than this in link time have stalled */
+#define BENCH_LIMIT_TICKS (20 * 1000000 * BENCH_TICKS_PER_US)
+
+/* Ethernet header, FCS, preamble and inter-frame gap sent with each IP packet */
+#define ETH_OVERHEAD 38
+
+#define RECEIVER 0
+#define SENDER 1
+#define PORT 15533
+
+/* Frames in flight in each direction, more are dropped as a full switch queue would */
+#define WIRE_FRAMES 256
+
+typedef struct wire_frame_t {
+  struct pbuf *p;
+  uint32_t arrival;
+} wire_frame_t;
+
+typedef struct wire_t {
+  wire_frame_t frames[WIRE_FRAMES];
+  uint32_t head;
+  uint32_t tail;
+  uint32_t link_free;        // Time the link finishes sending the last frame queued
+  struct netif *destination;
+} wire_t;
+
+static struct netif netif_sender;
+static struct netif netif_receiver;
+static wire_t wires[2];
+static uint32_t now;
+static uint32_t wire_drops;
+static uint32_t pool_drops;
+
+static uint8_t pattern[256 + BENCH_SEND_LENGTH];
+static uint8_t client_buffer[TCP_MSS];
+
+static inline int before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+/* Frames are held by reference until they arrive, lwIP does not retransmit a segment still referenced by a netif */
+__attribute__((fptrgroup("netif_output_fn")))
+static err_t wire_output(struct netif *n, struct pbuf *p, const ip4_addr_t *ipaddr) {
+  (void)ipaddr;
+  wire_t *wire = &wires[n == &netif_sender ? 0 : 1];
+
+  if (wire->head - wire->tail >= WIRE_FRAMES) {
+    wire_drops++;
+    return ERR_OK;
+  }
+
+  uint32_t start = before(wire->link_free, now) ? now : wire->link_free;
+  wire->link_free = start + (p->tot_len + ETH_OVERHEAD) * 8 * BENCH_TICKS_PER_US / BENCH_LINK_MBPS;
+
+  wire_frame_t *frame = &wire->frames[wire->head % WIRE_FRAMES];
+  pbuf_ref(p);
+  frame->p = p;
+  frame->arrival = wire->link_free + (BENCH_RTT_US * BENCH_TICKS_PER_US) / 2;
+  wire->head++;
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t bench_netif_init(struct netif *n) {
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST;
+  n->output = wire_output;
+  return ERR_OK;
+}
+
+static void wire_deliver(wire_t *wire) {
+  while (wire->tail != wire->head && !before(now, wire->frames[wire->tail % WIRE_FRAMES].arrival)) {
+    struct pbuf *p = wire->frames[wire->tail % WIRE_FRAMES].p;
+    wire->tail++;
+
+    struct pbuf *q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_POOL);
+    if (q == NULL) {
+      pool_drops++;
+    } else {
+      pbuf_copy(q, p);
+      ip4_input(q, wire->destination);
+    }
+    pbuf_free(p);
+  }
+}
+
+/* Time of the next frame arrival, or the limit given if there is none sooner */
+static uint32_t next_arrival(uint32_t limit) {
+  for (int w = 0; w < 2; ++w) {
+    if (wires[w].tail != wires[w].head && before(wires[w].frames[wires[w].tail % WIRE_FRAMES].arrival, limit)) {
+      limit = wires[w].frames[wires[w].tail % WIRE_FRAMES].arrival;
+    }
+  }
+  return limit;
+}
+
+static void add_netif(struct netif *n, wire_t *wire_in, uint8_t subnet) {
+  ip4_addr_t ipaddr, netmask, gw;
+  IP4_ADDR(&ipaddr, 10, 0, subnet, 1);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gw, 10, 0, subnet, 254);
+  netif_add(n, &ipaddr, &netmask, &gw, NULL, bench_netif_init, ip4_input);
+  netif_set_up(n);
+  netif_set_link_up(n);
+  wire_in->destination = n;
+}
+
+int main(void) {
+  uint32_t failures = 0;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  int32_t receiver_id = -1;
+  int connected = 0;
+  int can_send = 0;
+
+  for (uint32_t i = 0; i < sizeof(pattern); ++i) {
+    pattern[i] = (uint8_t)i;
+  }
+
+  lwip_init();
+  add_netif(&netif_sender, &wires[1], 1);
+  add_netif(&netif_receiver, &wires[0], 2);
+  netif_set_default(&netif_sender);
+  init_client_connections();
+  xtcp_init_queue();
+  tx_pool_init();
+
+  // Each end is bound to its own netif, so frames for the other end leave through it rather than being looped back
+  xtcp_ipaddr_t receiver_addr = {10, 0, 2, 1};
+  xtcp_error_int32_t listener = shim_new_socket(RECEIVER, XTCP_PROTOCOL_TCP);
+  tcp_bind_netif(get_tcp_pcb(listener.value), &netif_receiver);
+  failures += shim_listen(RECEIVER, listener.value, PORT, receiver_addr) != XTCP_SUCCESS;
+
+  xtcp_error_int32_t sender = shim_new_socket(SENDER, XTCP_PROTOCOL_TCP);
+  tcp_bind_netif(get_tcp_pcb(sender.value), &netif_sender);
+  failures += shim_connect(SENDER, sender.value, PORT, receiver_addr) != XTCP_SUCCESS;
+
+  uint32_t next_timer = TCP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+  uint32_t cpu_start = bench_time();
+
+  while (received < BENCH_BYTES && !failures) {
+    client_event_t event;
+    while ((event = dequeue_event(RECEIVER)).xtcp_event != XTCP_EVENT_NONE) {
+      if (event.xtcp_event == XTCP_ACCEPTED) {
+        receiver_id = event.id;
+        tcp_bind_netif(get_tcp_pcb(receiver_id), &netif_receiver);
+      } else if (event.xtcp_event == XTCP_RECV_DATA && event.id == receiver_id) {
+        uint8_t *data = NULL;
+        xtcp_error_int32_t length = get_remote_data(receiver_id, &data, sizeof(client_buffer), NULL);
+        if (length.status == XTCP_SUCCESS) {
+          memcpy(client_buffer, data, (size_t)length.value);
+          // The pattern repeats every 256 bytes, so the first and last byte show data lost or reordered
+          failures += client_buffer[0] != (uint8_t)received;
+          received += (uint32_t)length.value;
+          failures += client_buffer[length.value - 1] != (uint8_t)(received - 1);
+        }
+        (void)free_remote_data(receiver_id);
+      } else if (event.xtcp_event == XTCP_ABORTED || event.xtcp_event == XTCP_TIMED_OUT) {
+        failures++;
+      }
+    }
+
+    while ((event = dequeue_event(SENDER)).xtcp_event != XTCP_EVENT_NONE) {
+      if (event.xtcp_event == XTCP_NEW_CONNECTION || event.xtcp_event == XTCP_SENT_DATA) {
+        connected = 1;
+        can_send = 1;
+      } else if (event.xtcp_event == XTCP_ABORTED || event.xtcp_event == XTCP_TIMED_OUT) {
+        failures++;
+      }
+    }
+
+    // Send as a client does, until the send buffer is full, then wait for data to be acknowledged
+    while (connected && can_send && sent < BENCH_BYTES) {
+      uint32_t length = BENCH_BYTES - sent < BENCH_SEND_LENGTH ? BENCH_BYTES - sent : BENCH_SEND_LENGTH;
+      void *token = pbuf_shim_alloc_tx(length, 0);
+      if (token == NULL) {
+        can_send = 0;
+        break;
+      }
+      memcpy(pbuf_shim_token_payload(token), &pattern[sent & 0xFF], length);
+      if (shim_send(SENDER, sender.value, token) != XTCP_SUCCESS) {
+        can_send = 0;
+      } else {
+        sent += length;
+      }
+    }
+
+    // Move on to the next frame arrival or timer
+    now = next_arrival(next_timer);
+    wire_deliver(&wires[0]);
+    wire_deliver(&wires[1]);
+    if (!before(now, next_timer)) {
+      tcp_tmr();
+      next_timer += TCP_TMR_INTERVAL * 1000 * BENCH_TICKS_PER_US;
+    }
+    if (!before(now, BENCH_LIMIT_TICKS)) {
+      failures++;
+    }
+  }
+
+  uint32_t cpu_ticks = bench_time() - cpu_start;
+  uint32_t link_us = now / BENCH_TICKS_PER_US;
+
+  bench_report("tcp_throughput", "window_bytes", TCP_WND);
+  bench_report("tcp_throughput", "send_buffer_bytes", TCP_SND_BUF);
+  bench_report("tcp_throughput", "kbits_per_second",
+               link_us ? (int32_t)(((uint64_t)received * 8 * 1000) / link_us) : 0);
+  bench_report("tcp_throughput", "cpu_load_percent", now ? (int32_t)(((uint64_t)cpu_ticks * 100) / now) : 0);
+  bench_report("tcp_throughput", "wire_drops", (int32_t)wire_drops);
+  bench_report("tcp_throughput", "pool_drops", (int32_t)pool_drops);
+  bench_report("tcp_throughput", "failures", (int32_t)failures);
+  return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Soak test for the transmit buffer pools. Allocates mixed size buffers, holds them for a random number of iterations
+ * to mimic unacknowledged TCP data, and frees them. The same sequence is run against the lwIP heap and against the
+ * pools, reporting time per allocation and the number of failed allocations for each. */
+
+#include "bench.h"
+#include "tx_pool.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/pbuf.h"
+
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS 1000000
+#endif
+
+#define MAX_HELD 8
+#define MAX_HOLD 16
+
+typedef struct held_s {
+  struct pbuf *p;
+  uint32_t release_at;
+} held_t;
+
+static const uint16_t lengths[] = {16, 40, 64, 200, 256, 536, 1000, 1460, 1472};
+#define NUM_LENGTHS (sizeof(lengths) / sizeof(lengths[0]))
+
+static struct pbuf *heap_alloc(uint16_t length) { return pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM); }
+
+static void soak(const char *name, struct pbuf *(*alloc)(uint16_t)) {
+  held_t held[MAX_HELD] = {{0}};
+  uint32_t seed = 0x1234567;
+  uint32_t failures = 0;
+  uint32_t ticks = 0;
+
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; ++i) {
+    held_t *slot = &held[bench_rand(&seed) % MAX_HELD];
+    uint16_t length = lengths[bench_rand(&seed) % NUM_LENGTHS];
+
+    uint32_t start = bench_time();
+    for (uint32_t h = 0; h < MAX_HELD; ++h) {
+      if (held[h].p != NULL && held[h].release_at <= i) {
+        pbuf_free(held[h].p);
+        held[h].p = NULL;
+      }
+    }
+    if (slot->p == NULL) {
+      slot->p = alloc(length);
+      if (slot->p == NULL) {
+        failures++;
+      }
+    }
+    ticks += bench_time() - start;
+    slot->release_at = i + 1 + (bench_rand(&seed) % MAX_HOLD);
+  }
+
+  for (uint32_t h = 0; h < MAX_HELD; ++h) {
+    if (held[h].p != NULL) {
+      pbuf_free(held[h].p);
+    }
+  }
+
+  bench_report(name, "ns_per_iteration", (int32_t)((ticks * (1000 / BENCH_TICKS_PER_US)) / BENCH_ITERATIONS));
+  bench_report(name, "failures", (int32_t)failures);
+}
+
+int main(void) {
+  lwip_init();
+  tx_pool_init();
+
+  soak("heap", heap_alloc);
+  soak("tx_pool", tx_pool_alloc);
+
+  xtcp_tx_pool_stats_t stats = tx_pool_get_stats();
+  for (uint32_t c = 0; c < XTCP_TX_POOL_NUM_CLASSES; ++c) {
+    printf("class %lu: size %u, high water %u/%u, exhausted %lu\n", (unsigned long)c,
+           stats.size_class[c].block_size, stats.size_class[c].high_water, stats.size_class[c].num_blocks,
+           (unsigned long)stats.size_class[c].exhausted);
+  }
+  bench_report("tx_pool", "heap_allocs", (int32_t)stats.heap_allocs);
+  return 0;
+}
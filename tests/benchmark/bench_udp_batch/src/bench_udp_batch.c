@@ -0,0 +1,241 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Datagram rate through the stack side of the client interface, one datagram per call against recvfrom_batch() and
+ * sendto_batch(). Each round queues datagrams on a socket as lwIP delivers them and drains them as the server does for
+ * the client's calls, or sends datagrams to a netif whose frames are counted rather than sent. The synchronisation of
+ * each interface call is modelled as a word exchanged each way over a streaming channel, and the copies to and from
+ * the client's buffers are made as the server makes them. */
+
+#include <string.h>
+
+#include <xcore/channel_streaming.h>
+
+#include "bench.h"
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "pbuf_shim.h"
+#include "static_arp.h"
+#include "tx_pool.h"
+#include "udp_batch.h"
+#include "udp_recv.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include "netif/ethernet.h"
+
+#define ROUNDS 200
+#define DATAGRAMS_PER_ROUND XTCP_BATCH_MAX_DATAGRAMS
+#define PAYLOAD_SIZE 64
+#define CLIENT_NUM 0
+#define LOCAL_PORT 5000
+#define REMOTE_PORT 6000
+
+static struct netif netif;
+static const uint8_t our_mac[ETH_HWADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t peer_mac[ETH_HWADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+static ip4_addr_t peer;
+static uint32_t frames_sent;
+
+static streaming_channel_t call;
+static int32_t id;
+
+/* The client's buffers */
+static uint8_t client_buffer[XTCP_BATCH_MAX_BYTES];
+static xtcp_datagram_t client_datagrams[DATAGRAMS_PER_ROUND];
+
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t count_linkoutput(struct netif *n, struct pbuf *p) {
+  (void)n;
+  (void)p;
+  frames_sent++;
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t bench_netif_init(struct netif *n) {
+  n->hwaddr_len = ETH_HWADDR_LEN;
+  memcpy(n->hwaddr, our_mac, ETH_HWADDR_LEN);
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+  n->output = etharp_output;
+  n->linkoutput = count_linkoutput;
+  return ERR_OK;
+}
+
+/* Request and reply of one interface call */
+static void interface_call(void) {
+  s_chan_out_word(call.end_a, 0);
+  (void)s_chan_in_word(call.end_b);
+  s_chan_out_word(call.end_b, 0);
+  (void)s_chan_in_word(call.end_a);
+}
+
+static void deliver_round(void) {
+  for (uint32_t d = 0; d < DATAGRAMS_PER_ROUND; ++d) {
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, PAYLOAD_SIZE, PBUF_POOL);
+    memset(p->payload, (int)d, PAYLOAD_SIZE);
+    xtcp_udp_recv((void *)id, get_udp_pcb(id), p, &peer, REMOTE_PORT);
+  }
+}
+
+/* get_event() then recvfrom() for each datagram */
+static uint32_t recv_single(void) {
+  uint32_t received = 0;
+  for (;;) {
+    interface_call();
+    client_event_t event = dequeue_event(CLIENT_NUM);
+    if (event.xtcp_event == XTCP_EVENT_NONE) {
+      break;
+    }
+
+    interface_call();
+    xtcp_host_t remote = get_remote(id);
+    uint8_t *data = NULL;
+    xtcp_error_int32_t copy_length = get_remote_data(id, &data, sizeof(client_buffer), NULL);
+    if (copy_length.status == XTCP_SUCCESS) {
+      memcpy(client_buffer, data, copy_length.value);
+      memcpy(client_datagrams[0].ipaddr, remote.ipaddr, sizeof(xtcp_ipaddr_t));
+      received++;
+    }
+    (void)free_remote_data(id);
+  }
+  return received;
+}
+
+/* get_event() then one recvfrom_batch() */
+static uint32_t recv_batch(void) {
+  uint32_t received = 0;
+  for (;;) {
+    interface_call();
+    client_event_t event = dequeue_event(CLIENT_NUM);
+    if (event.xtcp_event == XTCP_EVENT_NONE) {
+      break;
+    }
+
+    interface_call();
+    xtcp_datagram_t batch[XTCP_BATCH_MAX_DATAGRAMS];
+    int32_t count = udp_batch_recvfrom(CLIENT_NUM, id, sizeof(client_buffer), batch, DATAGRAMS_PER_ROUND);
+    if (count > 0) {
+      memcpy(client_buffer, udp_batch_buffer(), batch[count - 1].offset + batch[count - 1].length);
+      memcpy(client_datagrams, batch, count * sizeof(xtcp_datagram_t));
+      received += count;
+    }
+  }
+  return received;
+}
+
+/* sendto() for each datagram */
+static uint32_t send_single(void) {
+  uint32_t sent = 0;
+  for (uint32_t d = 0; d < DATAGRAMS_PER_ROUND; ++d) {
+    interface_call();
+    void *buffer_token = pbuf_shim_alloc_tx(PAYLOAD_SIZE, 0);
+    if (buffer_token != NULL) {
+      memcpy(pbuf_shim_token_payload(buffer_token), &client_buffer[d * PAYLOAD_SIZE], PAYLOAD_SIZE);
+      if (shim_sendto(CLIENT_NUM, id, buffer_token, (uint8_t *)&peer, REMOTE_PORT) == XTCP_SUCCESS) {
+        sent++;
+      }
+    }
+  }
+  return sent;
+}
+
+/* One sendto_batch() */
+static uint32_t send_batch(void) {
+  xtcp_datagram_t batch[XTCP_BATCH_MAX_DATAGRAMS];
+  interface_call();
+  memcpy(batch, client_datagrams, DATAGRAMS_PER_ROUND * sizeof(xtcp_datagram_t));
+  memcpy(udp_batch_buffer(), client_buffer, DATAGRAMS_PER_ROUND * PAYLOAD_SIZE);
+  int32_t sent = udp_batch_sendto(CLIENT_NUM, id, DATAGRAMS_PER_ROUND * PAYLOAD_SIZE, batch, DATAGRAMS_PER_ROUND);
+  memcpy(client_datagrams, batch, DATAGRAMS_PER_ROUND * sizeof(xtcp_datagram_t));
+  return (sent > 0) ? (uint32_t)sent : 0;
+}
+
+static void run_recv(const char *name, uint32_t (*drain)(void)) {
+  uint32_t ticks = 0;
+  uint32_t failures = 0;
+
+  for (uint32_t r = 0; r < ROUNDS; ++r) {
+    deliver_round();
+    uint32_t start = bench_time();
+    uint32_t received = drain();
+    ticks += bench_time() - start;
+    if (received != DATAGRAMS_PER_ROUND) {
+      failures++;
+    }
+  }
+
+  uint32_t datagrams = ROUNDS * DATAGRAMS_PER_ROUND;
+  bench_report(name, "ns_per_datagram", (int32_t)(((uint64_t)ticks * (1000 / BENCH_TICKS_PER_US)) / datagrams));
+  bench_report(name, "datagrams_per_second", (int32_t)(((uint64_t)datagrams * BENCH_TICKS_PER_US * 1000000) / ticks));
+  bench_report(name, "failures", (int32_t)failures);
+}
+
+static void run_send(const char *name, uint32_t (*send)(void)) {
+  uint32_t ticks = 0;
+  uint32_t failures = 0;
+
+  for (uint32_t d = 0; d < DATAGRAMS_PER_ROUND; ++d) {
+    client_datagrams[d].offset = d * PAYLOAD_SIZE;
+    client_datagrams[d].length = PAYLOAD_SIZE;
+    memcpy(client_datagrams[d].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+    client_datagrams[d].port_number = REMOTE_PORT;
+  }
+
+  frames_sent = 0;
+  for (uint32_t r = 0; r < ROUNDS; ++r) {
+    uint32_t start = bench_time();
+    uint32_t sent = send();
+    ticks += bench_time() - start;
+    if (sent != DATAGRAMS_PER_ROUND) {
+      failures++;
+    }
+  }
+  if (frames_sent != ROUNDS * DATAGRAMS_PER_ROUND) {
+    failures++;
+  }
+
+  uint32_t datagrams = ROUNDS * DATAGRAMS_PER_ROUND;
+  bench_report(name, "ns_per_datagram", (int32_t)(((uint64_t)ticks * (1000 / BENCH_TICKS_PER_US)) / datagrams));
+  bench_report(name, "datagrams_per_second", (int32_t)(((uint64_t)datagrams * BENCH_TICKS_PER_US * 1000000) / ticks));
+  bench_report(name, "failures", (int32_t)failures);
+}
+
+int main(void) {
+  ip4_addr_t ipaddr, netmask, gw;
+  IP4_ADDR(&ipaddr, 192, 168, 200, 198);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gw, 192, 168, 200, 1);
+  IP4_ADDR(&peer, 192, 168, 200, 2);
+
+  lwip_init();
+  netif_add(&netif, &ipaddr, &netmask, &gw, NULL, bench_netif_init, ethernet_input);
+  netif_set_default(&netif);
+  netif_set_up(&netif);
+  netif_set_link_up(&netif);
+  static_arp_init();
+  (void)static_arp_add((const uint8_t *)&peer, peer_mac);
+
+  init_client_connections();
+  xtcp_init_queue();
+  tx_pool_init();
+  call = s_chan_alloc();
+
+  xtcp_error_int32_t connection = shim_new_socket(CLIENT_NUM, XTCP_PROTOCOL_UDP);
+  id = connection.value;
+  udp_bind(get_udp_pcb(id), IP_ADDR_ANY, LOCAL_PORT);
+
+  run_recv("recvfrom", recv_single);
+  run_recv("recvfrom_batch", recv_batch);
+  run_send("sendto", send_single);
+  run_send("sendto_batch", send_batch);
+
+  shim_close_socket(CLIENT_NUM, id);
+  s_chan_free(call);
+  return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+/* Frame handling of the loopback MAC in bench_loopback.xc */
+
+#include <string.h>
+
+#include "bench.h"
+#include "bench_loopback.h"
+
+#define ETH_HEADER_LENGTH 14
+#define IP_HEADER_LENGTH 20
+#define UDP_HEADER_LENGTH 8
+
+const uint8_t bench_mac_address[MACADDR_NUM_BYTES] = {0x00, 0x22, 0x97, 0x00, 0xbe, 0x01};
+const uint8_t bench_peer_mac_address[MACADDR_NUM_BYTES] = {0x00, 0x22, 0x97, 0x00, 0xbe, 0x02};
+
+static const uint8_t bench_ipaddr[4] = BENCH_IPADDR;
+static const uint8_t bench_peer_ipaddr[4] = BENCH_PEER_IPADDR;
+
+static uint32_t drops;
+
+void xtcp_configure_mac(unsigned netif_id, uint8_t mac_address[MACADDR_NUM_BYTES]) {
+  (void)netif_id;
+  memcpy(mac_address, bench_mac_address, MACADDR_NUM_BYTES);
+}
+
+int bench_loopback_reflects(const uint8_t frame[], unsigned length) {
+  if (length < ETH_HEADER_LENGTH) {
+    return 0;
+  }
+  // Multicast and broadcast destinations have the group bit set
+  return (frame[0] & 1) || (memcmp(frame, bench_mac_address, MACADDR_NUM_BYTES) == 0);
+}
+
+void bench_loopback_drop(void) { drops++; }
+
+void bench_loopback_report(const char name[]) {
+  bench_report(name, "loopback_drops", (int32_t)drops);
+  drops = 0;
+}
+
+static inline void put16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)(value >> 8);
+  p[1] = (uint8_t)value;
+}
+
+static uint16_t ip_header_checksum(const uint8_t *header) {
+  uint32_t sum = 0;
+  for (unsigned i = 0; i < IP_HEADER_LENGTH; i += 2) {
+    sum += ((uint32_t)header[i] << 8) | header[i + 1];
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return (uint16_t)~sum;
+}
+
+unsigned bench_udp_frame(uint8_t frame[], uint16_t port, const uint8_t payload[], unsigned length) {
+  static uint16_t ip_id;
+  uint8_t *ip = frame + ETH_HEADER_LENGTH;
+  uint8_t *udp = ip + IP_HEADER_LENGTH;
+
+  memcpy(frame, bench_mac_address, MACADDR_NUM_BYTES);
+  memcpy(frame + MACADDR_NUM_BYTES, bench_peer_mac_address, MACADDR_NUM_BYTES);
+  put16(frame + 12, 0x0800);
+
+  memset(ip, 0, IP_HEADER_LENGTH);
+  ip[0] = 0x45;
+  put16(ip + 2, (uint16_t)(IP_HEADER_LENGTH + UDP_HEADER_LENGTH + length));
+  put16(ip + 4, ip_id++);
+  ip[8] = 64;
+  ip[9] = 17;
+  memcpy(ip + 12, bench_peer_ipaddr, 4);
+  memcpy(ip + 16, bench_ipaddr, 4);
+  put16(ip + 10, ip_header_checksum(ip));
+
+  // A UDP checksum of zero is not checked
+  put16(udp, BENCH_PEER_PORT);
+  put16(udp + 2, port);
+  put16(udp + 4, (uint16_t)(UDP_HEADER_LENGTH + length));
+  put16(udp + 6, 0);
+  memcpy(udp + UDP_HEADER_LENGTH, payload, length);
+
+  unsigned total = ETH_HEADER_LENGTH + IP_HEADER_LENGTH + UDP_HEADER_LENGTH + length;
+  if (total < 60) {
+    // Pad to the minimum frame length
+    memset(frame + total, 0, 60 - total);
+    total = 60;
+  }
+  return total;
+}
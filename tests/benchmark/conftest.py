@@ -0,0 +1,106 @@
+# Copyright 2025 XMOS LIMITED.
+# This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+import json
+import shlex
+import pytest
+import subprocess
+import re
+import sys
+from pathlib import Path
+
+# Metrics where a rise is a regression, any other metric regresses when it falls
+LOWER_IS_BETTER = ("ns_per", "latency", "drops", "cpu_load", "failures", "resets", "unmapped")
+
+results = {}
+
+def pytest_addoption(parser):
+    parser.addoption("--bench-report", type=Path, help="Write every metric reported to this JSON file")
+    parser.addoption("--bench-baseline", type=Path, help="Fail benchmarks with metrics worse than this JSON report")
+    parser.addoption("--bench-tolerance", type=float, default=5.0,
+                     help="Change from the baseline allowed before a metric is a regression, in percent")
+    parser.addoption("--bench-args", nargs=2, action="append", default=[], metavar=("BENCH", "ARGS"),
+                     help="Run the benchmark named with these arguments, such as the scenarios of bench_impair")
+
+def pytest_configure(config):
+    # The trace is generated rather than checked in, bench_replay reads it relative to this directory
+    subprocess.run([sys.executable, "bench_replay/make_trace.py", "--output", "bench_replay/traces/tcp_upload.pcap"],
+                   check=True)
+    subprocess.run(["cmake", "-B", "build"], check=True)
+    subprocess.run(["cmake", "--build", "build"], check=True)
+
+def pytest_sessionfinish(session):
+    report = session.config.getoption("--bench-report")
+    if report is not None:
+        report.write_text(json.dumps(results, indent=2, sort_keys=True) + "\n")
+
+def regression(metric, value, baseline, tolerance):
+    """Describe how value is worse than baseline by more than the tolerance, or return None."""
+    allowed = abs(baseline) * tolerance / 100
+    if any(word in metric for word in LOWER_IS_BETTER):
+        worse = value > baseline + allowed
+    else:
+        worse = value < baseline - allowed
+    return f"{metric} is {value}, baseline {baseline}" if worse else None
+
+def pytest_collect_file(parent, file_path: Path):
+    """Custom collection function to inform pytest that xe files contain benchmarks."""
+    if file_path.suffix == ".xe":
+        return BenchSource.from_parent(parent, path=file_path)
+
+class BenchSource(pytest.File):
+    """
+    Each xe file contains 1 benchmark.
+    """
+    def collect(self):
+        yield BenchExecutable.from_parent(self, xe=self.path, name=self.path.stem)
+
+
+class BenchExecutable(pytest.Item):
+    """
+    Run the xe file in xsim and report the BENCH lines it prints.
+    """
+    def __init__(self, xe, **kwargs):
+        super().__init__(**kwargs)
+        self.xe=xe
+        self.fail_reason=[]
+
+    def runtest(self):
+        command = ["xsim", self.xe]
+        for bench, args in self.config.getoption("--bench-args"):
+            if self.name.endswith(bench):
+                command = ["xsim", "--args", self.xe] + shlex.split(args)
+        proc = subprocess.run(command, text=True, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        self.add_report_section("call", "stdout", proc.stdout)
+        bench_result_pattern=r"^BENCH: (?P<bench>\S+) (?P<metric>\S+) (?P<value>-?\d+)$"
+
+        baseline_path = self.config.getoption("--bench-baseline")
+        baseline = json.loads(baseline_path.read_text()) if baseline_path is not None else {}
+        tolerance = self.config.getoption("--bench-tolerance")
+
+        for match in re.finditer(bench_result_pattern, proc.stdout, re.MULTILINE):
+            bench, metric, value = match.group("bench", "metric", "value")
+            key = f"{bench}.{metric}"
+            self.user_properties.append((key, int(value)))
+            results[key] = int(value)
+            if metric == "failures" and int(value) != 0:
+                self.fail_reason.append(f"{bench}: {value} failures")
+            elif key in baseline:
+                reason = regression(key, int(value), baseline[key], tolerance)
+                if reason is not None:
+                    self.fail_reason.append(reason)
+
+        if proc.returncode or self.fail_reason:
+            raise BenchException
+
+    def repr_failure(self, excinfo):
+        if isinstance(excinfo.value, BenchException):
+            return "Failure summary:\n\t" + "\n\t".join(self.fail_reason)
+        return super().repr_failure(excinfo)
+
+    def reportinfo(self):
+        return self.path, 0, self.xe.stem
+
+
+class BenchException(Exception):
+    pass
@@ -0,0 +1,33 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <xcore/hwtimer.h>
+
+/** Reference clock ticks per microsecond */
+#define BENCH_TICKS_PER_US 100
+
+/** Read the 100MHz reference timer */
+static inline uint32_t bench_time(void) { return get_reference_time(); }
+
+/** Report a result as a "BENCH: <bench> <metric> <value>" line, collected by conftest.py */
+static inline void bench_report(const char *bench, const char *metric, int32_t value) {
+  printf("BENCH: %s %s %ld\n", bench, metric, (long)value);
+}
+
+/** Small xorshift generator so benchmark runs are repeatable */
+static inline uint32_t bench_rand(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,73 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef BENCH_LOOPBACK_H
+#define BENCH_LOOPBACK_H
+
+/* A stand-in Ethernet MAC for benchmarks running xtcp_lwip() under xsim. Frames the stack sends to its own MAC
+ * address or to broadcast are received by it again, so its clients can connect to each other through the whole
+ * stack. Frames for any other host are counted and dropped, and a benchmark can inject frames from a host on the link.
+ *
+ * The sources are in tests/benchmark/common, built into every benchmark. */
+
+#include <stdint.h>
+
+#include "ethernet.h"
+#include "xtcp.h"
+
+/** Frames the MAC holds for the stack to receive, a frame sent while they are all in use is dropped */
+#ifndef BENCH_LOOPBACK_FRAMES
+#define BENCH_LOOPBACK_FRAMES 16
+#endif
+
+/** The stack's address, on a /24 network */
+#define BENCH_IPADDR {192, 168, 200, 10}
+
+/** A host on the link that only receives */
+#define BENCH_PEER_IPADDR {192, 168, 200, 20}
+
+/** UDP port the injected frames are sent from */
+#define BENCH_PEER_PORT 4000
+
+/** MAC addresses of the stack, set by the xtcp_configure_mac() in bench_loopback.c, and of the peer */
+extern const uint8_t bench_mac_address[MACADDR_NUM_BYTES];
+extern const uint8_t bench_peer_mac_address[MACADDR_NUM_BYTES];
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** Check whether a frame sent by the stack is for the stack itself, so it is received again. Only the destination
+ * address at the start of the frame is read, length being that of the whole frame. */
+int bench_loopback_reflects(const uint8_t frame[], unsigned length);
+
+/** Count a frame the MAC dropped, as it had no free buffer */
+void bench_loopback_drop(void);
+
+/** Report the frames the MAC dropped since the last report, as "<name> loopback_drops" */
+void bench_loopback_report(const char name[]);
+
+/** Build a UDP datagram from the peer to a port of the stack.
+ *
+ * \param frame     Buffer for the frame, of at least ETHERNET_MAX_PACKET_SIZE bytes.
+ * \param port      The destination port.
+ * \param payload   The payload.
+ * \param length    The length of the payload.
+ * \returns         The length of the frame.
+ */
+unsigned bench_udp_frame(uint8_t frame[], uint16_t port, const uint8_t payload[], unsigned length);
+
+#ifdef __XC__
+}
+
+/** Frames injected into the link, received by the stack as if sent by the peer */
+interface bench_inject_if {
+  void frame(const uint8_t data[n], unsigned n);
+};
+
+/** The MAC task, serving the configuration, receive and transmit interfaces of one xtcp_lwip() */
+void bench_loopback(server ethernet_cfg_if i_cfg, server ethernet_rx_if i_rx, server ethernet_tx_if i_tx,
+                    server interface bench_inject_if ?i_inject);
+#endif
+
+#endif /* BENCH_LOOPBACK_H */
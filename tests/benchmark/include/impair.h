@@ -0,0 +1,231 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef IMPAIR_H
+#define IMPAIR_H
+
+/* A one way link between two netifs in virtual time, impaired as netem would: frames are serialised at a capped rate,
+ * queued up to a limit, then lost, duplicated, delayed with jitter or held back to be reordered at random. Frames are
+ * held by reference and copied into a PBUF_POOL pbuf on arrival, as the Ethernet receive path does, and passed to the
+ * input function of the destination netif. The generator is seeded, so each run of a benchmark is the same.
+ *
+ * Impairments are set from strings such as "loss=1.5,delay_us=500,jitter_us=200", so a benchmark runner can pass them
+ * as arguments. Percentages are given with up to four decimal places. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+/* LwIP headers */
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+
+/** Frames held by a link at once, the most queue_frames can be set to */
+#define IMPAIR_FRAMES 256
+
+/** Ethernet header, FCS, preamble and inter-frame gap sent with each IP packet */
+#define IMPAIR_FRAME_OVERHEAD 38
+
+typedef struct impair_config_t {
+  uint32_t rate_kbps;      // Link rate, zero is unlimited
+  uint32_t queue_frames;   // Frames queued or in flight before more are dropped, zero is IMPAIR_FRAMES
+  uint32_t delay_us;       // Propagation delay of every frame
+  uint32_t jitter_us;      // Most extra delay added to a frame, uniformly distributed
+  uint32_t loss_ppm;       // Frames lost, in parts per million
+  uint32_t duplicate_ppm;  // Frames delivered twice
+  uint32_t reorder_ppm;    // Frames held back by reorder_us, so those sent after overtake them
+  uint32_t reorder_us;
+} impair_config_t;
+
+typedef struct impair_stats_t {
+  uint32_t sent;
+  uint32_t delivered;
+  uint32_t lost;
+  uint32_t duplicated;
+  uint32_t reordered;      // Frames delivered after a frame sent later
+  uint32_t queue_drops;
+  uint32_t pool_drops;
+} impair_stats_t;
+
+typedef struct impair_frame_t {
+  struct pbuf *p;
+  uint32_t arrival;
+  uint32_t sequence;
+} impair_frame_t;
+
+typedef struct impair_link_t {
+  impair_config_t config;
+  impair_stats_t stats;
+  impair_frame_t frames[IMPAIR_FRAMES];  // Sorted by arrival
+  uint32_t count;
+  uint32_t link_free;                    // Time the link finishes serialising the last frame sent
+  uint32_t sequence;
+  uint32_t delivered_sequence;           // Highest sequence delivered, plus one
+  uint32_t rand_state;
+  struct netif *destination;
+} impair_link_t;
+
+static inline int impair_before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+/** Start a link to the destination netif, the seed must be non-zero */
+static inline void impair_init(impair_link_t *link, const impair_config_t *config, struct netif *destination,
+                               uint32_t seed) {
+  memset(link, 0, sizeof(*link));
+  link->config = *config;
+  link->destination = destination;
+  link->rand_state = seed;
+}
+
+static inline int impair_chance(impair_link_t *link, uint32_t ppm) {
+  return ppm && (bench_rand(&link->rand_state) % 1000000) < ppm;
+}
+
+/* Insert a frame after those arriving at the same time or sooner */
+static inline void impair_queue(impair_link_t *link, struct pbuf *p, uint32_t arrival, uint32_t sequence) {
+  uint32_t i = link->count;
+  while (i > 0 && impair_before(arrival, link->frames[i - 1].arrival)) {
+    link->frames[i] = link->frames[i - 1];
+    i--;
+  }
+  pbuf_ref(p);
+  link->frames[i].p = p;
+  link->frames[i].arrival = arrival;
+  link->frames[i].sequence = sequence;
+  link->count++;
+}
+
+static inline uint32_t impair_delay(impair_link_t *link) {
+  const impair_config_t *config = &link->config;
+  uint32_t delay_us = config->delay_us;
+  if (config->jitter_us) {
+    delay_us += bench_rand(&link->rand_state) % (config->jitter_us + 1);
+  }
+  if (impair_chance(link, config->reorder_ppm)) {
+    delay_us += config->reorder_us;
+  }
+  return delay_us * BENCH_TICKS_PER_US;
+}
+
+/** Send a frame at time now, the link takes its own reference to the pbuf */
+static inline void impair_send(impair_link_t *link, struct pbuf *p, uint32_t now) {
+  const impair_config_t *config = &link->config;
+  uint32_t limit = config->queue_frames && config->queue_frames < IMPAIR_FRAMES ? config->queue_frames : IMPAIR_FRAMES;
+  uint32_t sequence = link->sequence++;
+
+  link->stats.sent++;
+  if (link->count >= limit) {
+    link->stats.queue_drops++;
+    return;
+  }
+
+  uint32_t start = impair_before(link->link_free, now) ? now : link->link_free;
+  if (config->rate_kbps) {
+    start += (uint32_t)(((uint64_t)(p->tot_len + IMPAIR_FRAME_OVERHEAD) * 8 * 1000 * BENCH_TICKS_PER_US) /
+                        config->rate_kbps);
+  }
+  link->link_free = start;
+
+  if (impair_chance(link, config->loss_ppm)) {
+    link->stats.lost++;
+    return;
+  }
+  impair_queue(link, p, start + impair_delay(link), sequence);
+  if (impair_chance(link, config->duplicate_ppm) && link->count < limit) {
+    link->stats.duplicated++;
+    impair_queue(link, p, start + impair_delay(link), sequence);
+  }
+}
+
+/** Deliver the frames arriving by time now to the destination netif */
+static inline void impair_deliver(impair_link_t *link, uint32_t now) {
+  while (link->count && !impair_before(now, link->frames[0].arrival)) {
+    impair_frame_t frame = link->frames[0];
+    link->count--;
+    memmove(&link->frames[0], &link->frames[1], link->count * sizeof(link->frames[0]));
+
+    if (frame.sequence + 1 < link->delivered_sequence) {
+      link->stats.reordered++;
+    } else {
+      link->delivered_sequence = frame.sequence + 1;
+    }
+
+    struct pbuf *q = pbuf_alloc(PBUF_RAW, frame.p->tot_len, PBUF_POOL);
+    if (q == NULL) {
+      link->stats.pool_drops++;
+    } else {
+      pbuf_copy(q, frame.p);
+      link->stats.delivered++;
+      if (link->destination->input(q, link->destination) != ERR_OK) {
+        pbuf_free(q);
+      }
+    }
+    pbuf_free(frame.p);
+  }
+}
+
+/** Time of the next frame arrival, or the limit given if there is none sooner */
+static inline uint32_t impair_next_arrival(const impair_link_t *link, uint32_t limit) {
+  if (link->count && impair_before(link->frames[0].arrival, limit)) {
+    return link->frames[0].arrival;
+  }
+  return limit;
+}
+
+/* A percentage with up to four decimal places, in parts per million */
+static inline uint32_t impair_parse_ppm(const char *value, char **end) {
+  uint32_t ppm = (uint32_t)strtoul(value, end, 10) * 10000;
+  if (**end == '.') {
+    uint32_t scale = 1000;
+    for (++*end; **end >= '0' && **end <= '9'; ++*end) {
+      ppm += (uint32_t)(**end - '0') * scale;
+      scale /= 10;
+    }
+  }
+  return ppm;
+}
+
+/** Set the impairments named in a string of comma separated key=value pairs, returning zero, or -1 for a string with
+ *  a key that is unknown or a value that is not a number */
+static inline int impair_parse(impair_config_t *config, const char *spec) {
+  while (*spec) {
+    const char *equals = strchr(spec, '=');
+    if (equals == NULL) {
+      return -1;
+    }
+    size_t key_length = (size_t)(equals - spec);
+    const char *value = equals + 1;
+    char *end = NULL;
+
+#define IMPAIR_KEY(name) (key_length == sizeof(name) - 1 && !strncmp(spec, name, key_length))
+    if (IMPAIR_KEY("loss")) {
+      config->loss_ppm = impair_parse_ppm(value, &end);
+    } else if (IMPAIR_KEY("duplicate")) {
+      config->duplicate_ppm = impair_parse_ppm(value, &end);
+    } else if (IMPAIR_KEY("reorder")) {
+      config->reorder_ppm = impair_parse_ppm(value, &end);
+    } else if (IMPAIR_KEY("rate_kbps")) {
+      config->rate_kbps = (uint32_t)strtoul(value, &end, 10);
+    } else if (IMPAIR_KEY("queue_frames")) {
+      config->queue_frames = (uint32_t)strtoul(value, &end, 10);
+    } else if (IMPAIR_KEY("delay_us")) {
+      config->delay_us = (uint32_t)strtoul(value, &end, 10);
+    } else if (IMPAIR_KEY("jitter_us")) {
+      config->jitter_us = (uint32_t)strtoul(value, &end, 10);
+    } else if (IMPAIR_KEY("reorder_us")) {
+      config->reorder_us = (uint32_t)strtoul(value, &end, 10);
+    } else {
+      return -1;
+    }
+#undef IMPAIR_KEY
+
+    if (end == value || (*end != ',' && *end != '\0')) {
+      return -1;
+    }
+    spec = *end ? end + 1 : end;
+  }
+  return 0;
+}
+
+#endif /* IMPAIR_H */
@@ -0,0 +1,31 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef XTCP_CONF_H
+#define XTCP_CONF_H
+
+#define MAX_XTCP_CLIENTS 4
+
+#define XTCP_ARP_HASH_TABLE_SIZE 512
+
+#define XTCP_CLIENT_SCHED_ENABLE 1
+
+#define XTCP_RX_FILTER_ENABLE 1
+
+#define XTCP_RATE_LIMIT_ARP_REQUESTS 50
+
+#define XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS 50
+
+#define XTCP_RATE_LIMIT_ICMP_ECHO 20
+
+#define XTCP_RATE_LIMIT_ICMP_UNREACHABLE 10
+
+#define XTCP_RATE_LIMIT_BROADCAST_UDP 200
+
+#define XTCP_UDP_BATCH_ENABLE 1
+
+#define XTCP_STREAM_ENABLE 1
+
+#define XTCP_HTTP_ENABLE 1
+
+#endif /* XTCP_CONF_H */
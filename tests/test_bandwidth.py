@@ -15,12 +15,21 @@ from CollectFailures import CollectFailures
 @pytest.mark.parametrize('processes', [1, 2])
 @pytest.mark.parametrize('message_length', [100, 536, 1460])
 @pytest.mark.parametrize('target', ['XMS0020'])
-def test_bandwidth(request, protocol, processes, message_length, target):
+@pytest.mark.parametrize('pipeline', [False, True], ids=['single', 'pipeline'])
+@pytest.mark.parametrize('profile', ['standard', 'high_throughput'])
+def test_bandwidth(request, protocol, processes, message_length, target, pipeline, profile):
     dut_ip = '192.168.200.198'
     dut_ports_per_proc = processes  # Number of Ports and processes parameterised the same for simplicity
-    library = 'LWIP'
 
-    tester = RunXtcp(processes, dut_ports_per_proc, protocol, message_length)
+    # The high throughput LwIP profile only changes TCP, xtcp_bombard_lwip_high_throughput is built for TCP only
+    if profile == 'high_throughput':
+        if protocol != 'TCP':
+            pytest.skip('high_throughput profile is only built for TCP')
+        library = 'LWIP_HIGH_THROUGHPUT'
+    else:
+        library = 'LWIP'
+
+    tester = RunXtcp(processes, dut_ports_per_proc, protocol, message_length, pipeline)
     tester.setup(request)
 
     tester.run_test(0.000, target, dut_ip, 'ETH', library)
@@ -32,13 +41,14 @@ def test_bandwidth(request, protocol, processes, message_length, target):
 
 
 class RunXtcp(CollectFailures):
-    def __init__(self, processes, ports, protocol, message_length):
+    def __init__(self, processes, ports, protocol, message_length, pipeline=False):
         super(RunXtcp, self).__init__()
         self._adapter_id = None
         self.processes = processes
         self.ports = ports
         self.protocol = protocol
         self.message_length = message_length
+        self.pipeline = pipeline
 
         self.python_output = ""
         self.xrun_stdout = ""
@@ -62,6 +72,8 @@ class RunXtcp(CollectFailures):
 
     def run_test(self, delay, target, ip, interface, library):
         setup = f'{self.processes}_{self.ports}_{self.protocol}_{target}_{interface}'
+        if self.pipeline:
+            setup += '_PIPELINE'
         binary = pathlib.Path(f'xtcp_bombard_{library.lower()}/bin/{setup}/xtcp_bombard_{library.lower()}_{setup}.xe')
 
         assert binary.exists(), 'Found test binary'
@@ -174,6 +186,7 @@ class RunXtcp(CollectFailures):
         num_connections = self.processes * self.ports
         found_connections = 0
         num_interfaces = 0
+        tx_queue_full = None
 
         for line in self.xrun_stdout.splitlines():
             if (re.match('Listening on port: [0-9]+$', line)):
@@ -182,6 +195,17 @@ class RunXtcp(CollectFailures):
             elif 'IFUP' in line:
                 num_interfaces += 1
 
+            elif (match := re.search(r'Pipeline: tx_queue_full (?P<full>\d+)', line)):
+                tx_queue_full = int(match.group('full'))
+                print(line)
+
+        # A full transmit queue drops frames, stalling TCP and losing UDP datagrams
+        if self.pipeline:
+            if tx_queue_full is None:
+                self.record_failure("Could not find the pipeline statistics in the device output")
+            elif tx_queue_full > 0:
+                self.record_failure(f"Pipeline transmit queue full for {tx_queue_full} frames")
+
         if found_connections != num_connections:
             self.record_failure(
                 "Incorrect number of listening ports created on device\n" +
@@ -38,7 +38,7 @@ class UnityTestExecutable(pytest.Item):
         """
         proc = subprocess.run(["xsim", "--xscope", "-offline trace.xmt", self.xe], text=True, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
         self.add_report_section("call", "stdout", proc.stdout)
-        unity_result_pattern=r"^(?P<path>[^\n:]+):(?P<line>\d+):(?P<name>[^:]+):(?P<status>PASS|FAIL)(: (?P<message>.*))?$"
+        unity_result_pattern=r"^(?P<path>[^\n:]+):(?P<line>\d+):(?P<name>[^:]+):(?P<status>PASS|FAIL|IGNORE)(: (?P<message>.*))?$"
         unlikely_repl = "unlikely_repl"
 
         result = [i for i in re.finditer(unity_result_pattern, proc.stdout, re.MULTILINE)]
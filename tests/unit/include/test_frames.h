@@ -0,0 +1,83 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#ifndef TEST_FRAMES_H
+#define TEST_FRAMES_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* Frames for the tests of the receive path, sent from a host at 192.168.200.1 to the DUT at 192.168.200.198 */
+
+#define ETH_HEADER_SIZE 14
+#define IP_HEADER_SIZE 20
+#define UDP_HEADER_SIZE 8
+#define TCP_HEADER_SIZE 20
+#define UDP_FRAME_SIZE (ETH_HEADER_SIZE + IP_HEADER_SIZE + UDP_HEADER_SIZE)
+#define TCP_FRAME_SIZE (ETH_HEADER_SIZE + IP_HEADER_SIZE + TCP_HEADER_SIZE)
+
+#define TEST_FRAME_SRC_PORT 1234
+
+/** Set the IPv4 header checksum of a frame after changing its header */
+static inline void test_frame_set_ip_checksum(uint8_t frame[]) {
+  uint8_t *ip = &frame[ETH_HEADER_SIZE];
+  ip[10] = ip[11] = 0;
+  uint32_t sum = 0;
+  for (int i = 0; i < IP_HEADER_SIZE; i += 2) {
+    sum += (uint32_t)((ip[i] << 8) | ip[i + 1]);
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  sum = ~sum & 0xFFFF;
+  ip[10] = (uint8_t)(sum >> 8);
+  ip[11] = (uint8_t)sum;
+}
+
+/** Set the transport destination port of a frame */
+static inline void test_frame_set_dest_port(uint8_t frame[], uint16_t port) {
+  uint8_t *transport = &frame[ETH_HEADER_SIZE + IP_HEADER_SIZE];
+  transport[2] = (uint8_t)(port >> 8);
+  transport[3] = (uint8_t)port;
+}
+
+/** Set the IPv4 destination address of a frame, such as a broadcast or multicast group */
+static inline void test_frame_set_ip_dest(uint8_t frame[], const uint8_t dest[4]) {
+  memcpy(&frame[ETH_HEADER_SIZE + 16], dest, 4);
+  test_frame_set_ip_checksum(frame);
+}
+
+/** Build an IPv4 frame unicast to the DUT with a valid header checksum, and for UDP and TCP a transport header from
+ * TEST_FRAME_SRC_PORT to a port. Only the first TCP_FRAME_SIZE bytes are written.
+ *
+ * \param frame       The buffer to build the frame in.
+ * \param protocol    The IP protocol number.
+ * \param dest_port   The transport destination port, ignored for other protocols.
+ */
+static inline void test_frame_ipv4(uint8_t frame[], uint8_t protocol, uint16_t dest_port) {
+  static const uint8_t eth_header[ETH_HEADER_SIZE] = {
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x02, 0x08, 0x00};
+  static const uint8_t ip_header[IP_HEADER_SIZE] = {
+    0x45, 0x00, 0x00, 0x00, 0x12, 0x34, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+    192, 168, 200, 1, 192, 168, 200, 198};
+
+  memset(frame, 0, TCP_FRAME_SIZE);
+  memcpy(frame, eth_header, sizeof(eth_header));
+  uint8_t *ip = &frame[ETH_HEADER_SIZE];
+  memcpy(ip, ip_header, sizeof(ip_header));
+  ip[3] = IP_HEADER_SIZE + ((protocol == 6) ? TCP_HEADER_SIZE : UDP_HEADER_SIZE);
+  ip[9] = protocol;
+  test_frame_set_ip_checksum(frame);
+
+  if ((protocol == 17) || (protocol == 6)) {
+    uint8_t *transport = &frame[ETH_HEADER_SIZE + IP_HEADER_SIZE];
+    transport[0] = (uint8_t)(TEST_FRAME_SRC_PORT >> 8);
+    transport[1] = (uint8_t)TEST_FRAME_SRC_PORT;
+    test_frame_set_dest_port(frame, dest_port);
+    if (protocol == 6) {
+      transport[12] = (TCP_HEADER_SIZE / 4) << 4;
+    }
+  }
+}
+
+#endif /* TEST_FRAMES_H */
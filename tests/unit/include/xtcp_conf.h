@@ -10,4 +10,49 @@
 
 // #define CONNECTIONS_PER_UDP_PORT 2
 
+// The tests of code built whatever the options are also built with the library's defaults for those below
+#if !UNIT_TEST_DEFAULT_OPTIONS
+
+#define XTCP_ARP_HASH_TABLE_SIZE 16
+
+#define XTCP_CAPTURE_ENABLE 1
+
+#define XTCP_TRACE_ENABLE 1
+
+#define XTCP_TRACE_RECORDS 8
+
+#define XTCP_LOG_DEFERRED 1
+
+#define XTCP_LOG_RECORDS 8
+
+#define XTCP_EVENT_LATENCY_ENABLE 1
+
+#define XTCP_CLIENT_SCHED_ENABLE 1
+
+#define XTCP_PIPELINE_ENABLE 1
+
+#define XTCP_RX_FILTER_ENABLE 1
+
+#define XTCP_UDP_FAST_PATH 1
+
+#define XTCP_RATE_LIMIT_ARP_REQUESTS 50
+
+#define XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS 50
+
+#define XTCP_RATE_LIMIT_ICMP_ECHO 20
+
+#define XTCP_RATE_LIMIT_ICMP_UNREACHABLE 10
+
+#define XTCP_RATE_LIMIT_BROADCAST_UDP 200
+
+#define XTCP_UDP_BATCH_ENABLE 1
+
+#define XTCP_STREAM_ENABLE 1
+
+#define XTCP_HTTP_ENABLE 1
+
+#define XTCP_IPERF_ENABLE 1
+
+#endif /* !UNIT_TEST_DEFAULT_OPTIONS */
+
 #endif /* XTCP_CONF_H */
@@ -0,0 +1,214 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "capture.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "test_frames.h"
+
+#define START_TIME 1000u
+
+static uint8_t frame[1500];
+static uint8_t pcap[XTCP_CAPTURE_READ_MIN + 2048];
+
+static struct netif test_netif;
+static struct netif *saved_netif;
+static unsigned frames_sent;
+
+static err_t test_linkoutput(struct netif *netif, struct pbuf *p) {
+  (void)netif;
+  (void)p;
+  frames_sent++;
+  return ERR_OK;
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static xtcp_capture_filter_t filter_for(uint32_t directions) {
+  xtcp_capture_filter_t filter;
+  memset(&filter, 0, sizeof(filter));
+  filter.directions = directions;
+  return filter;
+}
+
+void setUp() {
+  saved_netif = netif_default;
+  memset(&test_netif, 0, sizeof(test_netif));
+  test_netif.linkoutput = test_linkoutput;
+  netif_default = &test_netif;
+  frames_sent = 0;
+  capture_init();
+  memset(frame, 0, sizeof(frame));
+  test_frame_ipv4(frame, 17, 5000);
+}
+
+void tearDown() {
+  capture_stop();
+  netif_default = saved_netif;
+}
+
+void test_read_starts_with_pcap_header(void) {
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_RX);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME + 150000123);
+
+  int32_t n = capture_read(pcap, sizeof(pcap));
+  TEST_ASSERT_EQUAL(XTCP_CAPTURE_PCAP_HEADER_LENGTH + XTCP_CAPTURE_RECORD_HEADER_LENGTH + UDP_FRAME_SIZE, n);
+  TEST_ASSERT_EQUAL_HEX32(0xA1B23C4D, get_le32(&pcap[0]));
+  TEST_ASSERT_EQUAL(XTCP_CAPTURE_SNAPLEN, get_le32(&pcap[16]));
+  TEST_ASSERT_EQUAL(1, get_le32(&pcap[20]));
+
+  // Timestamps are nanoseconds since the capture started
+  const uint8_t *record = &pcap[XTCP_CAPTURE_PCAP_HEADER_LENGTH];
+  TEST_ASSERT_EQUAL(1, get_le32(&record[0]));
+  TEST_ASSERT_EQUAL(500001230, get_le32(&record[4]));
+  TEST_ASSERT_EQUAL(UDP_FRAME_SIZE, get_le32(&record[8]));
+  TEST_ASSERT_EQUAL(UDP_FRAME_SIZE, get_le32(&record[12]));
+  TEST_ASSERT_EQUAL_MEMORY(frame, &record[XTCP_CAPTURE_RECORD_HEADER_LENGTH], UDP_FRAME_SIZE);
+
+  // The header is only sent once
+  TEST_ASSERT_EQUAL(0, capture_read(pcap, sizeof(pcap)));
+}
+
+void test_long_frames_are_truncated(void) {
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_RX);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  capture_rx(frame, 1000, START_TIME);
+
+  TEST_ASSERT_EQUAL(XTCP_CAPTURE_READ_MIN, capture_read(pcap, sizeof(pcap)));
+  const uint8_t *record = &pcap[XTCP_CAPTURE_PCAP_HEADER_LENGTH];
+  TEST_ASSERT_EQUAL(XTCP_CAPTURE_SNAPLEN, get_le32(&record[8]));
+  TEST_ASSERT_EQUAL(1000, get_le32(&record[12]));
+  TEST_ASSERT_EQUAL(1, capture_get_stats().truncated);
+}
+
+void test_filter_selects_port_and_ignores_port(void) {
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_RX);
+  filter.ip_protocol = 17;
+  filter.port = 5000;
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+  test_frame_set_dest_port(frame, 5001);
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+
+  xtcp_capture_stats_t stats = capture_get_stats();
+  TEST_ASSERT_EQUAL(1, stats.captured);
+  TEST_ASSERT_EQUAL(1, stats.filtered);
+
+  // Frames for the port the capture is read out over are never kept
+  filter = filter_for(XTCP_CAPTURE_RX);
+  filter.ignore_port = 5001;
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+  test_frame_set_dest_port(frame, 5000);
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+  TEST_ASSERT_EQUAL(1, capture_get_stats().captured);
+}
+
+void test_filter_on_address_rejects_arp(void) {
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_RX);
+  filter.ipaddr[0] = 192;
+  filter.ipaddr[1] = 168;
+  filter.ipaddr[2] = 200;
+  filter.ipaddr[3] = 1;
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+  frame[12] = 0x08;
+  frame[13] = 0x06;
+  capture_rx(frame, 42, START_TIME);
+  TEST_ASSERT_EQUAL(1, capture_get_stats().captured);
+}
+
+void test_sent_frames_are_captured_through_linkoutput(void) {
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_TX);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  TEST_ASSERT_TRUE(test_netif.linkoutput != test_linkoutput);
+
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, UDP_FRAME_SIZE, PBUF_RAM);
+  memcpy(p->payload, frame, UDP_FRAME_SIZE);
+  TEST_ASSERT_EQUAL(ERR_OK, test_netif.linkoutput(&test_netif, p));
+  TEST_ASSERT_EQUAL(1, frames_sent);
+  // Received frames are not selected
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+
+  capture_stop();
+  TEST_ASSERT_TRUE(test_netif.linkoutput == test_linkoutput);
+  (void)pbuf_free(p);
+
+  xtcp_capture_stats_t stats = capture_get_stats();
+  TEST_ASSERT_FALSE(stats.running);
+  TEST_ASSERT_EQUAL(1, stats.captured);
+  TEST_ASSERT_EQUAL(1, stats.filtered);
+  // What was captured can be read once stopped
+  TEST_ASSERT_EQUAL(XTCP_CAPTURE_PCAP_HEADER_LENGTH + XTCP_CAPTURE_RECORD_HEADER_LENGTH + UDP_FRAME_SIZE,
+                    capture_read(pcap, sizeof(pcap)));
+}
+
+void test_full_ring_overwrites_oldest(void) {
+  const uint32_t record = XTCP_CAPTURE_RECORD_HEADER_LENGTH + UDP_FRAME_SIZE;
+  const uint32_t frames = (XTCP_CAPTURE_RING_BYTES / record) + 10;
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_RX);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, START_TIME));
+  for (uint32_t i = 0; i < frames; ++i) {
+    // Number each frame in its UDP payload
+    memcpy(&frame[UDP_FRAME_SIZE - 4], &i, sizeof(i));
+    capture_rx(frame, UDP_FRAME_SIZE, START_TIME + i);
+  }
+
+  xtcp_capture_stats_t stats = capture_get_stats();
+  TEST_ASSERT_EQUAL(frames, stats.captured);
+  TEST_ASSERT_EQUAL(10, stats.overwritten);
+  TEST_ASSERT_EQUAL((frames - 10) * record, stats.pending_bytes);
+
+  // Reads return whole records, oldest first
+  uint32_t expected = 10;
+  uint32_t offset = XTCP_CAPTURE_PCAP_HEADER_LENGTH;
+  int32_t n;
+  while ((n = capture_read(pcap, XTCP_CAPTURE_READ_MIN + 100)) > 0) {
+    for (; offset < (uint32_t)n; offset += record) {
+      uint32_t number;
+      memcpy(&number, &pcap[offset + record - 4], sizeof(number));
+      TEST_ASSERT_EQUAL(expected++, number);
+    }
+    offset = 0;
+  }
+  TEST_ASSERT_EQUAL(frames, expected);
+  TEST_ASSERT_EQUAL(0, capture_get_stats().pending_bytes);
+}
+
+void test_timestamps_survive_timer_wrap(void) {
+  const uint32_t start = 0xFFFFFFFFu - 100;
+  xtcp_capture_filter_t filter = filter_for(XTCP_CAPTURE_RX);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, capture_start(&filter, start));
+  for (uint32_t s = 1; s <= 100; ++s) {
+    capture_tick(start + s * 100000000u);
+  }
+  capture_rx(frame, UDP_FRAME_SIZE, start + 100u * 100000000u);
+  // A frame received just before the last one keeps its place in time
+  capture_rx(frame, UDP_FRAME_SIZE, start + 100u * 100000000u - 1000);
+
+  TEST_ASSERT_TRUE(capture_read(pcap, sizeof(pcap)) > 0);
+  const uint8_t *record = &pcap[XTCP_CAPTURE_PCAP_HEADER_LENGTH];
+  TEST_ASSERT_EQUAL(100, get_le32(&record[0]));
+  TEST_ASSERT_EQUAL(0, get_le32(&record[4]));
+  record += XTCP_CAPTURE_RECORD_HEADER_LENGTH + UDP_FRAME_SIZE;
+  TEST_ASSERT_EQUAL(99, get_le32(&record[0]));
+  TEST_ASSERT_EQUAL(999990000, get_le32(&record[4]));
+}
+
+void test_invalid_arguments(void) {
+  xtcp_capture_filter_t filter = filter_for(0);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, capture_start(&filter, START_TIME));
+  TEST_ASSERT_FALSE(capture_get_stats().running);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, capture_read(pcap, XTCP_CAPTURE_READ_MIN - 1));
+
+  // Nothing is kept while stopped
+  capture_rx(frame, UDP_FRAME_SIZE, START_TIME);
+  TEST_ASSERT_EQUAL(0, capture_get_stats().captured);
+}
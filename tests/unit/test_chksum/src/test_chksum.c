@@ -0,0 +1,108 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "xtcp_chksum.h"
+
+#define BUFFER_SIZE 1600
+#define NUM_RANDOM_CASES 200
+
+static uint8_t src_buffer[BUFFER_SIZE + 8];
+static uint8_t dst_buffer[BUFFER_SIZE + 8];
+static uint32_t seed;
+
+static uint32_t next_rand(void) {
+  seed = seed * 1664525 + 1013904223;
+  return seed >> 8;
+}
+
+/* Reference: sum of 16-bit words in memory order, the same as lwIP's lwip_standard_chksum() */
+static uint16_t reference_chksum(const uint8_t *data, uint32_t len) {
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i + 1 < len; i += 2) {
+    uint16_t value;
+    memcpy(&value, &data[i], sizeof(value));
+    sum += value;
+  }
+  if (len & 1) {
+    uint16_t value = 0;
+    memcpy(&value, &data[len - 1], 1);
+    sum += value;
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  return (uint16_t)sum;
+}
+
+void setUp() {
+  seed = 1;
+  for (uint32_t i = 0; i < sizeof(src_buffer); ++i) {
+    src_buffer[i] = (uint8_t)next_rand();
+  }
+  memset(dst_buffer, 0, sizeof(dst_buffer));
+}
+void tearDown() {}
+
+void test_chksum_of_empty_buffer_is_zero(void) {
+  TEST_ASSERT_EQUAL(0, xtcp_chksum(src_buffer, 0));
+  TEST_ASSERT_EQUAL(0, xtcp_chksum_copy(dst_buffer, src_buffer, 0));
+}
+
+void test_chksum_of_all_ones_does_not_overflow(void) {
+  memset(src_buffer, 0xFF, BUFFER_SIZE);
+  TEST_ASSERT_EQUAL(reference_chksum(src_buffer, BUFFER_SIZE), xtcp_chksum(src_buffer, BUFFER_SIZE));
+  TEST_ASSERT_EQUAL(reference_chksum(src_buffer, BUFFER_SIZE - 1), xtcp_chksum(src_buffer, BUFFER_SIZE - 1));
+}
+
+void test_chksum_matches_reference_at_every_alignment(void) {
+  for (uint32_t offset = 0; offset < 8; ++offset) {
+    // Covers every remainder of the unrolled word loop
+    for (uint32_t len = 0; len < 100; ++len) {
+      TEST_ASSERT_EQUAL(reference_chksum(&src_buffer[offset], len), xtcp_chksum(&src_buffer[offset], (uint16_t)len));
+    }
+  }
+}
+
+void test_chksum_matches_reference_for_random_lengths(void) {
+  for (uint32_t i = 0; i < NUM_RANDOM_CASES; ++i) {
+    uint32_t offset = next_rand() % 8;
+    uint32_t len = next_rand() % (BUFFER_SIZE + 1);
+    TEST_ASSERT_EQUAL(reference_chksum(&src_buffer[offset], len), xtcp_chksum(&src_buffer[offset], (uint16_t)len));
+  }
+}
+
+void test_chksum_copy_copies_and_matches_reference(void) {
+  for (uint32_t i = 0; i < NUM_RANDOM_CASES; ++i) {
+    uint32_t src_offset = next_rand() % 8;
+    uint32_t dst_offset = next_rand() % 8;
+    uint32_t len = next_rand() % (BUFFER_SIZE + 1);
+    memset(dst_buffer, 0, sizeof(dst_buffer));
+
+    uint16_t sum = xtcp_chksum_copy(&dst_buffer[dst_offset], &src_buffer[src_offset], (uint16_t)len);
+    TEST_ASSERT_EQUAL(reference_chksum(&src_buffer[src_offset], len), sum);
+    TEST_ASSERT_EQUAL_MEMORY(&src_buffer[src_offset], &dst_buffer[dst_offset], len);
+  }
+}
+
+void test_chksum_copy_matches_chksum_at_every_alignment(void) {
+  for (uint32_t src_offset = 0; src_offset < 4; ++src_offset) {
+    for (uint32_t dst_offset = 0; dst_offset < 4; ++dst_offset) {
+      for (uint32_t len = 0; len < 100; ++len) {
+        uint16_t sum = xtcp_chksum_copy(&dst_buffer[dst_offset], &src_buffer[src_offset], (uint16_t)len);
+        TEST_ASSERT_EQUAL(xtcp_chksum(&src_buffer[src_offset], (uint16_t)len), sum);
+        TEST_ASSERT_EQUAL_MEMORY(&src_buffer[src_offset], &dst_buffer[dst_offset], len);
+      }
+    }
+  }
+}
+
+void test_chksum_copy_does_not_write_past_length(void) {
+  memset(dst_buffer, 0xA5, sizeof(dst_buffer));
+  xtcp_chksum_copy(&dst_buffer[1], src_buffer, 13);
+  TEST_ASSERT_EQUAL(0xA5, dst_buffer[0]);
+  TEST_ASSERT_EQUAL(0xA5, dst_buffer[14]);
+}
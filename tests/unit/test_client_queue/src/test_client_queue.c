@@ -3,6 +3,8 @@
 
 #include <unity.h>
 
+#include <xcore/hwtimer.h>
+
 #include "client_queue.h"
 
 #define TEST_CLIENT_NUM 1
@@ -24,6 +26,20 @@ void test_enqueue_and_dequeue_same_data(void) {
   TEST_ASSERT_EQUAL(TEST_INDEX, result.id);
 }
 
+void test_enqueue_length_is_dequeued_with_event(void) {
+  enqueue_event_length_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_SENT_DATA, 1460);
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+
+  client_event_t result = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(XTCP_SENT_DATA, result.xtcp_event);
+  TEST_ASSERT_EQUAL(1460, result.length);
+
+  // Events without a length report zero
+  result = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(XTCP_RECV_DATA, result.xtcp_event);
+  TEST_ASSERT_EQUAL(0, result.length);
+}
+
 void test_enqueue_with_bad_client_num_leaves_queue_unchanged(void) {
   xtcp_event_type_t test_event = XTCP_NEW_CONNECTION;
   enqueue_event_and_notify(TEST_BAD_CLIENT_NUM, TEST_INDEX, test_event);
@@ -149,3 +165,96 @@ void test_free_notifications_remove_all(void) {
   client_event_t result = dequeue_event(TEST_CLIENT_NUM);
   TEST_ASSERT_EQUAL(UNSET, result.id);
 }
+
+void test_free_recv_notifications_keeps_newest(void) {
+  // Setup
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_FROM_DATA);
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+
+  // Test
+  int32_t freed = free_recv_notifications_on_queue(TEST_CLIENT_NUM, TEST_INDEX, 1);
+
+  // Check data
+  TEST_ASSERT_EQUAL(1, freed);
+  client_event_t result = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(XTCP_RECV_DATA, result.xtcp_event);
+  // Queue should now be empty
+  result = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(UNSET, result.id);
+}
+
+void test_free_recv_notifications_leaves_other_events(void) {
+  // Setup
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_TIMED_OUT);
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+
+  // Test
+  int32_t freed = free_recv_notifications_on_queue(TEST_CLIENT_NUM, TEST_INDEX, 0);
+
+  // Check data
+  TEST_ASSERT_EQUAL(1, freed);
+  client_event_t result = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(XTCP_TIMED_OUT, result.xtcp_event);
+  // Queue should now be empty
+  result = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(UNSET, result.id);
+}
+
+void test_queue_stats_count_events_and_high_water(void) {
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+  // Dropped, the queue is full
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+  dequeue_event(TEST_CLIENT_NUM);
+
+  xtcp_client_queue_stats_t stats = client_queue_get_stats(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(2, stats.queued);
+  TEST_ASSERT_EQUAL(1, stats.dropped);
+  TEST_ASSERT_EQUAL(1, stats.depth);
+  TEST_ASSERT_EQUAL(CLIENT_QUEUE_SIZE, stats.high_water);
+
+  stats = client_queue_get_stats(TEST_BAD_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(0, stats.queued);
+}
+
+void test_latency_is_recorded_per_event_type(void) {
+#if XTCP_EVENT_LATENCY_ENABLE
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+  uint32_t start = get_reference_time();
+  while ((uint32_t)(get_reference_time() - start) < 100000) {
+    // At least a millisecond in the queue
+  }
+  dequeue_event(TEST_CLIENT_NUM);
+
+  xtcp_event_latency_t latency = client_queue_get_latency(TEST_CLIENT_NUM, XTCP_RECV_DATA);
+  TEST_ASSERT_EQUAL(1, latency.count);
+  TEST_ASSERT_GREATER_OR_EQUAL(1000, latency.max_us);
+  TEST_ASSERT_EQUAL(latency.max_us, (uint32_t)latency.total_us);
+
+  // A single event is counted in the bucket of its latency, 2^(n-1) to 2^n microseconds
+  uint32_t counted = 0;
+  for (unsigned n = 0; n < XTCP_EVENT_LATENCY_BUCKETS; ++n) {
+    if (latency.buckets[n]) {
+      TEST_ASSERT_GREATER_OR_EQUAL(11, n);
+    }
+    counted += latency.buckets[n];
+  }
+  TEST_ASSERT_EQUAL(1, counted);
+
+  // Other event types and clients are not counted
+  TEST_ASSERT_EQUAL(0, client_queue_get_latency(TEST_CLIENT_NUM, XTCP_SENT_DATA).count);
+  TEST_ASSERT_EQUAL(0, client_queue_get_latency(0, XTCP_RECV_DATA).count);
+  TEST_ASSERT_EQUAL(0, client_queue_get_latency(TEST_BAD_CLIENT_NUM, XTCP_RECV_DATA).count);
+  TEST_ASSERT_EQUAL(0, client_queue_get_latency(TEST_CLIENT_NUM, XTCP_EVENT_TYPES).count);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_EVENT_LATENCY_ENABLE is 0");
+#endif
+}
+
+void test_freed_events_have_no_latency(void) {
+  enqueue_event_and_notify(TEST_CLIENT_NUM, TEST_INDEX, XTCP_RECV_DATA);
+  free_notifications_on_queue(TEST_CLIENT_NUM, TEST_INDEX);
+  dequeue_event(TEST_CLIENT_NUM);
+
+  TEST_ASSERT_EQUAL(0, client_queue_get_latency(TEST_CLIENT_NUM, XTCP_RECV_DATA).count);
+}
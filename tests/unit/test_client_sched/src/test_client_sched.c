@@ -0,0 +1,165 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include "client_queue.h"
+#include "client_sched.h"
+
+#define HIGH_CLIENT 0
+#define NORMAL_CLIENT 1
+#define TEST_INDEX 7
+
+static void configure(unsigned client_num, uint32_t weight, uint32_t priority) {
+  xtcp_client_sched_t sched = {weight, priority};
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, client_sched_set(client_num, sched));
+}
+
+void setUp() {
+  xtcp_init_queue();
+  client_sched_init();
+}
+
+void tearDown() {}
+
+void test_clients_are_served_their_weight_each_round(void) {
+  configure(0, 2, XTCP_PRIORITY_NORMAL);
+  configure(1, 1, XTCP_PRIORITY_NORMAL);
+  TEST_ASSERT_FALSE(client_sched_throttled());
+
+  client_sched_sent(0);
+  TEST_ASSERT_TRUE(client_sched_may_send(0));
+  client_sched_sent(0);
+  TEST_ASSERT_FALSE(client_sched_may_send(0));
+  TEST_ASSERT_TRUE(client_sched_may_send(1));
+  TEST_ASSERT_TRUE(client_sched_throttled());
+
+  // The loop had nothing else to do, so a new round starts
+  client_sched_idle();
+  TEST_ASSERT_TRUE(client_sched_may_send(0));
+  TEST_ASSERT_FALSE(client_sched_throttled());
+}
+
+void test_default_weight_and_zero_weight(void) {
+  for (int i = 0; i < XTCP_CLIENT_WEIGHT; ++i) {
+    TEST_ASSERT_TRUE(client_sched_may_send(0));
+    client_sched_sent(0);
+  }
+  TEST_ASSERT_FALSE(client_sched_may_send(0));
+
+  // A client is always served at least one call a round
+  configure(1, 0, XTCP_PRIORITY_NORMAL);
+  TEST_ASSERT_TRUE(client_sched_may_send(1));
+  client_sched_sent(1);
+  TEST_ASSERT_FALSE(client_sched_may_send(1));
+}
+
+void test_bad_parameters_are_rejected(void) {
+  xtcp_client_sched_t sched = {1, XTCP_PRIORITY_HIGH + 1};
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, client_sched_set(0, sched));
+  sched.priority = XTCP_PRIORITY_NORMAL;
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, client_sched_set(MAX_XTCP_CLIENTS, sched));
+  TEST_ASSERT_FALSE(client_sched_may_send(MAX_XTCP_CLIENTS));
+}
+
+void test_sends_are_held_for_waiting_high_priority_client(void) {
+  configure(HIGH_CLIENT, 1, XTCP_PRIORITY_HIGH);
+  enqueue_event_and_notify(HIGH_CLIENT, TEST_INDEX, XTCP_RECV_DATA);
+
+  for (int i = 0; i < XTCP_CLIENT_PRIORITY_BOUND - 1; ++i) {
+    client_sched_iteration();
+    TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+  }
+  client_sched_iteration();
+  TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+  TEST_ASSERT_TRUE(client_sched_may_send(HIGH_CLIENT));
+  // No client has used its credit, so the loop has no round to end
+  TEST_ASSERT_FALSE(client_sched_throttled());
+
+  // Taking the event releases the hold
+  dequeue_event(HIGH_CLIENT);
+  client_sched_served(HIGH_CLIENT);
+  client_sched_iteration();
+  TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+}
+
+void test_idle_loop_keeps_hold_while_events_are_queued(void) {
+  configure(HIGH_CLIENT, 1, XTCP_PRIORITY_HIGH);
+  configure(NORMAL_CLIENT, 1, XTCP_PRIORITY_NORMAL);
+  enqueue_event_and_notify(HIGH_CLIENT, TEST_INDEX, XTCP_RECV_DATA);
+  for (int i = 0; i < XTCP_CLIENT_PRIORITY_BOUND; ++i) {
+    client_sched_iteration();
+  }
+  TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+
+  // A new round restores credit but the high-priority client's event is still overdue
+  client_sched_sent(HIGH_CLIENT);
+  TEST_ASSERT_TRUE(client_sched_throttled());
+  client_sched_idle();
+  TEST_ASSERT_TRUE(client_sched_may_send(HIGH_CLIENT));
+  TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+  client_sched_iteration();
+  TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+
+  dequeue_event(HIGH_CLIENT);
+  client_sched_served(HIGH_CLIENT);
+  client_sched_iteration();
+  TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+}
+
+void test_normal_priority_events_do_not_hold_sends(void) {
+  enqueue_event_and_notify(HIGH_CLIENT, TEST_INDEX, XTCP_RECV_DATA);
+  for (int i = 0; i < 2 * XTCP_CLIENT_PRIORITY_BOUND; ++i) {
+    client_sched_iteration();
+  }
+  TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+  TEST_ASSERT_FALSE(client_sched_throttled());
+}
+
+void test_hold_is_released_after_hold_max(void) {
+  configure(HIGH_CLIENT, 1, XTCP_PRIORITY_HIGH);
+  // A high-priority client that never takes its events
+  enqueue_event_and_notify(HIGH_CLIENT, TEST_INDEX, XTCP_IFUP);
+  for (int i = 0; i < XTCP_CLIENT_PRIORITY_BOUND; ++i) {
+    client_sched_iteration();
+  }
+  for (int i = 0; i < XTCP_CLIENT_HOLD_MAX; ++i) {
+    TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+    client_sched_iteration();
+  }
+  TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+
+  // The wait then starts again
+  for (int i = 0; i < XTCP_CLIENT_PRIORITY_BOUND - 1; ++i) {
+    client_sched_iteration();
+    TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+  }
+  client_sched_iteration();
+  TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+}
+
+void test_removed_events_release_hold(void) {
+  configure(HIGH_CLIENT, 1, XTCP_PRIORITY_HIGH);
+  enqueue_event_and_notify(HIGH_CLIENT, TEST_INDEX, XTCP_RECV_DATA);
+  for (int i = 0; i < XTCP_CLIENT_PRIORITY_BOUND; ++i) {
+    client_sched_iteration();
+  }
+  TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+
+  // Closing the connection takes its events off the queue
+  TEST_ASSERT_EQUAL(1, free_notifications_on_queue(HIGH_CLIENT, TEST_INDEX));
+  client_sched_iteration();
+  TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+}
+
+void test_round_ends_after_hold_max_without_idle(void) {
+  configure(NORMAL_CLIENT, 1, XTCP_PRIORITY_NORMAL);
+  client_sched_sent(NORMAL_CLIENT);
+  for (int i = 0; i < XTCP_CLIENT_HOLD_MAX - 1; ++i) {
+    client_sched_iteration();
+    TEST_ASSERT_FALSE(client_sched_may_send(NORMAL_CLIENT));
+  }
+  client_sched_iteration();
+  TEST_ASSERT_TRUE(client_sched_may_send(NORMAL_CLIENT));
+  TEST_ASSERT_FALSE(client_sched_throttled());
+}
@@ -102,3 +102,241 @@ void test_set_remote_then_get_remote_matches(void) {
     TEST_ASSERT_EQUAL(PAYLOAD_LENGTH, get_result.value);
     TEST_ASSERT_EQUAL_UINT32(pbuf_payload, test_payload);
 }
+
+void test_new_client_usage_is_empty(void) {
+    xtcp_client_usage_t usage = get_client_usage(TEST_CLIENT_NUM);
+    TEST_ASSERT_EQUAL(0, usage.sockets);
+    TEST_ASSERT_EQUAL(0, usage.rx_bytes);
+    TEST_ASSERT_EQUAL(0, usage.tx_bytes);
+    TEST_ASSERT_EQUAL(0, usage.quota.max_sockets);
+}
+
+void test_socket_quota_reports_enomem_when_full(void) {
+    xtcp_client_quota_t quota = {.max_sockets = 1, .max_rx_bytes = 0, .max_tx_bytes = 0};
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_client_quota(TEST_CLIENT_NUM, quota));
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, connection.status);
+    xtcp_error_int32_t connection2 = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_ENOMEM, connection2.status);
+
+    // Another client is not affected by the quota
+    xtcp_error_int32_t other = assign_client_connection(TEST_CLIENT_NUM + 1, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, other.status);
+
+    TEST_ASSERT_EQUAL(1, get_client_usage(TEST_CLIENT_NUM).sockets);
+}
+
+void test_socket_quota_frees_on_free_connection(void) {
+    xtcp_client_quota_t quota = {.max_sockets = 1, .max_rx_bytes = 0, .max_tx_bytes = 0};
+    (void)set_client_quota(TEST_CLIENT_NUM, quota);
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, connection.status);
+    free_client_connection(connection.value);
+    TEST_ASSERT_EQUAL(0, get_client_usage(TEST_CLIENT_NUM).sockets);
+
+    connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, connection.status);
+}
+
+// A receive quota that holds both a TCP segment and a UDP datagram
+#define RX_QUOTA (TCP_MSS + XTCP_UDP_MAX_DATAGRAM_SIZE)
+
+void test_rx_quota_refuses_pbuf_and_frees_on_release(void) {
+    uint8_t pbuf_payload[PAYLOAD_LENGTH] = {0};
+    struct pbuf first = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = RX_QUOTA};
+    struct pbuf second = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+    xtcp_client_quota_t quota = {.max_sockets = 0, .max_rx_bytes = RX_QUOTA, .max_tx_bytes = 0};
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_client_quota(TEST_CLIENT_NUM, quota));
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_remote(connection.value, NULL, 0, &first));
+    TEST_ASSERT_EQUAL(XTCP_ENOMEM, set_remote(connection.value, NULL, 0, &second));
+    TEST_ASSERT_EQUAL(RX_QUOTA, get_client_usage(TEST_CLIENT_NUM).rx_bytes);
+
+    // Taking the pbuf off the queue returns the bytes to the client
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, unlink_remote(connection.value, &first));
+    TEST_ASSERT_EQUAL(0, get_client_usage(TEST_CLIENT_NUM).rx_bytes);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_remote(connection.value, NULL, 0, &second));
+}
+
+void test_rx_quota_below_one_segment_rejected(void) {
+    xtcp_client_quota_t quota = {.max_sockets = 0, .max_rx_bytes = PAYLOAD_LENGTH, .max_tx_bytes = 0};
+    TEST_ASSERT_EQUAL(XTCP_EINVAL, set_client_quota(TEST_CLIENT_NUM, quota));
+    TEST_ASSERT_EQUAL(0, get_client_usage(TEST_CLIENT_NUM).quota.max_rx_bytes);
+
+    quota.max_rx_bytes = RX_QUOTA;
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_client_quota(TEST_CLIENT_NUM, quota));
+}
+
+void test_rx_quota_takes_pbuf_when_client_holds_nothing(void) {
+    uint8_t pbuf_payload[PAYLOAD_LENGTH] = {0};
+    // lwIP can pass on merged out-of-sequence segments larger than the quota
+    struct pbuf merged = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = 2 * RX_QUOTA};
+    xtcp_client_quota_t quota = {.max_sockets = 0, .max_rx_bytes = RX_QUOTA, .max_tx_bytes = 0};
+    (void)set_client_quota(TEST_CLIENT_NUM, quota);
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_remote(connection.value, NULL, 0, &merged));
+    TEST_ASSERT_EQUAL(2 * RX_QUOTA, get_client_usage(TEST_CLIENT_NUM).rx_bytes);
+}
+
+void test_recv_low_watermark_limited_by_rx_quota(void) {
+    xtcp_client_quota_t quota = {.max_sockets = 0, .max_rx_bytes = RX_QUOTA, .max_tx_bytes = 0};
+    (void)set_client_quota(TEST_CLIENT_NUM, quota);
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_EINVAL, set_recv_lowat(connection.value, RX_QUOTA + 1));
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_recv_lowat(connection.value, RX_QUOTA));
+
+    // Nor can the quota be lowered below a watermark already set
+    quota.max_rx_bytes = RX_QUOTA - 1;
+    TEST_ASSERT_EQUAL(XTCP_EINVAL, set_client_quota(TEST_CLIENT_NUM, quota));
+}
+
+void test_tx_quota_charges_and_releases(void) {
+    xtcp_client_quota_t quota = {.max_sockets = 0, .max_rx_bytes = 0, .max_tx_bytes = 100};
+    (void)set_client_quota(TEST_CLIENT_NUM, quota);
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, charge_tx_bytes(connection.value, 60));
+    TEST_ASSERT_EQUAL(XTCP_ENOMEM, charge_tx_bytes(connection.value, 60));
+    TEST_ASSERT_EQUAL(60, get_client_usage(TEST_CLIENT_NUM).tx_bytes);
+
+    release_tx_bytes(connection.value, 40);
+    TEST_ASSERT_EQUAL(20, get_client_usage(TEST_CLIENT_NUM).tx_bytes);
+
+    // Closing the connection returns any unacknowledged bytes
+    free_client_connection(connection.value);
+    TEST_ASSERT_EQUAL(0, get_client_usage(TEST_CLIENT_NUM).tx_bytes);
+}
+
+void test_chained_udp_datagram_is_received_whole(void) {
+    uint8_t head_payload[PAYLOAD_LENGTH] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t tail_payload[PAYLOAD_LENGTH] = {9, 10, 11, 12, 13, 14, 15, 16};
+    struct pbuf tail = {.payload = tail_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+    struct pbuf head = {.next = &tail, .payload = head_payload, .len = PAYLOAD_LENGTH, .tot_len = 2 * PAYLOAD_LENGTH};
+    uint8_t *test_payload = NULL;
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_remote(connection.value, NULL, 0, &head));
+    TEST_ASSERT_EQUAL(2 * PAYLOAD_LENGTH, get_client_usage(TEST_CLIENT_NUM).rx_bytes);
+
+    // Too small for the whole datagram
+    xtcp_error_int32_t get_result = get_remote_data(connection.value, &test_payload, PAYLOAD_LENGTH, NULL);
+    TEST_ASSERT_EQUAL(XTCP_EAGAIN, get_result.status);
+
+    get_result = get_remote_data(connection.value, &test_payload, 44, NULL);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, get_result.status);
+    TEST_ASSERT_EQUAL(2 * PAYLOAD_LENGTH, get_result.value);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(head_payload, test_payload, PAYLOAD_LENGTH);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tail_payload, &test_payload[PAYLOAD_LENGTH], PAYLOAD_LENGTH);
+}
+
+void test_chained_udp_datagram_is_one_queue_entry(void) {
+    uint8_t pbuf_payload[PAYLOAD_LENGTH] = {0};
+    struct pbuf tail = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+    struct pbuf head = {.next = &tail, .payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = 2 * PAYLOAD_LENGTH};
+    struct pbuf single = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+    (void)set_remote(connection.value, NULL, 0, &head);
+    (void)set_remote(connection.value, NULL, 0, &single);
+    TEST_ASSERT_EQUAL(2, count_remote_data(connection.value));
+
+    // Unlinking the chain leaves the datagram after it queued
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, unlink_remote(connection.value, &head));
+    TEST_ASSERT_EQUAL(1, count_remote_data(connection.value));
+    TEST_ASSERT_NULL(tail.next);
+    TEST_ASSERT_EQUAL(PAYLOAD_LENGTH, get_client_usage(TEST_CLIENT_NUM).rx_bytes);
+}
+
+void test_chained_tcp_data_is_received_one_pbuf_at_a_time(void) {
+    uint8_t pbuf_payload[PAYLOAD_LENGTH] = {0};
+    struct pbuf tail = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+    struct pbuf head = {.next = &tail, .payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = 2 * PAYLOAD_LENGTH};
+    uint8_t *test_payload = NULL;
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    (void)set_remote(connection.value, NULL, 0, &head);
+
+    xtcp_error_int32_t get_result = get_remote_data(connection.value, &test_payload, PAYLOAD_LENGTH, NULL);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, get_result.status);
+    TEST_ASSERT_EQUAL(PAYLOAD_LENGTH, get_result.value);
+    TEST_ASSERT_EQUAL_UINT32(pbuf_payload, test_payload);
+}
+
+void test_recv_events_held_until_low_watermark(void) {
+    uint8_t pbuf_payload[PAYLOAD_LENGTH] = {0};
+    struct pbuf first = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+    struct pbuf second = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_recv_lowat(connection.value, 2 * PAYLOAD_LENGTH));
+
+    (void)set_remote(connection.value, NULL, 0, &first);
+    TEST_ASSERT_EQUAL(0, take_recv_events(connection.value, 1, 0));
+
+    // Both events are released once the queued data reaches the watermark
+    (void)set_remote(connection.value, NULL, 0, &second);
+    TEST_ASSERT_EQUAL(2, take_recv_events(connection.value, 1, 0));
+    TEST_ASSERT_EQUAL(0, take_recv_events(connection.value, 0, 0));
+}
+
+void test_recv_events_released_on_flush(void) {
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    (void)set_recv_lowat(connection.value, PAYLOAD_LENGTH);
+
+    TEST_ASSERT_EQUAL(0, take_recv_events(connection.value, 1, 0));
+    hold_recv_events(connection.value, 1);
+    TEST_ASSERT_EQUAL(2, take_recv_events(connection.value, 0, 1));
+}
+
+void test_recv_low_watermark_limits(void) {
+    xtcp_error_int32_t udp = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+    TEST_ASSERT_EQUAL(XTCP_EINVAL, set_recv_lowat(udp.value, PAYLOAD_LENGTH));
+
+    xtcp_error_int32_t tcp = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_EINVAL, set_recv_lowat(tcp.value, TCP_WND + 1));
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_recv_lowat(tcp.value, TCP_WND));
+    TEST_ASSERT_EQUAL(TCP_WND, get_recv_lowat(tcp.value));
+}
+
+void test_acked_bytes_accumulate_until_cleared(void) {
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+
+    // With no watermark every acknowledgement is due
+    TEST_ASSERT_TRUE(sent_event_due(connection.value, 100));
+    TEST_ASSERT_TRUE(sent_event_due(connection.value, 50));
+    TEST_ASSERT_EQUAL(150, get_acked_bytes(connection.value));
+
+    clear_acked_bytes(connection.value);
+    TEST_ASSERT_EQUAL(0, get_acked_bytes(connection.value));
+}
+
+void test_send_low_watermark_needs_open_connection(void) {
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_send_lowat(connection.value, 1));
+
+    // No pcb, so there is no space and the event is not due
+    arm_writable_event(connection.value);
+    TEST_ASSERT_EQUAL(0, get_tcp_send_space(connection.value));
+    TEST_ASSERT_FALSE(sent_event_due(connection.value, 100));
+    TEST_ASSERT_EQUAL(100, get_acked_bytes(connection.value));
+}
+
+void test_count_remote_bytes_takes_whole_entries(void) {
+    uint8_t pbuf_payload[PAYLOAD_LENGTH] = {0};
+    struct pbuf first = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+    struct pbuf second = {.payload = pbuf_payload, .len = PAYLOAD_LENGTH, .tot_len = PAYLOAD_LENGTH};
+
+    xtcp_error_int32_t connection = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+    TEST_ASSERT_EQUAL(0, count_remote_bytes(connection.value, 100));
+    (void)set_remote(connection.value, NULL, 0, &first);
+    (void)set_remote(connection.value, NULL, 0, &second);
+
+    TEST_ASSERT_EQUAL(2 * PAYLOAD_LENGTH, count_remote_bytes(connection.value, 100));
+    TEST_ASSERT_EQUAL(PAYLOAD_LENGTH, count_remote_bytes(connection.value, 2 * PAYLOAD_LENGTH - 1));
+    TEST_ASSERT_EQUAL(0, count_remote_bytes(connection.value, PAYLOAD_LENGTH - 1));
+}
@@ -0,0 +1,103 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include <xcore/hwtimer.h>
+
+#include "deferred_log.h"
+#include "rate_limit.h"
+#include "xtcp_log.h"
+
+static uint8_t buffer[(XTCP_LOG_RECORDS + 1) * XTCP_LOG_RECORD_LENGTH];
+
+static uint32_t get_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_le16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+void setUp() { deferred_log_init(); }
+
+void tearDown() {}
+
+void test_record_holds_message_and_arguments(void) {
+  DEFERRED_LOG(LOG_TCP_ERR_LOST, XTCP_EINVAL, -14);
+
+  TEST_ASSERT_EQUAL(XTCP_LOG_RECORD_LENGTH, deferred_log_read(buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL(LOG_TCP_ERR_LOST, get_le16(&buffer[4]));
+  TEST_ASSERT_EQUAL(0, get_le16(&buffer[6]));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, (int32_t)get_le32(&buffer[8]));
+  TEST_ASSERT_EQUAL(-14, (int32_t)get_le32(&buffer[12]));
+
+  TEST_ASSERT_EQUAL(0, deferred_log_read(buffer, sizeof(buffer)));
+}
+
+void test_short_buffer_is_rejected(void) {
+  DEFERRED_LOG(LOG_UDP_ENQUEUE_FAILED, XTCP_ENOMEM, 0);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, deferred_log_read(buffer, XTCP_LOG_RECORD_LENGTH - 1));
+  TEST_ASSERT_EQUAL(XTCP_LOG_RECORD_LENGTH, deferred_log_read(buffer, XTCP_LOG_RECORD_LENGTH));
+}
+
+void test_repeats_over_rate_are_counted(void) {
+  for (int i = 0; i < XTCP_LOG_BURST + 3; ++i) {
+    DEFERRED_LOG(LOG_TCP_SENT_DELAYED, i, 0);
+  }
+  // Other messages have their own rate
+  DEFERRED_LOG(LOG_PBUF_ALLOC_FAILED, 0, 1460);
+
+  TEST_ASSERT_EQUAL((XTCP_LOG_BURST + 1) * XTCP_LOG_RECORD_LENGTH, deferred_log_read(buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL(LOG_PBUF_ALLOC_FAILED, get_le16(&buffer[XTCP_LOG_BURST * XTCP_LOG_RECORD_LENGTH + 4]));
+
+  // Once a token is due, the next record of the message carries the repeats suppressed
+  uint32_t start = get_reference_time();
+  while ((uint32_t)(get_reference_time() - start) < RATE_LIMIT_TICKS_PER_SECOND / XTCP_LOG_RATE + 100000) {
+  }
+  DEFERRED_LOG(LOG_TCP_SENT_DELAYED, 99, 0);
+  TEST_ASSERT_EQUAL(XTCP_LOG_RECORD_LENGTH, deferred_log_read(buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL(3, get_le16(&buffer[6]));
+  TEST_ASSERT_EQUAL(99, get_le32(&buffer[8]));
+}
+
+void test_overwritten_records_are_reported_first(void) {
+  // Three messages of a burst each overflow the ring
+  for (int i = 0; i < XTCP_LOG_BURST; ++i) {
+    DEFERRED_LOG(LOG_TCP_CLOSE_LOST, i, 0);
+    DEFERRED_LOG(LOG_TCP_SENT_DELAYED, i, 0);
+    DEFERRED_LOG(LOG_UDP_DATAGRAM_DROPPED, i, 0);
+  }
+
+  uint32_t lost = 3 * XTCP_LOG_BURST - XTCP_LOG_RECORDS;
+  TEST_ASSERT_EQUAL((XTCP_LOG_RECORDS + 1) * XTCP_LOG_RECORD_LENGTH, deferred_log_read(buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL(LOG_LOST, get_le16(&buffer[4]));
+  TEST_ASSERT_EQUAL(lost, get_le32(&buffer[8]));
+
+  // The oldest record remaining follows, the second round's SENT message
+  TEST_ASSERT_EQUAL(LOG_TCP_SENT_DELAYED, get_le16(&buffer[XTCP_LOG_RECORD_LENGTH + 4]));
+  TEST_ASSERT_EQUAL(1, get_le32(&buffer[XTCP_LOG_RECORD_LENGTH + 8]));
+  TEST_ASSERT_EQUAL(0, deferred_log_read(buffer, sizeof(buffer)));
+}
+
+void test_format_record_as_text(void) {
+  uint8_t record[XTCP_LOG_RECORD_LENGTH] = {
+      0x00, 0x61, 0xBC, 0x00,  // 12345600 ticks
+      LOG_TCP_ERR_LOST, 0,
+      2, 0,                    // repeats
+      0xFD, 0xFF, 0xFF, 0xFF,  // -3
+      0xF2, 0xFF, 0xFF, 0xFF,  // -14
+  };
+  char text[XTCP_LOG_TEXT_LENGTH];
+
+  const char *expected = "[    123456] lwip_tcp_event: ERR event lost: -3 (-14) (repeated 2 times)";
+  TEST_ASSERT_EQUAL(strlen(expected), xtcp_log_format(record, text, sizeof(text)));
+  TEST_ASSERT_EQUAL_STRING(expected, text);
+
+  // Text is truncated to the buffer
+  TEST_ASSERT_EQUAL(15, xtcp_log_format(record, text, 16));
+  TEST_ASSERT_EQUAL_STRING("[    123456] lw", text);
+
+  record[4] = LOG_MESSAGES;
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_log_format(record, text, sizeof(text)));
+}
@@ -0,0 +1,197 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "client_queue.h"
+#include "connection.h"
+#include "direct_client.h"
+#include "static_arp.h"
+#include "tx_pool.h"
+#include "udp_recv.h"
+#include "xtcp_direct.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "netif/ethernet.h"
+
+#define LOCAL_PORT 5000
+#define REMOTE_PORT 6000
+
+#define UDP_PAYLOAD_OFFSET (14 + 20 + 8)
+
+static struct netif netif;
+static ip4_addr_t peer;
+static const uint8_t our_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t peer_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+static uint8_t frame[ETHERNET_MAX_PACKET_SIZE];
+static uint32_t frame_count;
+
+/* What the callbacks were last given */
+static int32_t recv_id;
+static uint8_t recv_data[64];
+static uint16_t recv_length;
+static uint16_t recv_port;
+static uint32_t sent_length;
+static xtcp_event_type_t close_event;
+static int callback_arg;
+
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t capture_linkoutput(struct netif *n, struct pbuf *p) {
+  (void)n;
+  pbuf_copy_partial(p, frame, p->tot_len, 0);
+  frame_count++;
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t test_netif_init(struct netif *n) {
+  n->hwaddr_len = ETH_HWADDR_LEN;
+  memcpy(n->hwaddr, our_mac, ETH_HWADDR_LEN);
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+  n->output = etharp_output;
+  n->linkoutput = capture_linkoutput;
+  return ERR_OK;
+}
+
+/* Replies to each datagram from inside the receive callback */
+__attribute__((fptrgroup("xtcp_c_recv_fn")))
+static void echo_recv(void *arg, int32_t id, const struct pbuf *p, const xtcp_ipaddr_t addr, uint16_t port) {
+  TEST_ASSERT_EQUAL_PTR(&callback_arg, arg);
+  recv_id = id;
+  recv_length = pbuf_copy_partial(p, recv_data, sizeof(recv_data), 0);
+  recv_port = port;
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_c_sendto(id, recv_data, recv_length, (uint8_t *)addr, port));
+}
+
+__attribute__((fptrgroup("xtcp_c_sent_fn")))
+static void record_sent(void *arg, int32_t id, uint32_t length) {
+  (void)arg;
+  (void)id;
+  sent_length = length;
+}
+
+__attribute__((fptrgroup("xtcp_c_close_fn")))
+static void record_close(void *arg, int32_t id, xtcp_event_type_t event) {
+  (void)arg;
+  (void)id;
+  close_event = event;
+}
+
+static const xtcp_c_callbacks_t test_callbacks = {
+    .on_accept = NULL,
+    .on_connect = NULL,
+    .on_recv = echo_recv,
+    .on_sent = record_sent,
+    .on_close = record_close,
+};
+
+void setUp() {
+  static int initialised = 0;
+  if (!initialised) {
+    ip4_addr_t ipaddr, netmask, gw;
+    IP4_ADDR(&ipaddr, 192, 168, 200, 198);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    IP4_ADDR(&gw, 192, 168, 200, 1);
+
+    lwip_init();
+    netif_add(&netif, &ipaddr, &netmask, &gw, NULL, test_netif_init, ethernet_input);
+    netif_set_default(&netif);
+    netif_set_up(&netif);
+    netif_set_link_up(&netif);
+    static_arp_init();
+    initialised = 1;
+  }
+
+  init_client_connections();
+  xtcp_init_queue();
+  tx_pool_init();
+  direct_client_init();
+  frame_count = 0;
+  recv_id = -1;
+  recv_length = 0;
+  sent_length = 0;
+  close_event = XTCP_EVENT_NONE;
+
+  IP4_ADDR(&peer, 192, 168, 200, 2);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add((const uint8_t *)&peer, peer_mac));
+}
+
+void tearDown() {
+  (void)static_arp_remove((const uint8_t *)&peer);
+}
+
+void test_udp_datagram_is_answered_from_callback(void) {
+  xtcp_ipaddr_t any = {0, 0, 0, 0};
+  xtcp_error_int32_t socket = xtcp_c_socket(XTCP_PROTOCOL_UDP, &test_callbacks, &callback_arg);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, socket.status);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_c_listen(socket.value, LOCAL_PORT, any));
+
+  struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 5, PBUF_RAM);
+  memcpy(p->payload, "hello", 5);
+  pbuf_ref(p);
+  xtcp_udp_recv((void *)socket.value, get_udp_pcb(socket.value), p, &peer, REMOTE_PORT);
+
+  TEST_ASSERT_EQUAL(socket.value, recv_id);
+  TEST_ASSERT_EQUAL(5, recv_length);
+  TEST_ASSERT_EQUAL(REMOTE_PORT, recv_port);
+
+  // The reply left before the receive returned, and the datagram was not queued
+  TEST_ASSERT_EQUAL(1, frame_count);
+  TEST_ASSERT_EQUAL_MEMORY("hello", &frame[UDP_PAYLOAD_OFFSET], 5);
+  TEST_ASSERT_EQUAL(1, p->ref);
+  TEST_ASSERT_EQUAL(0, count_remote_data(socket.value));
+  for (unsigned client_num = 0; client_num < MAX_XTCP_CLIENTS; ++client_num) {
+    TEST_ASSERT_EQUAL(XTCP_EVENT_NONE, dequeue_event(client_num).xtcp_event);
+  }
+  pbuf_free(p);
+  xtcp_c_close(socket.value);
+}
+
+void test_direct_socket_is_not_visible_to_interface_clients(void) {
+  xtcp_error_int32_t socket = xtcp_c_socket(XTCP_PROTOCOL_UDP, &test_callbacks, NULL);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, socket.status);
+
+  for (unsigned client_num = 0; client_num < MAX_XTCP_CLIENTS; ++client_num) {
+    TEST_ASSERT_EQUAL(XTCP_EINVAL, find_client_connection(client_num, socket.value).status);
+  }
+  xtcp_c_close(socket.value);
+  TEST_ASSERT_FALSE(is_active(socket.value).value);
+}
+
+void test_tcp_events_call_callbacks(void) {
+  xtcp_error_int32_t socket = xtcp_c_socket(XTCP_PROTOCOL_TCP, &test_callbacks, NULL);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, socket.status);
+  struct tcp_pcb *pcb = get_tcp_pcb(socket.value);
+
+  TEST_ASSERT_EQUAL(ERR_OK, lwip_tcp_event((void *)socket.value, pcb, LWIP_EVENT_SENT, NULL, 100, ERR_OK));
+  TEST_ASSERT_EQUAL(100, sent_length);
+
+  // A reset connection has its socket freed after the callback
+  TEST_ASSERT_EQUAL(ERR_OK, lwip_tcp_event((void *)socket.value, NULL, LWIP_EVENT_ERR, NULL, 0, ERR_RST));
+  TEST_ASSERT_EQUAL(XTCP_TIMED_OUT, close_event);
+  TEST_ASSERT_FALSE(is_active(socket.value).value);
+  tcp_close(pcb);
+}
+
+void test_send_checks_socket(void) {
+  xtcp_ipaddr_t addr = {192, 168, 200, 2};
+  uint8_t data[4] = {0};
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_c_send(-1, data, sizeof(data)));
+
+  xtcp_error_int32_t tcp = xtcp_c_socket(XTCP_PROTOCOL_TCP, &test_callbacks, NULL);
+  TEST_ASSERT_EQUAL(XTCP_EPROTONOSUPPORT, xtcp_c_sendto(tcp.value, data, sizeof(data), addr, REMOTE_PORT));
+  xtcp_c_close(tcp.value);
+
+  // Sockets of interface clients cannot be used through the direct API
+  xtcp_error_int32_t owned = assign_client_connection(0, XTCP_PROTOCOL_UDP);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_c_send(owned.value, data, sizeof(data)));
+}
@@ -0,0 +1,243 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "xtcp_http.h"
+
+#define INDEX_REGION 3
+#define INDEX_LENGTH 94
+
+static xtcp_http_response_t response;
+
+static void receive(void *conn, const char *data) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_http_received(conn, (const uint8_t *)data, strlen(data)));
+}
+
+/* Build the next response and check its status line */
+static void expect_response(void *conn, const char *status) {
+  TEST_ASSERT_TRUE(xtcp_http_next(conn, &response));
+  uint32_t length = strlen(status);
+  TEST_ASSERT_TRUE(response.header_length > length);
+  TEST_ASSERT_EQUAL_MEMORY(status, response.header, length);
+}
+
+static int header_has(const char *text) {
+  uint32_t length = strlen(text);
+  for (uint32_t i = 0; i + length <= response.header_length; ++i) {
+    if (memcmp(&response.header[i], text, length) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void setUp() {
+  xtcp_http_init();
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_http_add_resource("/", "text/html", INDEX_REGION, 0, INDEX_LENGTH));
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_http_add_resource("/empty", "text/plain", INDEX_REGION, 0, 0));
+}
+
+void tearDown() {}
+
+void test_request_split_across_segments(void) {
+  void *conn = xtcp_http_open(1);
+  TEST_ASSERT_NOT_NULL(conn);
+
+  receive(conn, "GET / HT");
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+  TEST_ASSERT_TRUE(xtcp_http_wants_data(conn));
+  receive(conn, "TP/1.1\r\nHost: x\r");
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+  receive(conn, "\n\r\n");
+
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_TRUE(header_has("Content-Length: 94\r\n"));
+  TEST_ASSERT_FALSE(header_has("Connection:"));
+  TEST_ASSERT_EQUAL(INDEX_REGION, response.region);
+  TEST_ASSERT_EQUAL(INDEX_LENGTH, response.length);
+  TEST_ASSERT_FALSE(response.close);
+  TEST_ASSERT_FALSE(xtcp_http_wants_data(conn));
+
+  // The body is sent before the next request is taken
+  xtcp_http_commit(conn);
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+  TEST_ASSERT_FALSE(xtcp_http_wants_data(conn));
+  TEST_ASSERT_FALSE(xtcp_http_sent(conn));
+  TEST_ASSERT_TRUE(xtcp_http_wants_data(conn));
+  xtcp_http_close(conn);
+}
+
+void test_pipelined_requests_are_answered_in_order_on_one_connection(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET /missing HTTP/1.1\r\n\r\nHEAD / HTTP/1.1\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+
+  expect_response(conn, "HTTP/1.1 404 Not Found\r\n");
+  TEST_ASSERT_EQUAL(0, response.length);
+  xtcp_http_commit(conn);
+
+  // HEAD has the headers of a GET, without the body
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_TRUE(header_has("Content-Length: 94\r\n"));
+  TEST_ASSERT_EQUAL(0, response.length);
+  xtcp_http_commit(conn);
+
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_EQUAL(INDEX_LENGTH, response.length);
+  xtcp_http_commit(conn);
+  (void)xtcp_http_sent(conn);
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+
+  xtcp_http_stats_t stats = xtcp_http_get_stats();
+  TEST_ASSERT_EQUAL(1, stats.connections);
+  TEST_ASSERT_EQUAL(3, stats.requests);
+  TEST_ASSERT_EQUAL(2, stats.reused);
+  TEST_ASSERT_EQUAL(1, stats.errors);
+  xtcp_http_close(conn);
+}
+
+void test_unsent_header_is_built_again(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET /empty HTTP/1.1\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  // Not committed, as if send() returned XTCP_EAGAIN
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_TRUE(header_has("Content-Length: 0\r\n"));
+  xtcp_http_commit(conn);
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+  TEST_ASSERT_EQUAL(1, xtcp_http_get_stats().requests);
+  xtcp_http_close(conn);
+}
+
+void test_connection_close_and_http_1_0(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET / HTTP/1.1\r\nConnection: Close\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_TRUE(response.close);
+  TEST_ASSERT_TRUE(header_has("Connection: close\r\n"));
+  xtcp_http_commit(conn);
+  TEST_ASSERT_TRUE(xtcp_http_sent(conn));
+  xtcp_http_close(conn);
+
+  // HTTP/1.0 closes unless asked to keep the connection, and is then told it stays open
+  conn = xtcp_http_open(2);
+  receive(conn, "GET / HTTP/1.0\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_TRUE(response.close);
+  xtcp_http_close(conn);
+
+  conn = xtcp_http_open(3);
+  receive(conn, "GET / HTTP/1.0\r\nconnection: keep-alive\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_FALSE(response.close);
+  TEST_ASSERT_TRUE(header_has("Connection: keep-alive\r\n"));
+  xtcp_http_close(conn);
+}
+
+void test_request_body_is_skipped(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET /empty HTTP/1.1\r\nContent-Length: 10\r\n\r\n0123");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  xtcp_http_commit(conn);
+  receive(conn, "456789GET / HTTP/1.1\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  TEST_ASSERT_EQUAL(INDEX_LENGTH, response.length);
+  xtcp_http_close(conn);
+}
+
+void test_malformed_requests_close_the_connection(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET index.html HTTP/1.1\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 400 Bad Request\r\n");
+  TEST_ASSERT_TRUE(response.close);
+  xtcp_http_close(conn);
+
+  conn = xtcp_http_open(2);
+  receive(conn, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 501 Not Implemented\r\n");
+  TEST_ASSERT_TRUE(response.close);
+  xtcp_http_close(conn);
+
+  // A method without a body keeps the connection
+  conn = xtcp_http_open(3);
+  receive(conn, "DELETE / HTTP/1.1\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 405 Method Not Allowed\r\n");
+  TEST_ASSERT_FALSE(response.close);
+  xtcp_http_close(conn);
+}
+
+void test_oversize_request_is_refused(void) {
+  static char line[XTCP_HTTP_REQUEST_MAX + 1];
+  memset(line, 'a', XTCP_HTTP_REQUEST_MAX);
+  line[XTCP_HTTP_REQUEST_MAX] = '\0';
+
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET / HTTP/1.1\r\nCookie: ");
+  receive(conn, line);
+  expect_response(conn, "HTTP/1.1 431 ");
+  TEST_ASSERT_TRUE(response.close);
+  xtcp_http_commit(conn);
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+  xtcp_http_close(conn);
+}
+
+void test_received_data_is_deferred_while_a_body_is_sent(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET / HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_FALSE(xtcp_http_wants_data(conn));
+  xtcp_http_defer(conn);
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  xtcp_http_commit(conn);
+  TEST_ASSERT_FALSE(xtcp_http_take_deferred(conn));
+
+  TEST_ASSERT_FALSE(xtcp_http_sent(conn));
+  TEST_ASSERT_TRUE(xtcp_http_take_deferred(conn));
+  TEST_ASSERT_FALSE(xtcp_http_take_deferred(conn));
+  xtcp_http_close(conn);
+}
+
+void test_remote_close_waits_for_the_body(void) {
+  void *conn = xtcp_http_open(1);
+  receive(conn, "GET / HTTP/1.1\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+  expect_response(conn, "HTTP/1.1 200 OK\r\n");
+  xtcp_http_commit(conn);
+  TEST_ASSERT_FALSE(xtcp_http_remote_closed(conn));
+  TEST_ASSERT_TRUE(xtcp_http_sent(conn));
+  // The pipelined request is not answered
+  TEST_ASSERT_FALSE(xtcp_http_next(conn, &response));
+  xtcp_http_close(conn);
+}
+
+void test_pool_exhaustion_and_reuse(void) {
+  void *conns[XTCP_HTTP_MAX_CONNECTIONS];
+  for (int32_t i = 0; i < XTCP_HTTP_MAX_CONNECTIONS; ++i) {
+    conns[i] = xtcp_http_open(i);
+    TEST_ASSERT_NOT_NULL(conns[i]);
+    TEST_ASSERT_TRUE(xtcp_http_owns(conns[i]));
+  }
+  TEST_ASSERT_NULL(xtcp_http_open(XTCP_HTTP_MAX_CONNECTIONS));
+  TEST_ASSERT_EQUAL(1, xtcp_http_get_stats().rejected);
+
+  TEST_ASSERT_EQUAL_PTR(conns[2], xtcp_http_find(2));
+  xtcp_http_close(conns[2]);
+  TEST_ASSERT_FALSE(xtcp_http_owns(conns[2]));
+  TEST_ASSERT_NULL(xtcp_http_find(2));
+  // Closing twice does not free the state twice
+  xtcp_http_close(conns[2]);
+
+  void *reused = xtcp_http_open(100);
+  TEST_ASSERT_EQUAL_PTR(conns[2], reused);
+  TEST_ASSERT_NULL(xtcp_http_open(101));
+  TEST_ASSERT_FALSE(xtcp_http_owns(&response));
+}
+
+void test_resources_are_checked(void) {
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_http_add_resource("index.html", "text/html", 0, 0, 1));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_http_add_resource("/index.html", "text/html", -1, 0, 1));
+  for (uint32_t i = 2; i < XTCP_HTTP_MAX_RESOURCES; ++i) {
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_http_add_resource("/x", "text/html", 0, 0, 1));
+  }
+  TEST_ASSERT_EQUAL(XTCP_ENOMEM, xtcp_http_add_resource("/x", "text/html", 0, 0, 1));
+}
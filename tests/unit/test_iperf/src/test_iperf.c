@@ -0,0 +1,145 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "xtcp_iperf.h"
+
+#define TICKS_PER_MS 100000u
+#define MS(n) ((uint32_t)(n) * TICKS_PER_MS)
+
+#define MAX_REPORTS 16
+
+static xtcp_iperf_report_t reports[MAX_REPORTS];
+static unsigned num_reports;
+
+/* Replaces the weak function printing the reports */
+void xtcp_iperf_report(const xtcp_iperf_report_t *report) {
+  TEST_ASSERT_TRUE(num_reports < MAX_REPORTS);
+  reports[num_reports++] = *report;
+}
+
+void setUp() {
+  xtcp_iperf_init();
+  num_reports = 0;
+}
+
+void tearDown() {}
+
+void test_server_reports_each_interval(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(3, XTCP_IPERF_SERVER, 0, 0));
+  xtcp_iperf_count(3, 125000, MS(500));
+  TEST_ASSERT_EQUAL(-1, xtcp_iperf_tick(MS(999)));
+  TEST_ASSERT_EQUAL(0, num_reports);
+
+  // Bytes counted after the end of an interval belong to the next
+  xtcp_iperf_count(3, 250000, MS(1200));
+  TEST_ASSERT_EQUAL(1, num_reports);
+  TEST_ASSERT_EQUAL(0, reports[0].start_ms);
+  TEST_ASSERT_EQUAL(1000, reports[0].end_ms);
+  TEST_ASSERT_EQUAL(125000, reports[0].bytes);
+  TEST_ASSERT_EQUAL(1000, reports[0].kbits_per_second);
+  TEST_ASSERT_FALSE(reports[0].final);
+  TEST_ASSERT_EQUAL(XTCP_IPERF_SERVER, reports[0].role);
+  TEST_ASSERT_EQUAL(3, reports[0].id);
+
+  xtcp_iperf_close(3, MS(1500));
+  TEST_ASSERT_EQUAL(3, num_reports);
+  TEST_ASSERT_EQUAL(1000, reports[1].start_ms);
+  TEST_ASSERT_EQUAL(1500, reports[1].end_ms);
+  TEST_ASSERT_EQUAL(4000, reports[1].kbits_per_second);
+  TEST_ASSERT_TRUE(reports[2].final);
+  TEST_ASSERT_EQUAL(0, reports[2].start_ms);
+  TEST_ASSERT_EQUAL(1500, reports[2].end_ms);
+  TEST_ASSERT_EQUAL(375000, reports[2].bytes);
+  TEST_ASSERT_EQUAL(2000, reports[2].kbits_per_second);
+  TEST_ASSERT_FALSE(xtcp_iperf_has_session(3));
+}
+
+void test_idle_intervals_are_reported(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(1, XTCP_IPERF_SERVER, 0, 0));
+  TEST_ASSERT_EQUAL(-1, xtcp_iperf_tick(MS(3000)));
+  TEST_ASSERT_EQUAL(3, num_reports);
+  TEST_ASSERT_EQUAL(2000, reports[2].start_ms);
+  TEST_ASSERT_EQUAL(0, reports[2].bytes);
+}
+
+void test_session_time_survives_timer_wrap(void) {
+  uint32_t start = 0xFFFFFFFFu - MS(200);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(1, XTCP_IPERF_SERVER, start, 0));
+  xtcp_iperf_count(1, 1000, start + MS(600));
+  TEST_ASSERT_EQUAL(-1, xtcp_iperf_tick(start + MS(1000)));
+  TEST_ASSERT_EQUAL(1, num_reports);
+  TEST_ASSERT_EQUAL(1000, reports[0].bytes);
+}
+
+void test_client_expires_once(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(5, XTCP_IPERF_CLIENT, 0, 2000));
+  TEST_ASSERT_FALSE(xtcp_iperf_done(5, MS(1999)));
+  TEST_ASSERT_TRUE(xtcp_iperf_done(5, MS(2000)));
+  TEST_ASSERT_EQUAL(5, xtcp_iperf_tick(MS(2000)));
+  TEST_ASSERT_EQUAL(-1, xtcp_iperf_tick(MS(2001)));
+
+  // A server never expires
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(6, XTCP_IPERF_SERVER, 0, 1));
+  TEST_ASSERT_FALSE(xtcp_iperf_done(6, MS(5000)));
+}
+
+void test_sessions_are_limited(void) {
+  for (int32_t id = 0; id < XTCP_IPERF_MAX_SESSIONS; ++id) {
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(id, XTCP_IPERF_SERVER, 0, 0));
+  }
+  TEST_ASSERT_EQUAL(XTCP_ENOMEM, xtcp_iperf_open(XTCP_IPERF_MAX_SESSIONS, XTCP_IPERF_SERVER, 0, 0));
+  xtcp_iperf_close(0, MS(1));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_iperf_open(1, XTCP_IPERF_SERVER, 0, 0));
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(XTCP_IPERF_MAX_SESSIONS, XTCP_IPERF_SERVER, 0, 0));
+}
+
+void test_client_header_matches_iperf2(void) {
+  uint8_t header[XTCP_IPERF_HEADER_LENGTH];
+  const uint8_t expected[XTCP_IPERF_HEADER_LENGTH] = {
+      0x00, 0x00, 0x00, 0x00,  // flags, no test in the other direction
+      0x00, 0x00, 0x00, 0x01,  // threads
+      0x00, 0x00, 0x13, 0x89,  // port 5001
+      0x00, 0x00, 0x00, 0x00,  // buffer length
+      0x00, 0x00, 0x00, 0x00,  // window/bandwidth
+      0xFF, 0xFF, 0xFC, 0x18,  // -1000, ten seconds in 10ms units
+  };
+  xtcp_iperf_client_header(header, 10000);
+  TEST_ASSERT_EQUAL_MEMORY(expected, header, sizeof(expected));
+}
+
+/* A client session sending to a server session stand-in agree on what was moved */
+void test_client_and_server_agree(void) {
+  uint8_t buffer[XTCP_IPERF_BUFFER];
+  uint8_t header[XTCP_IPERF_HEADER_LENGTH];
+  uint32_t now = 0;
+
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(1, XTCP_IPERF_CLIENT, now, 1000));
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, xtcp_iperf_open(2, XTCP_IPERF_SERVER, now, 0));
+  xtcp_iperf_client_header(header, 1000);
+  xtcp_iperf_count(1, sizeof(header), now);
+  xtcp_iperf_count(2, sizeof(header), now);
+
+  xtcp_iperf_fill(buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_MEMORY("0123456789012", buffer, 13);
+  while (!xtcp_iperf_done(1, now)) {
+    xtcp_iperf_count(1, sizeof(buffer), now);
+    xtcp_iperf_count(2, sizeof(buffer), now);
+    now += MS(1);
+  }
+  xtcp_iperf_close(1, now);
+  xtcp_iperf_close(2, now);
+
+  // Each reports its one interval, then the whole session
+  TEST_ASSERT_EQUAL(4, num_reports);
+  TEST_ASSERT_EQUAL(XTCP_IPERF_CLIENT, reports[1].role);
+  TEST_ASSERT_EQUAL(XTCP_IPERF_SERVER, reports[3].role);
+  TEST_ASSERT_TRUE(reports[1].final && reports[3].final);
+  TEST_ASSERT_EQUAL(XTCP_IPERF_HEADER_LENGTH + (1000 * XTCP_IPERF_BUFFER), reports[1].bytes);
+  TEST_ASSERT_EQUAL(reports[1].bytes, reports[3].bytes);
+  TEST_ASSERT_EQUAL(reports[1].kbits_per_second, reports[3].kbits_per_second);
+  TEST_ASSERT_EQUAL(reports[0].bytes, reports[1].bytes);
+}
@@ -0,0 +1,93 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include <xcore/channel_streaming.h>
+
+#include "pipeline.h"
+#include "lwip/netif.h"
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "test_frames.h"
+
+static uint8_t frame[ETHERNET_MAX_PACKET_SIZE];
+
+/* Builds a UDP over IPv4 frame with a valid header checksum */
+void setUp() {
+  memset(frame, 0, sizeof(frame));
+  test_frame_ipv4(frame, 17, 5000);
+}
+void tearDown() {}
+
+void test_valid_ipv4_frame_passes(void) {
+  TEST_ASSERT_EQUAL(PIPELINE_RX_PASS, pipeline_rx_classify(frame, UDP_FRAME_SIZE));
+}
+
+void test_padded_ipv4_frame_passes(void) {
+  TEST_ASSERT_EQUAL(PIPELINE_RX_PASS, pipeline_rx_classify(frame, 60));
+}
+
+void test_runt_frame_is_invalid(void) {
+  TEST_ASSERT_EQUAL(PIPELINE_RX_INVALID, pipeline_rx_classify(frame, ETH_HEADER_SIZE - 1));
+}
+
+void test_bad_ip_checksum_is_invalid(void) {
+  frame[ETH_HEADER_SIZE + 11] ^= 0x01;
+  TEST_ASSERT_EQUAL(PIPELINE_RX_INVALID, pipeline_rx_classify(frame, UDP_FRAME_SIZE));
+}
+
+void test_bad_ip_version_is_invalid(void) {
+  frame[ETH_HEADER_SIZE] = 0x65;
+  test_frame_set_ip_checksum(frame);
+  TEST_ASSERT_EQUAL(PIPELINE_RX_INVALID, pipeline_rx_classify(frame, UDP_FRAME_SIZE));
+}
+
+void test_ip_total_length_beyond_frame_is_invalid(void) {
+  frame[ETH_HEADER_SIZE + 3] = IP_HEADER_SIZE + 9;
+  test_frame_set_ip_checksum(frame);
+  TEST_ASSERT_EQUAL(PIPELINE_RX_INVALID, pipeline_rx_classify(frame, UDP_FRAME_SIZE));
+}
+
+void test_ip_header_length_too_short_is_invalid(void) {
+  frame[ETH_HEADER_SIZE] = 0x44;
+  test_frame_set_ip_checksum(frame);
+  TEST_ASSERT_EQUAL(PIPELINE_RX_INVALID, pipeline_rx_classify(frame, UDP_FRAME_SIZE));
+}
+
+void test_arp_frame_passes(void) {
+  frame[13] = 0x06;
+  TEST_ASSERT_EQUAL(PIPELINE_RX_PASS, pipeline_rx_classify(frame, ETH_HEADER_SIZE + 28));
+  TEST_ASSERT_EQUAL(PIPELINE_RX_INVALID, pipeline_rx_classify(frame, ETH_HEADER_SIZE + 27));
+}
+
+void test_ipv6_frame_is_unsupported(void) {
+  frame[12] = 0x86;
+  frame[13] = 0xDD;
+  TEST_ASSERT_EQUAL(PIPELINE_RX_UNSUPPORTED, pipeline_rx_classify(frame, UDP_FRAME_SIZE));
+}
+
+void test_tx_queue_holds_a_send_buffer(void) {
+  static struct netif test_netif;
+  struct netif *saved_netif = netif_default;
+  memset(&test_netif, 0, sizeof(test_netif));
+  netif_default = &test_netif;
+  streaming_channel_t c_frontend = s_chan_alloc();
+  pipeline_init(c_frontend.end_a);
+
+  // LwIP sends a send buffer of full segments in one burst, before the front end takes any of them
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, UDP_FRAME_SIZE, PBUF_RAM);
+  memcpy(p->payload, frame, UDP_FRAME_SIZE);
+  for (int i = 0; i < TCP_SND_BUF / TCP_MSS; ++i) {
+    TEST_ASSERT_EQUAL(ERR_OK, test_netif.linkoutput(&test_netif, p));
+  }
+  (void)pbuf_free(p);
+  TEST_ASSERT_EQUAL(0, pipeline_get_stats().tx_queue_full);
+
+  // Only the first frame notifies the front end
+  (void)s_chan_in_word(c_frontend.end_b);
+  s_chan_free(c_frontend);
+  netif_default = saved_netif;
+}
@@ -0,0 +1,65 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include "rate_limit.h"
+
+#define RATE 100
+#define BURST 4
+#define TOKEN_TICKS (RATE_LIMIT_TICKS_PER_SECOND / RATE)
+
+static rate_limit_t limit;
+
+void setUp() {
+  rate_limit_init(&limit, RATE, BURST);
+}
+void tearDown() {}
+
+void test_starts_with_a_full_burst(void) {
+  for (int i = 0; i < BURST; ++i) {
+    TEST_ASSERT_TRUE(rate_limit_take(&limit, 0));
+  }
+  TEST_ASSERT_FALSE(rate_limit_take(&limit, 0));
+}
+
+void test_refills_at_the_rate(void) {
+  uint32_t now = 0;
+  for (int i = 0; i < BURST; ++i) {
+    (void)rate_limit_take(&limit, now);
+  }
+  now += TOKEN_TICKS - 1;
+  TEST_ASSERT_FALSE(rate_limit_take(&limit, now));
+  now += 1;
+  TEST_ASSERT_TRUE(rate_limit_take(&limit, now));
+  TEST_ASSERT_FALSE(rate_limit_take(&limit, now));
+}
+
+void test_refill_is_capped_at_the_burst(void) {
+  uint32_t now = 10 * BURST * TOKEN_TICKS;
+  for (int i = 0; i < BURST; ++i) {
+    TEST_ASSERT_TRUE(rate_limit_take(&limit, now));
+  }
+  TEST_ASSERT_FALSE(rate_limit_take(&limit, now));
+}
+
+void test_sustained_rate_is_enforced_across_timer_wrap(void) {
+  uint32_t now = 0xFFFFFFFF - RATE_LIMIT_TICKS_PER_SECOND / 2;
+  uint32_t passed = 0;
+  for (int i = 0; i < BURST; ++i) {
+    (void)rate_limit_take(&limit, now);
+  }
+  // Offer ten times the rate for one second
+  for (int i = 0; i < 10 * RATE; ++i) {
+    now += TOKEN_TICKS / 10;
+    passed += (uint32_t)rate_limit_take(&limit, now);
+  }
+  TEST_ASSERT_EQUAL_UINT32(RATE, passed);
+}
+
+void test_zero_rate_is_unlimited(void) {
+  rate_limit_init(&limit, 0, 0);
+  for (int i = 0; i < 1000; ++i) {
+    TEST_ASSERT_TRUE(rate_limit_take(&limit, 0));
+  }
+}
@@ -0,0 +1,257 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "rx_filter.h"
+#include "test_frames.h"
+
+/* LwIP headers */
+#include "lwip/netif.h"
+#include "lwip/opt.h"
+
+#define BOUND_PORT 15533
+#define LISTEN_PORT 80
+#define OTHER_PORT 5001
+
+#define TICKS_PER_SECOND 100000000
+
+#define TCP_SYN 0x02
+#define TCP_ACK 0x10
+
+static uint8_t frame[ETHERNET_MAX_PACKET_SIZE];
+static const uint8_t joined_group[4] = {239, 1, 2, 3};
+
+static void set_tcp_flags(uint8_t flags) {
+  frame[ETH_HEADER_SIZE + IP_HEADER_SIZE + 13] = flags;
+}
+
+/* Starts with a UDP frame, one bound UDP port, one TCP listener and one joined group */
+void setUp() {
+  memset(frame, 0, sizeof(frame));
+  test_frame_ipv4(frame, 17, BOUND_PORT);
+
+  rx_filter_init();
+  rx_filter_clear();
+  rx_filter_add_udp_port(BOUND_PORT);
+  rx_filter_add_tcp_listen_port(LISTEN_PORT);
+  rx_filter_add_group(joined_group);
+}
+void tearDown() {}
+
+void test_udp_to_bound_port_is_accepted(void) {
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().accepted);
+}
+
+void test_udp_to_unbound_port_is_dropped(void) {
+#if XTCP_RX_FILTER_ENABLE
+  test_frame_set_dest_port(frame, OTHER_PORT);
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().udp_no_socket);
+  TEST_ASSERT_EQUAL_UINT32(0, rx_filter_get_stats().accepted);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RX_FILTER_ENABLE is 0");
+#endif
+}
+
+void test_udp_to_unbound_port_is_accepted_without_filter(void) {
+#if !XTCP_RX_FILTER_ENABLE
+  // LwIP answers with ICMP port unreachable, so peers see the port refused
+  test_frame_set_dest_port(frame, OTHER_PORT);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(0, rx_filter_get_stats().udp_no_socket);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RX_FILTER_ENABLE is 1");
+#endif
+}
+
+void test_broadcast_udp_to_unbound_port_is_dropped(void) {
+#if XTCP_RX_FILTER_ENABLE
+  static const uint8_t broadcast[4] = {255, 255, 255, 255};
+  test_frame_set_ip_dest(frame, broadcast);
+  test_frame_set_dest_port(frame, OTHER_PORT);
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().udp_no_socket);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RX_FILTER_ENABLE is 0");
+#endif
+}
+
+void test_tcp_syn_to_listener_is_accepted(void) {
+  test_frame_ipv4(frame, 6, LISTEN_PORT);
+  set_tcp_flags(TCP_SYN);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, TCP_FRAME_SIZE, 0));
+}
+
+void test_tcp_syn_without_listener_is_dropped(void) {
+#if XTCP_RX_FILTER_ENABLE
+  test_frame_ipv4(frame, 6, OTHER_PORT);
+  set_tcp_flags(TCP_SYN);
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, TCP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().tcp_no_listener);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RX_FILTER_ENABLE is 0");
+#endif
+}
+
+void test_tcp_segment_without_listener_is_accepted(void) {
+  // Segments for connections the stack opened, or is closing, must reach lwIP
+  test_frame_ipv4(frame, 6, OTHER_PORT);
+  set_tcp_flags(TCP_SYN | TCP_ACK);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, TCP_FRAME_SIZE, 0));
+  set_tcp_flags(TCP_ACK);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, TCP_FRAME_SIZE, 0));
+}
+
+void test_multicast_to_joined_group_is_accepted(void) {
+  test_frame_set_ip_dest(frame, joined_group);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+}
+
+void test_multicast_to_other_group_is_dropped(void) {
+#if XTCP_RX_FILTER_ENABLE
+  static const uint8_t other_group[4] = {239, 1, 2, 4};
+  test_frame_set_ip_dest(frame, other_group);
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().multicast_not_joined);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RX_FILTER_ENABLE is 0");
+#endif
+}
+
+void test_icmp_is_accepted(void) {
+  test_frame_ipv4(frame, 1, 0);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+}
+
+void test_arp_is_accepted(void) {
+  frame[13] = 0x06;
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, 60, 0));
+}
+
+void test_later_fragment_is_accepted(void) {
+  test_frame_set_dest_port(frame, OTHER_PORT);
+  frame[ETH_HEADER_SIZE + 7] = 0x10;
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+}
+
+void test_truncated_udp_header_is_accepted(void) {
+  // Left to lwIP to drop and count
+  test_frame_set_dest_port(frame, OTHER_PORT);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, ETH_HEADER_SIZE + IP_HEADER_SIZE + 4, 0));
+}
+
+void test_full_port_table_accepts_all(void) {
+  for (int i = 0; i <= MEMP_NUM_UDP_PCB; ++i) {
+    rx_filter_add_udp_port((uint16_t)(1000 + i));
+  }
+  test_frame_set_dest_port(frame, OTHER_PORT);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+}
+
+static void set_arp_request(void) {
+  memset(frame, 0xFF, 6);
+  frame[12] = 0x08;
+  frame[13] = 0x06;
+  frame[ETH_HEADER_SIZE + 6] = 0;
+  frame[ETH_HEADER_SIZE + 7] = 1;
+}
+
+void test_arp_requests_are_rate_limited(void) {
+#if XTCP_RATE_LIMIT_ARP_REQUESTS
+  set_arp_request();
+  for (int i = 0; i < XTCP_RATE_LIMIT_ARP_BURST; ++i) {
+    TEST_ASSERT_TRUE(rx_filter_accept(frame, 60, 0));
+  }
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, 60, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().arp_rate_limited);
+
+  // One more request is allowed after one token period
+  uint32_t later = TICKS_PER_SECOND / XTCP_RATE_LIMIT_ARP_REQUESTS + 1;
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, 60, later));
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, 60, later));
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RATE_LIMIT_ARP_REQUESTS is 0");
+#endif
+}
+
+void test_arp_requests_for_netif_have_own_limit(void) {
+#if XTCP_RATE_LIMIT_ARP_REQUESTS && XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS
+  static const uint8_t netif_addr[4] = {192, 168, 200, 198};
+  struct netif *saved_netif = netif_default;
+  struct netif test_netif;
+  memset(&test_netif, 0, sizeof(test_netif));
+  memcpy(&test_netif.ip_addr, netif_addr, sizeof(netif_addr));
+  netif_default = &test_netif;
+
+  // A storm of requests for other hosts uses up its own limit
+  set_arp_request();
+  for (int i = 0; i <= XTCP_RATE_LIMIT_ARP_BURST; ++i) {
+    (void)rx_filter_accept(frame, 60, 0);
+  }
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, 60, 0));
+
+  memcpy(&frame[ETH_HEADER_SIZE + 24], netif_addr, sizeof(netif_addr));
+  for (int i = 0; i < XTCP_RATE_LIMIT_ARP_LOCAL_BURST; ++i) {
+    TEST_ASSERT_TRUE(rx_filter_accept(frame, 60, 0));
+  }
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, 60, 0));
+  netif_default = saved_netif;
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RATE_LIMIT_ARP_REQUESTS or XTCP_RATE_LIMIT_ARP_LOCAL_REQUESTS is 0");
+#endif
+}
+
+void test_arp_replies_are_not_rate_limited(void) {
+  set_arp_request();
+  frame[ETH_HEADER_SIZE + 7] = 2;
+  for (int i = 0; i < XTCP_RATE_LIMIT_ARP_BURST * 2; ++i) {
+    TEST_ASSERT_TRUE(rx_filter_accept(frame, 60, 0));
+  }
+}
+
+void test_icmp_echo_requests_are_rate_limited(void) {
+#if XTCP_RATE_LIMIT_ICMP_ECHO
+  test_frame_ipv4(frame, 1, 0);
+  frame[ETH_HEADER_SIZE + IP_HEADER_SIZE] = 8;
+  for (int i = 0; i < XTCP_RATE_LIMIT_ICMP_ECHO_BURST; ++i) {
+    TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  }
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().icmp_echo_rate_limited);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RATE_LIMIT_ICMP_ECHO is 0");
+#endif
+}
+
+void test_unsupported_protocol_is_rate_limited(void) {
+#if XTCP_RATE_LIMIT_ICMP_UNREACHABLE
+  test_frame_ipv4(frame, 47, 0);
+  for (int i = 0; i < XTCP_RATE_LIMIT_ICMP_UNREACHABLE_BURST; ++i) {
+    TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  }
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().icmp_unreachable_rate_limited);
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RATE_LIMIT_ICMP_UNREACHABLE is 0");
+#endif
+}
+
+void test_broadcast_udp_is_rate_limited_without_affecting_unicast(void) {
+#if XTCP_RATE_LIMIT_BROADCAST_UDP
+  memset(frame, 0xFF, 6);
+  for (int i = 0; i < XTCP_RATE_LIMIT_BROADCAST_UDP_BURST; ++i) {
+    TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  }
+  TEST_ASSERT_FALSE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, rx_filter_get_stats().broadcast_udp_rate_limited);
+
+  memset(frame, 0x02, 6);
+  TEST_ASSERT_TRUE(rx_filter_accept(frame, UDP_FRAME_SIZE, 0));
+#else
+  TEST_IGNORE_MESSAGE("XTCP_RATE_LIMIT_BROADCAST_UDP is 0");
+#endif
+}
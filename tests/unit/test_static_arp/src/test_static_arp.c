@@ -0,0 +1,131 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "static_arp.h"
+
+static const uint8_t mac_a[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0a};
+static const uint8_t mac_b[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0b};
+
+static void make_addr(uint8_t addr[4], uint32_t host) {
+  addr[0] = 10;
+  addr[1] = 0;
+  addr[2] = (uint8_t)(host >> 8);
+  addr[3] = (uint8_t)host;
+}
+
+void setUp() {}
+
+/* Removing every entry leaves the table empty for the next test */
+void tearDown() {
+  uint8_t addr[4];
+  for (uint32_t host = 0; host < 256; ++host) {
+    make_addr(addr, host);
+    (void)static_arp_remove(addr);
+  }
+}
+
+void test_added_entry_is_found(void) {
+  uint8_t addr[4];
+  make_addr(addr, 1);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_a));
+  const uint8_t *mac = static_arp_lookup(addr);
+  TEST_ASSERT_NOT_NULL(mac);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(mac_a, mac, 6);
+}
+
+void test_missing_entry_is_not_found(void) {
+  uint8_t addr[4];
+  make_addr(addr, 1);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_a));
+  make_addr(addr, 2);
+  TEST_ASSERT_NULL(static_arp_lookup(addr));
+}
+
+void test_add_replaces_existing_entry(void) {
+  uint8_t addr[4];
+  make_addr(addr, 1);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_a));
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_b));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(mac_b, static_arp_lookup(addr), 6);
+
+  // Replacing does not use another slot
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_remove(addr));
+  TEST_ASSERT_NULL(static_arp_lookup(addr));
+}
+
+void test_remove_missing_entry_fails(void) {
+  uint8_t addr[4];
+  make_addr(addr, 1);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_arp_remove(addr));
+}
+
+void test_non_unicast_addresses_are_rejected(void) {
+  static const uint8_t any[4] = {0, 0, 0, 0};
+  static const uint8_t broadcast[4] = {255, 255, 255, 255};
+  static const uint8_t multicast[4] = {239, 1, 2, 3};
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_arp_add(any, mac_a));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_arp_add(broadcast, mac_a));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_arp_add(multicast, mac_a));
+}
+
+void test_full_table_is_rejected(void) {
+  uint8_t addr[4];
+  for (uint32_t host = 0; host < STATIC_ARP_MAX_ENTRIES; ++host) {
+    make_addr(addr, host);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_a));
+  }
+  make_addr(addr, STATIC_ARP_MAX_ENTRIES);
+  TEST_ASSERT_EQUAL(XTCP_ENOMEM, static_arp_add(addr, mac_a));
+
+  // Every entry is still found
+  for (uint32_t host = 0; host < STATIC_ARP_MAX_ENTRIES; ++host) {
+    make_addr(addr, host);
+    TEST_ASSERT_NOT_NULL(static_arp_lookup(addr));
+  }
+}
+
+void test_entries_are_found_after_removals(void) {
+  uint8_t addr[4];
+  for (uint32_t host = 0; host < STATIC_ARP_MAX_ENTRIES; ++host) {
+    make_addr(addr, host);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, (host & 1) ? mac_b : mac_a));
+  }
+  for (uint32_t host = 0; host < STATIC_ARP_MAX_ENTRIES; host += 2) {
+    make_addr(addr, host);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_remove(addr));
+  }
+  for (uint32_t host = 0; host < STATIC_ARP_MAX_ENTRIES; ++host) {
+    make_addr(addr, host);
+    if (host & 1) {
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(mac_b, static_arp_lookup(addr), 6);
+    } else {
+      TEST_ASSERT_NULL(static_arp_lookup(addr));
+    }
+  }
+
+  // Removed slots are reused
+  for (uint32_t host = 0; host < STATIC_ARP_MAX_ENTRIES; host += 2) {
+    make_addr(addr, host + 100);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_a));
+  }
+}
+
+/* The hosts of one subnet differ only in their last octets, and are spread over the table */
+void test_subnet_lookups_are_short(void) {
+  uint8_t addr[4];
+  for (uint32_t host = 1; host <= STATIC_ARP_MAX_ENTRIES; ++host) {
+    make_addr(addr, host);
+    TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add(addr, mac_a));
+  }
+  uint32_t longest = 0;
+  for (uint32_t host = 1; host <= STATIC_ARP_MAX_ENTRIES; ++host) {
+    make_addr(addr, host);
+    uint32_t probes = static_arp_probes(addr);
+    longest = (probes > longest) ? probes : longest;
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(2, longest);
+}
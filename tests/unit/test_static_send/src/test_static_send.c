@@ -0,0 +1,119 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "static_send.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/pbuf.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/tcp.h"
+
+#define TEST_CLIENT_NUM 0
+#define REGION_SIZE 3000
+
+static uint8_t region_data[REGION_SIZE];
+static int32_t region;
+static int32_t id;
+static struct tcp_pcb *pcb;
+
+void setUp() {
+  static int initialised = 0;
+  if (!initialised) {
+    lwip_init();
+    for (uint32_t i = 0; i < REGION_SIZE; ++i) {
+      region_data[i] = (uint8_t)i;
+    }
+    initialised = 1;
+  }
+
+  init_client_connections();
+  xtcp_init_queue();
+  static_send_init();
+  region = xtcp_register_static(region_data, REGION_SIZE);
+  TEST_ASSERT_EQUAL(0, region);
+
+  // An established connection without a route, so segments stay queued until acknowledged by the test
+  id = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP).value;
+  pcb = get_tcp_pcb(id);
+  pcb->state = ESTABLISHED;
+}
+
+void tearDown() {
+  tcp_segs_free(pcb->unsent);
+  tcp_segs_free(pcb->unacked);
+  pcb->unsent = NULL;
+  pcb->unacked = NULL;
+  pcb->snd_queuelen = 0;
+  pcb->state = CLOSED;
+  shim_close_socket(TEST_CLIENT_NUM, id);
+}
+
+void test_register_checks_regions(void) {
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, xtcp_register_static(region_data, 0));
+  for (int32_t i = 1; i < XTCP_STATIC_REGIONS; ++i) {
+    TEST_ASSERT_EQUAL(i, xtcp_register_static(region_data, 1));
+  }
+  TEST_ASSERT_EQUAL(XTCP_ENOMEM, xtcp_register_static(region_data, 1));
+}
+
+void test_send_static_checks_range(void) {
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_send_start(TEST_CLIENT_NUM, id, region + 1, 0, 1));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_send_start(TEST_CLIENT_NUM, id, region, REGION_SIZE, 1));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_send_start(TEST_CLIENT_NUM, id, region, 1, REGION_SIZE));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_send_start(TEST_CLIENT_NUM, id, region, 0, 0));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, static_send_start(TEST_CLIENT_NUM + 1, id, region, 0, 1));
+
+  xtcp_error_int32_t udp = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+  TEST_ASSERT_EQUAL(XTCP_EPROTONOSUPPORT, static_send_start(TEST_CLIENT_NUM, udp.value, region, 0, 1));
+  shim_close_socket(TEST_CLIENT_NUM, udp.value);
+  TEST_ASSERT_FALSE(static_send_pending(id));
+}
+
+void test_send_static_queues_references(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_send_start(TEST_CLIENT_NUM, id, region, 100, 2000));
+  TEST_ASSERT_TRUE(static_send_pending(id));
+
+  // The first segment holds the region itself, not a copy
+  TEST_ASSERT_NOT_NULL(pcb->unsent);
+  struct pbuf *data = pcb->unsent->p->next;
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_EQUAL_PTR(&region_data[100], data->payload);
+
+  // Other sends wait for the static send
+  TEST_ASSERT_EQUAL(0, shim_get_send_space(TEST_CLIENT_NUM, id).value);
+  TEST_ASSERT_EQUAL(XTCP_EAGAIN, static_send_start(TEST_CLIENT_NUM, id, region, 0, 1));
+}
+
+void test_sent_static_raised_when_acknowledged(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_send_start(TEST_CLIENT_NUM, id, region, 0, 2000));
+
+  TEST_ASSERT_EQUAL(ERR_OK, lwip_tcp_event((void *)id, pcb, LWIP_EVENT_SENT, NULL, 1500, ERR_OK));
+  TEST_ASSERT_EQUAL(XTCP_EVENT_NONE, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+  TEST_ASSERT_TRUE(static_send_pending(id));
+
+  TEST_ASSERT_EQUAL(ERR_OK, lwip_tcp_event((void *)id, pcb, LWIP_EVENT_SENT, NULL, 500, ERR_OK));
+  client_event_t event = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(XTCP_SENT_STATIC, event.xtcp_event);
+  TEST_ASSERT_EQUAL(2000, event.length);
+  TEST_ASSERT_FALSE(static_send_pending(id));
+  TEST_ASSERT_EQUAL(0, get_tx_bytes(id));
+}
+
+void test_static_send_forgotten_with_connection(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_send_start(TEST_CLIENT_NUM, id, region, 0, 10));
+  free_client_connection(id);
+  TEST_ASSERT_FALSE(static_send_pending(id));
+
+  // Give the PCB a connection again for tearDown()
+  id = assign_client_connection(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP).value;
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_tcp_pcb(id, pcb));
+  tcp_arg(pcb, (void *)id);
+}
@@ -0,0 +1,96 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "stream.h"
+#include "xtcp_stream.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+
+#define TEST_CLIENT_NUM 0
+
+static xtcp_stream_t stream;
+
+void setUp() {
+  static int initialised = 0;
+  if (!initialised) {
+    lwip_init();
+    initialised = 1;
+  }
+
+  init_client_connections();
+  xtcp_init_queue();
+  stream_init();
+
+  unsigned client_end = xtcp_stream_alloc(&stream);
+  TEST_ASSERT_NOT_EQUAL(0, client_end);
+  xtcp_stream_connect(&stream, stream_open(TEST_CLIENT_NUM, client_end));
+  TEST_ASSERT_NOT_EQUAL(0, stream.c);
+}
+
+void tearDown() {
+  // Both ends buffer their end token, so the stream closes on one core
+  stream_close(TEST_CLIENT_NUM);
+  xtcp_stream_release(&stream);
+  TEST_ASSERT_TRUE(stream_busy());
+  stream_poll();
+  TEST_ASSERT_FALSE(stream_busy());
+}
+
+void test_stream_opens_once_per_client(void) {
+  xtcp_stream_t second;
+  unsigned client_end = xtcp_stream_alloc(&second);
+  TEST_ASSERT_EQUAL(0, stream_open(TEST_CLIENT_NUM, client_end));
+  xtcp_stream_connect(&second, 0);
+  TEST_ASSERT_EQUAL(0, second.c);
+}
+
+void test_send_stream_checks_connection(void) {
+  xtcp_error_int32_t udp = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+  TEST_ASSERT_EQUAL(XTCP_EPROTONOSUPPORT, stream_send(TEST_CLIENT_NUM, udp.value, 100));
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, stream_send(TEST_CLIENT_NUM + 1, udp.value, 100));
+  shim_close_socket(TEST_CLIENT_NUM, udp.value);
+
+  // A connection that is not established has no send space
+  xtcp_error_int32_t tcp = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+  TEST_ASSERT_EQUAL(0, stream_send(TEST_CLIENT_NUM, tcp.value, 0));
+  TEST_ASSERT_EQUAL(XTCP_EAGAIN, stream_send(TEST_CLIENT_NUM, tcp.value, 100));
+  TEST_ASSERT_FALSE(stream_busy());
+  shim_close_socket(TEST_CLIENT_NUM, tcp.value);
+}
+
+void test_recv_stream_takes_whole_pbufs(void) {
+  xtcp_error_int32_t tcp = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+  TEST_ASSERT_EQUAL(0, stream_recv(TEST_CLIENT_NUM, tcp.value, 100));
+
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, 200, PBUF_RAM);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, set_remote(tcp.value, NULL, 0, p));
+  TEST_ASSERT_EQUAL(XTCP_EAGAIN, stream_recv(TEST_CLIENT_NUM, tcp.value, 100));
+  TEST_ASSERT_FALSE(stream_busy());
+  shim_close_socket(TEST_CLIENT_NUM, tcp.value);
+}
+
+void test_poll_does_not_wait_for_client(void) {
+  // The client has not closed its end yet, so the stack keeps its end and carries on
+  stream_close(TEST_CLIENT_NUM);
+  TEST_ASSERT_FALSE(stream_poll());
+  TEST_ASSERT_TRUE(stream_busy());
+
+  xtcp_stream_release(&stream);
+  TEST_ASSERT_TRUE(stream_poll());
+  TEST_ASSERT_FALSE(stream_busy());
+
+  // Open the stream again for tearDown()
+  unsigned client_end = xtcp_stream_alloc(&stream);
+  xtcp_stream_connect(&stream, stream_open(TEST_CLIENT_NUM, client_end));
+  TEST_ASSERT_NOT_EQUAL(0, stream.c);
+}
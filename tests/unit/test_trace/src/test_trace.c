@@ -0,0 +1,114 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "client_queue.h"
+#include "trace.h"
+
+static uint8_t buffer[XTCP_TRACE_HEADER_LENGTH + (XTCP_TRACE_RECORDS + 1) * XTCP_TRACE_RECORD_LENGTH];
+
+static uint32_t get_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int16_t get_id(const uint8_t *record) { return (int16_t)(record[6] | (record[7] << 8)); }
+
+/* Read the trace and skip the header, returning the bytes of records */
+static int32_t read_records(void) {
+  int32_t n = trace_read(buffer, sizeof(buffer));
+  if (n < XTCP_TRACE_HEADER_LENGTH) {
+    return n;
+  }
+  memmove(buffer, &buffer[XTCP_TRACE_HEADER_LENGTH], (size_t)n - XTCP_TRACE_HEADER_LENGTH);
+  return n - XTCP_TRACE_HEADER_LENGTH;
+}
+
+void setUp() {
+  trace_init();
+  xtcp_init_queue();
+}
+
+void tearDown() {}
+
+void test_read_starts_with_header(void) {
+  trace_record(TRACE_TCP_WRITE, 1, 3, 1460, 0xFFFFFFFF);
+
+  int32_t n = trace_read(buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL(XTCP_TRACE_HEADER_LENGTH + XTCP_TRACE_RECORD_LENGTH, n);
+  TEST_ASSERT_EQUAL_MEMORY("XTRC", buffer, 4);
+  TEST_ASSERT_EQUAL(1, buffer[4]);
+  TEST_ASSERT_EQUAL(XTCP_TRACE_RECORD_LENGTH, buffer[6]);
+  TEST_ASSERT_EQUAL(100000000, get_le32(&buffer[8]));
+
+  const uint8_t *record = &buffer[XTCP_TRACE_HEADER_LENGTH];
+  TEST_ASSERT_EQUAL(TRACE_TCP_WRITE, record[4]);
+  TEST_ASSERT_EQUAL(1, record[5]);
+  TEST_ASSERT_EQUAL(3, get_id(record));
+  TEST_ASSERT_EQUAL(1460, get_le32(&record[8]));
+  TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, get_le32(&record[12]));
+
+  // The header is only sent once
+  TEST_ASSERT_EQUAL(0, trace_read(buffer, sizeof(buffer)));
+}
+
+void test_short_buffer_is_rejected(void) {
+  trace_record(TRACE_TIMER, TRACE_NO_CLIENT, TRACE_NO_ID, 0, 0);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, trace_read(buffer, XTCP_TRACE_READ_MIN - 1));
+  TEST_ASSERT_EQUAL(XTCP_TRACE_HEADER_LENGTH + XTCP_TRACE_RECORD_LENGTH, trace_read(buffer, XTCP_TRACE_READ_MIN));
+}
+
+void test_records_are_read_whole_and_in_order(void) {
+  for (uint32_t i = 0; i < 6; ++i) {
+    trace_record(TRACE_RX_FRAME, TRACE_NO_CLIENT, TRACE_NO_ID, 60 + i, 0);
+  }
+
+  TEST_ASSERT_EQUAL(XTCP_TRACE_READ_MIN, trace_read(buffer, XTCP_TRACE_READ_MIN));
+  TEST_ASSERT_EQUAL(60, get_le32(&buffer[XTCP_TRACE_HEADER_LENGTH + 8]));
+
+  // A buffer one byte short of four records takes three, leaving the last for the next read
+  TEST_ASSERT_EQUAL(3 * XTCP_TRACE_RECORD_LENGTH, trace_read(buffer, 4 * XTCP_TRACE_RECORD_LENGTH - 1));
+  for (uint32_t i = 0; i < 3; ++i) {
+    TEST_ASSERT_EQUAL(62 + i, get_le32(&buffer[i * XTCP_TRACE_RECORD_LENGTH + 8]));
+  }
+  TEST_ASSERT_EQUAL(XTCP_TRACE_RECORD_LENGTH, trace_read(buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL(65, get_le32(&buffer[8]));
+}
+
+void test_overwritten_records_are_reported_first(void) {
+  for (uint32_t i = 0; i < XTCP_TRACE_RECORDS + 3; ++i) {
+    trace_record(TRACE_TIMER, TRACE_NO_CLIENT, TRACE_NO_ID, i, 0);
+  }
+
+  TEST_ASSERT_EQUAL((XTCP_TRACE_RECORDS + 1) * XTCP_TRACE_RECORD_LENGTH, read_records());
+  TEST_ASSERT_EQUAL(TRACE_LOST, buffer[4]);
+  TEST_ASSERT_EQUAL(3, get_le32(&buffer[8]));
+  // The report takes the time of the oldest record kept, so the stream stays in time order
+  TEST_ASSERT_EQUAL(get_le32(&buffer[XTCP_TRACE_RECORD_LENGTH]), get_le32(&buffer[0]));
+  TEST_ASSERT_EQUAL(3, get_le32(&buffer[XTCP_TRACE_RECORD_LENGTH + 8]));
+
+  // Reported once
+  TEST_ASSERT_EQUAL(0, trace_read(buffer, sizeof(buffer)));
+}
+
+void test_client_queue_trace_points(void) {
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, enqueue_event_and_notify(1, 5, XTCP_RECV_DATA));
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, enqueue_event_and_notify(1, 5, XTCP_SENT_DATA));
+  TEST_ASSERT_EQUAL(XTCP_ENOMEM, enqueue_event_and_notify(1, 5, XTCP_CLOSED));
+  (void)dequeue_event(1);
+
+  TEST_ASSERT_EQUAL(4 * XTCP_TRACE_RECORD_LENGTH, read_records());
+  static const uint8_t sites[4] = {TRACE_EVENT_QUEUED, TRACE_EVENT_QUEUED, TRACE_EVENT_DROPPED, TRACE_EVENT_TAKEN};
+  static const uint32_t events[4] = {XTCP_RECV_DATA, XTCP_SENT_DATA, XTCP_CLOSED, XTCP_RECV_DATA};
+  static const uint32_t queued[4] = {1, 2, 0, 1};
+  for (uint32_t i = 0; i < 4; ++i) {
+    const uint8_t *record = &buffer[i * XTCP_TRACE_RECORD_LENGTH];
+    TEST_ASSERT_EQUAL(sites[i], record[4]);
+    TEST_ASSERT_EQUAL(1, record[5]);
+    TEST_ASSERT_EQUAL(5, get_id(record));
+    TEST_ASSERT_EQUAL(events[i], get_le32(&record[8]));
+    TEST_ASSERT_EQUAL(queued[i], get_le32(&record[12]));
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include "tx_pool.h"
+
+/* LwIP headers */
+#include "lwip/mem.h"
+
+#define SMALL_CLASS 0
+#define MEDIUM_CLASS 1
+
+void setUp() {
+  mem_init();
+  tx_pool_init();
+}
+void tearDown() {}
+
+void test_new_pool_is_empty(void) {
+  xtcp_tx_pool_stats_t stats = tx_pool_get_stats();
+  TEST_ASSERT_EQUAL(XTCP_TX_POOL_SMALL_SIZE, stats.size_class[SMALL_CLASS].block_size);
+  TEST_ASSERT_EQUAL(XTCP_TX_POOL_SMALL_COUNT, stats.size_class[SMALL_CLASS].num_blocks);
+  TEST_ASSERT_EQUAL(0, stats.size_class[SMALL_CLASS].in_use);
+  TEST_ASSERT_EQUAL(0, stats.heap_allocs);
+  TEST_ASSERT_EQUAL(0, stats.failures);
+}
+
+void test_alloc_uses_smallest_fitting_class(void) {
+  struct pbuf *p = tx_pool_alloc(XTCP_TX_POOL_SMALL_SIZE + 1);
+  TEST_ASSERT_NOT_NULL(p);
+  TEST_ASSERT_EQUAL(XTCP_TX_POOL_SMALL_SIZE + 1, p->len);
+
+  xtcp_tx_pool_stats_t stats = tx_pool_get_stats();
+  TEST_ASSERT_EQUAL(0, stats.size_class[SMALL_CLASS].in_use);
+  TEST_ASSERT_EQUAL(1, stats.size_class[MEDIUM_CLASS].in_use);
+  pbuf_free(p);
+}
+
+void test_free_returns_buffer_to_class(void) {
+  struct pbuf *p = tx_pool_alloc(10);
+  TEST_ASSERT_NOT_NULL(p);
+  pbuf_free(p);
+
+  xtcp_tx_pool_stats_t stats = tx_pool_get_stats();
+  TEST_ASSERT_EQUAL(0, stats.size_class[SMALL_CLASS].in_use);
+  TEST_ASSERT_EQUAL(1, stats.size_class[SMALL_CLASS].high_water);
+  TEST_ASSERT_EQUAL(1, stats.size_class[SMALL_CLASS].allocs);
+}
+
+void test_payload_leaves_room_for_headers(void) {
+  struct pbuf *p = tx_pool_alloc(XTCP_TX_POOL_SMALL_SIZE);
+  TEST_ASSERT_NOT_NULL(p);
+  TEST_ASSERT_TRUE((uint8_t *)p->payload >= ((uint8_t *)p + PBUF_TRANSPORT));
+  pbuf_free(p);
+}
+
+void test_exhausted_class_falls_back_to_larger_class(void) {
+  struct pbuf *held[XTCP_TX_POOL_SMALL_COUNT];
+  for (int i = 0; i < XTCP_TX_POOL_SMALL_COUNT; ++i) {
+    held[i] = tx_pool_alloc(1);
+    TEST_ASSERT_NOT_NULL(held[i]);
+  }
+
+  struct pbuf *p = tx_pool_alloc(1);
+  TEST_ASSERT_NOT_NULL(p);
+
+  xtcp_tx_pool_stats_t stats = tx_pool_get_stats();
+  TEST_ASSERT_EQUAL(XTCP_TX_POOL_SMALL_COUNT, stats.size_class[SMALL_CLASS].high_water);
+  TEST_ASSERT_EQUAL(1, stats.size_class[SMALL_CLASS].exhausted);
+  TEST_ASSERT_EQUAL(1, stats.size_class[MEDIUM_CLASS].in_use);
+
+  pbuf_free(p);
+  for (int i = 0; i < XTCP_TX_POOL_SMALL_COUNT; ++i) {
+    pbuf_free(held[i]);
+  }
+  stats = tx_pool_get_stats();
+  TEST_ASSERT_EQUAL(0, stats.size_class[SMALL_CLASS].in_use);
+  TEST_ASSERT_EQUAL(0, stats.size_class[MEDIUM_CLASS].in_use);
+}
+
+void test_oversize_length_uses_heap(void) {
+  struct pbuf *p = tx_pool_alloc(XTCP_TX_POOL_FRAME_SIZE + 1);
+#if XTCP_TX_POOL_FALLBACK_HEAP
+  TEST_ASSERT_NOT_NULL(p);
+  TEST_ASSERT_EQUAL(1, tx_pool_get_stats().heap_allocs);
+  pbuf_free(p);
+#else
+  TEST_ASSERT_NULL(p);
+  TEST_ASSERT_EQUAL(1, tx_pool_get_stats().failures);
+#endif
+}
@@ -0,0 +1,243 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "client_queue.h"
+#include "connection.h"
+#include "lwip_shim.h"
+#include "static_arp.h"
+#include "tx_pool.h"
+#include "udp_batch.h"
+#include "udp_recv.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include "netif/ethernet.h"
+
+#define TEST_CLIENT_NUM 0
+#define LOCAL_PORT 5000
+#define REMOTE_PORT 6000
+
+#define UDP_PAYLOAD_OFFSET (14 + 20 + 8)
+
+static struct netif netif;
+static ip4_addr_t peer;
+static int32_t id;
+static const uint8_t our_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t peer_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+static uint8_t frames[2][ETHERNET_MAX_PACKET_SIZE];
+static uint32_t frame_count;
+
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t capture_linkoutput(struct netif *n, struct pbuf *p) {
+  (void)n;
+  if (frame_count < 2) {
+    pbuf_copy_partial(p, frames[frame_count], p->tot_len, 0);
+  }
+  frame_count++;
+  // Stamp the payload pbuf as the MAC does, with the number of the frame
+  for (struct pbuf *q = p; q != NULL; q = q->next) {
+    if (q->flags & PBUF_FLAG_TX_TIMESTAMP) {
+      q->timestamp = frame_count;
+    }
+  }
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t test_netif_init(struct netif *n) {
+  n->hwaddr_len = ETH_HWADDR_LEN;
+  memcpy(n->hwaddr, our_mac, ETH_HWADDR_LEN);
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+  n->output = etharp_output;
+  n->linkoutput = capture_linkoutput;
+  return ERR_OK;
+}
+
+/* Deliver a datagram to the socket as lwIP does */
+static void receive(uint16_t length, uint8_t fill, uint16_t port) {
+  struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+  memset(p->payload, fill, length);
+  xtcp_udp_recv((void *)id, get_udp_pcb(id), p, &peer, port);
+}
+
+void setUp() {
+  static int initialised = 0;
+  if (!initialised) {
+    ip4_addr_t ipaddr, netmask, gw;
+    IP4_ADDR(&ipaddr, 192, 168, 200, 198);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    IP4_ADDR(&gw, 192, 168, 200, 1);
+
+    lwip_init();
+    netif_add(&netif, &ipaddr, &netmask, &gw, NULL, test_netif_init, ethernet_input);
+    netif_set_default(&netif);
+    netif_set_up(&netif);
+    netif_set_link_up(&netif);
+    static_arp_init();
+    initialised = 1;
+  }
+
+  init_client_connections();
+  xtcp_init_queue();
+  tx_pool_init();
+  frame_count = 0;
+
+  IP4_ADDR(&peer, 192, 168, 200, 2);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add((const uint8_t *)&peer, peer_mac));
+
+  xtcp_error_int32_t connection = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_UDP);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, connection.status);
+  id = connection.value;
+  udp_bind(get_udp_pcb(id), IP_ADDR_ANY, LOCAL_PORT);
+}
+
+void tearDown() {
+  shim_close_socket(TEST_CLIENT_NUM, id);
+  (void)static_arp_remove((const uint8_t *)&peer);
+}
+
+void test_recv_takes_every_queued_datagram(void) {
+  xtcp_datagram_t datagrams[4];
+  receive(10, 0xAA, REMOTE_PORT);
+  receive(5, 0xBB, REMOTE_PORT + 1);
+
+  TEST_ASSERT_EQUAL(2, udp_batch_recvfrom(TEST_CLIENT_NUM, id, 64, datagrams, 4));
+
+  const uint8_t *buffer = udp_batch_buffer();
+  TEST_ASSERT_EQUAL(0, datagrams[0].offset);
+  TEST_ASSERT_EQUAL(10, datagrams[0].length);
+  TEST_ASSERT_EQUAL(REMOTE_PORT, datagrams[0].port_number);
+  TEST_ASSERT_EQUAL_MEMORY(&peer, datagrams[0].ipaddr, sizeof(xtcp_ipaddr_t));
+  TEST_ASSERT_EACH_EQUAL_UINT8(0xAA, &buffer[datagrams[0].offset], 10);
+
+  // Payloads start word aligned
+  TEST_ASSERT_EQUAL(12, datagrams[1].offset);
+  TEST_ASSERT_EQUAL(5, datagrams[1].length);
+  TEST_ASSERT_EQUAL(REMOTE_PORT + 1, datagrams[1].port_number);
+  TEST_ASSERT_EACH_EQUAL_UINT8(0xBB, &buffer[datagrams[1].offset], 5);
+
+  // Nothing left to notify
+  TEST_ASSERT_EQUAL(XTCP_EVENT_NONE, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+  TEST_ASSERT_EQUAL(0, count_remote_data(id));
+}
+
+void test_recv_leaves_datagram_that_does_not_fit(void) {
+  xtcp_datagram_t datagrams[4];
+  receive(20, 0xAA, REMOTE_PORT);
+  receive(20, 0xBB, REMOTE_PORT);
+
+  TEST_ASSERT_EQUAL(1, udp_batch_recvfrom(TEST_CLIENT_NUM, id, 30, datagrams, 4));
+
+  // The second datagram and its event are still queued
+  TEST_ASSERT_EQUAL(1, count_remote_data(id));
+  client_event_t event = dequeue_event(TEST_CLIENT_NUM);
+  TEST_ASSERT_EQUAL(XTCP_RECV_FROM_DATA, event.xtcp_event);
+  TEST_ASSERT_EQUAL(id, event.id);
+  TEST_ASSERT_EQUAL(XTCP_EVENT_NONE, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+
+  TEST_ASSERT_EQUAL(1, udp_batch_recvfrom(TEST_CLIENT_NUM, id, 30, datagrams, 4));
+  TEST_ASSERT_EACH_EQUAL_UINT8(0xBB, udp_batch_buffer(), 20);
+}
+
+void test_recv_keeps_events_for_datagrams_still_queued(void) {
+  xtcp_datagram_t datagrams[1];
+  receive(8, 0xAA, REMOTE_PORT);
+  receive(8, 0xBB, REMOTE_PORT);
+
+  // The client has taken the first event before receiving
+  TEST_ASSERT_EQUAL(XTCP_RECV_FROM_DATA, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+  TEST_ASSERT_EQUAL(1, udp_batch_recvfrom(TEST_CLIENT_NUM, id, 64, datagrams, 1));
+
+  TEST_ASSERT_EQUAL(XTCP_RECV_FROM_DATA, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+  TEST_ASSERT_EQUAL(XTCP_EVENT_NONE, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+}
+
+void test_recv_discards_datagram_longer_than_buffer(void) {
+  xtcp_datagram_t datagrams[4];
+  receive(100, 0xAA, REMOTE_PORT);
+
+  TEST_ASSERT_EQUAL(XTCP_EAGAIN, udp_batch_recvfrom(TEST_CLIENT_NUM, id, 50, datagrams, 4));
+  TEST_ASSERT_EQUAL(0, count_remote_data(id));
+  TEST_ASSERT_EQUAL(XTCP_EVENT_NONE, dequeue_event(TEST_CLIENT_NUM).xtcp_event);
+}
+
+void test_recv_from_empty_queue_returns_zero(void) {
+  xtcp_datagram_t datagrams[4];
+  TEST_ASSERT_EQUAL(0, udp_batch_recvfrom(TEST_CLIENT_NUM, id, 64, datagrams, 4));
+}
+
+void test_tcp_reports_not_supported(void) {
+  xtcp_datagram_t datagrams[4] = {{0}};
+  xtcp_error_int32_t tcp = shim_new_socket(TEST_CLIENT_NUM, XTCP_PROTOCOL_TCP);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, tcp.status);
+
+  TEST_ASSERT_EQUAL(XTCP_EPROTONOSUPPORT, udp_batch_recvfrom(TEST_CLIENT_NUM, tcp.value, 64, datagrams, 4));
+  TEST_ASSERT_EQUAL(XTCP_EPROTONOSUPPORT, udp_batch_sendto(TEST_CLIENT_NUM, tcp.value, 64, datagrams, 1));
+  shim_close_socket(TEST_CLIENT_NUM, tcp.value);
+}
+
+void test_send_sends_each_datagram_to_its_host(void) {
+  uint8_t *buffer = udp_batch_buffer();
+  memset(&buffer[0], 0x11, 8);
+  memset(&buffer[8], 0x22, 16);
+
+  xtcp_datagram_t datagrams[2] = {
+    {.offset = 0, .length = 8, .port_number = REMOTE_PORT},
+    {.offset = 8, .length = 16, .port_number = REMOTE_PORT + 1},
+  };
+  memcpy(datagrams[0].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+  memcpy(datagrams[1].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+
+  TEST_ASSERT_EQUAL(2, udp_batch_sendto(TEST_CLIENT_NUM, id, 24, datagrams, 2));
+  TEST_ASSERT_EQUAL(2, frame_count);
+
+  TEST_ASSERT_EQUAL_MEMORY(peer_mac, frames[0], 6);
+  TEST_ASSERT_EQUAL(REMOTE_PORT + 1, (frames[1][36] << 8) | frames[1][37]);
+  TEST_ASSERT_EACH_EQUAL_UINT8(0x11, &frames[0][UDP_PAYLOAD_OFFSET], 8);
+  TEST_ASSERT_EACH_EQUAL_UINT8(0x22, &frames[1][UDP_PAYLOAD_OFFSET], 16);
+}
+
+void test_send_returns_transmit_timestamps(void) {
+  xtcp_datagram_t datagrams[2] = {
+    {.offset = 0, .length = 8, .port_number = REMOTE_PORT},
+    {.offset = 8, .length = 8, .port_number = REMOTE_PORT},
+  };
+  memcpy(datagrams[0].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+  memcpy(datagrams[1].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+
+  TEST_ASSERT_EQUAL(2, udp_batch_sendto(TEST_CLIENT_NUM, id, 16, datagrams, 2));
+  TEST_ASSERT_EQUAL(1, datagrams[0].timestamp);
+  TEST_ASSERT_EQUAL(2, datagrams[1].timestamp);
+}
+
+void test_send_to_any_address_uses_connected_host(void) {
+  memset(udp_batch_buffer(), 0x33, 4);
+  xtcp_datagram_t datagram = {.offset = 0, .length = 4};
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, shim_connect(TEST_CLIENT_NUM, id, REMOTE_PORT, (uint8_t *)&peer));
+
+  TEST_ASSERT_EQUAL(1, udp_batch_sendto(TEST_CLIENT_NUM, id, 4, &datagram, 1));
+  TEST_ASSERT_EQUAL(1, frame_count);
+  TEST_ASSERT_EQUAL(REMOTE_PORT, (frames[0][36] << 8) | frames[0][37]);
+}
+
+void test_send_stops_at_datagram_outside_buffer(void) {
+  xtcp_datagram_t datagrams[2] = {
+    {.offset = 0, .length = 8, .port_number = REMOTE_PORT},
+    {.offset = 8, .length = 16, .port_number = REMOTE_PORT},
+  };
+  memcpy(datagrams[0].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+  memcpy(datagrams[1].ipaddr, &peer, sizeof(xtcp_ipaddr_t));
+
+  TEST_ASSERT_EQUAL(1, udp_batch_sendto(TEST_CLIENT_NUM, id, 16, datagrams, 2));
+  TEST_ASSERT_EQUAL(1, frame_count);
+  TEST_ASSERT_EQUAL(XTCP_EINVAL, udp_batch_sendto(TEST_CLIENT_NUM, id, 16, &datagrams[1], 1));
+}
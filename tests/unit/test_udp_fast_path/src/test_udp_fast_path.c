@@ -0,0 +1,204 @@
+// Copyright 2025 XMOS LIMITED.
+// This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+#include <unity.h>
+
+#include <string.h>
+
+#include "static_arp.h"
+#include "udp_fast_path.h"
+#include "xtcp_chksum.h"
+
+/* LwIP headers */
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/stats.h"
+#include "lwip/udp.h"
+#include "netif/ethernet.h"
+
+#define CONNECTION_ID 0
+#define LOCAL_PORT 5000
+#define REMOTE_PORT 6000
+
+#define IP_OFFSET 14
+#define UDP_OFFSET (IP_OFFSET + 20)
+
+static struct netif netif;
+static struct udp_pcb *pcb;
+static ip4_addr_t peer;
+static const uint8_t our_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t peer_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+static uint8_t frame[ETHERNET_MAX_PACKET_SIZE];
+static uint32_t frame_len;
+
+__attribute__((fptrgroup("netif_linkoutput_fn")))
+static err_t capture_linkoutput(struct netif *n, struct pbuf *p) {
+  (void)n;
+  frame_len = pbuf_copy_partial(p, frame, p->tot_len, 0);
+  return ERR_OK;
+}
+
+__attribute__((fptrgroup("netif_init_fn")))
+static err_t test_netif_init(struct netif *n) {
+  n->hwaddr_len = ETH_HWADDR_LEN;
+  memcpy(n->hwaddr, our_mac, ETH_HWADDR_LEN);
+  n->mtu = 1500;
+  n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+  n->output = etharp_output;
+  n->linkoutput = capture_linkoutput;
+  return ERR_OK;
+}
+
+static struct pbuf *make_payload(uint16_t length) {
+  struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+  uint8_t *payload = p->payload;
+  for (uint16_t i = 0; i < length; ++i) {
+    payload[i] = (uint8_t)(i * 7 + 3);
+  }
+  return p;
+}
+
+/* Send through lwIP and build the cached route, as the shim does when the fast path is not taken */
+static void send_slow(uint16_t length) {
+  struct pbuf *p = make_payload(length);
+  void *payload = p->payload;
+  TEST_ASSERT_EQUAL(ERR_OK, udp_send(pcb, p));
+  udp_fast_path_update(CONNECTION_ID, pcb, p, payload);
+  pbuf_free(p);
+}
+
+static int send_fast(uint16_t length) {
+  struct pbuf *p = make_payload(length);
+  err_t err = ERR_VAL;
+  int taken = udp_fast_path_send(CONNECTION_ID, pcb, p, &err);
+  pbuf_free(p);
+  if (taken) {
+    TEST_ASSERT_EQUAL(ERR_OK, err);
+  }
+  return taken;
+}
+
+static uint16_t udp_checksum_total(void) {
+  uint8_t pseudo[12] = {0};
+  uint16_t udp_len = (uint16_t)((frame[UDP_OFFSET + 4] << 8) | frame[UDP_OFFSET + 5]);
+  memcpy(&pseudo[0], &frame[IP_OFFSET + 12], 8);
+  pseudo[9] = 17;
+  pseudo[10] = frame[UDP_OFFSET + 4];
+  pseudo[11] = frame[UDP_OFFSET + 5];
+  uint32_t sum = (uint32_t)xtcp_chksum(pseudo, sizeof(pseudo)) + xtcp_chksum(&frame[UDP_OFFSET], udp_len);
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  return (uint16_t)((sum & 0xFFFF) + (sum >> 16));
+}
+
+void setUp() {
+  static int initialised = 0;
+  if (!initialised) {
+    ip4_addr_t ipaddr, netmask, gw;
+    IP4_ADDR(&ipaddr, 192, 168, 200, 198);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    IP4_ADDR(&gw, 192, 168, 200, 1);
+
+    lwip_init();
+    netif_add(&netif, &ipaddr, &netmask, &gw, NULL, test_netif_init, ethernet_input);
+    netif_set_default(&netif);
+    netif_set_up(&netif);
+    netif_set_link_up(&netif);
+    static_arp_init();
+    initialised = 1;
+  }
+
+  IP4_ADDR(&peer, 192, 168, 200, 2);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add((const uint8_t *)&peer, peer_mac));
+
+  pcb = udp_new();
+  udp_bind(pcb, IP_ADDR_ANY, LOCAL_PORT);
+  udp_connect(pcb, &peer, REMOTE_PORT);
+}
+
+void tearDown() {
+  udp_remove(pcb);
+  (void)static_arp_remove((const uint8_t *)&peer);
+}
+
+void test_not_taken_before_first_send(void) {
+  TEST_ASSERT_FALSE(send_fast(32));
+}
+
+void test_fast_frame_matches_lwip_frame(void) {
+  static uint8_t slow_frame[ETHERNET_MAX_PACKET_SIZE];
+
+  send_slow(100);
+  uint32_t slow_len = frame_len;
+  memcpy(slow_frame, frame, slow_len);
+
+  TEST_ASSERT_TRUE(send_fast(100));
+  TEST_ASSERT_EQUAL_UINT32(slow_len, frame_len);
+
+  // Identical apart from the IP ID, which follows on from lwIP's, and so the IP header checksum
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(slow_frame, frame, IP_OFFSET + 4);
+  uint32_t slow_id = (uint32_t)((slow_frame[IP_OFFSET + 4] << 8) | slow_frame[IP_OFFSET + 5]);
+  uint32_t fast_id = (uint32_t)((frame[IP_OFFSET + 4] << 8) | frame[IP_OFFSET + 5]);
+  TEST_ASSERT_EQUAL_UINT32((slow_id + 1) & 0xFFFF, fast_id);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&slow_frame[IP_OFFSET + 6], &frame[IP_OFFSET + 6], 4);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&slow_frame[IP_OFFSET + 12], &frame[IP_OFFSET + 12], slow_len - (IP_OFFSET + 12));
+  TEST_ASSERT_EQUAL_HEX16(0xFFFF, xtcp_chksum(&frame[IP_OFFSET], 20));
+}
+
+void test_checksums_are_valid_for_all_lengths(void) {
+  send_slow(1);
+  for (uint16_t length = 0; length <= 64; ++length) {
+    TEST_ASSERT_TRUE(send_fast(length));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, xtcp_chksum(&frame[IP_OFFSET], 20));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, udp_checksum_total());
+  }
+}
+
+void test_datagram_larger_than_mtu_is_not_taken(void) {
+  send_slow(16);
+  TEST_ASSERT_TRUE(send_fast(1472));
+  TEST_ASSERT_FALSE(send_fast(1473));
+}
+
+void test_invalidate_drops_the_route(void) {
+  send_slow(16);
+  udp_fast_path_invalidate();
+  TEST_ASSERT_FALSE(send_fast(16));
+}
+
+void test_reconnect_drops_the_route(void) {
+  send_slow(16);
+  udp_connect(pcb, &peer, REMOTE_PORT + 1);
+  TEST_ASSERT_FALSE(send_fast(16));
+}
+
+void test_static_arp_change_drops_the_route(void) {
+  static const uint8_t new_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x03};
+  send_slow(16);
+  TEST_ASSERT_EQUAL(XTCP_SUCCESS, static_arp_add((const uint8_t *)&peer, new_mac));
+  TEST_ASSERT_FALSE(send_fast(16));
+
+  send_slow(16);
+  TEST_ASSERT_TRUE(send_fast(16));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(new_mac, frame, 6);
+}
+
+void test_unconnected_socket_is_not_cached(void) {
+  udp_disconnect(pcb);
+  struct pbuf *p = make_payload(16);
+  udp_fast_path_update(CONNECTION_ID, pcb, p, p->payload);
+  pbuf_free(p);
+  TEST_ASSERT_FALSE(send_fast(16));
+}
+
+#if UDP_STATS
+void test_fast_send_is_counted_by_lwip(void) {
+  send_slow(16);
+  uint32_t udp_xmit = lwip_stats.udp.xmit;
+  uint32_t ip_xmit = lwip_stats.ip.xmit;
+  TEST_ASSERT_TRUE(send_fast(16));
+  TEST_ASSERT_EQUAL_UINT32(udp_xmit + 1, lwip_stats.udp.xmit);
+  TEST_ASSERT_EQUAL_UINT32(ip_xmit + 1, lwip_stats.ip.xmit);
+}
+#endif
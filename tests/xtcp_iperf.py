@@ -0,0 +1,141 @@
+# Copyright 2025 XMOS LIMITED.
+# This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+import socket
+import struct
+import threading
+import time
+import argparse
+
+# Stand-in for iperf2 TCP, for hosts without iperf installed. It speaks the same protocol as `iperf -s` and
+# `iperf -c <ip> -t <seconds>`, and the lib_xtcp iperf tasks in xtcp_iperf.h, and prints reports in the same format
+# as xtcp_iperf_report(), so its numbers can be compared with either.
+#
+# Receive from a DUT running xtcp_iperf_client(),
+#   python xtcp_iperf.py --server --port 5001
+# Send to a DUT running xtcp_iperf_server(),
+#   python xtcp_iperf.py --ip 192.168.200.198 --port 5001 --time 10
+# Check the stand-in against itself over the loopback interface,
+#   python xtcp_iperf.py --self-test
+
+HEADER_LENGTH = 24
+BUFFER_LENGTH = 1460
+
+
+def report(conn_id, start, end, nbytes, final, role):
+    kbits = int((nbytes * 8) / ((end - start) * 1000)) if end > start else 0
+    suffix = (' received' if role == 'server' else ' sent') if final else ''
+    print(f"[{conn_id:3d}] {int(start):3d}.{int(start * 10) % 10:01d}-{int(end):3d}.{int(end * 10) % 10:01d} sec "
+          f"{nbytes // 1024:8d} KBytes {kbits:8d} Kbits/sec{suffix}", flush=True)
+    return kbits
+
+
+class Interval:
+    """Per-interval accounting matching the firmware's, intervals ending on whole multiples of the interval"""
+    def __init__(self, conn_id, role, interval):
+        self.conn_id = conn_id
+        self.role = role
+        self.interval = interval
+        self.start = time.monotonic()
+        self.interval_start = 0.0
+        self.interval_bytes = 0
+        self.total = 0
+
+    def elapsed(self):
+        return time.monotonic() - self.start
+
+    def advance(self):
+        elapsed = self.elapsed()
+        while elapsed - self.interval_start >= self.interval:
+            report(self.conn_id, self.interval_start, self.interval_start + self.interval, self.interval_bytes,
+                   False, self.role)
+            self.interval_start += self.interval
+            self.interval_bytes = 0
+
+    def count(self, nbytes):
+        self.advance()
+        self.interval_bytes += nbytes
+        self.total += nbytes
+
+    def close(self):
+        self.advance()
+        elapsed = self.elapsed()
+        if elapsed > self.interval_start:
+            report(self.conn_id, self.interval_start, elapsed, self.interval_bytes, False, self.role)
+        return report(self.conn_id, 0, elapsed, self.total, True, self.role)
+
+
+def serve(port, interval, once=False, results=None, ready=None):
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    listener.bind(('', port))
+    listener.listen(4)
+    if ready is not None:
+        ready.set()
+    conn_id = 0
+    while True:
+        sock, addr = listener.accept()
+        conn_id += 1
+        print(f"[{conn_id:3d}] connected with {addr[0]} port {addr[1]}", flush=True)
+        session = Interval(conn_id, 'server', interval)
+        while True:
+            data = sock.recv(65536)
+            if not data:
+                break
+            session.count(len(data))
+        sock.close()
+        kbits = session.close()
+        if results is not None:
+            results.append((session.total, kbits))
+        if once:
+            listener.close()
+            return
+
+
+def send(ip, port, duration, interval):
+    sock = socket.create_connection((ip, port))
+    # flags, threads, port, buffer length, window/bandwidth, amount as -time in 10ms units
+    header = struct.pack('!iiiiii', 0, 1, port, 0, 0, -int(duration * 100))
+    data = (b'0123456789' * ((BUFFER_LENGTH // 10) + 1))[:BUFFER_LENGTH]
+    session = Interval(1, 'client', interval)
+    sock.sendall(header)
+    session.count(HEADER_LENGTH)
+    while session.elapsed() < duration:
+        sock.sendall(data)
+        session.count(len(data))
+    sock.shutdown(socket.SHUT_WR)
+    sock.close()
+    return (session.total, session.close())
+
+
+def self_test(port, duration, interval):
+    results = []
+    ready = threading.Event()
+    server = threading.Thread(target=serve, args=(port, interval, True, results, ready))
+    server.start()
+    ready.wait()
+    sent, _ = send('127.0.0.1', port, duration, interval)
+    server.join()
+    received, _ = results[0]
+    if received != sent:
+        print(f"ERROR: sent {sent} bytes, received {received} bytes")
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='iperf2 TCP stand-in')
+    parser.add_argument('--ip', type=str, help="IP address of the iperf server to send to")
+    parser.add_argument('--port', type=int, default=5001, help="TCP port")
+    parser.add_argument('--server', action='store_true', help="Receive from iperf clients")
+    parser.add_argument('--time', type=float, default=10, help="Seconds to send for")
+    parser.add_argument('--interval', type=float, default=1, help="Seconds between reports")
+    parser.add_argument('--self-test', action='store_true', help="Send to a stand-in server over loopback")
+    args = parser.parse_args()
+
+    if args.self_test:
+        exit(self_test(args.port, min(args.time, 3), args.interval))
+    elif args.server:
+        serve(args.port, args.interval)
+    else:
+        send(args.ip, args.port, args.time, args.interval)
@@ -0,0 +1,196 @@
+# Copyright 2025 XMOS LIMITED.
+# This Software is subject to the terms of the XMOS Public Licence: Version 1.
+
+import argparse
+import struct
+import sys
+from collections import defaultdict, deque
+
+# Decoder for the lib_xtcp event trace, the bytes read with read_trace() concatenated, as sent over xscope by
+# xtcp_trace_xscope() or saved from a host build. Prints the records in time order, or a timeline per connection, and
+# the time each client took to take its events from the queue.
+#
+# Print every record,
+#   python xtcp_trace.py trace.bin
+# Print a timeline for each connection with the time between its records, and the event latencies,
+#   python xtcp_trace.py trace.bin --connections --latency
+# Check the decoder against records it encodes itself,
+#   python xtcp_trace.py --self-test
+
+MAGIC = 0x43525458
+VERSION = 1
+HEADER = struct.Struct('<IHHII')
+RECORD = struct.Struct('<IBBhII')
+
+NO_CLIENT = 0xFF
+NO_ID = -1
+
+# trace_site_t in lib_xtcp/src/trace.h
+SITES = {
+    0x01: 'lost',
+    0x10: 'event_queued',
+    0x11: 'event_taken',
+    0x12: 'event_dropped',
+    0x20: 'pbuf_alloc',
+    0x21: 'pbuf_free',
+    0x30: 'tcp_write',
+    0x31: 'tcp_output',
+    0x40: 'rx_frame',
+    0x50: 'timer',
+}
+
+# xtcp_event_type_t in lib_xtcp/api/xtcp.h
+EVENTS = ['NONE', 'NEW_CONNECTION', 'ACCEPTED', 'RECV_DATA', 'RECV_FROM_DATA', 'SENT_DATA', 'RESEND_DATA',
+          'TIMED_OUT', 'ABORTED', 'CLOSED', 'IFUP', 'IFDOWN', 'DNS_RESULT', 'SENT_STATIC']
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def describe(site, arg0, arg1):
+    """The arguments of a record as the trace point defines them"""
+    name = SITES.get(site)
+    if name in ('event_queued', 'event_taken'):
+        event = EVENTS[arg0] if arg0 < len(EVENTS) else str(arg0)
+        return f"{event} queued={arg1}"
+    if name == 'event_dropped':
+        return EVENTS[arg0] if arg0 < len(EVENTS) else str(arg0)
+    if name == 'pbuf_alloc':
+        return f"len={arg0} pbuf={arg1:#x}" if arg1 else f"len={arg0} failed"
+    if name == 'pbuf_free':
+        return f"len={arg0} pbuf={arg1:#x}"
+    if name == 'tcp_write':
+        return f"len={arg0} err={signed(arg1)}"
+    if name == 'tcp_output':
+        return f"err={signed(arg1)}"
+    if name == 'rx_frame':
+        return f"len={arg0} mac_time={arg1}"
+    if name == 'timer':
+        return f"timer={arg0}"
+    if name == 'lost':
+        return f"{arg0} records overwritten"
+    return f"{arg0:#x} {arg1:#x}"
+
+
+class Record:
+    def __init__(self, time_us, site, client, conn_id, arg0, arg1):
+        self.time_us = time_us
+        self.site = site
+        self.client = client
+        self.conn_id = conn_id
+        self.arg0 = arg0
+        self.arg1 = arg1
+
+    def __str__(self):
+        client = '-' if self.client == NO_CLIENT else str(self.client)
+        conn_id = '-' if self.conn_id == NO_ID else str(self.conn_id)
+        name = SITES.get(self.site, f"site_{self.site:#04x}")
+        return f"{self.time_us:14.2f} {client:>3} {conn_id:>4} {name:<14} {describe(self.site, self.arg0, self.arg1)}"
+
+
+def decode(data):
+    """Records of a trace, timestamps in microseconds from the first record"""
+    if len(data) < HEADER.size:
+        raise ValueError("Trace is shorter than its header")
+    magic, version, record_length, ticks_per_second, _ = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION or record_length != RECORD.size:
+        raise ValueError("Not a lib_xtcp event trace")
+
+    records = []
+    last = None
+    elapsed = 0
+    for offset in range(HEADER.size, len(data) - RECORD.size + 1, RECORD.size):
+        timestamp, site, client, conn_id, arg0, arg1 = RECORD.unpack_from(data, offset)
+        # The reference timer wraps, records are in time order so each follows the last
+        if last is not None:
+            elapsed += (timestamp - last) & 0xFFFFFFFF
+        last = timestamp
+        records.append(Record(elapsed * 1e6 / ticks_per_second, site, client, conn_id, arg0, arg1))
+    return records
+
+
+def print_connections(records):
+    """A timeline for each connection, with the time since its previous record"""
+    timelines = defaultdict(list)
+    for record in records:
+        if record.conn_id != NO_ID:
+            timelines[record.conn_id].append(record)
+    for conn_id in sorted(timelines):
+        print(f"Connection {conn_id}")
+        previous = None
+        for record in timelines[conn_id]:
+            delta = record.time_us - previous if previous is not None else 0.0
+            print(f"  +{delta:12.2f} {record}")
+            previous = record.time_us
+
+
+def event_latencies(records):
+    """Time from each event being queued to the client taking it, per client and event type, in microseconds"""
+    queued = defaultdict(deque)
+    latencies = defaultdict(list)
+    for record in records:
+        key = (record.client, record.conn_id, record.arg0)
+        if SITES.get(record.site) == 'event_queued':
+            queued[key].append(record.time_us)
+        elif SITES.get(record.site) == 'event_taken' and queued[key]:
+            latencies[(record.client, record.arg0)].append(record.time_us - queued[key].popleft())
+    return latencies
+
+
+def print_latency(records):
+    print(f"{'client':>6} {'event':<15} {'count':>6} {'mean_us':>10} {'max_us':>10}")
+    latencies = event_latencies(records)
+    for (client, event), values in sorted(latencies.items()):
+        name = EVENTS[event] if event < len(EVENTS) else str(event)
+        print(f"{client:>6} {name:<15} {len(values):>6} {sum(values) / len(values):>10.2f} {max(values):>10.2f}")
+
+
+def encode(records, ticks_per_second=100000000, start=0xFFFFFF00):
+    """Encode records of (ticks, site, client, id, arg0, arg1) as the stack does, timestamps offset from start"""
+    data = HEADER.pack(MAGIC, VERSION, RECORD.size, ticks_per_second, 0)
+    for ticks, site, client, conn_id, arg0, arg1 in records:
+        data += RECORD.pack((start + ticks) & 0xFFFFFFFF, site, client, conn_id, arg0 & 0xFFFFFFFF,
+                           arg1 & 0xFFFFFFFF)
+    return data
+
+
+def self_test():
+    # A RECV_DATA event queued, then taken 150 us later after the timer wraps, and a failed tcp_write
+    data = encode([(0, 0x40, NO_CLIENT, NO_ID, 1514, 7),
+                   (100, 0x10, 1, 3, 3, 1),
+                   (15100, 0x11, 1, 3, 3, 0),
+                   (15200, 0x30, 1, 3, 1460, -1),
+                   (15300, 0x01, NO_CLIENT, NO_ID, 12, 0)])
+    records = decode(data)
+    assert len(records) == 5
+    assert records[2].time_us == 151.0
+    assert 'RECV_DATA' in str(records[2])
+    assert 'err=-1' in str(records[3])
+    assert event_latencies(records) == {(1, 3): [150.0]}
+    print("Self test passed")
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Decode a lib_xtcp event trace')
+    parser.add_argument('trace', nargs='?', type=str, help="File of the bytes read with read_trace(), - for stdin")
+    parser.add_argument('--connections', action='store_true', help="Print a timeline for each connection")
+    parser.add_argument('--latency', action='store_true', help="Print the time clients took to take their events")
+    parser.add_argument('--self-test', action='store_true', help="Check the decoder against records it encodes")
+    args = parser.parse_args()
+
+    if args.self_test:
+        self_test()
+        sys.exit(0)
+    if args.trace is None:
+        parser.error("a trace file is needed")
+
+    data = sys.stdin.buffer.read() if args.trace == '-' else open(args.trace, 'rb').read()
+    trace = decode(data)
+    if args.connections:
+        print_connections(trace)
+    else:
+        for record in trace:
+            print(record)
+    if args.latency:
+        print_latency(trace)